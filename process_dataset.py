@@ -3,13 +3,9 @@
 import os
 import sys
 import subprocess
-import tqdm
-import glob
 import itertools
-import json
 import argparse
 import time
-import math
 from datetime import timedelta
 
 ONLY_DESCRIPTOR_ID = None
@@ -93,45 +89,6 @@ def get_available_descriptors():
     # Otherwise return all descriptors
     return {str(desc_id): desc_info for desc_id, desc_info in ALL_DESCRIPTORS.items()}
 
-def process_image(image_file, descriptor_id, params_dict, output_dir, mpeg7_app):
-    filename = os.path.basename(image_file)
-    base_filename = os.path.splitext(filename)[0]
-    descriptor_name = ALL_DESCRIPTORS[int(descriptor_id)]["name"]
-    
-    params_str = "_".join([f"{k}-{v}" for k, v in params_dict.items()]) if params_dict else "default"
-    output_file = os.path.join(output_dir, f"{base_filename}_{descriptor_name}_{params_str}.txt")
-    
-    cmd = [mpeg7_app, str(descriptor_id), image_file]
-    
-    for param_name, param_value in params_dict.items():
-        cmd.extend([param_name, param_value])
-        
-    try:
-        result = subprocess.run(
-            cmd,
-            stdout=subprocess.PIPE, stderr=subprocess.PIPE, check=False
-        )
-
-        if result.returncode != 0:
-            print(f"Failed to process {filename} with descriptor {descriptor_name}, params {params_dict}: {result.stderr.decode()}")
-            return False
-
-        output_text = result.stdout.decode()
-        
-        with open(output_file, 'w') as f:
-            metadata = {
-                "image": filename,
-                "descriptor_id": int(descriptor_id),
-                "descriptor_name": descriptor_name,
-                "parameters": params_dict
-            }
-            f.write(json.dumps(metadata) + "\n")
-            f.write(output_text)
-        return True
-    except Exception as e:
-        print(f"Error processing {filename} with descriptor {descriptor_name}, params {params_dict}: {str(e)}")
-        return False
-
 def get_parameter_combinations(descriptor_params):
     if not descriptor_params:
         return [{}]
@@ -147,83 +104,64 @@ def get_parameter_combinations(descriptor_params):
 
 def main():
     global ONLY_DESCRIPTOR_ID
-    
-    output_dir = OUTPUT_DIR
-    dataset_dir = DATASET_DIR
-    mpeg7_app = MPEG7_APP
-    
-    available_descriptors = get_available_descriptors()
-    descriptors_to_process = {}
-    for desc_id, desc_info in available_descriptors.items():
-        descriptors_to_process[desc_id] = {
-            "name": desc_info["name"],
-            "params": desc_info["params"]
-        }
-    
+
+    parser = argparse.ArgumentParser(description="Extract MPEG-7 descriptors from all images of a dataset")
+    parser.add_argument("--dataset", default=DATASET_DIR, help="directory with images or manifest file")
+    parser.add_argument("--output", default=OUTPUT_DIR, help="output directory")
+    parser.add_argument("--app", default=MPEG7_APP, help="path to mpeg7_app")
+    parser.add_argument("--threads", type=int, default=0, help="worker threads (0 - all hardware threads)")
+    parser.add_argument("--descriptor", type=int, default=ONLY_DESCRIPTOR_ID, help="process only this descriptor")
+    parser.add_argument("--restart", action="store_true", help="ignore checkpoint of previous run")
+    args = parser.parse_args()
+
+    ONLY_DESCRIPTOR_ID = args.descriptor
+
+    descriptors_to_process = get_available_descriptors()
+
     if not descriptors_to_process:
         print("Error: No valid descriptors available.")
         sys.exit(1)
-        
-    desc_ids = list(descriptors_to_process.keys())
-    if ONLY_DESCRIPTOR_ID:
-        print(f"Processing with single descriptor: {desc_ids[0]}")
-    else:
-        print(f"Processing with all available descriptors: {desc_ids}")
-    
-    if not os.path.isdir(dataset_dir):
-        print(f"Error: Directory '{dataset_dir}' does not exist.")
-        sys.exit(1)
 
-    os.makedirs(output_dir, exist_ok=True)
-    
-    image_files = []
-    for root, _, files in os.walk(dataset_dir):
-        for file in files:
-            if file.lower().endswith(('.jpg', '.jpeg', '.png', '.bmp', '.pgm', '.ppm')):
-                image_files.append(os.path.join(root, file))
+    print(f"Processing with descriptors: {list(descriptors_to_process.keys())}")
 
-    print(f"Found {len(image_files)} image files to process.")
-    
-    if not image_files:
-        print("No image files found in the dataset directory. Exiting.")
+    if not os.path.exists(args.dataset):
+        print(f"Error: '{args.dataset}' does not exist.")
         sys.exit(1)
-        
-    jobs = []
-    for image_file in image_files:
-        for descriptor_id, descriptor_info in descriptors_to_process.items():
-            for param_set in descriptor_info["params"]:
-                param_combinations = get_parameter_combinations(param_set)
-                for params in param_combinations:
-                    jobs.append((image_file, descriptor_id, params, output_dir, mpeg7_app))
-    
-    total_jobs = len(jobs)
-    print(f"Total job combinations: {total_jobs} (images × descriptors × parameter combinations)")
-    
+
+    # Whole dataset is processed by one mpeg7_app process: every image is decoded once,
+    # all descriptors are extracted on a pool of threads and written to one file per descriptor
+    cmd = [args.app, "batch", args.dataset, args.output, "--threads", str(args.threads)]
+
+    if args.restart:
+        cmd.append("--restart")
+
+    jobs = 0
+    for descriptor_id, descriptor_info in descriptors_to_process.items():
+        for param_set in descriptor_info["params"]:
+            for params in get_parameter_combinations(param_set):
+                cmd.extend(["--descriptor", descriptor_id])
+                for param_name, param_value in params.items():
+                    cmd.extend([param_name, param_value])
+                jobs += 1
+
+    print(f"Descriptor and parameter combinations per image: {jobs}")
+
     start_time = time.time()
-    successful = 0
-    failed = 0
-    
-    print("Starting sequential processing...")
-    
+
     try:
-        results = []
-        for job in tqdm.tqdm(jobs, desc="Processing images"):
-            image_file, descriptor_id, params, output_dir, mpeg7_app = job
-            result = process_image(image_file, descriptor_id, params, output_dir, mpeg7_app)
-            results.append(result)
-            if result:
-                successful += 1
-            else:
-                failed += 1
+        result = subprocess.run(cmd, check=False)
     except KeyboardInterrupt:
-        print("\nProcessing interrupted by user.")
+        print("\nProcessing interrupted by user, run again to resume from the last checkpoint.")
         sys.exit(1)
-    
+
     processing_time = time.time() - start_time
-    
+
+    if result.returncode != 0:
+        print(f"mpeg7_app batch failed with code {result.returncode}")
+        sys.exit(result.returncode)
+
     print(f"\nProcessing complete in {timedelta(seconds=int(processing_time))}.")
-    print(f"{successful} jobs completed successfully, {failed} jobs failed.")
-    print(f"\nIndividual results saved to {output_dir}/")
+    print(f"Results saved to {args.output}/ (one JSON line per image in each descriptor file)")
 
 
 if __name__ == "__main__":
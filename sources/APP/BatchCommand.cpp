@@ -0,0 +1,478 @@
+#include "BatchCommand.h"
+#include "FileSystem.h"
+
+#include "../Mpeg7.h"
+#include "../TOOLS/Parallel/Parallel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+
+void BatchCommand::printUsage(const char * programName) {
+    std::cout << "  Batch extraction:   " << programName << " batch <image_dir | manifest> <output_dir> [options]" << std::endl;
+    std::cout << "                        [--descriptor <descriptor_type> [param_name param_value ...]] ..." << std::endl;
+    std::cout << "Batch options:" << std::endl;
+    std::cout << "  --descriptor, -d    descriptor type with its parameters, may be repeated (default: all types)" << std::endl;
+    std::cout << "  --threads <n>       worker threads (default: all hardware threads)" << std::endl;
+    std::cout << "  --chunk <n>         images written between checkpoints (default: " << BATCH_CHUNK_PER_THREAD << " per thread)" << std::endl;
+    std::cout << "  --binary            write binary packets (.bin) instead of XML (.jsonl)" << std::endl;
+    std::cout << "  --restart           ignore checkpoint and start from the first image" << std::endl;
+    std::cout << "  --quiet             do not show progress" << std::endl;
+}
+
+int BatchCommand::run(const int argc, char * argv[]) {
+    BatchOptions options;
+
+    if (!parseArguments(argc, argv, options)) {
+        return 1;
+    }
+
+    std::vector<std::string> images;
+
+    if (!readImageList(options.input, images)) {
+        std::cerr << "Error: Could not read images from " << options.input << std::endl;
+        return 1;
+    }
+
+    if (images.empty()) {
+        std::cerr << "Error: No images found in " << options.input << std::endl;
+        return 1;
+    }
+
+    if (!FileSystem::createDirectory(options.outputDirectory)) {
+        std::cerr << "Error: Could not create output directory " << options.outputDirectory << std::endl;
+        return 1;
+    }
+
+    const size_t descriptorCount = options.descriptors.size();
+    const std::string extension = options.binary ? ".bin" : ".jsonl";
+
+    std::vector<std::string> outputPaths;
+
+    for (const BatchDescriptor & descriptor : options.descriptors) {
+        const std::string path = FileSystem::join(options.outputDirectory, descriptor.name + extension);
+
+        if (std::find(outputPaths.begin(), outputPaths.end(), path) != outputPaths.end()) {
+            std::cerr << "Error: Descriptor " << descriptor.name << " requested more than once." << std::endl;
+            return 1;
+        }
+        outputPaths.push_back(path);
+    }
+
+    // Resume from checkpoint - outputs are cut back to sizes stored after last complete chunk
+    const std::string checkpointPath = FileSystem::join(options.outputDirectory, BATCH_CHECKPOINT_FILE);
+    const unsigned long long runFingerprint = fingerprint(options, images);
+
+    unsigned long processed = 0;
+    std::vector<long long> offsets(descriptorCount, 0);
+
+    if (!options.restart && FileSystem::exists(checkpointPath)) {
+        if (!readCheckpoint(checkpointPath, runFingerprint, processed, offsets) || offsets.size() != descriptorCount) {
+            std::cerr << "Error: Checkpoint " << checkpointPath << " does not match images and descriptors of this run "
+                      << "(use --restart to start over)." << std::endl;
+            return 1;
+        }
+
+        for (size_t d = 0; d < descriptorCount; d++) {
+            if (FileSystem::fileSize(outputPaths[d]) < offsets[d] || !FileSystem::truncate(outputPaths[d], offsets[d])) {
+                std::cerr << "Error: Output " << outputPaths[d] << " is shorter than its checkpoint." << std::endl;
+                return 1;
+            }
+        }
+
+        if (options.progress) {
+            std::cerr << "Resuming from image " << processed << " of " << images.size() << std::endl;
+        }
+    }
+
+    std::vector<std::unique_ptr<std::ofstream>> outputs;
+
+    for (size_t d = 0; d < descriptorCount; d++) {
+        const std::ios::openmode mode = std::ios::binary | (processed > 0 ? std::ios::app : std::ios::trunc);
+        outputs.emplace_back(new std::ofstream(outputPaths[d], mode));
+
+        if (!outputs.back()->is_open()) {
+            std::cerr << "Error: Could not open output " << outputPaths[d] << std::endl;
+            return 1;
+        }
+        offsets[d] = FileSystem::fileSize(outputPaths[d]);
+    }
+
+    // Parameters and extractors are prepared once, every worker owns its extractors
+    std::vector<std::vector<const char *>> params(descriptorCount);
+
+    for (size_t d = 0; d < descriptorCount; d++) {
+        for (const std::string & param : options.descriptors[d].params) {
+            params[d].push_back(param.c_str());
+        }
+        params[d].push_back(nullptr);
+    }
+
+    const int workers = Parallel::resolveThreads(options.threads);
+
+    std::vector<std::vector<std::unique_ptr<DescriptorExtractor>>> extractors(workers);
+
+    for (int worker = 0; worker < workers; worker++) {
+        for (size_t d = 0; d < descriptorCount; d++) {
+            extractors[worker].emplace_back(createExtractor(options.descriptors[d].type));
+        }
+    }
+
+    // Parameters part of JSON records is the same for every image
+    std::vector<std::string> recordHeaders(descriptorCount);
+
+    for (size_t d = 0; d < descriptorCount; d++) {
+        const BatchDescriptor & descriptor = options.descriptors[d];
+
+        std::string header = "\"descriptor_id\":" + std::to_string(descriptor.type) +
+                             ",\"descriptor_name\":\"" + descriptorName(descriptor.type) + "\",\"parameters\":{";
+
+        for (size_t p = 0; p + 1 < descriptor.params.size(); p += 2) {
+            header += (p > 0 ? "," : "") + std::string("\"") + escapeJSON(descriptor.params[p]) + "\":\"" + escapeJSON(descriptor.params[p + 1]) + "\"";
+        }
+        recordHeaders[d] = header + "}";
+    }
+
+    const unsigned long imageCount = static_cast<unsigned long>(images.size());
+    const unsigned long chunkSize  = static_cast<unsigned long>(options.chunkSize > 0 ? options.chunkSize : workers * BATCH_CHUNK_PER_THREAD);
+
+    unsigned long failed = 0;
+    const unsigned long firstImage = processed;
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::string> records;
+    std::vector<char> recordFailed;
+
+    while (processed < imageCount) {
+        const unsigned long chunk = std::min(chunkSize, imageCount - processed);
+
+        records.assign(chunk * descriptorCount, std::string());
+        recordFailed.assign(chunk * descriptorCount, 0);
+
+        Parallel::forEach(chunk, options.threads, [&](const unsigned long i, const int worker) {
+            const std::string & path = images[processed + i];
+
+            Image image;
+            int loadError = 0;
+
+            try {
+                image.load(path.c_str(), IMAGE_UNCHANGED);
+            }
+            catch (ErrorCode exception) {
+                loadError = exception;
+            }
+
+            for (size_t d = 0; d < descriptorCount; d++) {
+                std::string & record = records[i * descriptorCount + d];
+                int error = loadError;
+
+                std::string xml;
+                unsigned char packet[DESCRIPTOR_BINARY_MAX_SIZE];
+                int packetSize = 0;
+
+                if (error == 0) {
+                    try {
+                        Descriptor * descriptor = extractors[worker][d]->extract(image, params[d].data());
+
+                        if (options.binary) {
+                            packetSize = static_cast<int>(DESCRIPTOR_BINARY_HEADER_SIZE + descriptor->getBinarySize());
+
+                            if (packetSize > DESCRIPTOR_BINARY_MAX_SIZE) {
+                                throw BINARY_BUFFER_TOO_SMALL;
+                            }
+
+                            DescriptorBinary::writeHeader(packet, options.descriptors[d].type);
+                            descriptor->writeBinary(packet + DESCRIPTOR_BINARY_HEADER_SIZE);
+                        }
+                        else {
+                            xml = descriptor->generateXML();
+                        }
+                    }
+                    catch (ErrorCode exception) {
+                        error = exception;
+                    }
+                }
+
+                recordFailed[i * descriptorCount + d] = error != 0;
+
+                if (options.binary) {
+                    const int value = error != 0 ? -error : packetSize;
+                    const unsigned int pathSize = static_cast<unsigned int>(path.size());
+
+                    for (int b = 0; b < 4; b++) {
+                        record += static_cast<char>((pathSize >> (8 * b)) & 0xFF);
+                    }
+                    record += path;
+
+                    for (int b = 0; b < 4; b++) {
+                        record += static_cast<char>((static_cast<unsigned int>(value) >> (8 * b)) & 0xFF);
+                    }
+
+                    if (error == 0) {
+                        record.append(reinterpret_cast<const char *>(packet), packetSize);
+                    }
+                }
+                else {
+                    record = "{\"image\":\"" + escapeJSON(path) + "\"," + recordHeaders[d];
+                    record += error != 0 ? ",\"error\":" + std::to_string(error) : ",\"xml\":\"" + escapeJSON(xml) + "\"";
+                    record += "}\n";
+                }
+            }
+        });
+
+        // Records are written in image order, checkpoint is stored only after outputs are flushed
+        for (size_t d = 0; d < descriptorCount; d++) {
+            for (unsigned long i = 0; i < chunk; i++) {
+                const std::string & record = records[i * descriptorCount + d];
+                outputs[d]->write(record.data(), static_cast<std::streamsize>(record.size()));
+                offsets[d] += static_cast<long long>(record.size());
+                failed += recordFailed[i * descriptorCount + d];
+            }
+            outputs[d]->flush();
+
+            if (!*outputs[d]) {
+                std::cerr << std::endl << "Error: Could not write output " << outputPaths[d] << std::endl;
+                return 1;
+            }
+        }
+
+        processed += chunk;
+
+        if (!writeCheckpoint(checkpointPath, runFingerprint, processed, offsets)) {
+            std::cerr << std::endl << "Error: Could not write checkpoint " << checkpointPath << std::endl;
+            return 1;
+        }
+
+        if (options.progress) {
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            const double rate = seconds > 0.0 ? (processed - firstImage) / seconds : 0.0;
+            const long remaining = rate > 0.0 ? static_cast<long>((imageCount - processed) / rate) : 0;
+
+            char line[160];
+            snprintf(line, sizeof(line), "\rProcessed %lu/%lu images (%.1f%%), %.1f images/s, %lu failed, ETA %02ld:%02ld:%02ld ",
+                     processed, imageCount, 100.0 * processed / imageCount, rate, failed,
+                     remaining / 3600, (remaining / 60) % 60, remaining % 60);
+            std::cerr << line << std::flush;
+        }
+    }
+
+    if (options.progress) {
+        std::cerr << std::endl;
+    }
+
+    std::cout << "Processed " << imageCount - firstImage << " images, " << failed << " of "
+              << (imageCount - firstImage) * descriptorCount << " descriptors failed." << std::endl;
+
+    for (const std::string & path : outputPaths) {
+        std::cout << "  " << path << std::endl;
+    }
+    return 0;
+}
+
+bool BatchCommand::parseArguments(const int argc, char * argv[], BatchOptions & options) {
+    if (argc < 4) {
+        std::cerr << "Error: Not enough arguments for batch command." << std::endl;
+        return false;
+    }
+
+    options.input = argv[2];
+    options.outputDirectory = argv[3];
+
+    for (int i = 4; i < argc; i++) {
+        const std::string argument = argv[i];
+
+        if (argument == "--descriptor" || argument == "-d") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: Missing descriptor type." << std::endl;
+                return false;
+            }
+
+            const int type = std::atoi(argv[++i]);
+
+            if (type < DOMINANT_COLOR_D || type > CONTOUR_SHAPE_D) {
+                std::cerr << "Error: Invalid descriptor type. Must be between 1 and 10." << std::endl;
+                return false;
+            }
+
+            BatchDescriptor descriptor;
+            descriptor.type = static_cast<DescriptorType>(type);
+
+            // Parameters follow descriptor type up to next option
+            while (i + 1 < argc && argv[i + 1][0] != '-') {
+                descriptor.params.push_back(argv[++i]);
+            }
+
+            if (descriptor.params.size() % 2 != 0) {
+                std::cerr << "Error: Parameters must be provided as name-value pairs." << std::endl;
+                return false;
+            }
+
+            descriptor.name = std::string(descriptorName(descriptor.type)) + "_";
+
+            for (size_t p = 0; p < descriptor.params.size(); p += 2) {
+                descriptor.name += (p > 0 ? "_" : "") + descriptor.params[p] + "-" + descriptor.params[p + 1];
+            }
+
+            if (descriptor.params.empty()) {
+                descriptor.name += "default";
+            }
+            options.descriptors.push_back(descriptor);
+        }
+        else if ((argument == "--threads" || argument == "--chunk") && i + 1 < argc) {
+            (argument == "--threads" ? options.threads : options.chunkSize) = std::atoi(argv[++i]);
+        }
+        else if (argument == "--binary") {
+            options.binary = true;
+        }
+        else if (argument == "--restart") {
+            options.restart = true;
+        }
+        else if (argument == "--quiet") {
+            options.progress = false;
+        }
+        else {
+            std::cerr << "Error: Unknown batch option '" << argument << "'." << std::endl;
+            return false;
+        }
+    }
+
+    if (options.descriptors.empty()) {
+        for (int type = DOMINANT_COLOR_D; type <= CONTOUR_SHAPE_D; type++) {
+            BatchDescriptor descriptor;
+            descriptor.type = static_cast<DescriptorType>(type);
+            descriptor.name = std::string(descriptorName(descriptor.type)) + "_default";
+            options.descriptors.push_back(descriptor);
+        }
+    }
+    return true;
+}
+
+bool BatchCommand::readImageList(const std::string & input, std::vector<std::string> & images) {
+    if (FileSystem::isDirectory(input)) {
+        images = FileSystem::listImages(input);
+        return true;
+    }
+
+    std::ifstream manifest(input);
+
+    if (!manifest.is_open()) {
+        return false;
+    }
+
+    const std::string base = FileSystem::parent(input);
+    std::string line;
+
+    while (std::getline(manifest, line)) {
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t')) {
+            line.pop_back();
+        }
+
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        const bool absolute = line[0] == '/' || line[0] == '\\' || (line.size() > 1 && line[1] == ':');
+        images.push_back(absolute ? line : FileSystem::join(base, line));
+    }
+    return true;
+}
+
+std::string BatchCommand::escapeJSON(const std::string & text) {
+    std::string escaped;
+    escaped.reserve(text.size() + text.size() / 8);
+
+    for (const char c : text) {
+        switch (c) {
+            case '"':  escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n";  break;
+            case '\r': escaped += "\\r";  break;
+            case '\t': escaped += "\\t";  break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char code[8];
+                    snprintf(code, sizeof(code), "\\u%04x", c);
+                    escaped += code;
+                }
+                else {
+                    escaped += c;
+                }
+        }
+    }
+    return escaped;
+}
+
+unsigned long long BatchCommand::fingerprint(const BatchOptions & options, const std::vector<std::string> & images) {
+    // FNV-1a over everything that decides content and order of outputs
+    unsigned long long hash = 14695981039346656037ULL;
+
+    const auto add = [&hash](const std::string & text) {
+        for (const char c : text) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+        }
+        hash = (hash ^ 0xFF) * 1099511628211ULL;
+    };
+
+    add(options.binary ? "binary" : "xml");
+
+    for (const BatchDescriptor & descriptor : options.descriptors) {
+        add(descriptor.name);
+    }
+
+    for (const std::string & image : images) {
+        add(image);
+    }
+    return hash;
+}
+
+bool BatchCommand::readCheckpoint(const std::string & path, const unsigned long long fingerprint,
+                                  unsigned long & processed, std::vector<long long> & offsets) {
+    std::ifstream file(path);
+
+    int version = 0;
+    unsigned long long storedFingerprint = 0;
+    size_t count = 0;
+
+    if (!(file >> version >> storedFingerprint >> processed >> count) || version != BATCH_CHECKPOINT_VERSION || storedFingerprint != fingerprint) {
+        return false;
+    }
+
+    offsets.assign(count, 0);
+
+    for (size_t d = 0; d < count; d++) {
+        if (!(file >> offsets[d])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BatchCommand::writeCheckpoint(const std::string & path, const unsigned long long fingerprint,
+                                   const unsigned long processed, const std::vector<long long> & offsets) {
+    // Written next to the checkpoint and renamed, so an interrupted write never leaves broken checkpoint
+    const std::string temporaryPath = path + ".tmp";
+
+    {
+        std::ofstream file(temporaryPath, std::ios::trunc);
+
+        file << BATCH_CHECKPOINT_VERSION << "\n" << fingerprint << "\n" << processed << "\n" << offsets.size() << "\n";
+
+        for (const long long offset : offsets) {
+            file << offset << "\n";
+        }
+
+        file.flush();
+
+        if (!file) {
+            return false;
+        }
+    }
+
+#if defined(_WIN32) || defined(_WIN64)
+    std::remove(path.c_str());
+#endif
+    return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
@@ -0,0 +1,74 @@
+/** @file   BatchCommand.h
+ *  @brief  'batch' command of mpeg7_app - extraction of many descriptors
+ *          from a whole dataset in a single process.
+ *
+ *          Images are listed from a directory (recursively) or a manifest file
+ *          (one path per line, relative paths are relative to the manifest).
+ *          Every image is decoded once and all requested descriptors are
+ *          extracted from it on a pool of worker threads, each worker reusing
+ *          its own extractor objects. Results of every descriptor (type and parameter set)
+ *          go to a separate output file in the output directory:
+ *
+ *          - <NAME>_<params>.jsonl (default) - one JSON object per image:
+ *            {"image", "descriptor_id", "descriptor_name", "parameters", "xml" | "error"}
+ *          - <NAME>_<params>.bin (--binary) - one record per image:
+ *            u32 path length, path, s32 packet size (or negative ErrorCode), packet (see DescriptorBinary.h)
+ *
+ *          Images are processed in chunks. After a chunk is written, output sizes are stored
+ *          in 'batch.checkpoint', so an interrupted run started again with the same
+ *          arguments cuts outputs back to the checkpoint and continues from there.
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include "../DESCRIPTORS/DescriptorType.h"
+
+#include <string>
+#include <vector>
+
+#define BATCH_CHECKPOINT_FILE    "batch.checkpoint"
+#define BATCH_CHECKPOINT_VERSION 1
+#define BATCH_CHUNK_PER_THREAD   16 // images per worker between checkpoints
+
+struct BatchDescriptor {
+    DescriptorType type;
+    std::vector<std::string> params; // name, value, name, value...
+    std::string name;                // output file name (without extension)
+};
+
+struct BatchOptions {
+    std::string input;
+    std::string outputDirectory;
+    std::vector<BatchDescriptor> descriptors;
+    int threads    = 0;
+    int chunkSize  = 0;
+    bool binary    = false;
+    bool progress  = true;
+    bool restart   = false;
+};
+
+class BatchCommand {
+    public:
+        static void printUsage(const char * programName);
+
+        /** @brief
+        * Runs batch command
+        * @param argc, argv - program arguments, argv[1] is "batch"
+        * @return int - process exit code */
+        static int run(int argc, char * argv[]);
+
+    private:
+        static bool parseArguments(int argc, char * argv[], BatchOptions & options);
+        static bool readImageList(const std::string & input, std::vector<std::string> & images);
+
+        static std::string escapeJSON(const std::string & text);
+
+        static unsigned long long fingerprint(const BatchOptions & options, const std::vector<std::string> & images);
+
+        static bool readCheckpoint(const std::string & path, unsigned long long fingerprint,
+                                   unsigned long & processed, std::vector<long long> & offsets);
+        static bool writeCheckpoint(const std::string & path, unsigned long long fingerprint,
+                                    unsigned long processed, const std::vector<long long> & offsets);
+};
@@ -0,0 +1,1474 @@
+#include "ConformanceCommand.h"
+
+#include "../Mpeg7.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <tuple>
+
+namespace {
+    // Corpus sizes: single pixel, tiny, odd and regular images
+    const int corpusSizes[][2] = {
+        { 1, 1 }, { 2, 3 }, { 7, 5 }, { 16, 16 }, { 33, 77 }, { 65, 31 }, { 128, 128 }, { 161, 97 }
+    };
+
+    const char * layoutNames[] = { "", "gray", "gray_alpha", "rgb", "rgba" };
+
+    /* Default distance accepted between golden and extracted descriptor, when packets differ.
+       Integer pipelines and Dominant Color (clustering may converge to other centroids) must match
+       bit for bit, others may differ by about one quantization step of a single value. */
+    const double defaultTolerances[] = {
+        0.0,    // (none)
+        0.0,    // Dominant Color
+        0.0,    // Scalable Color
+        2.0,    // Color Layout - one step of one weighted coefficient
+        0.0,    // Color Structure
+        0.0,    // CT Browsing
+        0.005,  // Homogeneous Texture
+        1.0,    // Texture Browsing - one step of one component
+        0.0,    // Edge Histogram
+        0.01,   // Region Shape
+        0.3     // Contour Shape - one step of one peak coordinate
+    };
+
+    unsigned int crcTable[256];
+
+    void initCRC() {
+        for (unsigned int n = 0; n < 256; n++) {
+            unsigned int c = n;
+
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            crcTable[n] = c;
+        }
+    }
+
+    unsigned int crc(const unsigned char * data, const size_t size) {
+        unsigned int c = 0xFFFFFFFFu;
+
+        for (size_t i = 0; i < size; i++) {
+            c = crcTable[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+        }
+        return c ^ 0xFFFFFFFFu;
+    }
+
+    void appendUInt32BE(std::vector<unsigned char> & buffer, const unsigned int value) {
+        buffer.push_back(static_cast<unsigned char>(value >> 24));
+        buffer.push_back(static_cast<unsigned char>(value >> 16));
+        buffer.push_back(static_cast<unsigned char>(value >> 8));
+        buffer.push_back(static_cast<unsigned char>(value));
+    }
+
+    void appendUInt32LE(std::vector<unsigned char> & buffer, const unsigned int value) {
+        buffer.push_back(static_cast<unsigned char>(value));
+        buffer.push_back(static_cast<unsigned char>(value >> 8));
+        buffer.push_back(static_cast<unsigned char>(value >> 16));
+        buffer.push_back(static_cast<unsigned char>(value >> 24));
+    }
+
+    unsigned int readUInt32LE(const unsigned char * buffer) {
+        return static_cast<unsigned int>(buffer[0]) | static_cast<unsigned int>(buffer[1]) << 8 |
+               static_cast<unsigned int>(buffer[2]) << 16 | static_cast<unsigned int>(buffer[3]) << 24;
+    }
+
+    void appendChunk(std::vector<unsigned char> & png, const char * type, const std::vector<unsigned char> & data) {
+        appendUInt32BE(png, static_cast<unsigned int>(data.size()));
+
+        const size_t start = png.size();
+        png.insert(png.end(), type, type + 4);
+        png.insert(png.end(), data.begin(), data.end());
+
+        appendUInt32BE(png, crc(&png[start], png.size() - start));
+    }
+
+    /** Descriptor decoded from packet, nullptr when packet is not valid */
+    Descriptor * decode(const std::vector<unsigned char> & packet) {
+        try {
+            const DescriptorType type = DescriptorBinary::readHeader(packet.data(), packet.size());
+            Descriptor * descriptor = createDescriptor(type);
+
+            try {
+                descriptor->readFromBinary(packet.data() + DESCRIPTOR_BINARY_HEADER_SIZE, packet.size() - DESCRIPTOR_BINARY_HEADER_SIZE);
+            }
+            catch (ErrorCode exception) {
+                delete descriptor;
+                return nullptr;
+            }
+            return descriptor;
+        }
+        catch (ErrorCode exception) {
+            return nullptr;
+        }
+    }
+
+    std::string recordKey(const ConformanceRecord & record) {
+        return record.image + "/" + descriptorName(record.type);
+    }
+
+    /** Largest relative error seen by accelerated path (largest distance for paths approximating reference) */
+    struct AcceleratedResult {
+        unsigned long distances = 0;
+        unsigned long failed = 0;
+        double maxError = 0.0;
+        bool approximate = false;
+
+        void add(const double accelerated, const double reference) {
+            const double error = std::fabs(accelerated - reference) / std::max(1.0, std::fabs(reference));
+
+            distances++;
+            maxError = std::max(maxError, error);
+
+            if (!(error <= CONFORMANCE_ACCELERATED_TOLERANCE)) {
+                failed++;
+            }
+        }
+
+        // Path approximating reference, distance of their descriptors is reported as error
+        void addDistance(const double distance, const double tolerance) {
+            approximate = true;
+            distances++;
+            maxError = std::max(maxError, distance);
+
+            if (!(distance <= tolerance)) {
+                failed++;
+            }
+        }
+    };
+
+    /** Synthetic RGBA scene of corpus: textured star on noisy background, partly transparent */
+    std::vector<unsigned char> renderScene(const int width, const int height) {
+        std::vector<unsigned char> rgba(static_cast<size_t>(width) * height * 4);
+
+        const double cx = width / 2.0;
+        const double cy = height / 2.0;
+        const double radius = 0.45 * std::min(width, height);
+
+        unsigned int seed = 12345;
+
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                unsigned char * pixel = &rgba[(static_cast<size_t>(y) * width + x) * 4];
+
+                seed = seed * 1103515245u + 12345u;
+                const int noise = static_cast<int>((seed >> 16) & 0x1F);
+
+                // No transcendental functions, so the scene is the same on every platform
+                const double dx = x + 0.5 - cx;
+                const double dy = y + 0.5 - cy;
+                const bool inside = std::fabs(dx) + std::fabs(dy) < radius || (std::fabs(dx) < radius / 3 && std::fabs(dy) < radius);
+
+                if (inside) {
+                    const bool checker = ((x / 4) + (y / 4)) % 2 == 0;
+                    pixel[0] = static_cast<unsigned char>(std::min(255, 128 + (x * 127) / width + noise));
+                    pixel[1] = static_cast<unsigned char>(checker ? 220 : 90 + noise);
+                    pixel[2] = static_cast<unsigned char>(std::min(255, 40 + ((x + 2 * y) % 16) * 12 + noise));
+                    pixel[3] = 255;
+                }
+                else {
+                    pixel[0] = static_cast<unsigned char>(noise / 2);
+                    pixel[1] = static_cast<unsigned char>(20 + (y * 60) / height);
+                    pixel[2] = static_cast<unsigned char>(noise);
+                    pixel[3] = static_cast<unsigned char>(((x + y) * 255) / (width + height));
+                }
+            }
+        }
+        return rgba;
+    }
+
+    const char * kernelName() {
+#if defined(__SSE__) || defined(_M_X64)
+        return "sse";
+#else
+        return "scalar";
+#endif
+    }
+}
+
+void ConformanceCommand::printUsage(const char * programName) {
+    std::cout << "  Conformance check:  " << programName << " conformance [--golden <file>] [--update] [--tolerance <descriptor_type> <distance>] [--verbose]" << std::endl;
+    std::cout << "Conformance options:" << std::endl;
+    std::cout << "  --golden <file>     golden descriptors (default: resources/" << CONFORMANCE_GOLDEN_FILE << ")" << std::endl;
+    std::cout << "  --update            write current results as new golden descriptors" << std::endl;
+    std::cout << "  --tolerance         largest distance to golden descriptor accepted for descriptor type, may be repeated" << std::endl;
+    std::cout << "  --verbose           report every image, not only failures" << std::endl;
+}
+
+int ConformanceCommand::run(const int argc, char * argv[]) {
+    ConformanceOptions options;
+
+    if (!parseArguments(argc, argv, options)) {
+        return 1;
+    }
+
+    std::vector<ConformanceImage> images = corpus();
+    const std::vector<ConformanceRecord> records = extractAll(images);
+
+    if (options.update) {
+        if (!writeGolden(options.golden, records)) {
+            std::cerr << "Error: Could not write golden file " << options.golden << std::endl;
+            return 1;
+        }
+        std::cout << "Written " << records.size() << " golden descriptors of " << images.size() << " images to " << options.golden << std::endl;
+        return 0;
+    }
+
+    std::vector<ConformanceRecord> golden;
+
+    if (!readGolden(options.golden, golden)) {
+        std::cerr << "Error: Could not read golden file " << options.golden << std::endl;
+        return 1;
+    }
+
+    const bool goldenPassed      = compareGolden(golden, records, options);
+    const bool acceleratedPassed = compareAccelerated(images, records, options);
+
+    const bool passed = goldenPassed && acceleratedPassed;
+    std::cout << (passed ? "Conformance passed." : "Conformance FAILED.") << std::endl;
+    return passed ? 0 : 2;
+}
+
+std::vector<ConformanceImage> ConformanceCommand::corpus() {
+    std::vector<ConformanceImage> images;
+
+    for (const auto & size : corpusSizes) {
+        const int width  = size[0];
+        const int height = size[1];
+
+        // One RGBA scene per size, other layouts are derived from it
+        const std::vector<unsigned char> rgba = renderScene(width, height);
+
+        for (int channels = 1; channels <= 4; channels++) {
+            std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * channels);
+
+            for (size_t i = 0; i < static_cast<size_t>(width) * height; i++) {
+                const unsigned char * source = &rgba[i * 4];
+                unsigned char * target = &pixels[i * channels];
+
+                if (channels <= 2) {
+                    target[0] = static_cast<unsigned char>((77 * source[0] + 150 * source[1] + 29 * source[2]) >> 8);
+                }
+                else {
+                    target[0] = source[0];
+                    target[1] = source[1];
+                    target[2] = source[2];
+                }
+
+                if (channels == 2 || channels == 4) {
+                    target[channels - 1] = source[3];
+                }
+            }
+
+            ConformanceImage image;
+            image.name = std::string(layoutNames[channels]) + "_" + std::to_string(width) + "x" + std::to_string(height);
+            image.data = encodePNG(pixels.data(), width, height, channels);
+            images.push_back(image);
+        }
+    }
+    return images;
+}
+
+std::vector<unsigned char> ConformanceCommand::encodePNG(const unsigned char * pixels, const int width, const int height, const int channels) {
+    static const unsigned char signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    static const unsigned char colorTypes[] = { 0, 0, 4, 2, 6 };
+
+    if (crcTable[1] == 0) {
+        initCRC();
+    }
+
+    std::vector<unsigned char> png(signature, signature + sizeof(signature));
+
+    std::vector<unsigned char> header;
+    appendUInt32BE(header, static_cast<unsigned int>(width));
+    appendUInt32BE(header, static_cast<unsigned int>(height));
+    header.push_back(8);                     // bit depth
+    header.push_back(colorTypes[channels]);
+    header.push_back(0);                     // compression
+    header.push_back(0);                     // filter
+    header.push_back(0);                     // interlace
+    appendChunk(png, "IHDR", header);
+
+    // Scanlines with filter type 0, in stored deflate blocks of zlib stream
+    const size_t rowSize = static_cast<size_t>(width) * channels;
+    std::vector<unsigned char> raw;
+
+    for (int y = 0; y < height; y++) {
+        raw.push_back(0);
+        raw.insert(raw.end(), pixels + y * rowSize, pixels + (y + 1) * rowSize);
+    }
+
+    std::vector<unsigned char> stream = { 0x78, 0x01 };
+
+    for (size_t offset = 0; offset < raw.size(); offset += 65535) {
+        const size_t length = std::min<size_t>(65535, raw.size() - offset);
+
+        stream.push_back(offset + length == raw.size() ? 1 : 0);
+        stream.push_back(static_cast<unsigned char>(length));
+        stream.push_back(static_cast<unsigned char>(length >> 8));
+        stream.push_back(static_cast<unsigned char>(~length));
+        stream.push_back(static_cast<unsigned char>(~length >> 8));
+        stream.insert(stream.end(), raw.begin() + offset, raw.begin() + offset + length);
+    }
+
+    unsigned int a = 1, b = 0;
+
+    for (const unsigned char value : raw) {
+        a = (a + value) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendUInt32BE(stream, (b << 16) | a);
+
+    appendChunk(png, "IDAT", stream);
+    appendChunk(png, "IEND", std::vector<unsigned char>());
+    return png;
+}
+
+std::vector<unsigned char> ConformanceCommand::encodeYUV(const unsigned char * rgb, const int width, const int height, const PixelFormat format) {
+    const int stride = (width + 1) & ~1;
+    const int chromaWidth  = (width + 1) / 2;
+    const int chromaHeight = (height + 1) / 2;
+
+    // Y plane, then chroma rows of the same stride (I420: U and V planes of half stride)
+    std::vector<unsigned char> frame(static_cast<size_t>(stride) * height + static_cast<size_t>(stride) * chromaHeight);
+    unsigned char * chroma = frame.data() + static_cast<size_t>(stride) * height;
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const unsigned char * pixel = rgb + (static_cast<size_t>(y) * width + x) * 3;
+            frame[static_cast<size_t>(y) * stride + x] = static_cast<unsigned char>(((66 * pixel[0] + 129 * pixel[1] + 25 * pixel[2] + 128) >> 8) + 16);
+        }
+    }
+
+    for (int cy = 0; cy < chromaHeight; cy++) {
+        for (int cx = 0; cx < chromaWidth; cx++) {
+            int r = 0, g = 0, b = 0, count = 0;
+
+            for (int y = 2 * cy; y < std::min(2 * cy + 2, height); y++) {
+                for (int x = 2 * cx; x < std::min(2 * cx + 2, width); x++) {
+                    const unsigned char * pixel = rgb + (static_cast<size_t>(y) * width + x) * 3;
+                    r += pixel[0];
+                    g += pixel[1];
+                    b += pixel[2];
+                    count++;
+                }
+            }
+            r /= count;
+            g /= count;
+            b /= count;
+
+            const unsigned char u = static_cast<unsigned char>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            const unsigned char v = static_cast<unsigned char>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+
+            if (format == PIXEL_I420) {
+                chroma[static_cast<size_t>(cy) * (stride / 2) + cx] = u;
+                chroma[static_cast<size_t>(chromaHeight + cy) * (stride / 2) + cx] = v;
+            }
+            else {
+                chroma[static_cast<size_t>(cy) * stride + 2 * cx]     = format == PIXEL_NV21 ? v : u;
+                chroma[static_cast<size_t>(cy) * stride + 2 * cx + 1] = format == PIXEL_NV21 ? u : v;
+            }
+        }
+    }
+    return frame;
+}
+
+std::vector<ConformanceRecord> ConformanceCommand::extractAll(std::vector<ConformanceImage> & images) {
+    std::vector<ConformanceRecord> records;
+    const char * params[] = { nullptr };
+
+    unsigned char packet[DESCRIPTOR_BINARY_MAX_SIZE];
+
+    for (ConformanceImage & conformanceImage : images) {
+        Image image;
+        int loadError = 0;
+
+        try {
+            image.load(conformanceImage.data.data(), static_cast<int>(conformanceImage.data.size()), IMAGE_UNCHANGED);
+        }
+        catch (ErrorCode exception) {
+            loadError = -exception;
+        }
+
+        for (int type = DOMINANT_COLOR_D; type <= CONTOUR_SHAPE_D; type++) {
+            ConformanceRecord record;
+            record.type  = static_cast<DescriptorType>(type);
+            record.image = conformanceImage.name;
+            record.result = loadError != 0 ? loadError : binaryExtraction(record.type, image, params, packet, DESCRIPTOR_BINARY_MAX_SIZE);
+
+            if (record.result > 0) {
+                record.packet.assign(packet, packet + record.result);
+            }
+            records.push_back(record);
+        }
+    }
+
+    // YUV frames of RGB images, their records follow records of encoded images
+    const std::pair<PixelFormat, const char *> yuvLayouts[] = { { PIXEL_NV12, "nv12" }, { PIXEL_NV21, "nv21" }, { PIXEL_I420, "i420" } };
+
+    for (ConformanceImage & conformanceImage : images) {
+        Image image;
+
+        try {
+            image.load(conformanceImage.data.data(), static_cast<int>(conformanceImage.data.size()), IMAGE_UNCHANGED);
+        }
+        catch (ErrorCode exception) {
+            continue;
+        }
+
+        if (image.getChannels() != 3) {
+            continue;
+        }
+
+        const int width  = image.getWidth();
+        const int height = image.getHeight();
+
+        for (const auto & layout : yuvLayouts) {
+            const std::vector<unsigned char> frame = encodeYUV(image.getData(), width, height, layout.first);
+
+            for (int type = DOMINANT_COLOR_D; type <= CONTOUR_SHAPE_D; type++) {
+                ConformanceRecord record;
+                record.type  = static_cast<DescriptorType>(type);
+                record.image = layout.second + conformanceImage.name.substr(conformanceImage.name.find('_'));
+                record.result = extractDescriptorBinaryFromPixels(record.type, frame.data(), width, height, (width + 1) & ~1, layout.first,
+                                                                  params, packet, DESCRIPTOR_BINARY_MAX_SIZE);
+
+                if (record.result > 0) {
+                    record.packet.assign(packet, packet + record.result);
+                }
+                records.push_back(record);
+            }
+        }
+    }
+    return records;
+}
+
+bool ConformanceCommand::readGolden(const std::string & path, std::vector<ConformanceRecord> & records) {
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file.is_open()) {
+        return false;
+    }
+
+    const std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (data.size() < 12 || data[0] != 'M' || data[1] != '7' || data[2] != 'C' || data[3] != 'G' ||
+        readUInt32LE(&data[4]) != CONFORMANCE_GOLDEN_VERSION) {
+        return false;
+    }
+
+    const unsigned int count = readUInt32LE(&data[8]);
+    size_t offset = 12;
+
+    for (unsigned int i = 0; i < count; i++) {
+        if (offset + 2 > data.size()) {
+            return false;
+        }
+
+        ConformanceRecord record;
+        record.type = static_cast<DescriptorType>(data[offset]);
+
+        const size_t nameLength = data[offset + 1];
+        offset += 2;
+
+        if (offset + nameLength + 4 > data.size()) {
+            return false;
+        }
+        record.image.assign(data.begin() + offset, data.begin() + offset + nameLength);
+        offset += nameLength;
+
+        record.result = static_cast<int>(readUInt32LE(&data[offset]));
+        offset += 4;
+
+        if (record.result > 0) {
+            if (offset + record.result > data.size()) {
+                return false;
+            }
+            record.packet.assign(data.begin() + offset, data.begin() + offset + record.result);
+            offset += record.result;
+        }
+        records.push_back(record);
+    }
+    return offset == data.size();
+}
+
+bool ConformanceCommand::writeGolden(const std::string & path, const std::vector<ConformanceRecord> & records) {
+    std::vector<unsigned char> data = { 'M', '7', 'C', 'G' };
+    appendUInt32LE(data, CONFORMANCE_GOLDEN_VERSION);
+    appendUInt32LE(data, static_cast<unsigned int>(records.size()));
+
+    for (const ConformanceRecord & record : records) {
+        data.push_back(static_cast<unsigned char>(record.type));
+        data.push_back(static_cast<unsigned char>(record.image.size()));
+        data.insert(data.end(), record.image.begin(), record.image.end());
+        appendUInt32LE(data, static_cast<unsigned int>(record.result));
+        data.insert(data.end(), record.packet.begin(), record.packet.end());
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file);
+}
+
+bool ConformanceCommand::compareGolden(const std::vector<ConformanceRecord> & golden, const std::vector<ConformanceRecord> & records,
+                                       const ConformanceOptions & options) {
+    std::map<std::string, const ConformanceRecord *> goldenRecords;
+
+    for (const ConformanceRecord & record : golden) {
+        goldenRecords[recordKey(record)] = &record;
+    }
+
+    const char * params[] = { nullptr };
+
+    // exact, within tolerance, failed - per descriptor type
+    int counts[CONTOUR_SHAPE_D + 1][3] = {};
+    bool passed = true;
+
+    for (const ConformanceRecord & record : records) {
+        const auto found = goldenRecords.find(recordKey(record));
+        std::string failure;
+        int outcome = 0;
+
+        if (found == goldenRecords.end()) {
+            failure = "missing in golden file";
+        }
+        else if (found->second->result <= 0 || record.result <= 0) {
+            if (found->second->result != record.result) {
+                failure = "result " + std::to_string(record.result) + ", golden " + std::to_string(found->second->result);
+            }
+        }
+        else if (found->second->packet != record.packet) {
+            std::unique_ptr<Descriptor> expected(decode(found->second->packet));
+            std::unique_ptr<Descriptor> actual(decode(record.packet));
+
+            if (!expected || !actual) {
+                failure = "invalid packet";
+            }
+            else {
+                std::unique_ptr<DescriptorDistance> distance(createDistance(record.type));
+                double value = DBL_MAX;
+
+                try {
+                    value = distance->getDistance(expected.get(), actual.get(), params);
+                }
+                catch (ErrorCode exception) {
+                }
+
+                if (value <= tolerance(record.type, options)) {
+                    outcome = 1;
+
+                    if (options.verbose) {
+                        std::cout << "  " << recordKey(record) << ": within tolerance, distance " << value << std::endl;
+                    }
+                }
+                else {
+                    failure = "distance to golden " + std::to_string(value);
+                }
+            }
+        }
+
+        if (!failure.empty()) {
+            outcome = 2;
+            passed = false;
+            std::cout << "  FAILED " << recordKey(record) << ": " << failure << std::endl;
+        }
+        counts[record.type][outcome]++;
+    }
+
+    std::cout << "Golden descriptors (" << options.golden << "):" << std::endl;
+
+    for (int type = DOMINANT_COLOR_D; type <= CONTOUR_SHAPE_D; type++) {
+        char line[160];
+        snprintf(line, sizeof(line), "  %-20s %4d exact %4d within tolerance (%g) %4d failed",
+                 descriptorName(static_cast<DescriptorType>(type)), counts[type][0], counts[type][1],
+                 tolerance(static_cast<DescriptorType>(type), options), counts[type][2]);
+        std::cout << line << std::endl;
+    }
+
+    if (golden.size() != records.size()) {
+        std::cout << "  FAILED golden file has " << golden.size() << " descriptors, corpus " << records.size() << std::endl;
+        passed = false;
+    }
+    return passed;
+}
+
+bool ConformanceCommand::compareAccelerated(std::vector<ConformanceImage> & images, const std::vector<ConformanceRecord> & records,
+                                            const ConformanceOptions & options) {
+    std::vector<std::unique_ptr<Descriptor>> regionShapes, homogeneousTextures, colorStructures;
+
+    for (const ConformanceRecord & record : records) {
+        if (record.result <= 0) {
+            continue;
+        }
+
+        std::vector<std::unique_ptr<Descriptor>> * target = record.type == REGION_SHAPE_D        ? &regionShapes        :
+                                                            record.type == HOMOGENEOUS_TEXTURE_D ? &homogeneousTextures :
+                                                            record.type == COLOR_STRUCTURE_D     ? &colorStructures     : nullptr;
+        if (target != nullptr) {
+            Descriptor * descriptor = decode(record.packet);
+
+            if (descriptor != nullptr) {
+                target->emplace_back(descriptor);
+            }
+        }
+    }
+
+    std::vector<std::pair<std::string, AcceleratedResult>> results;
+    const char * noParams[] = { nullptr };
+
+    // Region Shape index - dequantized magnitudes, L1 kernel
+    {
+        RegionShapeIndex index;
+        RegionShapeDistance reference;
+        AcceleratedResult result;
+
+        for (const auto & descriptor : regionShapes) {
+            index.add(static_cast<RegionShape *>(descriptor.get()));
+        }
+
+        std::vector<float> distances(index.size());
+
+        for (const auto & query : regionShapes) {
+            index.getDistances(static_cast<RegionShape *>(query.get()), distances.data());
+
+            for (size_t i = 0; i < regionShapes.size(); i++) {
+                result.add(distances[i], reference.getDistance(query.get(), regionShapes[i].get(), noParams));
+            }
+        }
+        results.emplace_back("REGION_SHAPE index", result);
+    }
+
+    /* Homogeneous Texture index - every matching option, then default option (empty params) after "rs",
+       so option of previous query must not be kept by index */
+    {
+        HomogeneousTextureIndex index;
+
+        for (const auto & descriptor : homogeneousTextures) {
+            index.add(static_cast<HomogeneousTexture *>(descriptor.get()));
+        }
+
+        std::vector<float> distances(index.size());
+
+        for (const char * option : { "n", "r", "s", "rs", "default" }) {
+            const char * optionParams[] = { "option", option, nullptr };
+            const char ** params = strcmp(option, "default") == 0 ? noParams : optionParams;
+            HomogeneousTextureDistance reference;
+            AcceleratedResult result;
+
+            for (const auto & query : homogeneousTextures) {
+                index.getDistances(static_cast<HomogeneousTexture *>(query.get()), params, distances.data());
+
+                for (size_t i = 0; i < homogeneousTextures.size(); i++) {
+                    result.add(distances[i], reference.getDistance(query.get(), homogeneousTextures[i].get(), params));
+                }
+            }
+            results.emplace_back(std::string("HOMOGENEOUS_TEXTURE index (") + option + ")", result);
+        }
+    }
+
+    /* Extraction context distance - Homogeneous Texture packets compared with "rs" option and then with default option
+       (empty params) through one context, against getDistanceBinary of the same params */
+    {
+        ExtractionContext * context = nullptr;
+        AcceleratedResult result;
+
+        createExtractionContext(HOMOGENEOUS_TEXTURE_D, noParams, &context);
+
+        std::vector<const ConformanceRecord *> packets;
+
+        for (const ConformanceRecord & record : records) {
+            if (record.type == HOMOGENEOUS_TEXTURE_D && record.result > 0) {
+                packets.push_back(&record);
+            }
+        }
+
+        const char * rotationScale[] = { "option", "rs", nullptr };
+
+        for (const ConformanceRecord * first : packets) {
+            for (const ConformanceRecord * second : packets) {
+                for (const char ** params : { rotationScale, noParams }) {
+                    double contextDistance = 0.0, reference = 0.0;
+
+                    const int contextResult = getDistanceWithContext(context, first->packet.data(), first->result,
+                                                                     second->packet.data(), second->result, params, &contextDistance);
+                    const int referenceResult = getDistanceBinary(first->packet.data(), first->result,
+                                                                  second->packet.data(), second->result, params, &reference);
+
+                    result.add(contextResult, referenceResult);
+                    result.add(contextDistance, reference);
+                }
+            }
+        }
+
+        freeExtractionContext(context);
+        results.emplace_back("extraction context distance", result);
+    }
+
+    // Color Structure index - byte L1 kernel
+    if (!colorStructures.empty()) {
+        ColorStructureIndex index(static_cast<ColorStructure *>(colorStructures.front().get())->GetSize());
+        ColorStructureDistance reference;
+        AcceleratedResult result;
+
+        for (const auto & descriptor : colorStructures) {
+            index.add(static_cast<ColorStructure *>(descriptor.get()));
+        }
+
+        std::vector<float> distances(index.size());
+
+        for (const auto & query : colorStructures) {
+            index.getDistances(static_cast<ColorStructure *>(query.get()), distances.data());
+
+            for (size_t i = 0; i < colorStructures.size(); i++) {
+                result.add(distances[i], reference.getDistance(query.get(), colorStructures[i].get(), noParams));
+            }
+        }
+        results.emplace_back("COLOR_STRUCTURE index", result);
+    }
+
+    // Region Shape splatted ART - unquantized coefficient magnitudes of every image
+    {
+        std::unique_ptr<RegionShapeExtractor> direct(new RegionShapeExtractor());
+        std::unique_ptr<RegionShapeExtractor> splat(new RegionShapeExtractor());
+        AcceleratedResult result;
+
+        direct->setEngine(ART_ENGINE_DIRECT);
+        splat->setEngine(ART_ENGINE_SPLAT);
+
+        for (ConformanceImage & conformanceImage : images) {
+            Image image;
+
+            try {
+                image.load(conformanceImage.data.data(), static_cast<int>(conformanceImage.data.size()), IMAGE_UNCHANGED);
+                direct->extract(image, noParams);
+                splat->extract(image, noParams);
+            }
+            catch (ErrorCode exception) {
+                continue;
+            }
+
+            for (int p = 0; p < ART_ANGULAR; p++) {
+                for (int r = 0; r < ART_RADIAL; r++) {
+                    const double reference = direct->getMagnitude(p, r);
+                    const double accelerated = splat->getMagnitude(p, r);
+
+                    // Image without foreground has no magnitudes in both engines
+                    if (!(std::isnan(reference) && std::isnan(accelerated))) {
+                        result.add(accelerated, reference);
+                    }
+                }
+            }
+        }
+        results.emplace_back("REGION_SHAPE splat extraction", result);
+    }
+
+    // Homogeneous Texture polar table kernel - filtered projection of every image large enough for extraction
+    {
+        std::unique_ptr<HomogeneousTextureExtractor> direct(new HomogeneousTextureExtractor());
+        std::unique_ptr<HomogeneousTextureExtractor> table(new HomogeneousTextureExtractor());
+        AcceleratedResult result;
+
+        direct->setRadonEngine(HT_RADON_DIRECT);
+        table->setRadonEngine(HT_RADON_TABLE);
+
+        for (ConformanceImage & conformanceImage : images) {
+            Image image;
+
+            try {
+                image.load(conformanceImage.data.data(), static_cast<int>(conformanceImage.data.size()), IMAGE_UNCHANGED);
+                direct->extract(image, noParams);
+                table->extract(image, noParams);
+            }
+            catch (ErrorCode exception) {
+                continue;
+            }
+
+            for (int view = 0; view < Nview; view++) {
+                for (int ray = 0; ray < Nray; ray++) {
+                    result.add(table->getProjection(view, ray), direct->getProjection(view, ray));
+                }
+            }
+        }
+        results.emplace_back("HOMOGENEOUS_TEXTURE polar table", result);
+    }
+
+    /* Tiled extraction - packet bytes of every image read in bands of 7 rows.
+       Gray + alpha images are skipped, Image::getChannel_G gives their alpha instead of gray (kept for golden descriptors) */
+    {
+        AcceleratedResult result;
+
+        for (ConformanceImage & conformanceImage : images) {
+            Image image;
+
+            try {
+                image.load(conformanceImage.data.data(), static_cast<int>(conformanceImage.data.size()), IMAGE_UNCHANGED);
+            }
+            catch (ErrorCode exception) {
+                continue;
+            }
+
+            if (image.getChannels() == 2) {
+                continue;
+            }
+
+            ImageTileSource source(image, 7);
+
+            for (DescriptorType type : { SCALABLE_COLOR_D, COLOR_STRUCTURE_D, EDGE_HISTOGRAM_D, CT_BROWSING_D }) {
+                unsigned char reference[DESCRIPTOR_BINARY_MAX_SIZE];
+                unsigned char tiled[DESCRIPTOR_BINARY_MAX_SIZE];
+
+                const int referenceSize = binaryExtraction(type, image, noParams, reference, DESCRIPTOR_BINARY_MAX_SIZE);
+                const int tiledSize = binaryExtraction(type, source, noParams, tiled, DESCRIPTOR_BINARY_MAX_SIZE);
+
+                result.add(tiledSize, referenceSize);
+
+                for (int i = 0; i < std::min(referenceSize, tiledSize); i++) {
+                    result.add(tiled[i], reference[i]);
+                }
+            }
+        }
+        results.emplace_back("tiled extraction", result);
+    }
+
+    /* Descriptor grid - results and record bytes of every cell of 3 x 2 grid against extraction from cell cropped into own image.
+       Corpus images are too small for Homogeneous Texture (cells fail, their packets are zeroed), so the scene is also
+       rendered in 383 x 256 pixels: cells of first column are 127 pixels wide and fail, other cells are extracted */
+    {
+        const DescriptorType gridTypes[] = { EDGE_HISTOGRAM_D, COLOR_LAYOUT_D, SCALABLE_COLOR_D, HOMOGENEOUS_TEXTURE_D };
+        const char ** gridParams[] = { noParams, noParams, noParams, noParams };
+        const int typeCount = 4, columns = 3, rows = 2;
+        AcceleratedResult result;
+
+        std::vector<ConformanceImage> gridImages(images);
+        ConformanceImage large;
+        large.name = "rgba_383x256";
+        large.data = encodePNG(renderScene(383, 256).data(), 383, 256, 4);
+        gridImages.push_back(large);
+
+        for (ConformanceImage & conformanceImage : gridImages) {
+            Image image;
+
+            try {
+                image.load(conformanceImage.data.data(), static_cast<int>(conformanceImage.data.size()), IMAGE_UNCHANGED);
+            }
+            catch (ErrorCode exception) {
+                continue;
+            }
+
+            const int width    = image.getWidth();
+            const int height   = image.getHeight();
+            const int channels = image.getChannels();
+
+            if (width < columns || height < rows) {
+                continue;
+            }
+
+            // Cells cropped into own images, their packets
+            std::vector<std::vector<unsigned char>> references(columns * rows * typeCount);
+            int referenceSizes[columns * rows * typeCount];
+            int slotSizes[typeCount] = {};
+
+            for (int r = 0; r < rows; r++) {
+                for (int c = 0; c < columns; c++) {
+                    const int left = c * width / columns, right = (c + 1) * width / columns;
+                    const int top = r * height / rows, bottom = (r + 1) * height / rows;
+
+                    std::vector<unsigned char> pixels(static_cast<size_t>(right - left) * (bottom - top) * channels);
+
+                    for (int y = top; y < bottom; y++) {
+                        std::copy(image.getData() + (static_cast<size_t>(y) * width + left) * channels,
+                                  image.getData() + (static_cast<size_t>(y) * width + right) * channels,
+                                  pixels.begin() + static_cast<size_t>(y - top) * (right - left) * channels);
+                    }
+
+                    std::vector<unsigned char> png = encodePNG(pixels.data(), right - left, bottom - top, channels);
+                    Image cell;
+                    cell.load(png.data(), static_cast<int>(png.size()), IMAGE_UNCHANGED);
+
+                    for (int t = 0; t < typeCount; t++) {
+                        const int index = (r * columns + c) * typeCount + t;
+                        unsigned char packet[DESCRIPTOR_BINARY_MAX_SIZE];
+
+                        referenceSizes[index] = binaryExtraction(gridTypes[t], cell, noParams, packet, DESCRIPTOR_BINARY_MAX_SIZE);
+                        references[index].assign(packet, packet + std::max(referenceSizes[index], 0));
+                        slotSizes[t] = std::max(slotSizes[t], referenceSizes[index]);
+                    }
+                }
+            }
+
+            // Size of tensor is queried first
+            int gridResults[columns * rows * typeCount];
+            int needed = 0;
+            const int recordSize = slotSizes[0] + slotSizes[1] + slotSizes[2] + slotSizes[3];
+
+            result.add(gridExtraction(gridTypes, gridParams, typeCount, image, columns, rows, nullptr, 0, gridResults, &needed),
+                       -BINARY_BUFFER_TOO_SMALL);
+            result.add(needed, columns * rows * recordSize);
+
+            std::vector<unsigned char> grid(static_cast<size_t>(needed), 0xA5);
+            result.add(gridExtraction(gridTypes, gridParams, typeCount, image, columns, rows, grid.data(), needed, gridResults, nullptr),
+                       recordSize);
+
+            for (int cell = 0; cell < columns * rows; cell++) {
+                int offset = cell * recordSize;
+
+                for (int t = 0; t < typeCount; t++) {
+                    const int index = cell * typeCount + t;
+                    result.add(gridResults[index], referenceSizes[index]);
+
+                    // Packet of failed cell is zeroed
+                    for (int i = 0; i < slotSizes[t]; i++) {
+                        result.add(grid[offset + i], referenceSizes[index] > 0 ? references[index][i] : 0);
+                    }
+                    offset += slotSizes[t];
+                }
+            }
+        }
+        results.emplace_back("descriptor grid", result);
+    }
+
+    /* Shape descriptors of masks - opaque pixels of every RGBA corpus image as RLE in both pixel orders and as object
+       of label map (with second object, transparent pixels of left half), packet bytes against extraction from the same
+       mask encoded as gray image (object is dark for Region Shape, bright for Contour Shape) */
+    {
+        const DescriptorType shapeTypes[] = { REGION_SHAPE_D, CONTOUR_SHAPE_D };
+        const char ** shapeParams[] = { noParams, noParams };
+        AcceleratedResult result;
+
+        const auto comparePackets = [&result](const unsigned char * packet, const int size, const unsigned char * reference, const int referenceSize) {
+            result.add(size, referenceSize);
+
+            for (int i = 0; i < std::min(size, referenceSize); i++) {
+                result.add(packet[i], reference[i]);
+            }
+        };
+
+        for (ConformanceImage & conformanceImage : images) {
+            Image image;
+
+            try {
+                image.load(conformanceImage.data.data(), static_cast<int>(conformanceImage.data.size()), IMAGE_UNCHANGED);
+            }
+            catch (ErrorCode exception) {
+                continue;
+            }
+
+            if (image.getChannels() != 4) {
+                continue;
+            }
+
+            const int width  = image.getWidth();
+            const int height = image.getHeight();
+            const size_t size = static_cast<size_t>(width) * height;
+
+            std::unique_ptr<unsigned char[]> alpha(image.getChannel_A());
+            std::vector<unsigned short> labels(size);
+
+            for (size_t i = 0; i < size; i++) {
+                labels[i] = alpha[i] == 255 ? 1 : static_cast<int>(i % width) < width / 2 ? 2 : 0;
+            }
+
+            std::vector<unsigned char> labelPackets(2 * 2 * DESCRIPTOR_BINARY_MAX_SIZE);
+            int labelResults[4];
+
+            extractShapesBinaryFromLabels(shapeTypes, shapeParams, 2, width, height, labels.data(), 2, 1, labelPackets.data(), labelResults);
+
+            for (int label = 1; label <= 2; label++) {
+                std::vector<unsigned char> mask(size);
+
+                for (size_t i = 0; i < size; i++) {
+                    mask[i] = labels[i] == label ? 255 : 0;
+                }
+
+                // Missing object has no packet (0) in label map
+                if (std::find(mask.begin(), mask.end(), 255) == mask.end()) {
+                    continue;
+                }
+
+                Image maskImages[2];
+
+                for (int t = 0; t < 2; t++) {
+                    std::vector<unsigned char> gray(mask);
+
+                    if (shapeTypes[t] == REGION_SHAPE_D) {
+                        for (unsigned char & value : gray) {
+                            value = static_cast<unsigned char>(255 - value);
+                        }
+                    }
+
+                    std::vector<unsigned char> png = encodePNG(gray.data(), width, height, 1);
+                    maskImages[t].load(png.data(), static_cast<int>(png.size()), IMAGE_UNCHANGED);
+                }
+
+                // Counts of alternating background and foreground runs, starting with background
+                std::vector<unsigned int> counts[2];
+
+                for (int columnMajor = 0; columnMajor < 2; columnMajor++) {
+                    unsigned char previous = 0;
+                    counts[columnMajor].push_back(0);
+
+                    for (size_t i = 0; i < size; i++) {
+                        const size_t pixel = columnMajor ? (i % height) * width + i / height : i;
+
+                        if (mask[pixel] != previous) {
+                            counts[columnMajor].push_back(0);
+                            previous = mask[pixel];
+                        }
+                        counts[columnMajor].back()++;
+                    }
+                }
+
+                for (int t = 0; t < 2; t++) {
+                    unsigned char reference[DESCRIPTOR_BINARY_MAX_SIZE];
+                    unsigned char packet[DESCRIPTOR_BINARY_MAX_SIZE];
+
+                    const int referenceSize = binaryExtraction(shapeTypes[t], maskImages[t], noParams, reference, DESCRIPTOR_BINARY_MAX_SIZE);
+
+                    comparePackets(&labelPackets[((label - 1) * 2 + t) * DESCRIPTOR_BINARY_MAX_SIZE], labelResults[(label - 1) * 2 + t],
+                                   reference, referenceSize);
+
+                    if (label != 1) {
+                        continue;
+                    }
+
+                    for (int columnMajor = 0; columnMajor < 2; columnMajor++) {
+                        const int packetSize = extractShapeBinaryFromRLE(shapeTypes[t], width, height, counts[columnMajor].data(),
+                                                                         static_cast<int>(counts[columnMajor].size()), columnMajor,
+                                                                         noParams, packet, DESCRIPTOR_BINARY_MAX_SIZE);
+                        comparePackets(packet, packetSize, reference, referenceSize);
+                    }
+                }
+            }
+        }
+        results.emplace_back("shape masks (RLE, label map)", result);
+    }
+
+    /* Shape descriptors of polygons - object of corpus scene (diamond joined with vertical bar) as polygon, against
+       extraction from the same object rasterized into gray image. Pixels on polygon edges may differ and Contour Shape
+       takes polygon vertices instead of traced contour, so distance of descriptors has to stay within polygon tolerance */
+    {
+        AcceleratedResult result;
+
+        for (const auto & corpusSize : corpusSizes) {
+            const int width  = corpusSize[0];
+            const int height = corpusSize[1];
+
+            if (std::min(width, height) < 16) {
+                continue;
+            }
+
+            const double cx = width / 2.0;
+            const double cy = height / 2.0;
+            const double r  = 0.45 * std::min(width, height);
+
+            const double xy[] = { cx - r / 3, cy - r,         cx + r / 3, cy - r,         cx + r / 3, cy - 2 * r / 3, cx + r, cy,
+                                  cx + r / 3, cy + 2 * r / 3, cx + r / 3, cy + r,         cx - r / 3, cy + r,
+                                  cx - r / 3, cy + 2 * r / 3, cx - r,     cy,             cx - r / 3, cy - 2 * r / 3 };
+
+            for (DescriptorType type : { REGION_SHAPE_D, CONTOUR_SHAPE_D }) {
+                // Object is dark for Region Shape, bright for Contour Shape
+                const unsigned char object = type == REGION_SHAPE_D ? 0 : 255;
+                std::vector<unsigned char> gray(static_cast<size_t>(width) * height);
+
+                for (int y = 0; y < height; y++) {
+                    for (int x = 0; x < width; x++) {
+                        const double dx = x + 0.5 - cx;
+                        const double dy = y + 0.5 - cy;
+                        const bool inside = std::fabs(dx) + std::fabs(dy) < r || (std::fabs(dx) < r / 3 && std::fabs(dy) < r);
+
+                        gray[static_cast<size_t>(y) * width + x] = static_cast<unsigned char>(inside ? object : 255 - object);
+                    }
+                }
+
+                std::vector<unsigned char> png = encodePNG(gray.data(), width, height, 1);
+                Image image;
+                image.load(png.data(), static_cast<int>(png.size()), IMAGE_UNCHANGED);
+
+                unsigned char reference[DESCRIPTOR_BINARY_MAX_SIZE];
+                unsigned char packet[DESCRIPTOR_BINARY_MAX_SIZE];
+
+                const int referenceSize = binaryExtraction(type, image, noParams, reference, DESCRIPTOR_BINARY_MAX_SIZE);
+                const int packetSize = extractShapeBinaryFromPolygon(type, width, height, xy, 10, noParams, packet, DESCRIPTOR_BINARY_MAX_SIZE);
+
+                std::unique_ptr<Descriptor> expected(referenceSize > 0 ? decode(std::vector<unsigned char>(reference, reference + referenceSize)) : nullptr);
+                std::unique_ptr<Descriptor> actual(packetSize > 0 ? decode(std::vector<unsigned char>(packet, packet + packetSize)) : nullptr);
+
+                double value = DBL_MAX;
+
+                if (expected && actual) {
+                    std::unique_ptr<DescriptorDistance> distance(createDistance(type));
+                    value = distance->getDistance(expected.get(), actual.get(), noParams);
+                }
+
+                result.addDistance(value, type == REGION_SHAPE_D ? CONFORMANCE_POLYGON_REGION_SHAPE_TOLERANCE
+                                                                 : CONFORMANCE_POLYGON_CONTOUR_SHAPE_TOLERANCE);
+            }
+        }
+        results.emplace_back("shape polygons", result);
+    }
+
+    /* Stream session - every corpus image as frame (twice in a row), with threshold 0 every frame is extracted and packets
+       of every descriptor type are those of extraction from the same pixels */
+    {
+        const int typeCount = CONTOUR_SHAPE_D;
+        DescriptorType sessionTypes[typeCount];
+        const char ** sessionParams[typeCount];
+
+        for (int t = 0; t < typeCount; t++) {
+            sessionTypes[t] = static_cast<DescriptorType>(DOMINANT_COLOR_D + t);
+            sessionParams[t] = noParams;
+        }
+
+        AcceleratedResult result;
+        StreamSession * session = nullptr;
+
+        if (createStreamSession(sessionTypes, sessionParams, typeCount, 0.0, &session) != 0) {
+            result.add(1, 0);
+        }
+
+        std::vector<unsigned char> frameOutput(static_cast<size_t>(typeCount) * DESCRIPTOR_BINARY_MAX_SIZE);
+        int frameResults[typeCount];
+
+        for (ConformanceImage & conformanceImage : images) {
+            Image image;
+
+            try {
+                image.load(conformanceImage.data.data(), static_cast<int>(conformanceImage.data.size()), IMAGE_UNCHANGED);
+            }
+            catch (ErrorCode exception) {
+                continue;
+            }
+
+            const int width  = image.getWidth();
+            const int height = image.getHeight();
+            const int stride = width * image.getChannels();
+            const PixelFormat format = static_cast<PixelFormat>(image.getChannels());
+
+            for (int repeat = 0; repeat < 2 && session != nullptr; repeat++) {
+                result.add(extractFrameBinary(session, image.getData(), width, height, stride, format, frameOutput.data(), frameResults), 1);
+
+                for (int t = 0; t < typeCount; t++) {
+                    unsigned char reference[DESCRIPTOR_BINARY_MAX_SIZE];
+                    const int referenceSize = extractDescriptorBinaryFromPixels(sessionTypes[t], image.getData(), width, height, stride, format,
+                                                                                noParams, reference, DESCRIPTOR_BINARY_MAX_SIZE);
+                    const unsigned char * packet = frameOutput.data() + t * DESCRIPTOR_BINARY_MAX_SIZE;
+
+                    result.add(frameResults[t], referenceSize);
+
+                    for (int i = 0; i < std::min(frameResults[t], referenceSize); i++) {
+                        result.add(packet[i], reference[i]);
+                    }
+                }
+            }
+        }
+        freeStreamSession(session);
+        results.emplace_back("stream session (threshold 0)", result);
+    }
+
+    /* Stream session with threshold - for every RGB corpus image: image is extracted, image brighter by one level is skipped
+       (packets of image), inverted image is scene change, brighter image is extracted again (differs from inverted one).
+       Return codes and packets are checked against expected frame and extraction from its pixels */
+    {
+        const DescriptorType sessionTypes[] = { SCALABLE_COLOR_D, EDGE_HISTOGRAM_D };
+        const char ** sessionParams[] = { noParams, noParams };
+        const double threshold = 4.0;
+
+        AcceleratedResult result;
+        StreamSession * session = nullptr;
+
+        if (createStreamSession(sessionTypes, sessionParams, 2, threshold, &session) != 0) {
+            result.add(1, 0);
+        }
+
+        std::vector<unsigned char> frameOutput(2 * DESCRIPTOR_BINARY_MAX_SIZE);
+        int frameResults[2];
+
+        for (ConformanceImage & conformanceImage : images) {
+            Image image;
+
+            try {
+                image.load(conformanceImage.data.data(), static_cast<int>(conformanceImage.data.size()), IMAGE_UNCHANGED);
+            }
+            catch (ErrorCode exception) {
+                continue;
+            }
+
+            if (image.getChannels() != 3 || session == nullptr) {
+                continue;
+            }
+
+            const int width  = image.getWidth();
+            const int height = image.getHeight();
+            const size_t size = static_cast<size_t>(width) * height * 3;
+
+            std::vector<unsigned char> brighter(image.getData(), image.getData() + size);
+            std::vector<unsigned char> inverted(image.getData(), image.getData() + size);
+
+            for (size_t i = 0; i < size; i++) {
+                brighter[i] = static_cast<unsigned char>(std::min(brighter[i] + 1, 255));
+                inverted[i] = static_cast<unsigned char>(255 - inverted[i]);
+            }
+
+            // Frame passed to session, expected return code and frame whose packets are expected
+            const std::tuple<const unsigned char *, int, const unsigned char *> frames[] = {
+                std::make_tuple(image.getData(), 1, image.getData()),
+                std::make_tuple(brighter.data(), 0, image.getData()),
+                std::make_tuple(inverted.data(), 1, inverted.data()),
+                std::make_tuple(brighter.data(), 1, brighter.data())
+            };
+
+            for (const auto & frame : frames) {
+                result.add(extractFrameBinary(session, std::get<0>(frame), width, height, width * 3, PIXEL_RGB, frameOutput.data(), frameResults),
+                           std::get<1>(frame));
+
+                for (int t = 0; t < 2; t++) {
+                    unsigned char reference[DESCRIPTOR_BINARY_MAX_SIZE];
+                    const int referenceSize = extractDescriptorBinaryFromPixels(sessionTypes[t], std::get<2>(frame), width, height, width * 3,
+                                                                                PIXEL_RGB, noParams, reference, DESCRIPTOR_BINARY_MAX_SIZE);
+                    const unsigned char * packet = frameOutput.data() + t * DESCRIPTOR_BINARY_MAX_SIZE;
+
+                    result.add(frameResults[t], referenceSize);
+
+                    for (int i = 0; i < std::min(frameResults[t], referenceSize); i++) {
+                        result.add(packet[i], reference[i]);
+                    }
+                }
+            }
+        }
+        freeStreamSession(session);
+        results.emplace_back("stream session (threshold, skip)", result);
+    }
+
+    /* Frame groups - for every RGB corpus image, groups of three identical frames, of image and inverted image, and of image,
+       inverted image and image with rotated channels, with every aggregation. Packet of group against descriptor of histograms
+       of its frames aggregated here (mean, median of sorted bins, minimum). Group without frames (new one and the next shot
+       after extraction) gives GROUP_EMPTY */
+    {
+        AcceleratedResult result;
+        ScalableColorExtractor extractor;
+
+        for (GroupAggregation aggregation : { GROUP_AVERAGE, GROUP_MEDIAN, GROUP_INTERSECTION }) {
+            FrameGroup * group = nullptr;
+
+            if (createFrameGroup(noParams, aggregation, &group) != 0) {
+                result.add(1, 0);
+                continue;
+            }
+
+            unsigned char packet[DESCRIPTOR_BINARY_MAX_SIZE];
+            result.add(extractGroupBinary(group, packet, DESCRIPTOR_BINARY_MAX_SIZE), -GROUP_EMPTY);
+
+            for (ConformanceImage & conformanceImage : images) {
+                Image image;
+
+                try {
+                    image.load(conformanceImage.data.data(), static_cast<int>(conformanceImage.data.size()), IMAGE_UNCHANGED);
+                }
+                catch (ErrorCode exception) {
+                    continue;
+                }
+
+                if (image.getChannels() != 3) {
+                    continue;
+                }
+
+                const int width  = image.getWidth();
+                const int height = image.getHeight();
+                const size_t size = static_cast<size_t>(width) * height * 3;
+
+                std::vector<unsigned char> inverted(image.getData(), image.getData() + size);
+                std::vector<unsigned char> rotated(size);
+
+                for (size_t i = 0; i < size; i++) {
+                    inverted[i] = static_cast<unsigned char>(255 - inverted[i]);
+                    rotated[i] = image.getData()[i - i % 3 + (i + 1) % 3];
+                }
+
+                const std::vector<std::vector<const unsigned char *>> groups = {
+                    { image.getData(), image.getData(), image.getData() },
+                    { image.getData(), inverted.data() },
+                    { image.getData(), inverted.data(), rotated.data() }
+                };
+
+                for (const auto & frames : groups) {
+                    std::vector<std::vector<double>> binValues;
+
+                    for (const unsigned char * frame : frames) {
+                        addFrameToGroup(group, frame, width, height, width * 3, PIXEL_RGB);
+
+                        Image view;
+                        view.view(frame, width, height, width * 3, PIXEL_RGB);
+                        binValues.emplace_back(256);
+                        extractor.frameBinValues(view, binValues.back().data());
+                    }
+
+                    double aggregated[256];
+
+                    for (int i = 0; i < 256; i++) {
+                        std::vector<double> bin;
+                        double sum = 0.0;
+
+                        for (const auto & values : binValues) {
+                            bin.push_back(values[i]);
+                            sum += values[i];
+                        }
+                        std::sort(bin.begin(), bin.end());
+
+                        const size_t count = bin.size();
+                        aggregated[i] = aggregation == GROUP_AVERAGE ? sum / count :
+                                        aggregation == GROUP_MEDIAN  ? (count % 2 ? bin[count / 2] : (bin[count / 2 - 1] + bin[count / 2]) / 2.0) :
+                                                                       bin.front();
+                    }
+
+                    Descriptor * expected = extractor.extractBinValues(aggregated, noParams);
+                    std::vector<unsigned char> reference(expected->getBinarySize());
+                    expected->writeBinary(reference.data());
+
+                    const int packetSize = extractGroupBinary(group, packet, DESCRIPTOR_BINARY_MAX_SIZE);
+                    const int referenceSize = static_cast<int>(reference.size()) + DESCRIPTOR_BINARY_HEADER_SIZE;
+
+                    result.add(packetSize, referenceSize);
+
+                    for (int i = DESCRIPTOR_BINARY_HEADER_SIZE; i < std::min(packetSize, referenceSize); i++) {
+                        result.add(packet[i], reference[i - DESCRIPTOR_BINARY_HEADER_SIZE]);
+                    }
+                }
+            }
+
+            result.add(extractGroupBinary(group, packet, DESCRIPTOR_BINARY_MAX_SIZE), -GROUP_EMPTY);
+            freeFrameGroup(group);
+        }
+        results.emplace_back("frame groups (aggregation, empty)", result);
+    }
+
+    /* Views of pixels - every corpus image in its own layout (RGB and RGBA also swapped to BGR and BGRA), rows padded
+       to longer stride, packet bytes of every descriptor type against extraction from decoded image */
+    {
+        AcceleratedResult result;
+
+        for (ConformanceImage & conformanceImage : images) {
+            Image image;
+
+            try {
+                image.load(conformanceImage.data.data(), static_cast<int>(conformanceImage.data.size()), IMAGE_UNCHANGED);
+            }
+            catch (ErrorCode exception) {
+                continue;
+            }
+
+            const int width    = image.getWidth();
+            const int height   = image.getHeight();
+            const int channels = image.getChannels();
+            const int stride   = width * channels + 5;
+
+            std::vector<PixelFormat> formats = { static_cast<PixelFormat>(channels) };
+
+            if (channels >= 3) {
+                formats.push_back(channels == 3 ? PIXEL_BGR : PIXEL_BGRA);
+            }
+
+            for (int type = DOMINANT_COLOR_D; type <= CONTOUR_SHAPE_D; type++) {
+                unsigned char reference[DESCRIPTOR_BINARY_MAX_SIZE];
+                const int referenceSize = binaryExtraction(static_cast<DescriptorType>(type), image, noParams, reference, DESCRIPTOR_BINARY_MAX_SIZE);
+
+                for (PixelFormat format : formats) {
+                    // Padding bytes must not be read
+                    std::vector<unsigned char> pixels(static_cast<size_t>(stride) * height, 0xA5);
+
+                    for (int y = 0; y < height; y++) {
+                        const unsigned char * source = image.getData() + static_cast<size_t>(y) * width * channels;
+                        unsigned char * target = &pixels[static_cast<size_t>(y) * stride];
+
+                        for (int i = 0; i < width * channels; i += channels) {
+                            std::copy(source + i, source + i + channels, target + i);
+
+                            if (format == PIXEL_BGR || format == PIXEL_BGRA) {
+                                std::swap(target[i], target[i + 2]);
+                            }
+                        }
+                    }
+
+                    unsigned char packet[DESCRIPTOR_BINARY_MAX_SIZE];
+                    const int packetSize = extractDescriptorBinaryFromPixels(static_cast<DescriptorType>(type), pixels.data(), width, height, stride,
+                                                                             format, noParams, packet, DESCRIPTOR_BINARY_MAX_SIZE);
+
+                    result.add(packetSize, referenceSize);
+
+                    for (int i = 0; i < std::min(packetSize, referenceSize); i++) {
+                        result.add(packet[i], reference[i]);
+                    }
+                }
+            }
+        }
+        results.emplace_back("pixel views (padded, BGR)", result);
+    }
+
+    std::cout << "Accelerated paths against reference (" << kernelName() << " kernels):" << std::endl;
+    bool passed = true;
+
+    for (const auto & entry : results) {
+        char line[160];
+        snprintf(line, sizeof(line), "  %-36s %7lu values  %-18s %.3g  %s", entry.first.c_str(), entry.second.distances,
+                 entry.second.approximate ? "max distance" : "max relative error", entry.second.maxError, entry.second.failed == 0 ? "ok" : "FAILED");
+        std::cout << line << std::endl;
+
+        if (entry.second.failed != 0) {
+            passed = false;
+        }
+    }
+
+    if (options.verbose) {
+        std::cout << "  compared descriptors: " << regionShapes.size() << " REGION_SHAPE, " << homogeneousTextures.size()
+                  << " HOMOGENEOUS_TEXTURE, " << colorStructures.size() << " COLOR_STRUCTURE" << std::endl;
+    }
+    return passed;
+}
+
+double ConformanceCommand::tolerance(const DescriptorType type, const ConformanceOptions & options) {
+    const auto found = options.tolerances.find(type);
+
+    if (found != options.tolerances.end()) {
+        return found->second;
+    }
+
+    return defaultTolerances[type];
+}
+
+bool ConformanceCommand::parseArguments(const int argc, char * argv[], ConformanceOptions & options) {
+#ifdef MPEG7_RESOURCES_DIR
+    options.golden = std::string(MPEG7_RESOURCES_DIR) + "/" + CONFORMANCE_GOLDEN_FILE;
+#else
+    options.golden = std::string("resources/") + CONFORMANCE_GOLDEN_FILE;
+#endif
+
+    for (int i = 2; i < argc; i++) {
+        const std::string argument = argv[i];
+
+        if (argument == "--golden" && i + 1 < argc) {
+            options.golden = argv[++i];
+        }
+        else if (argument == "--tolerance" && i + 2 < argc) {
+            const int type = std::atoi(argv[++i]);
+
+            if (type < DOMINANT_COLOR_D || type > CONTOUR_SHAPE_D) {
+                std::cerr << "Error: Invalid descriptor type. Must be between 1 and 10." << std::endl;
+                return false;
+            }
+            options.tolerances[type] = std::atof(argv[++i]);
+        }
+        else if (argument == "--update") {
+            options.update = true;
+        }
+        else if (argument == "--verbose") {
+            options.verbose = true;
+        }
+        else {
+            std::cerr << "Error: Unknown conformance option '" << argument << "'." << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,118 @@
+/** @file   ConformanceCommand.h
+ *  @brief  'conformance' command of mpeg7_app - golden output regression check
+ *          guarding optimized extraction and matching code.
+ *
+ *          A deterministic corpus is generated in memory: one synthetic scene
+ *          (textured star on noisy background, partly transparent) rendered at
+ *          tiny, odd and regular sizes, in every pixel layout the loader accepts
+ *          (gray, gray + alpha, RGB, RGBA), each encoded as PNG. RGB images are also
+ *          converted to raw YUV 4:2:0 frames (NV12, NV21, I420), extracted through views
+ *          of pixels. All ten descriptors are extracted from every image with default
+ *          parameters and compared with binary packets (see DescriptorBinary.h) of the
+ *          committed golden file:
+ *
+ *          - equal packets (or equal ErrorCode) pass as exact,
+ *          - different packets pass when distance between golden and extracted descriptor
+ *            is not greater than per-descriptor tolerance (about one quantization step
+ *            of a single value for descriptors computed in floating point, see --tolerance).
+ *
+ *          Every accelerated matching path (search indexes with their SIMD kernels) is then
+ *          run on the extracted descriptors and compared with the reference DescriptorDistance,
+ *          accelerated extraction engines (Region Shape splatted ART, Homogeneous Texture polar table
+ *          kernel) are compared with the direct computation on every corpus image.
+ *
+ *          Golden file layout (multi-byte values little-endian):
+ *
+ *          Offset | Size | Value
+ *          ------ | ---- | ----------------------------------------
+ *          0      | 4    | 'M' '7' 'C' 'G'
+ *          4      | 4    | u32 CONFORMANCE_GOLDEN_VERSION
+ *          8      | 4    | u32 record count
+ *          12     | n    | records: u8 descriptor type, u8 image name length, image name,
+ *                 |      | s32 packet size (or negative ErrorCode), packet
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include "../DESCRIPTORS/DescriptorType.h"
+#include "../TOOLS/Image/Image.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#define CONFORMANCE_GOLDEN_FILE    "conformance.golden"
+#define CONFORMANCE_GOLDEN_VERSION 1
+
+// Largest relative error of accelerated distance against reference distance
+#define CONFORMANCE_ACCELERATED_TOLERANCE 1.0e-4
+
+/* Largest distance of shape descriptors of polygon against the same polygon rasterized into image. Region Shape differs
+ * by pixels on edges only, Contour Shape takes polygon vertices instead of traced pixel contour (about 0.25 on corpus,
+ * clearly different polygons, e.g. the corpus object and a rectangle or a triangle, are above 0.7) */
+#define CONFORMANCE_POLYGON_REGION_SHAPE_TOLERANCE  0.01
+#define CONFORMANCE_POLYGON_CONTOUR_SHAPE_TOLERANCE 0.4
+
+/** Generated corpus image */
+struct ConformanceImage {
+    std::string name;                  // layout and size, e.g. "rgba_33x77"
+    std::vector<unsigned char> data;   // encoded PNG
+};
+
+/** Result of one extraction: packet or negative ErrorCode */
+struct ConformanceRecord {
+    DescriptorType type;
+    std::string image;
+    int result = 0;                    // packet size or negative ErrorCode
+    std::vector<unsigned char> packet;
+};
+
+struct ConformanceOptions {
+    std::string golden;
+    bool update  = false;
+    bool verbose = false;
+    std::map<int, double> tolerances;  // descriptor type -> tolerance
+};
+
+class ConformanceCommand {
+    public:
+        static void printUsage(const char * programName);
+
+        /** @brief
+        * Runs conformance command
+        * @param argc, argv - program arguments, argv[1] is "conformance"
+        * @return int - process exit code (0 - all checks passed) */
+        static int run(int argc, char * argv[]);
+
+        /** @brief
+        * Generates conformance corpus (same images on every platform) */
+        static std::vector<ConformanceImage> corpus();
+
+        /** @brief
+        * Encodes 8-bit pixels as PNG with stored (uncompressed) deflate blocks
+        * @param channels - 1 (gray), 2 (gray + alpha), 3 (RGB) or 4 (RGBA) */
+        static std::vector<unsigned char> encodePNG(const unsigned char * pixels, int width, int height, int channels);
+
+        /** @brief
+        * Converts RGB pixels to contiguous YUV 4:2:0 frame (BT.601 limited range in 8-bit fixed point,
+        * chroma of 2 x 2 pixels averaged), stride of frame is width rounded up to even
+        * @param format - PIXEL_NV12, PIXEL_NV21 or PIXEL_I420 */
+        static std::vector<unsigned char> encodeYUV(const unsigned char * rgb, int width, int height, PixelFormat format);
+
+    private:
+        static bool parseArguments(int argc, char * argv[], ConformanceOptions & options);
+
+        static std::vector<ConformanceRecord> extractAll(std::vector<ConformanceImage> & images);
+
+        static bool readGolden(const std::string & path, std::vector<ConformanceRecord> & records);
+        static bool writeGolden(const std::string & path, const std::vector<ConformanceRecord> & records);
+
+        static bool compareGolden(const std::vector<ConformanceRecord> & golden, const std::vector<ConformanceRecord> & records,
+                                  const ConformanceOptions & options);
+        static bool compareAccelerated(std::vector<ConformanceImage> & images, const std::vector<ConformanceRecord> & records,
+                                       const ConformanceOptions & options);
+
+        static double tolerance(DescriptorType type, const ConformanceOptions & options);
+};
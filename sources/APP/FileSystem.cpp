@@ -0,0 +1,188 @@
+#include "FileSystem.h"
+
+#include <algorithm>
+#include <cctype>
+#include <sys/stat.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <windows.h>
+    #include <direct.h>
+    #include <fcntl.h>
+    #include <io.h>
+    #define PATH_SEPARATOR '\\'
+#else
+    #include <dirent.h>
+    #include <unistd.h>
+    #define PATH_SEPARATOR '/'
+#endif
+
+bool FileSystem::isDirectory(const std::string & path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && (info.st_mode & S_IFMT) == S_IFDIR;
+}
+
+bool FileSystem::exists(const std::string & path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0;
+}
+
+long long FileSystem::fileSize(const std::string & path) {
+    struct stat info;
+
+    if (stat(path.c_str(), &info) != 0) {
+        return -1;
+    }
+    return static_cast<long long>(info.st_size);
+}
+
+bool FileSystem::truncate(const std::string & path, const long long size) {
+#if defined(_WIN32) || defined(_WIN64)
+    int file = _open(path.c_str(), _O_RDWR | _O_BINARY);
+
+    if (file < 0) {
+        return false;
+    }
+
+    const bool result = _chsize_s(file, size) == 0;
+    _close(file);
+    return result;
+#else
+    return ::truncate(path.c_str(), static_cast<off_t>(size)) == 0;
+#endif
+}
+
+bool FileSystem::createDirectory(const std::string & path) {
+#if defined(_WIN32) || defined(_WIN64)
+    _mkdir(path.c_str());
+#else
+    mkdir(path.c_str(), 0755);
+#endif
+    return isDirectory(path);
+}
+
+std::string FileSystem::join(const std::string & directory, const std::string & name) {
+    if (directory.empty()) {
+        return name;
+    }
+
+    const char last = directory[directory.size() - 1];
+
+    if (last == '/' || last == '\\') {
+        return directory + name;
+    }
+    return directory + PATH_SEPARATOR + name;
+}
+
+std::string FileSystem::parent(const std::string & path) {
+    const size_t separator = path.find_last_of("/\\");
+
+    if (separator == std::string::npos) {
+        return "";
+    }
+    return path.substr(0, separator + 1);
+}
+
+bool FileSystem::isImageFile(const std::string & path) {
+    static const char * extensions[] = { ".jpg", ".jpeg", ".png", ".bmp", ".pgm", ".ppm", ".tga", ".gif", nullptr };
+
+    const size_t dot = path.find_last_of('.');
+
+    if (dot == std::string::npos) {
+        return false;
+    }
+
+    std::string extension = path.substr(dot);
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+
+    for (int i = 0; extensions[i] != nullptr; i++) {
+        if (extension == extensions[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void collectFiles(const std::string & directory, bool (* accept)(const std::string &, const std::string &),
+                         const std::string & extension, std::vector<std::string> & files) {
+#if defined(_WIN32) || defined(_WIN64)
+    WIN32_FIND_DATAA entry;
+    HANDLE handle = FindFirstFileA(FileSystem::join(directory, "*").c_str(), &entry);
+
+    if (handle == INVALID_HANDLE_VALUE) {
+        return;
+    }
+
+    do {
+        const std::string name = entry.cFileName;
+
+        if (name == "." || name == "..") {
+            continue;
+        }
+
+        const std::string path = FileSystem::join(directory, name);
+
+        if (entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            collectFiles(path, accept, extension, files);
+        }
+        else if (accept(name, extension)) {
+            files.push_back(path);
+        }
+    } while (FindNextFileA(handle, &entry));
+
+    FindClose(handle);
+#else
+    DIR * handle = opendir(directory.c_str());
+
+    if (handle == nullptr) {
+        return;
+    }
+
+    for (dirent * entry = readdir(handle); entry != nullptr; entry = readdir(handle)) {
+        const std::string name = entry->d_name;
+
+        if (name == "." || name == "..") {
+            continue;
+        }
+
+        const std::string path = FileSystem::join(directory, name);
+
+        if (FileSystem::isDirectory(path)) {
+            collectFiles(path, accept, extension, files);
+        }
+        else if (accept(name, extension)) {
+            files.push_back(path);
+        }
+    }
+
+    closedir(handle);
+#endif
+}
+
+static bool acceptImage(const std::string & name, const std::string &) {
+    return FileSystem::isImageFile(name);
+}
+
+static bool acceptExtension(const std::string & name, const std::string & extension) {
+    if (name.size() < extension.size()) {
+        return false;
+    }
+    return std::equal(extension.begin(), extension.end(), name.end() - extension.size(), [](const char a, const char b) {
+        return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+    });
+}
+
+std::vector<std::string> FileSystem::listImages(const std::string & directory) {
+    std::vector<std::string> images;
+    collectFiles(directory, acceptImage, "", images);
+    std::sort(images.begin(), images.end());
+    return images;
+}
+
+std::vector<std::string> FileSystem::listFiles(const std::string & directory, const std::string & extension) {
+    std::vector<std::string> files;
+    collectFiles(directory, acceptExtension, extension, files);
+    std::sort(files.begin(), files.end());
+    return files;
+}
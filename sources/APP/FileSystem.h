@@ -0,0 +1,53 @@
+/** @file   FileSystem.h
+ *  @brief  Small set of file system helpers used by mpeg7_app commands
+ *          (C++14 has no std::filesystem, so POSIX and Windows calls are wrapped here).
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+class FileSystem {
+    public:
+        static bool isDirectory(const std::string & path);
+        static bool exists(const std::string & path);
+
+        /** @brief
+        * @return long long - file size in bytes or -1, when file does not exist */
+        static long long fileSize(const std::string & path);
+
+        /** @brief
+        * Cuts file to given size (drops data written after last checkpoint)
+        * @return bool - true on success */
+        static bool truncate(const std::string & path, long long size);
+
+        /** @brief
+        * Creates directory, existing directory is not an error
+        * @return bool - true, when directory exists after the call */
+        static bool createDirectory(const std::string & path);
+
+        /** @brief
+        * Joins directory and file name with path separator */
+        static std::string join(const std::string & directory, const std::string & name);
+
+        /** @brief
+        * @return std::string - directory part of path ("" for bare file name) */
+        static std::string parent(const std::string & path);
+
+        /** @brief
+        * Recursively collects image files (by extension) from directory
+        * @return std::vector<std::string> - sorted paths, so order is the same between runs */
+        static std::vector<std::string> listImages(const std::string & directory);
+
+        /** @brief
+        * Recursively collects files with given extension (e.g. ".xml", case insensitive) from directory
+        * @return std::vector<std::string> - sorted paths */
+        static std::vector<std::string> listFiles(const std::string & directory, const std::string & extension);
+
+        /** @brief
+        * Checks file extension against formats decoded by the library */
+        static bool isImageFile(const std::string & path);
+};
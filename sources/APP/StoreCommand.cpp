@@ -0,0 +1,353 @@
+#include "StoreCommand.h"
+#include "FileSystem.h"
+
+#include "../Mpeg7.h"
+#include "../STORE/DescriptorStore.h"
+#include "../STORE/MappedFile.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+
+void StoreCommand::printUsage(const char * programName) {
+    std::cout << "  Descriptor store:   " << programName << " store convert <batch.jsonl | xml_dir | xml_file> <output.m7s>" << std::endl;
+    std::cout << "                        [--type <descriptor_type>] [--threads <n>]" << std::endl;
+    std::cout << "                      " << programName << " store info <store.m7s> [record_index ...]" << std::endl;
+}
+
+int StoreCommand::run(const int argc, char * argv[]) {
+    if (argc < 4) {
+        std::cerr << "Error: Not enough arguments for store command." << std::endl;
+        return 1;
+    }
+
+    const std::string command = argv[2];
+
+    if (command == "convert") {
+        return convert(argc, argv);
+    }
+
+    if (command == "info") {
+        return info(argc, argv);
+    }
+
+    std::cerr << "Error: Unknown store command '" << command << "'. Use 'convert' or 'info'." << std::endl;
+    return 1;
+}
+
+int StoreCommand::convert(const int argc, char * argv[]) {
+    if (argc < 5) {
+        std::cerr << "Error: Not enough arguments for store convert command." << std::endl;
+        return 1;
+    }
+
+    const std::string input = argv[3];
+    const std::string output = argv[4];
+    DescriptorType storeType = NONE;
+    int threads = 0;
+
+    for (int i = 5; i < argc; i++) {
+        const std::string argument = argv[i];
+
+        if (argument == "--type" && i + 1 < argc) {
+            const int type = std::atoi(argv[++i]);
+
+            if (type < DOMINANT_COLOR_D || type > CONTOUR_SHAPE_D) {
+                std::cerr << "Error: Invalid descriptor type. Must be between 1 and 10." << std::endl;
+                return 1;
+            }
+            storeType = static_cast<DescriptorType>(type);
+        }
+        else if (argument == "--threads" && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        }
+        else {
+            std::cerr << "Error: Unknown store option '" << argument << "'." << std::endl;
+            return 1;
+        }
+    }
+
+    DescriptorStoreWriter writer;
+    bool opened = false;
+    unsigned long long skipped = 0;
+
+    try {
+        const bool read = readSources(input, threads, [&](const std::string & key, const DescriptorXMLRecord & record) {
+            if (record.result < 0) {
+                std::cerr << "Warning: Skipping " << key << " (error " << -record.result << ")" << std::endl;
+                skipped++;
+                return;
+            }
+
+            if (storeType == NONE) {
+                storeType = record.type;
+            }
+
+            if (record.type != storeType) {
+                std::cerr << "Warning: Skipping " << key << " (" << descriptorName(record.type) << " in "
+                          << descriptorName(storeType) << " store)" << std::endl;
+                skipped++;
+                return;
+            }
+
+            if (!opened) {
+                writer.open(output.c_str(), storeType);
+                opened = true;
+            }
+
+            try {
+                writer.addRecord(record.record, static_cast<unsigned long>(record.result), key.c_str());
+            }
+            catch (ErrorCode exception) {
+                if (exception != STORE_RECORD_SIZE_ERROR) {
+                    throw;
+                }
+                std::cerr << "Warning: Skipping " << key << " (extracted with other parameters than first record)" << std::endl;
+                skipped++;
+            }
+        });
+
+        if (!read) {
+            std::cerr << "Error: Could not read descriptors from " << input << std::endl;
+            return 1;
+        }
+
+        if (!opened) {
+            if (storeType == NONE) {
+                std::cerr << "Error: No descriptors found in " << input << std::endl;
+                return 1;
+            }
+            // Only descriptors of other types were found, store is created empty
+            writer.open(output.c_str(), storeType);
+        }
+
+        const unsigned long long stored = writer.size();
+        writer.close();
+
+        DescriptorStoreReader reader;
+        reader.open(output.c_str());
+
+        std::cout << "Stored " << stored << " descriptors (" << descriptorName(storeType) << ", ";
+
+        if (reader.getRecordSize() > 0) {
+            std::cout << "fixed " << reader.getRecordSize() << " byte records";
+        }
+        else {
+            std::cout << "variable size records";
+        }
+        std::cout << "), skipped " << skipped << ", " << FileSystem::fileSize(output) << " bytes written to " << output << std::endl;
+    }
+    catch (ErrorCode exception) {
+        std::cerr << "Error: Could not write store " << output << " (error " << exception << ")" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int StoreCommand::info(const int argc, char * argv[]) {
+    const std::string path = argv[3];
+    DescriptorStoreReader reader;
+
+    try {
+        reader.open(path.c_str());
+    }
+    catch (ErrorCode exception) {
+        std::cerr << "Error: Could not open store " << path << " (error " << exception << ")" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Store:       " << path << std::endl;
+    std::cout << "Descriptor:  " << descriptorName(reader.getType()) << " (" << reader.getType() << ")" << std::endl;
+    std::cout << "Records:     " << reader.size() << std::endl;
+
+    if (reader.getRecordSize() > 0) {
+        std::cout << "Layout:      fixed, " << reader.getRecordSize() << " bytes per record" << std::endl;
+    }
+    else {
+        std::cout << "Layout:      variable, offset table" << std::endl;
+    }
+    std::cout << "File size:   " << FileSystem::fileSize(path) << " bytes" << std::endl;
+
+    for (int i = 4; i < argc; i++) {
+        const unsigned long long index = std::strtoull(argv[i], nullptr, 10);
+
+        try {
+            std::unique_ptr<Descriptor> descriptor(createDescriptor(reader.getType()));
+            reader.read(index, descriptor.get());
+
+            unsigned long length = 0;
+            const char * key = reader.key(index, length);
+
+            std::cout << "Record " << index << ": " << std::string(key, length) << std::endl;
+            std::cout << descriptor->generateXML() << std::endl;
+        }
+        catch (ErrorCode exception) {
+            std::cerr << "Error: Could not read record " << argv[i] << " (error " << exception << ")" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+bool StoreCommand::readSources(const std::string & input, const int threads,
+                               const std::function<void(const std::string & key, const DescriptorXMLRecord & record)> & callback) {
+    std::vector<std::string> files;
+
+    if (FileSystem::isDirectory(input)) {
+        files = FileSystem::listFiles(input, ".xml");
+    }
+    else if (input.size() >= 6 && input.compare(input.size() - 6, 6, ".jsonl") == 0) {
+        std::ifstream file(input, std::ios::binary);
+
+        if (!file.is_open()) {
+            return false;
+        }
+
+        std::string line;
+        std::string image;
+        std::string xml;
+        unsigned char record[DESCRIPTOR_BINARY_MAX_SIZE];
+
+        while (std::getline(file, line)) {
+            // Failed extractions have "error" code instead of "xml"
+            if (!jsonField(line, "xml", xml)) {
+                continue;
+            }
+
+            if (!jsonField(line, "image", image)) {
+                image.clear();
+            }
+
+            DescriptorXMLStream stream(xml.data(), xml.size());
+            DescriptorXMLRecord decoded;
+
+            try {
+                const long size = stream.next(record, decoded.type);
+                decoded.result = size < 0 ? -DESCRIPTOR_NODE_NOT_FOUND : static_cast<int>(size);
+            }
+            catch (ErrorCode exception) {
+                decoded.result = -static_cast<int>(exception);
+            }
+
+            decoded.offset = 0;
+            decoded.record = record;
+            callback(image, decoded);
+        }
+        return true;
+    }
+    else {
+        files.push_back(input);
+    }
+
+    for (const std::string & path : files) {
+        MappedFile file;
+
+        try {
+            file.open(path.c_str());
+        }
+        catch (ErrorCode exception) {
+            if (files.size() == 1 && path == input) {
+                return false;
+            }
+            std::cerr << "Warning: Could not open " << path << std::endl;
+            continue;
+        }
+
+        // Descriptors after the first one of a file are keyed by their position, e.g. "archive.xml#1"
+        unsigned long index = 0;
+
+        DescriptorXMLStream::forEach(reinterpret_cast<const char *>(file.data()), static_cast<size_t>(file.size()), threads,
+                                     [&](const DescriptorXMLRecord & record) {
+            callback(index == 0 ? path : path + "#" + std::to_string(index), record);
+            index++;
+        });
+    }
+    return true;
+}
+
+static int hexValue(const char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool StoreCommand::jsonField(const std::string & line, const char * name, std::string & value) {
+    const std::string pattern = std::string("\"") + name + "\":";
+    size_t position = line.find(pattern);
+
+    if (position == std::string::npos) {
+        return false;
+    }
+
+    position += pattern.size();
+
+    while (position < line.size() && line[position] == ' ') {
+        position++;
+    }
+
+    if (position >= line.size() || line[position] != '"') {
+        return false;
+    }
+
+    value.clear();
+
+    for (position++; position < line.size(); position++) {
+        const char c = line[position];
+
+        if (c == '"') {
+            return true;
+        }
+
+        if (c != '\\') {
+            value += c;
+            continue;
+        }
+
+        if (++position >= line.size()) {
+            return false;
+        }
+
+        switch (line[position]) {
+            case 'n': value += '\n'; break;
+            case 'r': value += '\r'; break;
+            case 't': value += '\t'; break;
+            case 'b': value += '\b'; break;
+            case 'f': value += '\f'; break;
+            case 'u': {
+                if (position + 4 >= line.size()) {
+                    return false;
+                }
+
+                unsigned int code = 0;
+
+                for (int i = 1; i <= 4; i++) {
+                    const int digit = hexValue(line[position + i]);
+
+                    if (digit < 0) {
+                        return false;
+                    }
+                    code = code * 16 + digit;
+                }
+                position += 4;
+
+                // UTF-8 encoding of code point (surrogate pairs do not appear in batch output)
+                if (code < 0x80) {
+                    value += static_cast<char>(code);
+                }
+                else if (code < 0x800) {
+                    value += static_cast<char>(0xC0 | (code >> 6));
+                    value += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else {
+                    value += static_cast<char>(0xE0 | (code >> 12));
+                    value += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    value += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default: value += line[position]; break;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,53 @@
+/** @file   StoreCommand.h
+ *  @brief  'store' command of mpeg7_app - conversion of extracted XML descriptors
+ *          into memory-mapped descriptor store (see DescriptorStore.h) and its inspection.
+ *
+ *          Input of conversion may be:
+ *
+ *          - .jsonl output of batch command (key of record = "image" field, lines with "error" are skipped),
+ *          - directory searched recursively for .xml files (key = file path),
+ *          - single .xml file.
+ *
+ *          XML files may hold many concatenated documents (key of n-th descriptor after the first is "path#n"),
+ *          they are memory mapped and decoded without DOM on worker threads (--threads).
+ *
+ *          A store holds descriptors of one type, which is taken from --type or the first descriptor read.
+ *          Descriptors of other type or with other record size (other extraction parameters) are skipped.
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include "../DESCRIPTORS/DescriptorType.h"
+#include "../STORE/DescriptorXMLStream.h"
+
+#include <functional>
+#include <string>
+
+class StoreCommand {
+    public:
+        static void printUsage(const char * programName);
+
+        /** @brief
+        * Runs store command
+        * @param argc, argv - program arguments, argv[1] is "store"
+        * @return int - process exit code */
+        static int run(int argc, char * argv[]);
+
+    private:
+        static int convert(int argc, char * argv[]);
+        static int info(int argc, char * argv[]);
+
+        /** @brief
+        * Decodes descriptors of batch .jsonl, .xml directory or .xml file (see DescriptorXMLStream)
+        * and passes them with their keys one by one to callback, in input order
+        * @return bool - false, when input could not be read */
+        static bool readSources(const std::string & input, int threads,
+                                const std::function<void(const std::string & key, const DescriptorXMLRecord & record)> & callback);
+
+        /** @brief
+        * Finds string field of single-line JSON object and unescapes it
+        * @return bool - false, when object has no such string field */
+        static bool jsonField(const std::string & line, const char * name, std::string & value);
+};
@@ -0,0 +1,247 @@
+#include "Benchmark.h"
+
+#include "../TOOLS/Image/Image.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <string>
+
+#ifdef MPEG7_JPEG_TURBO
+    #include <cstdio>
+    #include <cstdlib>
+    #include <jpeglib.h>
+#endif
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+BenchmarkImage BenchmarkImages::synthetic(const int width, const int height) {
+    std::vector<unsigned char> rgb(static_cast<size_t>(width) * height * 3);
+
+    const double cx = width / 2.0;
+    const double cy = height / 2.0;
+    const double radius = 0.45 * std::min(width, height);
+
+    unsigned int seed = 12345;
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            unsigned char * pixel = &rgb[(static_cast<size_t>(y) * width + x) * 3];
+
+            seed = seed * 1103515245u + 12345u;
+            const int noise = static_cast<int>((seed >> 16) & 0x1F);
+
+            const double dx = x - cx;
+            const double dy = y - cy;
+            const double angle = std::atan2(dy, dx);
+            const double distance = std::sqrt(dx * dx + dy * dy);
+
+            // Five armed star, its edge gets texture from checker and stripes
+            const bool inside = distance < radius * (0.6 + 0.4 * std::cos(5.0 * angle));
+
+            if (inside) {
+                const bool checker = ((x / 8) + (y / 8)) % 2 == 0;
+                pixel[0] = static_cast<unsigned char>(std::min(255, 128 + (x * 127) / width + noise));
+                pixel[1] = static_cast<unsigned char>(checker ? 220 : 90 + noise);
+                pixel[2] = static_cast<unsigned char>(std::min(255, 60 + static_cast<int>(100 * (1.0 + std::sin(x / 3.0 + y / 5.0))) / 2 + noise));
+            }
+            else {
+                pixel[0] = static_cast<unsigned char>(noise / 2);
+                pixel[1] = static_cast<unsigned char>(noise / 2);
+                pixel[2] = static_cast<unsigned char>(noise / 2);
+            }
+        }
+    }
+
+    BenchmarkImage image;
+    image.name   = "synthetic";
+    image.width  = width;
+    image.height = height;
+    image.data   = encodePPM(rgb.data(), width, height);
+    return image;
+}
+
+BenchmarkImage BenchmarkImages::resized(const std::string & path, const std::string & name, const int width, const int height) {
+    BenchmarkImage image;
+    image.name = name;
+
+    Image source;
+    source.load(path.c_str(), IMAGE_COLOR);
+
+    const int sourceWidth  = source.getWidth();
+    const int sourceHeight = source.getHeight();
+
+    if (sourceWidth == width && sourceHeight == height) {
+        std::ifstream file(path, std::ios::binary);
+        image.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        image.width  = width;
+        image.height = height;
+        return image;
+    }
+
+    const unsigned char * rgb = source.getRGB();
+    std::vector<unsigned char> output(static_cast<size_t>(width) * height * 3);
+
+    for (int y = 0; y < height; y++) {
+        const double sy = std::max(0.0, (y + 0.5) * sourceHeight / height - 0.5);
+        const int y0 = std::min(static_cast<int>(sy), sourceHeight - 1);
+        const int y1 = std::min(y0 + 1, sourceHeight - 1);
+        const double wy = sy - y0;
+
+        for (int x = 0; x < width; x++) {
+            const double sx = std::max(0.0, (x + 0.5) * sourceWidth / width - 0.5);
+            const int x0 = std::min(static_cast<int>(sx), sourceWidth - 1);
+            const int x1 = std::min(x0 + 1, sourceWidth - 1);
+            const double wx = sx - x0;
+
+            for (int c = 0; c < 3; c++) {
+                const double top    = rgb[(y0 * sourceWidth + x0) * 3 + c] * (1.0 - wx) + rgb[(y0 * sourceWidth + x1) * 3 + c] * wx;
+                const double bottom = rgb[(y1 * sourceWidth + x0) * 3 + c] * (1.0 - wx) + rgb[(y1 * sourceWidth + x1) * 3 + c] * wx;
+                output[(static_cast<size_t>(y) * width + x) * 3 + c] = static_cast<unsigned char>(top * (1.0 - wy) + bottom * wy + 0.5);
+            }
+        }
+    }
+
+    delete[] rgb;
+
+    image.width  = width;
+    image.height = height;
+    image.data   = encodePPM(output.data(), width, height);
+    return image;
+}
+
+std::vector<unsigned char> BenchmarkImages::encodePPM(const unsigned char * rgb, const int width, const int height) {
+    const std::string header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+
+    std::vector<unsigned char> data(header.begin(), header.end());
+    data.insert(data.end(), rgb, rgb + static_cast<size_t>(width) * height * 3);
+    return data;
+}
+
+#ifdef MPEG7_JPEG_TURBO
+BenchmarkImage BenchmarkImages::jpeg(const BenchmarkImage & image, const int quality) {
+    Image source;
+    source.load(const_cast<unsigned char *>(image.data.data()), static_cast<int>(image.data.size()), IMAGE_COLOR);
+
+    unsigned char * rgb = source.getRGB();
+    unsigned char * buffer = nullptr;
+    unsigned long size = 0;
+
+    jpeg_compress_struct info;
+    jpeg_error_mgr error;
+
+    info.err = jpeg_std_error(&error);
+    jpeg_create_compress(&info);
+    jpeg_mem_dest(&info, &buffer, &size);
+
+    info.image_width      = static_cast<JDIMENSION>(source.getWidth());
+    info.image_height     = static_cast<JDIMENSION>(source.getHeight());
+    info.input_components = 3;
+    info.in_color_space   = JCS_RGB;
+
+    jpeg_set_defaults(&info);
+    jpeg_set_quality(&info, quality, TRUE);
+    jpeg_start_compress(&info, TRUE);
+
+    while (info.next_scanline < info.image_height) {
+        JSAMPROW row = rgb + static_cast<size_t>(info.next_scanline) * info.image_width * 3;
+        jpeg_write_scanlines(&info, &row, 1);
+    }
+
+    jpeg_finish_compress(&info);
+    jpeg_destroy_compress(&info);
+
+    BenchmarkImage output;
+    output.name   = image.name + "-jpeg";
+    output.width  = image.width;
+    output.height = image.height;
+    output.data.assign(buffer, buffer + size);
+
+    free(buffer);
+    delete[] rgb;
+    return output;
+}
+#endif
+
+bool BenchmarkMemory::resetPeakRSS() {
+#if defined(__linux__)
+    // Writing 5 to clear_refs resets VmHWM (Linux 4.0+)
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+    clearRefs.flush();
+    return static_cast<bool>(clearRefs);
+#else
+    return false;
+#endif
+}
+
+long BenchmarkMemory::peakRSS() {
+#if defined(_WIN32) || defined(_WIN64)
+    PROCESS_MEMORY_COUNTERS counters;
+
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<long>(counters.PeakWorkingSetSize / 1024);
+    }
+    return -1;
+#else
+    #if defined(__linux__)
+        std::ifstream status("/proc/self/status");
+        std::string line;
+
+        while (std::getline(status, line)) {
+            if (line.compare(0, 6, "VmHWM:") == 0) {
+                return std::stol(line.substr(6));
+            }
+        }
+    #endif
+
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+    #if defined(__APPLE__)
+        return static_cast<long>(usage.ru_maxrss / 1024); // bytes on macOS
+    #else
+        return static_cast<long>(usage.ru_maxrss);
+    #endif
+#endif
+}
+
+BenchmarkStatistics BenchmarkStatisticsCalculator::summarize(std::vector<double> samples) {
+    BenchmarkStatistics statistics;
+
+    if (samples.empty()) {
+        return statistics;
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    double sum = 0.0;
+
+    for (const double sample : samples) {
+        sum += sample;
+    }
+
+    statistics.count = static_cast<int>(samples.size());
+    statistics.min   = samples.front();
+    statistics.max   = samples.back();
+    statistics.mean  = sum / samples.size();
+    statistics.p50   = percentile(samples, 0.50);
+    statistics.p90   = percentile(samples, 0.90);
+    statistics.p99   = percentile(samples, 0.99);
+    return statistics;
+}
+
+double BenchmarkStatisticsCalculator::percentile(const std::vector<double> & sorted, const double p) {
+    // Linear interpolation between closest ranks
+    const double rank = p * (sorted.size() - 1);
+    const size_t lower = static_cast<size_t>(rank);
+    const size_t upper = std::min(lower + 1, sorted.size() - 1);
+    return sorted[lower] + (rank - lower) * (sorted[upper] - sorted[lower]);
+}
@@ -0,0 +1,91 @@
+/** @file   Benchmark.h
+ *  @brief  Helpers of mpeg7_bench - benchmark images, timing statistics
+ *          and process memory measurement.
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/** Encoded image used as benchmark input (decoding is a measured stage too) */
+struct BenchmarkImage {
+    std::string name;                  // source name, e.g. "lenna" or "synthetic"
+    int width  = 0;
+    int height = 0;
+    std::vector<unsigned char> data;   // encoded file (PNG, JPEG, PPM...)
+};
+
+/** Summary of measured latencies, all values in milliseconds */
+struct BenchmarkStatistics {
+    int count   = 0;
+    double min  = 0.0;
+    double mean = 0.0;
+    double p50  = 0.0;
+    double p90  = 0.0;
+    double p99  = 0.0;
+    double max  = 0.0;
+};
+
+class BenchmarkImages {
+    public:
+        /** @brief
+        * Colour test card: gradients, checker texture and noise, with bright
+        * star shaped object on dark background, so shape descriptors find a region and contour
+        * @return BenchmarkImage - image encoded as binary PPM */
+        static BenchmarkImage synthetic(int width, int height);
+
+        /** @brief
+        * Reads image file and rescales it (bilinear) to given size
+        * @return BenchmarkImage - image encoded as binary PPM (original file, when size is unchanged) */
+        static BenchmarkImage resized(const std::string & path, const std::string & name, int width, int height);
+
+        /** @brief
+        * Encodes RGB pixels as binary PPM (P6) */
+        static std::vector<unsigned char> encodePPM(const unsigned char * rgb, int width, int height);
+
+#ifdef MPEG7_JPEG_TURBO
+        /** @brief
+        * The same image encoded as baseline JPEG (4:2:0 chroma), input of decoder benchmark
+        * @return BenchmarkImage - named after image with "-jpeg" suffix */
+        static BenchmarkImage jpeg(const BenchmarkImage & image, int quality);
+#endif
+};
+
+class BenchmarkClock {
+    private:
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        BenchmarkClock() : start(std::chrono::steady_clock::now()) {}
+
+        /** @brief
+        * @return double - milliseconds since construction */
+        double elapsed() const {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+};
+
+class BenchmarkMemory {
+    public:
+        /** @brief
+        * Resets peak resident set size, so next peakRSS() reports peak of following code only
+        * (supported on Linux, elsewhere peak of whole process is reported)
+        * @return bool - true, when peak was reset */
+        static bool resetPeakRSS();
+
+        /** @brief
+        * @return long - peak resident set size in kilobytes, -1 when not available */
+        static long peakRSS();
+};
+
+class BenchmarkStatisticsCalculator {
+    public:
+        static BenchmarkStatistics summarize(std::vector<double> samples);
+
+    private:
+        static double percentile(const std::vector<double> & sorted, double p);
+};
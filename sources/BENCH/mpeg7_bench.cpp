@@ -0,0 +1,602 @@
+/** @file   mpeg7_bench.cpp
+ *  @brief  Benchmark of all extractors and distances of the library.
+ *
+ *          Every descriptor is extracted from synthetic images and sample images
+ *          (resources/lenna.png by default) rescaled to several resolutions.
+ *          For each descriptor and image the benchmark reports latency of the pipeline stages
+ *          (decode, extract, XML generation, distance), throughput and peak resident memory.
+ *          Results are printed as a table and can be written as JSON (--json), so they
+ *          can be compared between builds and releases.
+ *
+ *          With --decoders it compares decode throughput of image decoders built into
+ *          the library instead (stb_image, libjpeg-turbo): full size color, gray and
+ *          color reduced 2, 4 and 8 times, of synthetic images (PPM, JPEG) and sample images.
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#include "Benchmark.h"
+#include "../Mpeg7.h"
+#include "../TOOLS/Image/ImageDecoder.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#ifndef MPEG7_RESOURCES_DIR
+    #define MPEG7_RESOURCES_DIR "resources"
+#endif
+
+#define BENCH_JSON_VERSION 1
+
+struct BenchmarkOptions {
+    int iterations         = 10;
+    int warmup             = 1;
+    int distanceIterations = 1000;
+    bool synthetic         = true;
+    bool decoders          = false;
+    std::vector<int> sizes;
+    std::vector<DescriptorType> descriptors;
+    std::vector<std::string> images;
+    std::string json;
+};
+
+struct BenchmarkResult {
+    DescriptorType type = NONE;
+    std::string image;
+    int width  = 0;
+    int height = 0;
+
+    BenchmarkStatistics decode;
+    BenchmarkStatistics extract;
+    BenchmarkStatistics xml;
+    BenchmarkStatistics distance;
+
+    long peakRSS  = -1;
+    int errors    = 0;
+    int lastError = 0;
+};
+
+/** Decoding of one image by one decoder in one mode */
+struct DecodeResult {
+    std::string decoder;
+    std::string image;
+    std::string format;
+    std::string mode;
+    int width  = 0;
+    int height = 0;
+
+    int outputWidth    = 0;
+    int outputHeight   = 0;
+    int outputChannels = 0;
+
+    BenchmarkStatistics decode;
+
+    int errors    = 0;
+    int lastError = 0;
+};
+
+struct DecodeMode {
+    const char * name;
+    LoadMode loadMode;
+    int scale;
+};
+
+static const DecodeMode decodeModes[] = {
+    { "color",   IMAGE_COLOR,     1 },
+    { "gray",    IMAGE_GRAYSCALE, 1 },
+    { "color/2", IMAGE_COLOR,     2 },
+    { "color/4", IMAGE_COLOR,     4 },
+    { "color/8", IMAGE_COLOR,     8 }
+};
+
+static void printUsage(const char * programName) {
+    std::cout << "Usage: " << programName << " [options]" << std::endl;
+    std::cout << "  --iterations <n>    measured extractions per descriptor and image (default: 10)" << std::endl;
+    std::cout << "  --warmup <n>        extractions before measurement (default: 1)" << std::endl;
+    std::cout << "  --distances <n>     measured distance calculations (default: 1000)" << std::endl;
+    std::cout << "  --sizes <w,w,...>   image widths, aspect ratio is kept (default: 128,256,512)" << std::endl;
+    std::cout << "  --descriptor <t>    benchmark only given descriptor type, may be repeated" << std::endl;
+    std::cout << "  --image <path>      sample image, may be repeated (default: " << MPEG7_RESOURCES_DIR << "/lenna.png)" << std::endl;
+    std::cout << "  --no-synthetic      skip synthetic images" << std::endl;
+    std::cout << "  --decoders          compare decode throughput of image decoders instead of extractors" << std::endl;
+    std::cout << "  --json <path>       write results as JSON ('-' for standard output)" << std::endl;
+}
+
+static bool parseArguments(const int argc, char * argv[], BenchmarkOptions & options) {
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--iterations" && hasValue) {
+            options.iterations = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (argument == "--warmup" && hasValue) {
+            options.warmup = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (argument == "--distances" && hasValue) {
+            options.distanceIterations = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (argument == "--sizes" && hasValue) {
+            std::stringstream sizes(argv[++i]);
+            std::string size;
+
+            while (std::getline(sizes, size, ',')) {
+                if (std::atoi(size.c_str()) > 0) {
+                    options.sizes.push_back(std::atoi(size.c_str()));
+                }
+            }
+        }
+        else if (argument == "--descriptor" && hasValue) {
+            const int type = std::atoi(argv[++i]);
+
+            if (type < DOMINANT_COLOR_D || type > CONTOUR_SHAPE_D) {
+                std::cerr << "Error: Invalid descriptor type. Must be between 1 and 10." << std::endl;
+                return false;
+            }
+            options.descriptors.push_back(static_cast<DescriptorType>(type));
+        }
+        else if (argument == "--image" && hasValue) {
+            options.images.push_back(argv[++i]);
+        }
+        else if (argument == "--no-synthetic") {
+            options.synthetic = false;
+        }
+        else if (argument == "--decoders") {
+            options.decoders = true;
+        }
+        else if (argument == "--json" && hasValue) {
+            options.json = argv[++i];
+        }
+        else {
+            std::cerr << "Error: Unknown option '" << argument << "'." << std::endl;
+            return false;
+        }
+    }
+
+    if (options.sizes.empty()) {
+        options.sizes = { 128, 256, 512 };
+    }
+
+    if (options.descriptors.empty()) {
+        for (int type = DOMINANT_COLOR_D; type <= CONTOUR_SHAPE_D; type++) {
+            options.descriptors.push_back(static_cast<DescriptorType>(type));
+        }
+    }
+
+    if (options.images.empty()) {
+        options.images.push_back(std::string(MPEG7_RESOURCES_DIR) + "/lenna.png");
+    }
+    return true;
+}
+
+static std::vector<BenchmarkImage> prepareImages(const BenchmarkOptions & options) {
+    std::vector<BenchmarkImage> images;
+
+    for (const int size : options.sizes) {
+        if (options.synthetic) {
+            images.push_back(BenchmarkImages::synthetic(size, size));
+        }
+
+        for (const std::string & path : options.images) {
+            const size_t separator = path.find_last_of("/\\");
+
+            std::string name = path.substr(separator == std::string::npos ? 0 : separator + 1);
+            name = name.substr(0, name.find_last_of('.'));
+
+            try {
+                Image source;
+                source.load(path.c_str(), IMAGE_COLOR);
+
+                const int height = std::max(1, static_cast<int>(static_cast<double>(size) * source.getHeight() / source.getWidth() + 0.5));
+                images.push_back(BenchmarkImages::resized(path, name, size, height));
+            }
+            catch (ErrorCode exception) {
+                std::cerr << "Warning: Could not load " << path << " (error " << exception << "), skipped." << std::endl;
+            }
+        }
+    }
+    return images;
+}
+
+static BenchmarkResult benchmark(const BenchmarkOptions & options, const BenchmarkImage & input, Image & image,
+                                 const BenchmarkStatistics & decode, const DescriptorType type, Descriptor * reference) {
+    const char * params[] = { nullptr };
+
+    BenchmarkResult result;
+    result.type   = type;
+    result.image  = input.name;
+    result.width  = input.width;
+    result.height = input.height;
+    result.decode = decode;
+
+    BenchmarkMemory::resetPeakRSS();
+
+    std::unique_ptr<DescriptorExtractor> extractor(createExtractor(type));
+    Descriptor * descriptor = nullptr;
+
+    std::vector<double> samples;
+
+    for (int i = 0; i < options.warmup + options.iterations; i++) {
+        const BenchmarkClock clock;
+
+        try {
+            descriptor = extractor->extract(image, params);
+        }
+        catch (ErrorCode exception) {
+            descriptor = nullptr;
+            result.errors++;
+            result.lastError = exception;
+            continue;
+        }
+
+        if (i >= options.warmup) {
+            samples.push_back(clock.elapsed());
+        }
+    }
+    result.extract = BenchmarkStatisticsCalculator::summarize(samples);
+
+    if (descriptor != nullptr) {
+        samples.clear();
+
+        for (int i = 0; i < options.iterations; i++) {
+            const BenchmarkClock clock;
+            const std::string xml = descriptor->generateXML();
+            samples.push_back(clock.elapsed());
+        }
+        result.xml = BenchmarkStatisticsCalculator::summarize(samples);
+    }
+
+    if (descriptor != nullptr && reference != nullptr) {
+        std::unique_ptr<DescriptorDistance> distance(createDistance(type));
+        samples.clear();
+
+        try {
+            for (int i = 0; i < options.distanceIterations; i++) {
+                const BenchmarkClock clock;
+                distance->getDistance(descriptor, reference, params);
+                samples.push_back(clock.elapsed());
+            }
+        }
+        catch (ErrorCode exception) {
+            result.errors++;
+            result.lastError = exception;
+        }
+        result.distance = BenchmarkStatisticsCalculator::summarize(samples);
+    }
+
+    result.peakRSS = BenchmarkMemory::peakRSS();
+    return result;
+}
+
+static std::string encodedFormat(const std::vector<unsigned char> & data) {
+    if (data.size() >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF) {
+        return "jpeg";
+    }
+    if (data.size() >= 4 && data[0] == 0x89 && data[1] == 'P' && data[2] == 'N' && data[3] == 'G') {
+        return "png";
+    }
+    if (data.size() >= 2 && data[0] == 'P' && data[1] >= '1' && data[1] <= '6') {
+        return "pnm";
+    }
+    return "other";
+}
+
+static std::vector<BenchmarkImage> prepareDecoderImages(const BenchmarkOptions & options) {
+    std::vector<BenchmarkImage> images;
+
+    if (options.synthetic) {
+        for (const int size : options.sizes) {
+            images.push_back(BenchmarkImages::synthetic(size, size));
+#ifdef MPEG7_JPEG_TURBO
+            images.push_back(BenchmarkImages::jpeg(images.back(), 90));
+#endif
+        }
+    }
+
+    // Sample images are decoded as they are (their format and size), not rescaled
+    for (const std::string & path : options.images) {
+        const size_t separator = path.find_last_of("/\\");
+
+        BenchmarkImage image;
+        image.name = path.substr(separator == std::string::npos ? 0 : separator + 1);
+
+        std::ifstream file(path, std::ios::binary);
+        image.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+        try {
+            Image source;
+            source.load(const_cast<unsigned char *>(image.data.data()), static_cast<int>(image.data.size()), IMAGE_UNCHANGED);
+
+            image.width  = source.getWidth();
+            image.height = source.getHeight();
+            images.push_back(image);
+        }
+        catch (ErrorCode exception) {
+            std::cerr << "Warning: Could not load " << path << " (error " << exception << "), skipped." << std::endl;
+        }
+    }
+    return images;
+}
+
+static DecodeResult benchmarkDecoder(const BenchmarkOptions & options, const BenchmarkImage & input, ImageDecoder & decoder,
+                                     const DecodeMode & mode) {
+    DecodeResult result;
+    result.decoder = decoder.getName();
+    result.image   = input.name;
+    result.format  = encodedFormat(input.data);
+    result.mode    = mode.name;
+    result.width   = input.width;
+    result.height  = input.height;
+
+    std::vector<double> samples;
+
+    for (int i = 0; i < options.warmup + options.iterations; i++) {
+        Image decoded;
+        decoded.setDecoder(&decoder);
+        decoded.setDecodeScale(mode.scale);
+
+        const BenchmarkClock clock;
+
+        try {
+            decoded.load(const_cast<unsigned char *>(input.data.data()), static_cast<int>(input.data.size()), mode.loadMode);
+        }
+        catch (ErrorCode exception) {
+            result.errors++;
+            result.lastError = exception;
+            continue;
+        }
+
+        if (i >= options.warmup) {
+            samples.push_back(clock.elapsed());
+        }
+
+        result.outputWidth    = decoded.getWidth();
+        result.outputHeight   = decoded.getHeight();
+        result.outputChannels = decoded.getChannels();
+    }
+    result.decode = BenchmarkStatisticsCalculator::summarize(samples);
+    return result;
+}
+
+static void writeStatistics(std::ostream & output, const char * name, const BenchmarkStatistics & statistics) {
+    output << "\"" << name << "\": ";
+
+    if (statistics.count == 0) {
+        output << "null";
+        return;
+    }
+
+    output << "{\"count\": " << statistics.count << ", \"min\": " << statistics.min << ", \"mean\": " << statistics.mean
+           << ", \"p50\": " << statistics.p50 << ", \"p90\": " << statistics.p90 << ", \"p99\": " << statistics.p99
+           << ", \"max\": " << statistics.max << "}";
+}
+
+static void writeHeaderJSON(std::ostream & output, const BenchmarkOptions & options) {
+    output.precision(6);
+    output << std::fixed;
+
+    output << "{" << std::endl;
+    output << "  \"version\": " << BENCH_JSON_VERSION << "," << std::endl;
+#if defined(__VERSION__)
+    output << "  \"compiler\": \"" << __VERSION__ << "\"," << std::endl;
+#endif
+#if defined(NDEBUG)
+    output << "  \"build\": \"release\"," << std::endl;
+#else
+    output << "  \"build\": \"debug\"," << std::endl;
+#endif
+    output << "  \"iterations\": " << options.iterations << "," << std::endl;
+    output << "  \"warmup\": " << options.warmup << "," << std::endl;
+    output << "  \"distance_iterations\": " << options.distanceIterations << "," << std::endl;
+    output << "  \"unit\": \"ms\"," << std::endl;
+}
+
+static void writeJSON(std::ostream & output, const BenchmarkOptions & options, const std::vector<BenchmarkResult> & results) {
+    writeHeaderJSON(output, options);
+    output << "  \"results\": [" << std::endl;
+
+    for (size_t r = 0; r < results.size(); r++) {
+        const BenchmarkResult & result = results[r];
+        const double megapixels = result.width * static_cast<double>(result.height) / 1e6;
+
+        output << "    {\"descriptor_id\": " << result.type << ", \"descriptor_name\": \"" << descriptorName(result.type)
+               << "\", \"image\": \"" << result.image << "\", \"width\": " << result.width << ", \"height\": " << result.height << ", ";
+
+        writeStatistics(output, "decode", result.decode);
+        output << ", ";
+        writeStatistics(output, "extract", result.extract);
+        output << ", ";
+        writeStatistics(output, "xml", result.xml);
+        output << ", ";
+        writeStatistics(output, "distance", result.distance);
+
+        if (result.extract.count > 0 && result.extract.mean > 0.0) {
+            output << ", \"images_per_second\": " << 1000.0 / result.extract.mean
+                   << ", \"megapixels_per_second\": " << 1000.0 * megapixels / result.extract.mean;
+        }
+
+        output << ", \"peak_rss_kb\": " << result.peakRSS << ", \"errors\": " << result.errors
+               << ", \"last_error\": " << result.lastError << "}" << (r + 1 < results.size() ? "," : "") << std::endl;
+    }
+
+    output << "  ]" << std::endl;
+    output << "}" << std::endl;
+}
+
+static void writeDecodeJSON(std::ostream & output, const BenchmarkOptions & options, const std::vector<DecodeResult> & results) {
+    writeHeaderJSON(output, options);
+    output << "  \"decode_results\": [" << std::endl;
+
+    for (size_t r = 0; r < results.size(); r++) {
+        const DecodeResult & result = results[r];
+        const double megapixels = result.width * static_cast<double>(result.height) / 1e6;
+
+        output << "    {\"decoder\": \"" << result.decoder << "\", \"image\": \"" << result.image << "\", \"format\": \""
+               << result.format << "\", \"width\": " << result.width << ", \"height\": " << result.height
+               << ", \"mode\": \"" << result.mode << "\", \"output_width\": " << result.outputWidth
+               << ", \"output_height\": " << result.outputHeight << ", \"output_channels\": " << result.outputChannels << ", ";
+
+        writeStatistics(output, "decode", result.decode);
+
+        if (result.decode.count > 0 && result.decode.mean > 0.0) {
+            output << ", \"megapixels_per_second\": " << 1000.0 * megapixels / result.decode.mean;
+        }
+
+        output << ", \"errors\": " << result.errors << ", \"last_error\": " << result.lastError << "}"
+               << (r + 1 < results.size() ? "," : "") << std::endl;
+    }
+
+    output << "  ]" << std::endl;
+    output << "}" << std::endl;
+}
+
+static int benchmarkDecoders(const BenchmarkOptions & options) {
+    const std::vector<BenchmarkImage> images = prepareDecoderImages(options);
+
+    if (images.empty()) {
+        std::cerr << "Error: No benchmark images." << std::endl;
+        return 1;
+    }
+
+    std::ostream & table = options.json == "-" ? std::cerr : std::cout;
+
+    char line[256];
+    snprintf(line, sizeof(line), "%-14s %-16s %-6s %11s %-8s %11s %9s %9s %9s %9s %6s",
+             "decoder", "image", "format", "size", "mode", "output", "mean", "p50", "p90", "MP/s", "errors");
+    table << line << std::endl;
+
+    std::vector<DecodeResult> results;
+
+    // Every decoder supporting format of image (stb_image decodes all of them)
+    for (const BenchmarkImage & input : images) {
+        for (ImageDecoder * decoder : ImageDecoders::all()) {
+            if (!decoder->supports(input.data.data(), static_cast<int>(input.data.size()))) {
+                continue;
+            }
+
+            for (const DecodeMode & mode : decodeModes) {
+                const DecodeResult result = benchmarkDecoder(options, input, *decoder, mode);
+                results.push_back(result);
+
+                const std::string size   = std::to_string(result.width) + "x" + std::to_string(result.height);
+                const std::string output = std::to_string(result.outputWidth) + "x" + std::to_string(result.outputHeight);
+                const double megapixels  = result.width * static_cast<double>(result.height) / 1e6;
+
+                snprintf(line, sizeof(line), "%-14s %-16s %-6s %11s %-8s %11s %9.3f %9.3f %9.3f %9.1f %6d",
+                         result.decoder.c_str(), result.image.c_str(), result.format.c_str(), size.c_str(), result.mode.c_str(),
+                         output.c_str(), result.decode.mean, result.decode.p50, result.decode.p90,
+                         result.decode.mean > 0.0 ? 1000.0 * megapixels / result.decode.mean : 0.0, result.errors);
+                table << line << std::endl;
+            }
+        }
+    }
+
+    if (options.json == "-") {
+        writeDecodeJSON(std::cout, options, results);
+    }
+    else if (!options.json.empty()) {
+        std::ofstream file(options.json);
+
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not write " << options.json << std::endl;
+            return 1;
+        }
+        writeDecodeJSON(file, options, results);
+    }
+    return 0;
+}
+
+int main(const int argc, char * argv[]) {
+    BenchmarkOptions options;
+
+    if (!parseArguments(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (options.decoders) {
+        return benchmarkDecoders(options);
+    }
+
+    const std::vector<BenchmarkImage> images = prepareImages(options);
+
+    if (images.empty()) {
+        std::cerr << "Error: No benchmark images." << std::endl;
+        return 1;
+    }
+
+    // Table goes to standard error when JSON is written to standard output
+    std::ostream & table = options.json == "-" ? std::cerr : std::cout;
+
+    char line[256];
+    snprintf(line, sizeof(line), "%-20s %-10s %9s %9s %9s %9s %9s %9s %9s %9s %10s %6s",
+             "descriptor", "image", "size", "decode", "p50", "p90", "p99", "img/s", "xml", "dist us", "peak MB", "errors");
+    table << line << std::endl;
+
+    // Distances are measured against descriptor of the first image it could be extracted from
+    std::vector<std::unique_ptr<DescriptorExtractor>> referenceExtractors;
+    std::vector<Descriptor *> references(options.descriptors.size(), nullptr);
+
+    for (const DescriptorType type : options.descriptors) {
+        referenceExtractors.emplace_back(createExtractor(type));
+    }
+
+    std::vector<BenchmarkResult> results;
+
+    for (const BenchmarkImage & input : images) {
+        Image image;
+        std::vector<double> samples;
+
+        for (int i = 0; i < options.iterations; i++) {
+            Image decoded;
+            const BenchmarkClock clock;
+            decoded.load(const_cast<unsigned char *>(input.data.data()), static_cast<int>(input.data.size()), IMAGE_UNCHANGED);
+            samples.push_back(clock.elapsed());
+        }
+
+        const BenchmarkStatistics decode = BenchmarkStatisticsCalculator::summarize(samples);
+        image.load(const_cast<unsigned char *>(input.data.data()), static_cast<int>(input.data.size()), IMAGE_UNCHANGED);
+
+        for (size_t d = 0; d < options.descriptors.size(); d++) {
+            if (references[d] == nullptr) {
+                const char * params[] = { nullptr };
+
+                try {
+                    references[d] = referenceExtractors[d]->extract(image, params);
+                }
+                catch (ErrorCode) {
+                    references[d] = nullptr;
+                }
+            }
+
+            const BenchmarkResult result = benchmark(options, input, image, decode, options.descriptors[d], references[d]);
+            results.push_back(result);
+
+            const std::string size = std::to_string(result.width) + "x" + std::to_string(result.height);
+
+            snprintf(line, sizeof(line), "%-20s %-10s %9s %9.3f %9.3f %9.3f %9.3f %9.1f %9.3f %9.3f %10.1f %6d",
+                     descriptorName(result.type), result.image.c_str(), size.c_str(), result.decode.mean,
+                     result.extract.p50, result.extract.p90, result.extract.p99,
+                     result.extract.mean > 0.0 ? 1000.0 / result.extract.mean : 0.0,
+                     result.xml.mean, 1000.0 * result.distance.mean, result.peakRSS / 1024.0, result.errors);
+            table << line << std::endl;
+        }
+    }
+
+    if (options.json == "-") {
+        writeJSON(std::cout, options, results);
+    }
+    else if (!options.json.empty()) {
+        std::ofstream file(options.json);
+
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not write " << options.json << std::endl;
+            return 1;
+        }
+        writeJSON(file, options, results);
+    }
+    return 0;
+}
@@ -5,44 +5,23 @@ CTBrowsing::CTBrowsing() = default;
 void CTBrowsing::loadParameters(const char ** params) {
 }
 
-std::string CTBrowsing::generateXML() {
-    XMLDocument xmlDoc;
-    XMLDeclaration * p_Declaration = xmlDoc.NewDeclaration("xml version='1.0' encoding='ISO-8859-1' ");
-    XMLElement * p_Root = xmlDoc.NewElement("Mpeg7");
-    XMLElement * p_DescriptionUnit = xmlDoc.NewElement("DescriptionUnit");
-    XMLElement * p_Descriptor = xmlDoc.NewElement("Descriptor");
-    XMLElement * p_BrowsingCategory = xmlDoc.NewElement("BrowsingCategory");
-    XMLElement * p_SubRanngeIndex = xmlDoc.NewElement("SubRangeIndex");
-
-    p_Root->SetAttribute("xmlns", "urn:mpeg:mpeg7:schema:2001");
-    p_Root->SetAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
-    p_DescriptionUnit->SetAttribute("xsi:type", "DescriptorCollectionType");
-    p_Descriptor->SetAttribute("xsi:type", "ColorTemperatureBrowsingType");
-
+void CTBrowsing::writeXML(XMLWriter & writer) {
     // Set BrowsingCategory
     int temp = ctBrowsingComponent[0];
 
-    std::string category_string = temp == 0 ? "hot"      :
-                                  temp == 1 ? "warm"     :
-                                  temp == 2 ? "moderate" :
-                                  temp == 3 ? "cool"     : throw CT_BROWSING_GEN_CATEGORY_ERROR;
-
-    p_BrowsingCategory->SetText(category_string.c_str());
+    const char * category_string = temp == 0 ? "hot"      :
+                                   temp == 1 ? "warm"     :
+                                   temp == 2 ? "moderate" :
+                                   temp == 3 ? "cool"     : throw CT_BROWSING_GEN_CATEGORY_ERROR;
 
-    // Set SubRangeIndex
-    p_SubRanngeIndex->SetText(ctBrowsingComponent[1]);
+    beginXML(writer, "ColorTemperatureBrowsingType");
 
-    xmlDoc.InsertFirstChild(p_Declaration);
-    xmlDoc.InsertEndChild(p_Root);
+    writer.textElement("BrowsingCategory", category_string);
 
-    p_Root->InsertEndChild(p_DescriptionUnit);
-    p_DescriptionUnit->InsertEndChild(p_Descriptor);
-    p_Descriptor->InsertEndChild(p_BrowsingCategory);
-    p_Descriptor->InsertEndChild(p_SubRanngeIndex);
+    // Set SubRangeIndex
+    writer.textElement("SubRangeIndex", ctBrowsingComponent[1]);
 
-    XMLPrinter xmlPrinter;
-    xmlDoc.Accept(&xmlPrinter);
-    return xmlPrinter.CStr();
+    endXML(writer);
 }
 
 void CTBrowsing::readFromXML(XMLElement * descriptorElement) {
@@ -87,6 +66,30 @@ int * CTBrowsing::getCTBrowsingComponent() {
     return ctBrowsingComponent;
 }
 
+unsigned long CTBrowsing::getBinarySize() {
+    return 2;
+}
+
+void CTBrowsing::writeBinary(unsigned char * buffer) {
+    DescriptorBinary::writeUInt8(buffer, ctBrowsingComponent[0]);
+    DescriptorBinary::writeUInt8(buffer + 1, ctBrowsingComponent[1]);
+}
+
+void CTBrowsing::readFromBinary(const unsigned char * buffer, const unsigned long size) {
+    DescriptorBinary::checkSize(size, getBinarySize());
+
+    if (buffer[0] > 3) {
+        throw BINARY_VALUE_ERROR;
+    }
+
+    if (ctBrowsingComponent == nullptr) {
+        ctBrowsingComponent = new int[2];
+    }
+
+    ctBrowsingComponent[0] = buffer[0];
+    ctBrowsingComponent[1] = buffer[1];
+}
+
 CTBrowsing::~CTBrowsing() {
 	delete[] ctBrowsingComponent;
 }
\ No newline at end of file
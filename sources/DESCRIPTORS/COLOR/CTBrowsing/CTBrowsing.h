@@ -19,7 +19,10 @@ class CTBrowsing : public Descriptor {
 
         void loadParameters(const char ** params);
 		void readFromXML(XMLElement * descriptorElement);
-        std::string generateXML();
+        void writeXML(XMLWriter & writer);
+        unsigned long getBinarySize();
+        void writeBinary(unsigned char * buffer);
+        void readFromBinary(const unsigned char * buffer, unsigned long size);
 
         void SetCTBrowsing_Component(int * PBC);
         int * getCTBrowsingComponent();
@@ -1,10 +1,17 @@
 #include "CTBrowsingExtractor.h"
+#include "../../../TOOLS/Trace/Trace.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 CTBrowsingExtractor::CTBrowsingExtractor() {
     descriptor = new CTBrowsing();
 }
 
 Descriptor * CTBrowsingExtractor::extract(Image & image, const char ** params) {
+    TRACE_SCOPE("CTBrowsingExtractor::extract");
+
     descriptor->loadParameters(params);
     
     // Get image inforamtion
@@ -54,6 +61,94 @@ Descriptor * CTBrowsingExtractor::extract(Image & image, const char ** params) {
     return descriptor;
 }
 
+Descriptor * CTBrowsingExtractor::extract(TileSource & source, const char ** params) {
+    TRACE_SCOPE("CTBrowsingExtractor::extractTiles");
+
+    descriptor->loadParameters(params);
+
+    const int sourceWidth  = source.getWidth();
+    const int sourceHeight = source.getHeight();
+    const int bandHeight   = std::max(1, std::min(source.getTileHeight(), sourceHeight));
+
+    std::vector<unsigned char> rgb(static_cast<size_t>(sourceWidth) * bandHeight * 3);
+
+    /* Averaging of perc_ill without XYZ image and discarding mask - every iteration reads source again.
+    Pixel is averaged, when it is not dark and none of its components exceeded threshold of any previous
+    iteration (so only lowest thresholds are kept), sums go over pixels in the same order as in perc_ill */
+    const double lowlevelpercent = 0.05;
+    const double f = 3.0;
+    const int iterations = 5;
+
+    const double inf = std::numeric_limits<double>::infinity();
+
+    double xyz[3];
+    double xyz_a[3];
+    double xyz_Ts[3]  = { 0.0, 0.0, 0.0 };
+    double p_th[3]    = { 0.0, 0.0, 0.0 };
+    double xyz_min[3] = { inf, inf, inf }; // lowest thresholds of previous iterations
+
+    int loop_cnt = 0;
+    int flag = 1;
+    long pix_cnt;
+
+    while (loop_cnt < iterations && flag == 1) {
+        xyz_a[0] = 0.0;
+        xyz_a[1] = 0.0;
+        xyz_a[2] = 0.0;
+
+        pix_cnt = 0;
+
+        for (int top = 0; top < sourceHeight; top += bandHeight) {
+            const int rows = std::min(bandHeight, sourceHeight - top);
+            const size_t pixelCount = static_cast<size_t>(sourceWidth) * rows;
+
+            source.read(0, top, sourceWidth, rows, rgb.data(), nullptr);
+
+            for (size_t i = 0; i < pixelCount; i++) {
+                rgb2xyz(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2], xyz);
+
+                if (xyz[1] < lowlevelpercent || xyz[0] > xyz_min[0] || xyz[1] > xyz_min[1] || xyz[2] > xyz_min[2]) {
+                    continue;
+                }
+
+                xyz_a[0] += xyz[0];
+                xyz_a[1] += xyz[1];
+                xyz_a[2] += xyz[2];
+                pix_cnt++;
+            }
+        }
+
+        for (int i = 0; i < 3; i++) {
+            xyz_a[i] /= static_cast<double>(pix_cnt);
+            xyz_Ts[i] = f * xyz_a[i];
+            xyz_min[i] = std::min(xyz_min[i], xyz_Ts[i]);
+        }
+
+        if ((xyz_Ts[0] == p_th[0]) && (xyz_Ts[1] == p_th[1]) && (xyz_Ts[2] == p_th[2])) {
+            flag = 0;
+        }
+
+        for (int i = 0; i < 3; i++) {
+            p_th[i] = xyz_Ts[i];
+        }
+        loop_cnt++;
+    }
+
+    // Chromacity of average color (6) and its temperature (7)
+    const double pix = xyz_a[0] / (xyz_a[0] + xyz_a[1] + xyz_a[2]);
+    const double piy = xyz_a[1] / (xyz_a[0] + xyz_a[1] + xyz_a[2]);
+
+    int ctemperature;
+    convert_xy2temp(pix, piy, &ctemperature);
+
+    int PCTBC[2];
+    PCTBC_Extraction(&ctemperature, PCTBC);
+
+    descriptor->SetCTBrowsing_Component(PCTBC);
+
+    return descriptor;
+}
+
 unsigned char ** CTBrowsingExtractor::allocateDiscardingArrayMemory(const int height, const int width) {
     // Allocate memory for rows:
     const auto mem = static_cast<unsigned char **>(malloc(height * sizeof(unsigned char *)));
@@ -77,26 +172,16 @@ double ** CTBrowsingExtractor::allocateXYZ(const int height, const int width) {
 }
 
 void CTBrowsingExtractor::rgb2xyz(unsigned char * imagebuff, double ** XYZ, unsigned char ** p_mask, const int imageWidth, const int imageHeight) {
+    TRACE_SCOPE("CTBrowsingExtractor::rgb2xyz");
+
     int i, j;
-    double sRGBr, sRGBg, sRGBb;
 
     for (i = 0; i < imageHeight; i++) {
         for (j = 0; j < imageWidth; j++) {
-            // Convert RGB to sRGB (1)
-            rgb2srgb(imagebuff[i * (imageWidth * 3) + j * 3 + 0],
-                     imagebuff[i * (imageWidth * 3) + j * 3 + 1],
-                     imagebuff[i * (imageWidth * 3) + j * 3 + 2], &sRGBr, &sRGBg, &sRGBb);
-
-            // Convert sRGB to XYZ with conversion matrix (2)
-            XYZ[i][j * 3 + 0] = RGB2XYZ_M[0][0] * sRGBr + RGB2XYZ_M[0][1] * sRGBg + RGB2XYZ_M[0][2] * sRGBb;
-            XYZ[i][j * 3 + 1] = RGB2XYZ_M[1][0] * sRGBr + RGB2XYZ_M[1][1] * sRGBg + RGB2XYZ_M[1][2] * sRGBb;
-            XYZ[i][j * 3 + 2] = RGB2XYZ_M[2][0] * sRGBr + RGB2XYZ_M[2][1] * sRGBg + RGB2XYZ_M[2][2] * sRGBb;
-
-            if ((XYZ[i][j * 3 + 0] < 0) || (XYZ[i][j * 3 + 1] < 0) || (XYZ[i][j * 3 + 2] < 0)) {
-                XYZ[i][j * 3 + 0] = 0.0;
-                XYZ[i][j * 3 + 1] = 0.0;
-                XYZ[i][j * 3 + 2] = 0.0;
-            }
+            // Convert RGB to sRGB (1) and sRGB to XYZ with conversion matrix (2)
+            rgb2xyz(imagebuff[i * (imageWidth * 3) + j * 3 + 0],
+                    imagebuff[i * (imageWidth * 3) + j * 3 + 1],
+                    imagebuff[i * (imageWidth * 3) + j * 3 + 2], &XYZ[i][j * 3]);
 
             // This made no sense, because next method "perc_ill" overrides initially p_mask array values to 255 (duh!):
             /*  (XM continuation)
@@ -107,6 +192,24 @@ void CTBrowsingExtractor::rgb2xyz(unsigned char * imagebuff, double ** XYZ, unsi
     }
 }
 
+void CTBrowsingExtractor::rgb2xyz(const int r, const int g, const int b, double * xyz) {
+    double sRGBr, sRGBg, sRGBb;
+
+    // Convert RGB to sRGB (1)
+    rgb2srgb(r, g, b, &sRGBr, &sRGBg, &sRGBb);
+
+    // Convert sRGB to XYZ with conversion matrix (2)
+    xyz[0] = RGB2XYZ_M[0][0] * sRGBr + RGB2XYZ_M[0][1] * sRGBg + RGB2XYZ_M[0][2] * sRGBb;
+    xyz[1] = RGB2XYZ_M[1][0] * sRGBr + RGB2XYZ_M[1][1] * sRGBg + RGB2XYZ_M[1][2] * sRGBb;
+    xyz[2] = RGB2XYZ_M[2][0] * sRGBr + RGB2XYZ_M[2][1] * sRGBg + RGB2XYZ_M[2][2] * sRGBb;
+
+    if ((xyz[0] < 0) || (xyz[1] < 0) || (xyz[2] < 0)) {
+        xyz[0] = 0.0;
+        xyz[1] = 0.0;
+        xyz[2] = 0.0;
+    }
+}
+
 void CTBrowsingExtractor::rgb2srgb(const int r, const int g, const int b, double * r_srgb, double * g_srgb, double * b_srgb) {
     *r_srgb = (r <= 0.03928 * 255.0) ? r / (255.0 * 12.92) : rgb_pow_table[r];
     *g_srgb = (g <= 0.03928 * 255.0) ? g / (255.0 * 12.92) : rgb_pow_table[g];
@@ -114,6 +217,8 @@ void CTBrowsingExtractor::rgb2srgb(const int r, const int g, const int b, double
 }
 
 void CTBrowsingExtractor::perc_ill(double ** XYZ, unsigned char ** p_mask, const int imageWidth, const int imageHeight, double * pix, double * piy) {
+    TRACE_SCOPE("CTBrowsingExtractor::perc_ill");
+
     /* (KK) OMMIT DARK PIXELS FROM XYZ (3)
     If luminance component of threshold array is lower than 5 %,
     this pixel does not impact colour temperature perception,
@@ -7,6 +7,7 @@
 
 #include "../../DescriptorExtractor.h"
 #include "../CTBrowsing/CTBrowsing.h"
+#include "../../../TOOLS/Tile/TileSource.h"
 
 #define ABSVALUE(a)	((a < 0) ? (a * -1) : a)
 
@@ -46,6 +47,7 @@ class CTBrowsingExtractor : public DescriptorExtractor {
 
         // RGB -> XYZ
         void rgb2xyz(unsigned char * imagebuff, double** XYZ, unsigned char ** p_mask, int imageWidth, int imageHeight);
+        void rgb2xyz(int r, int g, int b, double * xyz);
 
         // RGB -> sRGB
         void rgb2srgb(int r, int g, int b, double * r_srgb, double * g_srgb, double* b_srgb);
@@ -67,5 +69,10 @@ class CTBrowsingExtractor : public DescriptorExtractor {
     public:
 	    CTBrowsingExtractor();
 	    Descriptor * extract(Image & image, const char ** params);
+
+        /** @brief
+        * Extraction from bands of rows read from source, source is read once per averaging iteration (up to 5 times) */
+        Descriptor * extract(TileSource & source, const char ** params);
+
         ~CTBrowsingExtractor();
 };
@@ -64,70 +64,34 @@ void ColorLayout::loadParameters(const char ** params) {
     }
 }
 
-std::string ColorLayout::generateXML() {
-    XMLDocument xmlDoc;
+void ColorLayout::writeXML(XMLWriter & writer) {
+    char y_AC_name[32];
+    char cb_AC_name[32];
+    char cr_AC_name[32];
 
-    XMLDeclaration * p_Declaration = xmlDoc.NewDeclaration("xml version='1.0' encoding='ISO-8859-1' ");
+    snprintf(y_AC_name,  sizeof(y_AC_name),  "YACCoeff%d",  numberOfYCoefficients - 1);
+    snprintf(cb_AC_name, sizeof(cb_AC_name), "CbACCoeff%d", numberOfCCoefficients - 1);
+    snprintf(cr_AC_name, sizeof(cr_AC_name), "CrACCoeff%d", numberOfCCoefficients - 1);
 
-    XMLElement * p_Root = xmlDoc.NewElement("Mpeg7");
-    XMLElement * p_DescriptionUnit = xmlDoc.NewElement("DescriptionUnit");
-    XMLElement * p_Descriptor = xmlDoc.NewElement("Descriptor");
+    beginXML(writer, "ColorLayoutType");
 
-    XMLElement * p_YDCCoeff = xmlDoc.NewElement("YDCCoeff");
-    XMLElement * p_CbDCCoeff = xmlDoc.NewElement("CbDCCoeff");
-    XMLElement * p_CrDCCoeff = xmlDoc.NewElement("CrDCCoeff");
+    writer.textElement("YDCCoeff", yCoefficients[0]);   // YDCCoeff
+    writer.textElement("CbDCCoeff", cbCoefficients[0]); // CbDCCoeff
+    writer.textElement("CrDCCoeff", crCoefficients[0]); // CrDCCoeff
 
-    std::string y_AC_name  = "YACCoeff"  + std::to_string(numberOfYCoefficients - 1);
-    std::string cb_AC_name = "CbACCoeff" + std::to_string(numberOfCCoefficients - 1);
-    std::string cr_AC_name = "CrACCoeff" + std::to_string(numberOfCCoefficients - 1);
+    writer.openElement(y_AC_name);   // YACCoeff
+    writer.textValues(yCoefficients + 1, numberOfYCoefficients - 1);
+    writer.closeElement();
 
-    XMLElement * p_YACCoeff = xmlDoc.NewElement(y_AC_name.c_str());
-    XMLElement * p_CbACCoeff = xmlDoc.NewElement(cb_AC_name.c_str());
-    XMLElement * p_CrACCoeff = xmlDoc.NewElement(cr_AC_name.c_str());
+    writer.openElement(cb_AC_name);  // CbACCoeff
+    writer.textValues(cbCoefficients + 1, numberOfCCoefficients - 1);
+    writer.closeElement();
 
-    p_Root->SetAttribute("xmlns", "urn:mpeg:mpeg7:schema:2001");
-    p_Root->SetAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
-    p_DescriptionUnit->SetAttribute("xsi:type", "DescriptorCollectionType");
-    p_Descriptor->SetAttribute("xsi:type", "ColorLayoutType");
+    writer.openElement(cr_AC_name);  // CrACCoeff
+    writer.textValues(crCoefficients + 1, numberOfCCoefficients - 1);
+    writer.closeElement();
 
-    p_YDCCoeff->SetText(yCoefficients[0]);   // YDCCoeff
-    p_CbDCCoeff->SetText(cbCoefficients[0]); // CbDCCoeff
-    p_CrDCCoeff->SetText(crCoefficients[0]); // CrDCCoeff
-
-    std::string yACstring;
-    std::string cbACstring;
-    std::string crACstring;
-
-    for (int i = 1; i < numberOfYCoefficients; i++) {
-        yACstring.append(std::to_string(yCoefficients[i]) + " ");
-    }
-
-    for (int i = 1; i < numberOfCCoefficients; i++) {
-        cbACstring.append(std::to_string(cbCoefficients[i]) + " ");
-        crACstring.append(std::to_string(crCoefficients[i]) + " ");
-    }
-
-    p_YACCoeff->SetText(yACstring.c_str());   // YACCoeff
-    p_CbACCoeff->SetText(cbACstring.c_str()); // CbACCoeff
-    p_CrACCoeff->SetText(crACstring.c_str()); // CrACCoeff
-
-    xmlDoc.InsertFirstChild(p_Declaration);
-    xmlDoc.InsertEndChild(p_Root);
-
-    p_Root->InsertEndChild(p_DescriptionUnit);
-    p_DescriptionUnit->InsertEndChild(p_Descriptor);
-
-    p_Descriptor->InsertEndChild(p_YDCCoeff);
-    p_Descriptor->InsertEndChild(p_CbDCCoeff);
-    p_Descriptor->InsertEndChild(p_CrDCCoeff);
-
-    p_Descriptor->InsertEndChild(p_YACCoeff);
-    p_Descriptor->InsertEndChild(p_CbACCoeff);
-    p_Descriptor->InsertEndChild(p_CrACCoeff);
-
-    XMLPrinter xmlPrinter;
-    xmlDoc.Accept(&xmlPrinter);
-    return xmlPrinter.CStr();
+    endXML(writer);
 }
 
 void ColorLayout::readFromXML(XMLElement * descriptorElement) {
@@ -334,14 +298,17 @@ void ColorLayout::readFromXML(XMLElement * descriptorElement) {
 }
 
 void ColorLayout::allocateYCoefficients() {
+	delete[] yCoefficients; // coefficients of previous extraction (descriptor kept by reused extractor)
 	yCoefficients = new int[numberOfYCoefficients];
 }
 
 void ColorLayout::allocateCbCoefficients() {
+	delete[] cbCoefficients; // coefficients of previous extraction (descriptor kept by reused extractor)
 	cbCoefficients = new int[numberOfCCoefficients];
 }
 
 void ColorLayout::allocateCrCoefficients() {
+	delete[] crCoefficients; // coefficients of previous extraction (descriptor kept by reused extractor)
 	crCoefficients = new int[numberOfCCoefficients];
 }
 
@@ -385,6 +352,66 @@ int * ColorLayout::getCrCoefficients() {
     return crCoefficients;
 }
 
+unsigned long ColorLayout::getBinarySize() {
+    return 2 + numberOfYCoefficients + 2 * numberOfCCoefficients;
+}
+
+void ColorLayout::writeBinary(unsigned char * buffer) {
+    DescriptorBinary::writeUInt8(buffer, numberOfYCoefficients);
+    DescriptorBinary::writeUInt8(buffer + 1, numberOfCCoefficients);
+
+    unsigned char * value = buffer + 2;
+
+    for (int i = 0; i < numberOfYCoefficients; i++) {
+        DescriptorBinary::writeUInt8(value++, yCoefficients[i]);
+    }
+
+    for (int i = 0; i < numberOfCCoefficients; i++) {
+        DescriptorBinary::writeUInt8(value++, cbCoefficients[i]);
+    }
+
+    for (int i = 0; i < numberOfCCoefficients; i++) {
+        DescriptorBinary::writeUInt8(value++, crCoefficients[i]);
+    }
+}
+
+void ColorLayout::readFromBinary(const unsigned char * buffer, const unsigned long size) {
+    if (size < 2) {
+        throw BINARY_SIZE_ERROR;
+    }
+
+    const auto validCount = [](const int count) {
+        return count == 3 || count == 6 || count == 10 || count == 15 || count == 21 || count == 28 || count == 64;
+    };
+
+    if (!validCount(buffer[0]) || !validCount(buffer[1])) {
+        throw BINARY_VALUE_ERROR;
+    }
+
+    numberOfYCoefficients = buffer[0];
+    numberOfCCoefficients = buffer[1];
+
+    DescriptorBinary::checkSize(size, getBinarySize());
+
+    allocateYCoefficients();
+    allocateCbCoefficients();
+    allocateCrCoefficients();
+
+    const unsigned char * value = buffer + 2;
+
+    for (int i = 0; i < numberOfYCoefficients; i++) {
+        yCoefficients[i] = *value++;
+    }
+
+    for (int i = 0; i < numberOfCCoefficients; i++) {
+        cbCoefficients[i] = *value++;
+    }
+
+    for (int i = 0; i < numberOfCCoefficients; i++) {
+        crCoefficients[i] = *value++;
+    }
+}
+
 ColorLayout::~ColorLayout() {
 	if (yCoefficients) {
 		delete[] yCoefficients;
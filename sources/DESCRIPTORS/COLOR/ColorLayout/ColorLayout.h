@@ -60,7 +60,10 @@ class ColorLayout : public Descriptor {
         // General descriptor functions
         void loadParameters(const char ** params);
         void readFromXML(XMLElement * descriptorElement);
-        std::string generateXML();
+        void writeXML(XMLWriter & writer);
+        unsigned long getBinarySize();
+        void writeBinary(unsigned char * buffer);
+        void readFromBinary(const unsigned char * buffer, unsigned long size);
 
         // Allocating result arrays
         void allocateYCoefficients();
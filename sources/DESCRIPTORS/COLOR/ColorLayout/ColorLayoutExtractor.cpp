@@ -1,16 +1,23 @@
 #include "ColorLayoutExtractor.h"
+#include "../../../TOOLS/Trace/Trace.h"
 
 ColorLayoutExtractor::ColorLayoutExtractor() {
 	descriptor = new ColorLayout();
 }
 
 Descriptor * ColorLayoutExtractor::extract(Image & image, const char ** params) {
+    TRACE_SCOPE("ColorLayoutExtractor::extract");
+
 	descriptor->loadParameters(params);
 
     /* Create small image */
 	short small_img[3][64];
 	CreateSmallImage(image, small_img);
 
+    return SmallImageDescriptor(small_img);
+}
+
+Descriptor * ColorLayoutExtractor::SmallImageDescriptor(short small_img[3][64]) {
     /* Apply DCT */
 	FastDiscreteCosineTransform(small_img[0]);
     FastDiscreteCosineTransform(small_img[1]);
@@ -48,13 +55,14 @@ Descriptor * ColorLayoutExtractor::extract(Image & image, const char ** params)
 }
 
 void ColorLayoutExtractor::CreateSmallImage(Image & image, short small_img[3][64]) {
+    TRACE_SCOPE("ColorLayoutExtractor::CreateSmallImage");
+
     /* Original image is being partitioned into 64 blocks */
 
     // Get image information:
     const bool transparencyPresent = image.getTransparencyPresent();
     const int imageWidth           = image.getWidth();
     const int imageHeight          = image.getHeight();
-    const int imageSize            = image.getSize();
 
     int i, j, k;
     int x, y;
@@ -70,103 +78,103 @@ void ColorLayoutExtractor::CreateSmallImage(Image & image, short small_img[3][64
         }
     }
 
-    // Upsampling for small pictures (less than 8 x 8 pixels) to avoid floating point exception (XM)    
-    const int rep_width  = (imageWidth  < 8) ? 7 : 0;
-    const int rep_height = (imageHeight < 8) ? 7 : 0;
+    // Upsampling for small pictures (less than 8 x 8 pixels) to avoid floating point exception (XM)
+    const int rep_width  = (imageWidth  < 8) ? 8 : 1;
+    const int rep_height = (imageHeight < 8) ? 8 : 1;
 
-    const int width  = (imageWidth   < 8) ? 8 * imageWidth : imageWidth;
-    const int height = (imageHeight  < 8) ? 8 * imageHeight : imageHeight;
+    const int width  = rep_width  * imageWidth;
+    const int height = rep_height * imageHeight;
 
     // Get image data
     const unsigned char * pR = image.getChannel_R();
     const unsigned char * pG = image.getChannel_G();
     const unsigned char * pB = image.getChannel_B();
     // if image has alpha channel, get it:
-    const unsigned char * pA = transparencyPresent ? new unsigned char[imageSize] : nullptr;
+    const unsigned char * pA = transparencyPresent ? image.getChannel_A() : nullptr;
 
     /* Modify the code to use new operation to alloc memory for 3D array (XM)
 
     Creates new buffer for image data (for 3 or 4 channels, if alpha is present) 
     In case of memory leaks, reduntant pointers to each channel in this buffer
     were removed from original code. All operations are made on this buffer now. (KK) */
-    unsigned char * buffer = transparencyPresent ? new unsigned char[4 * width * height] : new unsigned char[3 * width * height];
-
-    int idx = 0;
-    for (y = 0; y < imageHeight; y++) {
-        for (x = 0; x < imageWidth; x++) {
-            buffer[idx + 0] = pR[idx];
-            buffer[idx + width * height] = pG[idx];
-            buffer[idx + width * height * 2] = pB[idx];
-
-            if (transparencyPresent) {
-                buffer[idx + width * height * 3] = pA[idx];
-            }
-
-            for (i = 0; i < rep_width; i++) {
-                buffer[idx + 0] = pR[idx];
-                buffer[idx + width * height] = pG[idx];
-                buffer[idx + width * height * 2] = pB[idx];
+    const int planeSize = width * height;
+    unsigned char * buffer = transparencyPresent ? new unsigned char[4 * planeSize] : new unsigned char[3 * planeSize];
 
-                if (transparencyPresent) {
-                    buffer[idx + width * height * 3] = pA[idx];
-                }
-            }
-            idx++;
-        }
-
-        for (j = 0; j < rep_height; j++) {
-            memcpy(buffer + 0 * (width * height) + (8 * y + j + 1) * width + 0,
-                   buffer + 0 * (width * height) + (8 * y)         * width + 0, width);
-
-            memcpy(buffer + 1 * (width * height) + (8 * y + j + 1) * width + 0,
-                   buffer + 1 * (width * height) + (8 * y)         * width + 0, width);
+    // Every source pixel is repeated rep_width x rep_height times
+    for (y = 0; y < height; y++) {
+        for (x = 0; x < width; x++) {
+            const int source = (y / rep_height) * imageWidth + x / rep_width;
+            const int target = y * width + x;
 
-            memcpy(buffer + 2 * (width * height) + (8 * y + j + 1) * width + 0,
-                   buffer + 2 * (width * height) + (8 * y)         * width + 0, width);
+            buffer[target]                 = pR[source];
+            buffer[target + planeSize]     = pG[source];
+            buffer[target + planeSize * 2] = pB[source];
 
             if (transparencyPresent) {
-                memcpy(buffer + 3 * (width * height) + (8 * y + j + 1) * width + 0,
-                       buffer + 3 * (width * height) + (8 * y)         * width + 0, width);
+                buffer[target + planeSize * 3] = pA[source];
             }
         }
     }
 
-    double yy;
+    int ycc[3];
     short R, G, B, A;
     int y_axis, x_axis;
 
-    idx = 0;
     for (y = 0; y < height; y++) {
         for (x = 0; x < width; x++) {
+            const int idx = y * width + x;
+
             y_axis = static_cast<int>(y / (height / 8.0));
             x_axis = static_cast<int>(x / (width / 8.0));
 
             k = y_axis * 8 + x_axis;
 
-            G = pG[idx];
-            B = pB[idx];
-            R = pR[idx];
+            R = buffer[idx];
+            G = buffer[idx + planeSize];
+            B = buffer[idx + planeSize * 2];
 
             if (transparencyPresent) {
-                A = pA[idx];
+                A = buffer[idx + planeSize * 3];
                 if (A == 0) {
                     continue;
                 }
             }
 
-            idx++;
-
-            // RGB to YCbCr conversion
-            yy = (0.299 * R + 0.587 * G + 0.114 * B) / 256.0;
+            PixelYCbCr(R, G, B, ycc);
 
-            small_block_sum[0][k] += static_cast<int>(219.0 * yy + 16.5);                              // Y
-            small_block_sum[1][k] += static_cast<int>(224.0 * 0.564 * (B / 256.0 * 1.0 - yy) + 128.5); // Cb
-            small_block_sum[2][k] += static_cast<int>(224.0 * 0.713 * (R / 256.0 * 1.0 - yy) + 128.5); // Cr
+            small_block_sum[0][k] += ycc[0];
+            small_block_sum[1][k] += ycc[1];
+            small_block_sum[2][k] += ycc[2];
 
             cnt[k]++;
         }
     }
 
+    AverageBlocks(small_block_sum, cnt, transparencyPresent, small_img);
+
+    delete[] pR;
+    delete[] pG;
+    delete[] pB;
+
+    if (pA) {
+        delete[] pA;
+    }
+
+    delete[] buffer;
+}
+
+void ColorLayoutExtractor::PixelYCbCr(const int R, const int G, const int B, int * ycc) {
+    // RGB to YCbCr conversion
+    const double yy = (0.299 * R + 0.587 * G + 0.114 * B) / 256.0;
+
+    ycc[0] = static_cast<int>(219.0 * yy + 16.5);                              // Y
+    ycc[1] = static_cast<int>(224.0 * 0.564 * (B / 256.0 * 1.0 - yy) + 128.5); // Cb
+    ycc[2] = static_cast<int>(224.0 * 0.713 * (R / 256.0 * 1.0 - yy) + 128.5); // Cr
+}
+
+void ColorLayoutExtractor::AverageBlocks(long small_block_sum[3][64], const int cnt[64], const bool transparencyPresent, short small_img[3][64]) {
+    int i, j, k;
+
     double total_sum[3] = { 0.0, 0.0, 0.0 };
     int valid_cell = 0;
 
@@ -211,16 +219,88 @@ void ColorLayoutExtractor::CreateSmallImage(Image & image, short small_img[3][64
             }
         }
     }
+}
+
+void ColorLayoutExtractor::prepareRegions(Image & image) {
+    TRACE_SCOPE("ColorLayoutExtractor::prepareRegions");
+
+    regionImageWidth   = image.getWidth();
+    regionImageHeight  = image.getHeight();
+    regionTransparency = image.getTransparencyPresent();
+
+    const size_t size = static_cast<size_t>(regionImageWidth) * regionImageHeight;
+
+    const unsigned char * pR = image.getChannel_R();
+    const unsigned char * pG = image.getChannel_G();
+    const unsigned char * pB = image.getChannel_B();
+    const unsigned char * pA = regionTransparency ? image.getChannel_A() : nullptr;
+
+    regionYCbCr.resize(size * 3);
+    regionAlpha.clear();
+
+    if (pA) {
+        regionAlpha.assign(pA, pA + size);
+    }
+
+    int ycc[3];
+
+    for (size_t i = 0; i < size; i++) {
+        PixelYCbCr(pR[i], pG[i], pB[i], ycc);
+
+        regionYCbCr[i * 3]     = static_cast<short>(ycc[0]);
+        regionYCbCr[i * 3 + 1] = static_cast<short>(ycc[1]);
+        regionYCbCr[i * 3 + 2] = static_cast<short>(ycc[2]);
+    }
 
     delete[] pR;
     delete[] pG;
     delete[] pB;
+    delete[] pA;
+}
 
-    if (pA) {
-        delete[] pA;
+Descriptor * ColorLayoutExtractor::extractRegion(const int x, const int y, const int width, const int height, const char ** params) {
+    TRACE_SCOPE("ColorLayoutExtractor::extractRegion");
+
+    if (x < 0 || y < 0 || width <= 0 || height <= 0 || width > regionImageWidth - x || height > regionImageHeight - y) {
+        throw GRID_NOT_VALID;
     }
 
-    delete[] buffer;
+    descriptor->loadParameters(params);
+
+    long small_block_sum[3][64] = {{0}};
+    int cnt[64] = {0};
+
+    // Upsampling for small regions, as in CreateSmallImage
+    const int rep_width  = (width  < 8) ? 8 : 1;
+    const int rep_height = (height < 8) ? 8 : 1;
+
+    const int repWidth  = rep_width  * width;
+    const int repHeight = rep_height * height;
+
+    for (int j = 0; j < repHeight; j++) {
+        const int y_axis = static_cast<int>(j / (repHeight / 8.0));
+
+        for (int i = 0; i < repWidth; i++) {
+            const size_t source = static_cast<size_t>(y + j / rep_height) * regionImageWidth + x + i / rep_width;
+
+            if (regionTransparency && regionAlpha[source] == 0) {
+                continue;
+            }
+
+            const int k = y_axis * 8 + static_cast<int>(i / (repWidth / 8.0));
+
+            small_block_sum[0][k] += regionYCbCr[source * 3];
+            small_block_sum[1][k] += regionYCbCr[source * 3 + 1];
+            small_block_sum[2][k] += regionYCbCr[source * 3 + 2];
+
+            cnt[k]++;
+        }
+    }
+
+    short small_img[3][64];
+    AverageBlocks(small_block_sum, cnt, regionTransparency, small_img);
+
+    return SmallImageDescriptor(small_img);
 }
 
 void ColorLayoutExtractor::FastDiscreteCosineTransform(short * block) {
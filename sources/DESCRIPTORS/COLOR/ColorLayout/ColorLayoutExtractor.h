@@ -8,6 +8,8 @@
 #include "../../DescriptorExtractor.h"
 #include "../ColorLayout/ColorLayout.h"
 
+#include <vector>
+
 class ColorLayoutExtractor : public DescriptorExtractor {
 	private:
         ColorLayout * descriptor = nullptr;
@@ -18,6 +20,18 @@ class ColorLayoutExtractor : public DescriptorExtractor {
 
         // Ico creation from representative colors
 		void CreateSmallImage(Image &image, short small_img[3][64]);
+        void PixelYCbCr(int R, int G, int B, int * ycc);
+        void AverageBlocks(long small_block_sum[3][64], const int cnt[64], bool transparencyPresent, short small_img[3][64]);
+
+        // DCT, quantization and zig-zag scan of small image into descriptor
+        Descriptor * SmallImageDescriptor(short small_img[3][64]);
+
+        // YCbCr values (and alpha) of pixels of image prepared for extraction of regions
+        std::vector<short> regionYCbCr;
+        std::vector<unsigned char> regionAlpha;
+        int regionImageWidth    = 0;
+        int regionImageHeight   = 0;
+        bool regionTransparency = false;
 
         // DCT
 		void FastDiscreteCosineTransform(short * block);
@@ -30,5 +44,15 @@ class ColorLayoutExtractor : public DescriptorExtractor {
 	public:
 		ColorLayoutExtractor();
 		Descriptor * extract(Image & image, const char ** params);
+
+        /** @brief
+        * Converts all pixels of image to YCbCr once for extraction of its regions with extractRegion */
+        void prepareRegions(Image & image);
+
+        /** @brief
+        * Extraction from width x height region at (x, y) of prepared image (the same descriptor as of cropped image),
+        * throws ErrorCode (GRID_NOT_VALID for region outside of image) */
+        Descriptor * extractRegion(int x, int y, int width, int height, const char ** params);
+
         ~ColorLayoutExtractor();
 };
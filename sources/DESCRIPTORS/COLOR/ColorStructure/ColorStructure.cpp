@@ -45,57 +45,32 @@ void ColorStructure::loadParameters(const char ** params) {
     }
 }
 
-std::string ColorStructure::generateXML() {
-    XMLDocument xmlDoc;
-
-    XMLDeclaration * p_Declaration = xmlDoc.NewDeclaration("xml version='1.0' encoding='ISO-8859-1' ");
-    XMLElement * p_Root = xmlDoc.NewElement("Mpeg7");
-    XMLElement * p_DescriptionUnit = xmlDoc.NewElement("DescriptionUnit");
-    XMLElement * p_Descriptor = xmlDoc.NewElement("Descriptor");
-    XMLElement * p_Values = xmlDoc.NewElement("Values");
-
-    p_Root->SetAttribute("xmlns", "urn:mpeg:mpeg7:schema:2001");
-    p_Root->SetAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
-    p_DescriptionUnit->SetAttribute("xsi:type", "DescriptorCollectionType");
-    p_Descriptor->SetAttribute("xsi:type", "ColorStructureType");
+void ColorStructure::writeXML(XMLWriter & writer) {
+    beginXML(writer, "ColorStructureType");
 
     switch (descriptorSize) {
         case 32:
-            p_Descriptor->SetAttribute("colorQuant", 1);
+            writer.attribute("colorQuant", 1);
             break;
         case 64:
-            p_Descriptor->SetAttribute("colorQuant", 2);
+            writer.attribute("colorQuant", 2);
             break;
         case 128:
-            p_Descriptor->SetAttribute("colorQuant", 3);
+            writer.attribute("colorQuant", 3);
             break;
         case 256:
-            p_Descriptor->SetAttribute("colorQuant", 4);
+            writer.attribute("colorQuant", 4);
             break;
         default:
-            p_Descriptor->SetAttribute("colorQuant", 0);
+            writer.attribute("colorQuant", 0);
             break;
     }
 
-    std::string values_string;
-    
-    for (unsigned int i = 0; i < descriptorSize; i++) {
-        values_string.append(std::to_string(descriptorData[i]) + " ");
-    }
-
-    p_Values->SetText(values_string.c_str());
-
-    xmlDoc.InsertFirstChild(p_Declaration);
-    xmlDoc.InsertEndChild(p_Root);
-
-    p_Root->InsertEndChild(p_DescriptionUnit);
-    p_DescriptionUnit->InsertEndChild(p_Descriptor);
-    p_Descriptor->InsertEndChild(p_Values);
+    writer.openElement("Values");
+    writer.textValues(descriptorData, descriptorSize);
+    writer.closeElement();
 
-    XMLPrinter xmlPrinter;
-    xmlDoc.Accept(&xmlPrinter);
-
-    return xmlPrinter.CStr();
+    endXML(writer);
 }
 
 void ColorStructure::readFromXML(XMLElement * descriptorElement) {
@@ -216,6 +191,40 @@ unsigned long ColorStructure::GetElement(const unsigned long index) {
 	return 0;
 }
 
+unsigned long ColorStructure::getBinarySize() {
+    return 2 + descriptorSize;
+}
+
+void ColorStructure::writeBinary(unsigned char * buffer) {
+    DescriptorBinary::writeUInt16(buffer, descriptorSize);
+
+    for (unsigned long i = 0; i < descriptorSize; i++) {
+        DescriptorBinary::writeUInt8(buffer + 2 + i, descriptorData[i]);
+    }
+}
+
+void ColorStructure::readFromBinary(const unsigned char * buffer, const unsigned long size) {
+    if (size < 2) {
+        throw BINARY_SIZE_ERROR;
+    }
+
+    const unsigned long binarySize = DescriptorBinary::readUInt16(buffer);
+
+    if (binarySize != 32 && binarySize != 64 && binarySize != 128 && binarySize != 256) {
+        throw BINARY_VALUE_ERROR;
+    }
+
+    DescriptorBinary::checkSize(size, 2 + binarySize);
+
+    targetSize     = binarySize;
+    descriptorSize = binarySize;
+    descriptorData = new unsigned long[descriptorSize];
+
+    for (unsigned long i = 0; i < descriptorSize; i++) {
+        descriptorData[i] = buffer[2 + i];
+    }
+}
+
 ColorStructure::~ColorStructure() {
     if (descriptorData) {
         delete[] descriptorData;
@@ -41,7 +41,10 @@ class ColorStructure : public Descriptor {
 
         void loadParameters(const char ** params);
 		void readFromXML(XMLElement * descriptorElement);
-        std::string generateXML();
+        void writeXML(XMLWriter & writer);
+        unsigned long getBinarySize();
+        void writeBinary(unsigned char * buffer);
+        void readFromBinary(const unsigned char * buffer, unsigned long size);
 
         unsigned long SetSize(unsigned long size);
         unsigned long GetSize();
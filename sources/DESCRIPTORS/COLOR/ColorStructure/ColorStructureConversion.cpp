@@ -0,0 +1,240 @@
+#include "ColorStructureConversion.h"
+
+#include <algorithm>
+
+int ColorStructureConversion::GetColorQuantSpace(const int size) {
+    if (size == 256) {
+        return 3;
+    }
+    else if (size == 128) {
+        return 2;
+    }
+    else if (size == 64) {
+        return 1;
+    }
+    else if (size == 32) {
+        return 0;
+    }
+    else {
+        throw COL_STUCT_GETCOLORQSPACE_ERROR;
+    }
+}
+
+int ColorStructureConversion::GetBinSize(const int iColorQuantSpace) {
+    if (iColorQuantSpace <= 3 && iColorQuantSpace >= 0) {
+        return 32 << iColorQuantSpace;
+    }
+    else {
+        // (KK) replaced 'assert("Out of bounds GetBinSize")' with exception
+        throw COL_STRUCT_GETBINSIZE_ERROR;
+    }
+}
+
+int ColorStructureConversion::TransformBinIndex(const int iOrig, const int iOrigColorQuantSpace, const int iNewColorQuantSpace) {
+    if (iOrig < 0 || iOrig >= GetBinSize(iOrigColorQuantSpace) || GetBinSize(iNewColorQuantSpace) <= 0) {
+        throw COL_STRUCT_GETBINSIZE_OUT_OF_BOUNDS;
+    }
+
+    if (iOrigColorQuantSpace == iNewColorQuantSpace) {
+        return iOrig;
+    }
+
+    // Only transforms to smaller spaces exist (XM tables)
+    const unsigned char * table = colorQuantTransform[iOrigColorQuantSpace][iNewColorQuantSpace];
+
+    if (!table) {
+        throw COL_STRUCT_BUILD_TRANSFORM_TABLE_ERROR;
+    }
+
+    return table[iOrig];
+}
+
+int ColorStructureConversion::QuantAmplNonLinear(double value) {
+    int iQuant;
+    int nTotalLevels = 0;
+
+    // Calculate total levels
+    for (iQuant = 0; iQuant < NUM_AMPL_REGIONS; iQuant++) {
+        nTotalLevels += nAmplLevels[iQuant];
+    }
+
+    /* (KK) replace 'assert(val >= 0.0); assert(val <= 1.0);' with exception: */
+    if (value < 0.0 || value > 1.0) {
+        throw COL_STRUCT_QUANTAMPL_NOLINEAR_NORMALIZE_ERROR;
+    }
+
+    // Find quantization boundary and base value
+    int quantValue = 0;
+    for (iQuant = 0; iQuant + 1 < NUM_AMPL_REGIONS; iQuant++) {
+        if (value < amplThresh[iQuant + 1]) {
+            break;
+        }
+        quantValue += nAmplLevels[iQuant];
+    }
+
+    // Quantize
+    const double nextThresh = (iQuant + 1 < NUM_AMPL_REGIONS) ? amplThresh[iQuant + 1] : 1.0;
+
+    value = floor(quantValue + (value - amplThresh[iQuant]) * (nAmplLevels[iQuant] / (nextThresh - amplThresh[iQuant])));
+
+    // Limit, one bin contains all of histogram (XM)
+    if (value == nTotalLevels) {
+        value = nTotalLevels - 1;
+    }
+    /* (KK) replace 'assert(val >= 0.0); assert(val < nTotalLevels);' with exception */
+    if (value < 0.0 || value >= nTotalLevels) {
+        throw COL_STRUCT_QUANTAMPL_NONLINEAR_TOTAL_LEVELS;
+    }
+
+    return static_cast<int>(value);
+}
+
+double ColorStructureConversion::DequantAmplNonLinear(const int level) {
+    // Level 0 is reserved for empty bins, they have to stay empty after accumulation
+    if (level <= 0) {
+        return 0.0;
+    }
+
+    int quantValue = 0;
+
+    for (int iQuant = 0; iQuant < NUM_AMPL_REGIONS; iQuant++) {
+        if (level < quantValue + nAmplLevels[iQuant]) {
+            const double nextThresh = (iQuant + 1 < NUM_AMPL_REGIONS) ? amplThresh[iQuant + 1] : 1.0;
+            return amplThresh[iQuant] + (level - quantValue + 0.5) * (nextThresh - amplThresh[iQuant]) / nAmplLevels[iQuant];
+        }
+        quantValue += nAmplLevels[iQuant];
+    }
+    return 1.0;
+}
+
+void ColorStructureConversion::Convert(ColorStructure * descriptor, const unsigned long targetSize, unsigned char * values) {
+    const unsigned long size = descriptor->GetSize();
+
+    if (targetSize > size) {
+        throw COL_STRUCT_UNIFYBINS_ERROR;
+    }
+
+    const int iOrigSpace = GetColorQuantSpace(static_cast<int>(size));
+    const int iTargSpace = GetColorQuantSpace(static_cast<int>(targetSize));
+
+    // Same size - values are copied without requantization
+    if (iOrigSpace == iTargSpace) {
+        for (unsigned long i = 0; i < size; i++) {
+            values[i] = static_cast<unsigned char>(descriptor->GetElement(i));
+        }
+        return;
+    }
+
+    double amplitudes[BASE_QUANT_SPACE] = { 0.0 };
+
+    for (unsigned long i = 0; i < size; i++) {
+        amplitudes[TransformBinIndex(static_cast<int>(i), iOrigSpace, iTargSpace)] += DequantAmplNonLinear(static_cast<int>(descriptor->GetElement(i)));
+    }
+
+    // Clip and quantize
+    for (unsigned long i = 0; i < targetSize; i++) {
+        values[i] = static_cast<unsigned char>(QuantAmplNonLinear(std::min(amplitudes[i], 1.0)));
+    }
+}
+
+void ColorStructureConversion::Convert(ColorStructure * descriptor, const unsigned long targetSize) {
+    unsigned char values[BASE_QUANT_SPACE];
+
+    Convert(descriptor, targetSize, values);
+
+    descriptor->SetSize(targetSize);
+
+    for (unsigned long i = 0; i < targetSize; i++) {
+        descriptor->SetElement(i, values[i]);
+    }
+}
+
+const unsigned char ColorStructureConversion::cqt256_128[256] = {
+    0,   1,   2,   3,   0,   1,   2,   3,   4,   5,   6,   7,   4,   5,   6,   7,
+    8,   9,   10,  11,   8,   9,  10,  11,  12,  13,  14,  15,  12,  13,  14,  15,
+    16,  17,  18,  19,  16,  17,  18,  19,  20,  21,  22,  23,  20,  21,  22,  23,
+    24,  25,  26,  27,  24,  25,  26,  27,  28,  29,  30,  31,  28,  29,  30,  31,
+    32,  33,  34,  35,  32,  33,  34,  35,  36,  37,  38,  39,  36,  37,  38,  39,
+    40,  41,  42,  43,  40,  41,  42,  43,  44,  45,  46,  47,  44,  45,  46,  47,
+    48,  49,  50,  51,  48,  49,  50,  51,  52,  53,  54,  55,  52,  53,  54,  55,
+    56,  57,  58,  59,  56,  57,  58,  59,  60,  61,  62,  63,  60,  61,  62,  63,
+    64,  65,  66,  67,  64,  65,  66,  67,  68,  69,  70,  71,  68,  69,  70,  71,
+    72,  73,  74,  75,  72,  73,  74,  75,  76,  77,  78,  79,  76,  77,  78,  79,
+    80,  81,  82,  83,  80,  81,  82,  83,  84,  85,  86,  87,  84,  85,  86,  87,
+    88,  89,  90,  91,  88,  89,  90,  91,  92,  93,  94,  95,  92,  93,  94,  95,
+    96,  96,  97,  97,  98,  98,  99,  99,  100, 100, 101, 101, 102, 102, 103, 103,
+    104, 104, 105, 105, 106, 106, 107, 107, 108, 108, 109, 109, 110, 110, 111, 111,
+    112, 112, 113, 113, 114, 114, 115, 115, 116, 116, 117, 117, 118, 118, 119, 119,
+    120, 120, 121, 121, 122, 122, 123, 123, 124, 124, 125, 125, 126, 126, 127, 127 };
+
+const unsigned char ColorStructureConversion::cqt256_064[256] = {
+    0,  0,  0,  0,  0,  0,  0,  0,  1,  1,  1,  1,  1,  1,  1,  1,
+    2,  2,  2,  2,  2,  2,  2,  2,  3,  3,  3,  3,  3,  3,  3,  3,
+    4,  4,  4,  4,  4,  4,  4,  4,  5,  5,  5,  5,  5,  5,  5,  5,
+    6,  6,  6,  6,  6,  6,  6,  6,  7,  7,  7,  7,  7,  7,  7,  7,
+    8,  8,  9,  9,  8,  8,  9,  9,  10, 10, 11, 11, 10, 10, 11, 11,
+    12, 12, 13, 13, 12, 12, 13, 13, 14, 14, 15, 15, 14, 14, 15, 15,
+    16, 16, 17, 17, 16, 16, 17, 17, 18, 18, 19, 19, 18, 18, 19, 19,
+    20, 20, 21, 21, 20, 20, 21, 21, 22, 22, 23, 23, 22, 22, 23, 23,
+    24, 25, 26, 27, 24, 25, 26, 27, 24, 25, 26, 27, 24, 25, 26, 27,
+    28, 29, 30, 31, 28, 29, 30, 31, 28, 29, 30, 31, 28, 29, 30, 31,
+    32, 33, 34, 35, 32, 33, 34, 35, 32, 33, 34, 35, 32, 33, 34, 35,
+    36, 37, 38, 39, 36, 37, 38, 39, 36, 37, 38, 39, 36, 37, 38, 39,
+    40, 40, 41, 41, 42, 42, 43, 43, 44, 44, 45, 45, 46, 46, 47, 47,
+    48, 48, 49, 49, 50, 50, 51, 51, 52, 52, 53, 53, 54, 54, 55, 55,
+    56, 56, 56, 56, 57, 57, 57, 57, 58, 58, 58, 58, 59, 59, 59, 59,
+    60, 60, 60, 60, 61, 61, 61, 61, 62, 62, 62, 62, 63, 63, 63, 63 };
+
+const unsigned char ColorStructureConversion::cqt256_032[256] = {
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+    2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,
+    3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,
+    4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+    5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,
+    6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,
+    7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+    8,  9, 10, 11,  8,  9,  10, 11, 8,  9,  10, 11, 8,  9,  10, 11,
+    12, 13, 14, 15, 12, 13, 14, 15, 12, 13, 14, 15, 12, 13, 14, 15,
+    16, 17, 18, 19, 16, 17, 18, 19, 16, 17, 18, 19, 16, 17, 18, 19,
+    20, 21, 22, 23, 20, 21, 22, 23, 20, 21, 22, 23, 20, 21, 22, 23,
+    8,  8,  9,  9,  10, 10, 11, 11, 12, 12, 13, 13, 14, 14, 15, 15,
+    16, 16, 17, 17, 18, 18, 19, 19, 20, 20, 21, 21, 22, 22, 23, 23,
+    24, 24, 24, 24, 25, 25, 25, 25, 26, 26, 26, 26, 27, 27, 27, 27,
+    28, 28, 28, 28, 29, 29, 29, 29, 30, 30, 30, 30, 31, 31, 31, 31 };
+
+const unsigned char ColorStructureConversion::cqt128_064[128] = {
+    0,  0,  0,  0,  1,  1,  1,  1,  2,  2,  2,  2,  3,  3,  3,  3,
+    4,  4,  4,  4,  5,  5,  5,  5,  6,  6,  6,  6,  7,  7,  7,  7,
+    8,  8,  9,  9,  10, 10, 11, 11, 12, 12, 13, 13, 14, 14, 15, 15,
+    16, 16, 17, 17, 18, 18, 19, 19, 20, 20, 21, 21, 22, 22, 23, 23,
+    24, 25, 26, 27, 24, 25, 26, 27, 28, 29, 30, 31, 28, 29, 30, 31,
+    32, 33, 34, 35, 32, 33, 34, 35, 36, 37, 38, 39, 36, 37, 38, 39,
+    40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55,
+    56, 56, 57, 57, 58, 58, 59, 59, 60, 60, 61, 61, 62, 62, 63, 63 };
+
+const unsigned char ColorStructureConversion::cqt128_032[128] = {
+    0,  0,  0,  0,  0,  0,  0,  0,  1,  1,  1,  1,  1,  1,  1,  1,
+    2,  2,  2,  2,  2,  2,  2,  2,  3,  3,  3,  3,  3,  3,  3,  3,
+    4,  4,  4,  4,  4,  4,  4,  4,  5,  5,  5,  5,  5,  5,  5,  5,
+    6,  6,  6,  6,  6,  6,  6,  6,  7,  7,  7,  7,  7,  7,  7,  7,
+    8,  9,  10, 11, 8,  9,  10, 11, 12, 13, 14, 15, 12, 13, 14, 15,
+    16, 17, 18, 19, 16, 17, 18, 19, 20, 21, 22, 23, 20, 21, 22, 23,
+    8,  9,  10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23,
+    24, 24, 25, 25, 26, 26, 27, 27, 28, 28, 29, 29, 30, 30, 31, 31 };
+
+const unsigned char ColorStructureConversion::cqt064_032[64] = {
+    0,  0,  1,  1,  2,  2,  3,  3,  4,  4,  4,  4,  5,  5,  5,  5,
+    6,  6,  6,  6,  7,  7,  7,  7,  8,  9,  10, 11, 12, 13, 14, 15,
+    16, 17, 18, 19, 20, 21, 22, 23, 8,  9,  10, 11, 12, 13, 14, 15,
+    16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31 };
+
+const unsigned char * const ColorStructureConversion::colorQuantTransform[NUM_COLOR_QUANT_SPACE][NUM_COLOR_QUANT_SPACE] = {
+    { nullptr,		  nullptr,		  nullptr,		  nullptr },
+    { cqt064_032, nullptr,		  nullptr,		  nullptr },
+    { cqt128_032, cqt128_064, nullptr,		  nullptr },
+    { cqt256_032, cqt256_064, cqt256_128, nullptr } };
+
+const double ColorStructureConversion::amplThresh[NUM_AMPL_REGIONS] = { 0.0, 0.000000000001, 0.037, 0.08, 0.195, 0.32 };
+
+const int ColorStructureConversion::nAmplLevels[NUM_AMPL_REGIONS] = { 1, 25, 20, 35, 35, 140 };
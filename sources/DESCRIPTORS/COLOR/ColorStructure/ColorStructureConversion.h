@@ -0,0 +1,63 @@
+/** @file   ColorStructureConversion.h
+ *  @brief  Color Structure bin size conversion shared by extraction,
+ *          distance calculation and search.
+ *
+ *          All supported bin size transforms (256/128/64 down to any smaller size)
+ *          are constant tables compiled into the library, so no transform table
+ *          is built at run time and conversion is safe to use from many threads.
+ *          Conversion to a larger bin count is not defined by the standard
+ *          and is rejected.
+ *
+ *          Stored descriptors hold non-linearly quantized amplitudes,
+ *          so converting them dequantizes every bin to the middle of its
+ *          amplitude interval, accumulates bins mapped to the same target bin,
+ *          clips to 1.0 and quantizes the result again (as UnifyBins and
+ *          QuantAmplNonLinear do during extraction).
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include "ColorStructure.h"
+
+#define	BASE_QUANT_SPACE       256
+#define	BASE_QUANT_SPACE_INDEX 3
+#define NUM_COLOR_QUANT_SPACE  4
+#define NUM_AMPL_REGIONS       6
+#define NUM_AMPL_LEVELS        256
+
+class ColorStructureConversion {
+    private:
+        static const unsigned char cqt256_128[256];
+        static const unsigned char cqt256_064[256];
+        static const unsigned char cqt256_032[256];
+        static const unsigned char cqt128_064[128];
+        static const unsigned char cqt128_032[128];
+        static const unsigned char cqt064_032[64];
+
+        static const unsigned char * const colorQuantTransform[NUM_COLOR_QUANT_SPACE][NUM_COLOR_QUANT_SPACE];
+
+        static const double amplThresh[NUM_AMPL_REGIONS];
+        static const int nAmplLevels[NUM_AMPL_REGIONS];
+
+    public:
+        static int GetColorQuantSpace(int size);
+        static int GetBinSize(int iColorQuantSpace);
+        static int TransformBinIndex(int iOrig, int iOrigColorQuantSpace, int iNewColorQuantSpace);
+
+        /** @brief
+        * Quantizes normalized bin amplitude (0.0 - 1.0) to one of NUM_AMPL_LEVELS levels */
+        static int QuantAmplNonLinear(double value);
+        /** @brief
+        * Returns normalized amplitude in the middle of quantization level interval */
+        static double DequantAmplNonLinear(int level);
+
+        /** @brief
+        * Converts descriptor values to smaller (or equal) bin count
+        * @param descriptor - source descriptor
+        * @param targetSize - 32, 64, 128 or 256, not larger than descriptor size
+        * @param values - output array of targetSize quantized amplitudes */
+        static void Convert(ColorStructure * descriptor, unsigned long targetSize, unsigned char * values);
+        static void Convert(ColorStructure * descriptor, unsigned long targetSize);
+};
@@ -1,14 +1,34 @@
 #include "ColorStructureDistance.h"
 
+#include <algorithm>
+
 ColorStructureDistance::ColorStructureDistance() = default;
 
 double ColorStructureDistance::getDistance(Descriptor * descriptor1, Descriptor * descriptor2, const char ** params) {
     const auto colorStructureDescriptor1 = static_cast<ColorStructure *>(descriptor1);
     const auto colorStructureDescriptor2 = static_cast<ColorStructure *>(descriptor2);
 
-    // Check size equality
+    // Descriptors extracted with different ColorQuantSize are compared in the smaller bin space
     if (colorStructureDescriptor1->GetSize() != colorStructureDescriptor2->GetSize()) {
-        throw COL_STRUCT_DISTANCE_SIZE_ERROR;
+        const unsigned long size = std::min(colorStructureDescriptor1->GetSize(), colorStructureDescriptor2->GetSize());
+
+        unsigned char values1[BASE_QUANT_SPACE];
+        unsigned char values2[BASE_QUANT_SPACE];
+
+        try {
+            ColorStructureConversion::Convert(colorStructureDescriptor1, size, values1);
+            ColorStructureConversion::Convert(colorStructureDescriptor2, size, values2);
+        }
+        catch (ErrorCode exception) {
+            throw COL_STRUCT_DISTANCE_SIZE_ERROR;
+        }
+
+        double L1error = 0.0;
+
+        for (unsigned long i = 0; i < size; i++) {
+            L1error += fabs(values1[i] / 255.0 - values2[i] / 255.0);
+        }
+        return L1error;
     }
 
     // Calculate the distance
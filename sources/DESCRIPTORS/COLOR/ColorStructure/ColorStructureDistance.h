@@ -7,6 +7,7 @@
 
 #include "../../DescriptorDistance.h"
 #include "../ColorStructure/ColorStructure.h"
+#include "../ColorStructure/ColorStructureConversion.h"
 
 class ColorStructureDistance : public DescriptorDistance {
     public:
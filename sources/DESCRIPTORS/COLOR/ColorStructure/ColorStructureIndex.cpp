@@ -0,0 +1,133 @@
+#include "ColorStructureIndex.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CSD_SIMD_SSE2
+#endif
+
+ColorStructureIndex::ColorStructureIndex(const unsigned long targetSize) : targetSize(targetSize) {
+    // Throws for unsupported sizes
+    ColorStructureConversion::GetColorQuantSpace(static_cast<int>(targetSize));
+}
+
+unsigned long ColorStructureIndex::getTargetSize() {
+    return targetSize;
+}
+
+void ColorStructureIndex::reserve(const unsigned long size) {
+    references.reserve(size * targetSize);
+}
+
+unsigned long ColorStructureIndex::add(ColorStructure * descriptor) {
+    if (descriptor->GetSize() < targetSize) {
+        throw COL_STRUCT_DISTANCE_SIZE_ERROR;
+    }
+
+    references.resize(references.size() + targetSize);
+    ColorStructureConversion::Convert(descriptor, targetSize, &references[count * targetSize]);
+
+    return count++;
+}
+
+unsigned long ColorStructureIndex::size() {
+    return count;
+}
+
+void ColorStructureIndex::clear() {
+    references.clear();
+    count = 0;
+}
+
+const unsigned char * ColorStructureIndex::getReference(const unsigned long id) {
+    return id < count ? &references[id * targetSize] : nullptr;
+}
+
+unsigned long ColorStructureIndex::distance(const unsigned char * values1, const unsigned char * values2, const unsigned long length) {
+#ifdef CSD_SIMD_SSE2
+    // Bin counts are multiples of 32, so every row is made of whole 16 byte blocks
+    __m128i sum = _mm_setzero_si128();
+
+    for (unsigned long i = 0; i < length; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values1 + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values2 + i));
+        sum = _mm_add_epi64(sum, _mm_sad_epu8(a, b));
+    }
+
+    return static_cast<unsigned long>(_mm_cvtsi128_si32(sum)) + static_cast<unsigned long>(_mm_cvtsi128_si32(_mm_srli_si128(sum, 8)));
+#else
+    unsigned long sum = 0;
+
+    for (unsigned long i = 0; i < length; i++) {
+        sum += values1[i] > values2[i] ? values1[i] - values2[i] : values2[i] - values1[i];
+    }
+    return sum;
+#endif
+}
+
+void ColorStructureIndex::getDistances(ColorStructure * query, float * distances) {
+    if (query->GetSize() < targetSize) {
+        throw COL_STRUCT_DISTANCE_SIZE_ERROR;
+    }
+
+    unsigned char queryValues[BASE_QUANT_SPACE];
+    ColorStructureConversion::Convert(query, targetSize, queryValues);
+
+    const unsigned char * reference = references.data();
+
+    for (unsigned long i = 0; i < count; i++, reference += targetSize) {
+        distances[i] = static_cast<float>(distance(queryValues, reference, targetSize) / 255.0);
+    }
+}
+
+std::vector<std::pair<unsigned long, float>> ColorStructureIndex::search(ColorStructure * query, unsigned long k) {
+    std::vector<std::pair<unsigned long, float>> result;
+
+    if (query->GetSize() < targetSize) {
+        throw COL_STRUCT_DISTANCE_SIZE_ERROR;
+    }
+
+    if (k == 0 || count == 0) {
+        return result;
+    }
+    k = std::min(k, count);
+
+    unsigned char queryValues[BASE_QUANT_SPACE];
+    ColorStructureConversion::Convert(query, targetSize, queryValues);
+
+    // Max-heap on distance, holding the k best references found so far
+    // (integer sums are compared, they are scaled only for the result)
+    const auto farther = [](const std::pair<unsigned long, unsigned long> & a, const std::pair<unsigned long, unsigned long> & b) {
+        return a.second < b.second;
+    };
+
+    std::vector<std::pair<unsigned long, unsigned long>> heap;
+    heap.reserve(k);
+
+    const unsigned char * reference = references.data();
+
+    for (unsigned long i = 0; i < count; i++, reference += targetSize) {
+        const unsigned long d = distance(queryValues, reference, targetSize);
+
+        if (heap.size() < k) {
+            heap.emplace_back(i, d);
+            std::push_heap(heap.begin(), heap.end(), farther);
+        }
+        else if (d < heap.front().second) {
+            std::pop_heap(heap.begin(), heap.end(), farther);
+            heap.back() = std::make_pair(i, d);
+            std::push_heap(heap.begin(), heap.end(), farther);
+        }
+    }
+
+    std::sort_heap(heap.begin(), heap.end(), farther);
+
+    result.reserve(heap.size());
+    for (const auto & item : heap) {
+        result.emplace_back(item.first, static_cast<float>(item.second / 255.0));
+    }
+    return result;
+}
+
+ColorStructureIndex::~ColorStructureIndex() = default;
@@ -0,0 +1,59 @@
+/** @file   ColorStructureIndex.h
+ *  @brief  Color Structure search layout for scanning many reference descriptors.
+ *
+ *          All references are normalized on ingest to one bin count given
+ *          at construction (see ColorStructureConversion), and stored as rows of
+ *          quantized amplitude bytes. Queries extracted with larger ColorQuantSize
+ *          are converted once, then compared with every row by a byte L1 kernel.
+ *
+ *          Distances are equal to ColorStructureDistance::getDistance.
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "ColorStructure.h"
+#include "ColorStructureConversion.h"
+
+class ColorStructureIndex {
+    private:
+        unsigned long targetSize;
+        std::vector<unsigned char> references;
+        unsigned long count = 0;
+
+    public:
+        /** @brief
+        * @param targetSize - bin count of stored descriptors (32, 64, 128 or 256) */
+        explicit ColorStructureIndex(unsigned long targetSize);
+
+        unsigned long getTargetSize();
+
+        void reserve(unsigned long size);
+        unsigned long add(ColorStructure * descriptor);
+        unsigned long size();
+        void clear();
+
+        const unsigned char * getReference(unsigned long id);
+
+        /** @brief
+        * Computes L1 distance between query and every reference
+        * @param query - query descriptor, with at least getTargetSize() bins
+        * @param distances - output array of size() elements */
+        void getDistances(ColorStructure * query, float * distances);
+
+        /** @brief
+        * Finds k nearest references to query
+        * @return vector of (reference id, distance) pairs sorted by ascending distance */
+        std::vector<std::pair<unsigned long, float>> search(ColorStructure * query, unsigned long k);
+
+        /** @brief
+        * Sum of absolute differences of two rows of quantized amplitudes
+        * @param length - row length, multiple of 16 */
+        static unsigned long distance(const unsigned char * values1, const unsigned char * values2, unsigned long length);
+
+        ~ColorStructureIndex();
+};
@@ -200,73 +200,41 @@ void DominantColor::readFromXML(XMLElement * descriptorElement) {
     }
 }
 
-std::string DominantColor::generateXML() {
-	XMLDocument xmlDoc;
-
-	XMLDeclaration * p_Declaration  = xmlDoc.NewDeclaration("xml version='1.0' encoding='ISO-8859-1' ");
-	XMLElement * p_Root		        = xmlDoc.NewElement("Mpeg7");
-	XMLElement * p_DescriptionUnit  = xmlDoc.NewElement("DescriptionUnit");
-	XMLElement * p_Descriptor		= xmlDoc.NewElement("Descriptor");
-	XMLElement * p_SpatialCoherency	= nullptr;
-
-	p_Root->SetAttribute("xmlns", "urn:mpeg:mpeg7:schema:2001");
-	p_Root->SetAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
-	p_DescriptionUnit->SetAttribute("xsi:type", "DescriptorCollectionType");
-	p_Descriptor->SetAttribute("xsi:type", "DominantColorType");
-
-	p_Root->InsertEndChild(p_DescriptionUnit);
-	p_DescriptionUnit->InsertEndChild(p_Descriptor);
-
-	p_SpatialCoherency = xmlDoc.NewElement("SpatialCoherency");
+void DominantColor::writeXML(XMLWriter & writer) {
+	beginXML(writer, "DominantColorType");
 
 	if (spatialCoherencyPresent) {
-		p_SpatialCoherency->SetText(spatialCoherencyValue);
+		writer.textElement("SpatialCoherency", spatialCoherencyValue);
 	}
 	else {
-		p_SpatialCoherency->SetText(0);
+		writer.textElement("SpatialCoherency", 0);
 	}
-    
-	p_Descriptor->InsertEndChild(p_SpatialCoherency);
-
-	std::vector<XMLElement *> p_Values(resultDescriptorSize, nullptr);
-	std::vector<XMLElement *> p_ValuesPercentages(resultDescriptorSize, nullptr);
-	std::vector<XMLElement *> p_ValuesColorValueIndices(resultDescriptorSize, nullptr);
-	std::vector<XMLElement *> p_ValuesColorVariances(resultDescriptorSize, nullptr);
 
 	for (int i = 0; i < resultDescriptorSize; i++) {
-		p_Values[i]					 = xmlDoc.NewElement("Value");
-		p_ValuesPercentages[i]		 = xmlDoc.NewElement("Percentage");
-		p_ValuesColorValueIndices[i] = xmlDoc.NewElement("Index");
-		p_ValuesColorVariances[i]    = xmlDoc.NewElement("ColorVariance");
-
-		p_ValuesPercentages[i]->SetText(std::to_string(resultPercentages[i]).c_str());
-
-		std::string colorValueIndex(std::to_string(resultDominantColors[i][0]) + " " +
-								    std::to_string(resultDominantColors[i][1]) + " " +
-								    std::to_string(resultDominantColors[i][2]));
+		writer.openElement("Value");
+		writer.textElement("Percentage", resultPercentages[i]);
 
-		p_ValuesColorValueIndices[i]->SetText(colorValueIndex.c_str());
-
-		p_Values[i]->InsertEndChild(p_ValuesPercentages[i]);
-		p_Values[i]->InsertEndChild(p_ValuesColorValueIndices[i]);
+		writer.openElement("Index");
+		writer.text(resultDominantColors[i][0]);
+		writer.text(" ");
+		writer.text(resultDominantColors[i][1]);
+		writer.text(" ");
+		writer.text(resultDominantColors[i][2]);
+		writer.closeElement();
 
 		if (variancePresent) {
-			std::string colorVariance(std::to_string(resultColorVariances[i][0]) + " " +
-				                      std::to_string(resultColorVariances[i][1]) + " " +
-				                      std::to_string(resultColorVariances[i][2]));
-
-			p_ValuesColorVariances[i]->SetText(colorVariance.c_str());
-			p_Values[i]->InsertEndChild(p_ValuesColorVariances[i]);
+			writer.openElement("ColorVariance");
+			writer.text(resultColorVariances[i][0]);
+			writer.text(" ");
+			writer.text(resultColorVariances[i][1]);
+			writer.text(" ");
+			writer.text(resultColorVariances[i][2]);
+			writer.closeElement();
 		}
-		p_Descriptor->InsertEndChild(p_Values[i]);
+		writer.closeElement();
 	}
 
-	xmlDoc.InsertFirstChild(p_Declaration);
-	xmlDoc.InsertEndChild(p_Root);
-
-	XMLPrinter xmlPrinter;
-	xmlDoc.Accept(&xmlPrinter);
-	return xmlPrinter.CStr();
+	endXML(writer);
 }
 
 bool DominantColor::getVariancePresent() {
@@ -282,6 +250,9 @@ void DominantColor::setResultDescriptorSize(const unsigned char size) {
 }
 
 void DominantColor::allocateResultArrays(const int size) {
+    // Arrays of previous extraction (descriptor kept by reused extractor) are released first
+    releaseResultArrays();
+
     resultDominantColors = new int * [3 * size];
     resultColorVariances = new int * [3 * size];
     resultPercentages    = new int   [size]; 
@@ -319,9 +290,97 @@ unsigned char DominantColor::getResultDescriptorSize() {
     return resultDescriptorSize;
 }
 
+unsigned long DominantColor::getBinarySize() {
+    return 3 + resultDescriptorSize * (variancePresent ? 7 : 4);
+}
+
+void DominantColor::writeBinary(unsigned char * buffer) {
+    // Spatial coherency is a quantized integer value, 0 means not present (as in XML)
+    const long coherency = spatialCoherencyPresent ? static_cast<long>(spatialCoherencyValue) : 0;
+
+    if (coherency != (spatialCoherencyPresent ? spatialCoherencyValue : 0.0f)) {
+        throw BINARY_VALUE_ERROR;
+    }
+
+    DescriptorBinary::writeUInt8(buffer, variancePresent ? 1 : 0);
+    DescriptorBinary::writeUInt8(buffer + 1, coherency);
+    DescriptorBinary::writeUInt8(buffer + 2, resultDescriptorSize);
+
+    unsigned char * value = buffer + 3;
+
+    for (int i = 0; i < resultDescriptorSize; i++) {
+        DescriptorBinary::writeUInt8(value++, resultPercentages[i]);
+
+        for (int j = 0; j < 3; j++) {
+            DescriptorBinary::writeUInt8(value++, resultDominantColors[i][j]);
+        }
+
+        if (variancePresent) {
+            for (int j = 0; j < 3; j++) {
+                DescriptorBinary::writeUInt8(value++, resultColorVariances[i][j]);
+            }
+        }
+    }
+}
+
+void DominantColor::readFromBinary(const unsigned char * buffer, const unsigned long size) {
+    if (size < 3) {
+        throw BINARY_SIZE_ERROR;
+    }
+
+    if (buffer[0] > 1) {
+        throw BINARY_VALUE_ERROR;
+    }
+
+    variancePresent         = buffer[0] == 1;
+    spatialCoherencyPresent = buffer[1] != 0;
+    spatialCoherencyValue   = buffer[1];
+    resultDescriptorSize    = buffer[2];
+
+    DescriptorBinary::checkSize(size, getBinarySize());
+
+    // Allocate arrays the same way as readFromXML does
+    resultDominantColors = new int * [resultDescriptorSize];
+
+    for (int i = 0; i < resultDescriptorSize; i++) {
+        resultDominantColors[i] = new int[3];
+    }
+
+    if (variancePresent) {
+        resultColorVariances = new int * [resultDescriptorSize];
+
+        for (int i = 0; i < resultDescriptorSize; i++) {
+            resultColorVariances[i] = new int[3];
+        }
+    }
+
+    resultPercentages = new int[resultDescriptorSize];
+
+    const unsigned char * value = buffer + 3;
+
+    for (int i = 0; i < resultDescriptorSize; i++) {
+        resultPercentages[i] = *value++;
+
+        for (int j = 0; j < 3; j++) {
+            resultDominantColors[i][j] = *value++;
+        }
+
+        if (variancePresent) {
+            for (int j = 0; j < 3; j++) {
+                resultColorVariances[i][j] = *value++;
+            }
+        }
+    }
+}
+
 DominantColor::~DominantColor() {
+    releaseResultArrays();
+}
+
+void DominantColor::releaseResultArrays() {
     if (resultPercentages) {
         delete[] resultPercentages;
+        resultPercentages = nullptr;
     }
 
     if (resultDominantColors) {
@@ -329,6 +388,7 @@ DominantColor::~DominantColor() {
             delete[] resultDominantColors[i];
         }
         delete[] resultDominantColors;
+        resultDominantColors = nullptr;
     }
 
     if (resultColorVariances) {
@@ -336,5 +396,6 @@ DominantColor::~DominantColor() {
             delete[] resultColorVariances[i];
         }
         delete[] resultColorVariances;
+        resultColorVariances = nullptr;
     }
-}
\ No newline at end of file
+}
@@ -23,12 +23,17 @@ class DominantColor : public Descriptor {
         int ** resultColorVariances = nullptr;  // dominant colors variances array
         int * resultPercentages     = nullptr;	 // dominant colors percents array
 		float spatialCoherencyValue;		 // spatial coherency value
+
+        void releaseResultArrays();
 	public:
         DominantColor();
 
         void loadParameters(const char ** params);
 		void readFromXML(XMLElement * descriptorElement);
-        std::string generateXML();
+        void writeXML(XMLWriter & writer);
+        unsigned long getBinarySize();
+        void writeBinary(unsigned char * buffer);
+        void readFromBinary(const unsigned char * buffer, unsigned long size);
 
         bool getVariancePresent();
         bool getSpatialCoherencyPresent();
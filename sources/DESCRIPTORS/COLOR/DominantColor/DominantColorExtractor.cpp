@@ -1,30 +1,37 @@
 #include "DominantColorExtractor.h"
+#include "../../../TOOLS/Trace/Trace.h"
 
 DominantColorExtractor::DominantColorExtractor(): currentColorNumber(0) {
     descriptor = new DominantColor();
 }
 
 Descriptor * DominantColorExtractor::extract(Image & image, const char ** params) {
+    TRACE_SCOPE("DominantColorExtractor::extract");
+
     descriptor->loadParameters(params);
 
     // Get image information
     const int imageWidth     = image.getWidth();
     const int imageHeight    = image.getHeight();
     const int imageSize      = image.getSize();
-    const int imageTotalSize = image.getTotalSize();
     const bool transparencyPresent = image.getTransparencyPresent();
 
     const float agglomeratingFactor = DSTMIN;
     const float splittingFactor     = SPLITTING_FACTOR;
 
-    dominantColorWeights    = new float[DESCRIPTOR_SIZE];
-    dominantColorCentroids  = new float * [DESCRIPTOR_SIZE];
-    dominantColorsVariances = new float * [DESCRIPTOR_SIZE];
+    // Cluster arrays are allocated once and cleared for every extraction
+    if (dominantColorWeights == nullptr) {
+        dominantColorWeights    = new float[DESCRIPTOR_SIZE];
+        dominantColorCentroids  = new float * [DESCRIPTOR_SIZE];
+        dominantColorsVariances = new float * [DESCRIPTOR_SIZE];
 
-    for (int k = 0; k < DESCRIPTOR_SIZE; k++) {
-        dominantColorCentroids[k] = new float[3];
-        dominantColorsVariances[k] = new float[3];
+        for (int k = 0; k < DESCRIPTOR_SIZE; k++) {
+            dominantColorCentroids[k]  = new float[3];
+            dominantColorsVariances[k] = new float[3];
+        }
+    }
 
+    for (int k = 0; k < DESCRIPTOR_SIZE; k++) {
         dominantColorWeights[k] = 0.0;
 
         dominantColorCentroids[k][0] = 0.0;
@@ -36,12 +43,9 @@ Descriptor * DominantColorExtractor::extract(Image & image, const char ** params
         dominantColorsVariances[k][2] = 0.0;
     }
 
-    // Get image data and convert RGB to LUV
-    const unsigned char * RGB = image.getRGB();
-    LUV = new float[imageTotalSize]; 
+    // Convert RGB to LUV (three values per pixel, whatever number of channels the image has)
+    LUV = new float[imageSize * 3];
     rgb2luv(image, LUV);
-    delete[] RGB;
-    //rgb2luv(image, LUV);
 
     unsigned char * alphaChannelBuffer = transparencyPresent ? image.getChannel_A() : nullptr;
 
@@ -148,12 +152,18 @@ Descriptor * DominantColorExtractor::extract(Image & image, const char ** params
 
     delete[] LUV;
 
+    if (alphaChannelBuffer) {
+        delete[] alphaChannelBuffer;
+    }
+
     descriptor->setResultDescriptorSize(currentColorNumber);
 
     return descriptor;
 }
 
 double DominantColorExtractor::AssignPixelsToClusters(int * pixelsClusters, float * imageData, const int imageSize, unsigned char * alphaChannelBuffer) {
+    TRACE_SCOPE("DominantColorExtractor::AssignPixelsToClusters");
+
     /* Assign each pixel to it's cluster ISO/IEC 15938-8 4.2.3.1, 267  */
     int nearestClusterIndex;			   // index of cluster centroid nearest to pixel
     double currentDistance;				   // current distance
@@ -205,6 +215,8 @@ double DominantColorExtractor::AssignPixelsToClusters(int * pixelsClusters, floa
 }
 
 void DominantColorExtractor::RecalculateCentroids(int * pixelsClusters, float * imageData, const int imageSize, unsigned char * alphaChannelBuffer) {
+    TRACE_SCOPE("DominantColorExtractor::RecalculateCentroids");
+
     /* Calculate new color cluster centroids - as average of pixels assigned for them */
     int currentPixelIndex;
     int currentColorCentroid;
@@ -257,6 +269,8 @@ void DominantColorExtractor::RecalculateCentroids(int * pixelsClusters, float *
 }
 
 void DominantColorExtractor::CalculateVariances(int * pixelsClusters, float * imageData, const int imageSize, unsigned char * alphaChannelBuffer) {
+    TRACE_SCOPE("DominantColorExtractor::CalculateVariances");
+
     int i, j;
     double tmp;
     unsigned char * pAlpha;
@@ -295,6 +309,8 @@ void DominantColorExtractor::CalculateVariances(int * pixelsClusters, float * im
 }
 
 void DominantColorExtractor::Split(int * pixelsClusters, float *imageData, const int imageSize, unsigned char * alphaChannelBuffer, const double factor) {
+    TRACE_SCOPE("DominantColorExtractor::Split");
+
     /*  Splitting color clusters (KK)
     NewcolorBin1 = OldcolorBin + PerturbanceVector;
     NewcolorBin2 = OldcolorBin - PerturbanceVector; */
@@ -375,6 +391,8 @@ void DominantColorExtractor::Split(int * pixelsClusters, float *imageData, const
 }
 
 void DominantColorExtractor::Agglom(const double distthr) {
+    TRACE_SCOPE("DominantColorExtractor::Agglom");
+
     double d1, d2, d3;
     double dists[DESCRIPTOR_SIZE][DESCRIPTOR_SIZE];
     double distmin = 0.0;
@@ -648,6 +666,8 @@ void DominantColorExtractor::xyz2luv(double * XYZ, float * LUV, const int size)
 }
 
 void DominantColorExtractor::rgb2luv(Image &image, float * LUV) {
+    TRACE_SCOPE("DominantColorExtractor::rgb2luv");
+
     const auto XYZ = new double[image.getSize() * 3];
     rgb2xyz(image, XYZ);
     xyz2luv(XYZ, LUV, image.getSize() * 3);
@@ -118,57 +118,30 @@ void ScalableColor::readFromXML(XMLElement * descriptorElement) {
     }
 }
 
-std::string ScalableColor::generateXML() {
-	XMLDocument xmlDoc;
-
-	XMLDeclaration * p_Declaration = xmlDoc.NewDeclaration("xml version='1.0' encoding='ISO-8859-1' ");
-	XMLElement * p_Root = xmlDoc.NewElement("Mpeg7");
-	XMLElement * p_DescriptionUnit = xmlDoc.NewElement("DescriptionUnit");
-	XMLElement * p_Descriptor = xmlDoc.NewElement("Descriptor");
-	XMLElement * p_Coefficients = xmlDoc.NewElement("Coefficients");
-
-	p_Root->SetAttribute("xmlns", "urn:mpeg:mpeg7:schema:2001");
-	p_Root->SetAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
-	p_DescriptionUnit->SetAttribute("xsi:type", "DescriptorCollectionType");
-	p_Descriptor->SetAttribute("xsi:type", "ScalableColorType");
-
-	std::string numberOfCoefficients_string = numberOfCoefficients == 256   ? "4" :
-											  numberOfCoefficients == 128   ? "3" :
-											  numberOfCoefficients == 64    ? "2" :
-											  numberOfCoefficients == 32    ? "1" :
-											  numberOfCoefficients == 16    ? "0" : throw SCAL_COL_XML_COEFF_ERROR;
-
-	p_Descriptor->SetAttribute("NumberOfCoefficients", numberOfCoefficients_string.c_str());
-
-    std::string bitplanesDiscarded_string = numberOfBitplanesDiscarded == 0 ? "0" :
-                                            numberOfBitplanesDiscarded == 1 ? "1" :
-                                            numberOfBitplanesDiscarded == 2 ? "2" :
-                                            numberOfBitplanesDiscarded == 3 ? "3" :
-                                            numberOfBitplanesDiscarded == 4 ? "4" :
-                                            numberOfBitplanesDiscarded == 6 ? "5" :
-                                            numberOfBitplanesDiscarded == 8 ? "6" : throw SCAL_COL_XML_BITS_DISC_ERROR;
-
-	p_Descriptor->SetAttribute("NumberOfBitplanesDiscarded", bitplanesDiscarded_string.c_str());
-
-	std::string coefficients_string;
-
-	for (unsigned int i = 0; i < numberOfCoefficients; i++) {
-		coefficients_string.append(std::to_string(coefficients[i]) + " ");
-	}
-
-	p_Coefficients->SetText(coefficients_string.c_str());
-
-	xmlDoc.InsertFirstChild(p_Declaration);
-	xmlDoc.InsertEndChild(p_Root);
-
-	p_Root->InsertEndChild(p_DescriptionUnit);
-	p_DescriptionUnit->InsertEndChild(p_Descriptor);
-	p_Descriptor->InsertEndChild(p_Coefficients);
-
-	XMLPrinter xmlPrinter;
-	xmlDoc.Accept(&xmlPrinter);
-
-	return xmlPrinter.CStr();
+void ScalableColor::writeXML(XMLWriter & writer) {
+	const char * numberOfCoefficients_string = numberOfCoefficients == 256   ? "4" :
+											   numberOfCoefficients == 128   ? "3" :
+											   numberOfCoefficients == 64    ? "2" :
+											   numberOfCoefficients == 32    ? "1" :
+											   numberOfCoefficients == 16    ? "0" : throw SCAL_COL_XML_COEFF_ERROR;
+
+    const char * bitplanesDiscarded_string = numberOfBitplanesDiscarded == 0 ? "0" :
+                                             numberOfBitplanesDiscarded == 1 ? "1" :
+                                             numberOfBitplanesDiscarded == 2 ? "2" :
+                                             numberOfBitplanesDiscarded == 3 ? "3" :
+                                             numberOfBitplanesDiscarded == 4 ? "4" :
+                                             numberOfBitplanesDiscarded == 6 ? "5" :
+                                             numberOfBitplanesDiscarded == 8 ? "6" : throw SCAL_COL_XML_BITS_DISC_ERROR;
+
+	beginXML(writer, "ScalableColorType");
+	writer.attribute("NumberOfCoefficients", numberOfCoefficients_string);
+	writer.attribute("NumberOfBitplanesDiscarded", bitplanesDiscarded_string);
+
+	writer.openElement("Coefficients");
+	writer.textValues(coefficients, numberOfCoefficients);
+	writer.closeElement();
+
+	endXML(writer);
 }
 
 unsigned int ScalableColor::getNumberOfCoefficients() {
@@ -192,6 +165,8 @@ void ScalableColor::setNumberOfBitplanesDiscarded(const int bitsDisc) {
 }
 
 void ScalableColor::allocateCoefficients(const int size) {
+    // Coefficients of previous extraction (descriptor kept by reused extractor) are released first
+    delete[] coefficients;
     coefficients = new int[size];
 }
 
@@ -199,6 +174,47 @@ int * ScalableColor::getCoefficients() {
     return coefficients;
 }
 
+unsigned long ScalableColor::getBinarySize() {
+    return 3 + 2 * numberOfCoefficients;
+}
+
+void ScalableColor::writeBinary(unsigned char * buffer) {
+    DescriptorBinary::writeUInt16(buffer, numberOfCoefficients);
+    DescriptorBinary::writeUInt8(buffer + 2, numberOfBitplanesDiscarded);
+
+    for (unsigned int i = 0; i < numberOfCoefficients; i++) {
+        DescriptorBinary::writeInt16(buffer + 3 + 2 * i, coefficients[i]);
+    }
+}
+
+void ScalableColor::readFromBinary(const unsigned char * buffer, const unsigned long size) {
+    if (size < 3) {
+        throw BINARY_SIZE_ERROR;
+    }
+
+    const unsigned int coeffNum = DescriptorBinary::readUInt16(buffer);
+    const unsigned int bitsDisc = buffer[2];
+
+    if (coeffNum != 16 && coeffNum != 32 && coeffNum != 64 && coeffNum != 128 && coeffNum != 256) {
+        throw BINARY_VALUE_ERROR;
+    }
+
+    if (bitsDisc > 8 || bitsDisc == 5 || bitsDisc == 7) {
+        throw BINARY_VALUE_ERROR;
+    }
+
+    numberOfCoefficients       = coeffNum;
+    numberOfBitplanesDiscarded = bitsDisc;
+
+    DescriptorBinary::checkSize(size, getBinarySize());
+
+    coefficients = new int[numberOfCoefficients];
+
+    for (unsigned int i = 0; i < numberOfCoefficients; i++) {
+        coefficients[i] = DescriptorBinary::readInt16(buffer + 3 + 2 * i);
+    }
+}
+
 ScalableColor::~ScalableColor() {
     if (coefficients) {
         delete[] coefficients;
@@ -20,7 +20,10 @@ class ScalableColor : public Descriptor {
 
         void loadParameters(const char ** params);
         void readFromXML(XMLElement * descriptorElement);
-        std::string generateXML();
+        void writeXML(XMLWriter & writer);
+        unsigned long getBinarySize();
+        void writeBinary(unsigned char * buffer);
+        void readFromBinary(const unsigned char * buffer, unsigned long size);
 
         unsigned int getNumberOfCoefficients();
         unsigned int getNumberOfBitplanesDiscarded();
@@ -113,6 +113,9 @@ double ScalableColorDistance::getDistance(Descriptor * descriptor1, Descriptor *
         sqrerr += distance;
     }
 
+    free(histogram1);
+    free(histogram2);
+
     return sqrerr;
 }
 
@@ -1,57 +1,245 @@
 #include "ScalableColorExtractor.h"
+#include "../../../TOOLS/Trace/Trace.h"
+
+#include <algorithm>
+#include <vector>
 
 ScalableColorExtractor::ScalableColorExtractor() {
     descriptor = new ScalableColor();
 }
 
 Descriptor * ScalableColorExtractor::extract(Image & image, const char ** params) {
+    TRACE_SCOPE("ScalableColorExtractor::extract");
+
     descriptor->loadParameters(params);
 
     /* Calculate histogram in HSV color space */
-    const auto histogram = new int[256] {0};
-
-    const int imageHeight = image.getHeight();
-    const int imageWidth  = image.getWidth();
-    const int imageSize   = image.getSize();
+    unsigned long long counts[256] = {0};
 
     const unsigned char * rgb = image.getRGB();
 
+    AccumulateHistogram(rgb, image.getSize(), counts);
+
+    delete[] rgb;
+
+    return HistogramDescriptor(counts, static_cast<unsigned long long>(image.getWidth()) * image.getHeight());
+}
+
+Descriptor * ScalableColorExtractor::extract(TileSource & source, const char ** params) {
+    TRACE_SCOPE("ScalableColorExtractor::extractTiles");
+
+    descriptor->loadParameters(params);
+
+    const int sourceWidth  = source.getWidth();
+    const int sourceHeight = source.getHeight();
+    const int bandHeight   = std::max(1, std::min(source.getTileHeight(), sourceHeight));
+
+    // Histogram is sum of histograms of bands, alpha is not used (as in extraction from image)
+    unsigned long long counts[256] = {0};
+    std::vector<unsigned char> rgb(static_cast<size_t>(sourceWidth) * bandHeight * 3);
+
+    for (int top = 0; top < sourceHeight; top += bandHeight) {
+        const int rows = std::min(bandHeight, sourceHeight - top);
+
+        source.read(0, top, sourceWidth, rows, rgb.data(), nullptr);
+        AccumulateHistogram(rgb.data(), static_cast<unsigned long>(sourceWidth) * rows, counts);
+    }
+
+    return HistogramDescriptor(counts, static_cast<unsigned long long>(sourceWidth) * sourceHeight);
+}
+
+void ScalableColorExtractor::AccumulateHistogram(const unsigned char * rgb, const unsigned long pixelCount, unsigned long long * counts) {
     // Quantization parameters:
     const int hue_quant = 16;
     const int sat_quant = 4;
     const int val_quant = 4;
 
-    // test - loop over all pixels and save their value s to local file:
-    FILE * file = fopen("test.txt", "w");
-    if (file == nullptr) {
-        printf("Error opening file!\n");
-        return nullptr;
-    }
-
-    for (int i = 0; i < imageSize; i++) {
-        fprintf(file, "%d %d %d\n", rgb[3 * i], rgb[3 * i + 1], rgb[3 * i + 2]);
-    }
-
-    for (int i = 0; i < imageSize; i++) {
+    for (unsigned long i = 0; i < pixelCount; i++) {
         // Calculate quantized hsv values for current pixel
         const int * hsv_quantized = rgb2hsv(rgb[3 * i], rgb[3 * i + 1], rgb[3 * i + 2], hue_quant, sat_quant, val_quant);
 
         // Calculating histogram index
-        histogram[hsv_quantized[2] * 4 * 16 + hsv_quantized[1] * 16 + hsv_quantized[0]]++;
+        counts[hsv_quantized[2] * 4 * 16 + hsv_quantized[1] * 16 + hsv_quantized[0]]++;
+
+        delete hsv_quantized;
+    }
+}
+
+void ScalableColorExtractor::prepareRegions(Image & image) {
+    TRACE_SCOPE("ScalableColorExtractor::prepareRegions");
+
+    regionImageWidth  = image.getWidth();
+    regionImageHeight = image.getHeight();
+    regionBins.resize(static_cast<size_t>(regionImageWidth) * regionImageHeight);
+
+    const unsigned char * rgb = image.getRGB();
+
+    for (size_t i = 0; i < regionBins.size(); i++) {
+        const int * hsv_quantized = rgb2hsv(rgb[3 * i], rgb[3 * i + 1], rgb[3 * i + 2], 16, 4, 4);
+
+        regionBins[i] = static_cast<unsigned char>(hsv_quantized[2] * 4 * 16 + hsv_quantized[1] * 16 + hsv_quantized[0]);
 
         delete hsv_quantized;
     }
 
     delete[] rgb;
+}
+
+Descriptor * ScalableColorExtractor::extractRegion(const int x, const int y, const int width, const int height, const char ** params) {
+    TRACE_SCOPE("ScalableColorExtractor::extractRegion");
+
+    if (x < 0 || y < 0 || width <= 0 || height <= 0 || width > regionImageWidth - x || height > regionImageHeight - y) {
+        throw GRID_NOT_VALID;
+    }
+
+    descriptor->loadParameters(params);
+
+    unsigned long long counts[256] = {0};
+
+    for (int j = y; j < y + height; j++) {
+        const unsigned char * bins = &regionBins[static_cast<size_t>(j) * regionImageWidth + x];
+
+        for (int i = 0; i < width; i++) {
+            counts[bins[i]]++;
+        }
+    }
+
+    return HistogramDescriptor(counts, static_cast<unsigned long long>(width) * height);
+}
+
+void ScalableColorExtractor::beginGroup(const GroupAggregation aggregation) {
+    if (aggregation != GROUP_AVERAGE && aggregation != GROUP_MEDIAN && aggregation != GROUP_INTERSECTION) {
+        throw GROUP_AGGREGATION_NOT_SUPPORTED;
+    }
+
+    groupAggregation  = aggregation;
+    groupFrameCount   = 0;
+    groupFrameHistograms.clear();
+    std::fill(groupBinValues, groupBinValues + 256, 0.0);
+}
+
+void ScalableColorExtractor::frameBinValues(Image & image, double * binValues) {
+    unsigned long long counts[256] = {0};
+
+    const unsigned char * rgb = image.getRGB();
 
+    AccumulateHistogram(rgb, image.getSize(), counts);
+
+    delete[] rgb;
+
+    ScaleHistogram(counts, static_cast<unsigned long long>(image.getWidth()) * image.getHeight(), binValues);
+}
+
+Descriptor * ScalableColorExtractor::extractBinValues(const double * binValues, const char ** params) {
+    descriptor->loadParameters(params);
+
+    return BinValuesDescriptor(binValues);
+}
+
+void ScalableColorExtractor::addFrame(Image & image) {
+    TRACE_SCOPE("ScalableColorExtractor::addFrame");
+
+    // Histograms of frames of different size are aggregated after normalization
+    double binValues[256];
+    frameBinValues(image, binValues);
+
+    switch (groupAggregation) {
+        case GROUP_AVERAGE:
+            for (int i = 0; i < 256; i++) {
+                groupBinValues[i] += binValues[i];
+            }
+            break;
+        case GROUP_MEDIAN:
+            groupFrameHistograms.insert(groupFrameHistograms.end(), binValues, binValues + 256);
+            break;
+        case GROUP_INTERSECTION:
+            for (int i = 0; i < 256; i++) {
+                groupBinValues[i] = groupFrameCount == 0 ? binValues[i] : std::min(groupBinValues[i], binValues[i]);
+            }
+            break;
+    }
+
+    groupFrameCount++;
+}
+
+int ScalableColorExtractor::getGroupFrameCount() const {
+    return groupFrameCount;
+}
+
+Descriptor * ScalableColorExtractor::extractGroup(const char ** params) {
+    TRACE_SCOPE("ScalableColorExtractor::extractGroup");
+
+    descriptor->loadParameters(params);
+
+    if (groupFrameCount == 0) {
+        throw GROUP_EMPTY;
+    }
+
+    double binValues[256];
+
+    switch (groupAggregation) {
+        case GROUP_AVERAGE:
+            for (int i = 0; i < 256; i++) {
+                binValues[i] = groupBinValues[i] / groupFrameCount;
+            }
+            break;
+        case GROUP_MEDIAN: {
+            // Median of every bin over frames (mean of two middle values for even frame count)
+            std::vector<double> bin(static_cast<size_t>(groupFrameCount));
+            const size_t middle = bin.size() / 2;
+
+            for (int i = 0; i < 256; i++) {
+                for (int f = 0; f < groupFrameCount; f++) {
+                    bin[f] = groupFrameHistograms[static_cast<size_t>(f) * 256 + i];
+                }
+
+                std::nth_element(bin.begin(), bin.begin() + middle, bin.end());
+                binValues[i] = bin[middle];
+
+                if (bin.size() % 2 == 0) {
+                    binValues[i] = (binValues[i] + *std::max_element(bin.begin(), bin.begin() + middle)) / 2.0;
+                }
+            }
+            break;
+        }
+        case GROUP_INTERSECTION:
+            std::copy(groupBinValues, groupBinValues + 256, binValues);
+            break;
+    }
+
+    return BinValuesDescriptor(binValues);
+}
+
+Descriptor * ScalableColorExtractor::HistogramDescriptor(const unsigned long long * counts, const unsigned long long pixelCount) {
+    double binValues[256];
+
+    ScaleHistogram(counts, pixelCount, binValues);
+
+    return BinValuesDescriptor(binValues);
+}
+
+void ScalableColorExtractor::ScaleHistogram(const unsigned long long * counts, const unsigned long long pixelCount, double * binValues) {
     /* Cut to 11 bit precision */
     const int factor = 0x7ff;  // 11
-    double binaryValue;
+
+    for (int i = 0; i < 256; i++) {
+        binValues[i] = static_cast<double>(factor) * static_cast<double>(counts[i]) / static_cast<double>(pixelCount);
+    }
+}
+
+Descriptor * ScalableColorExtractor::BinValuesDescriptor(const double * binValues) {
+    const auto histogram = new int[256];
+
+    // Quantization parameters:
+    const int hue_quant = 16;
+    const int sat_quant = 4;
+    const int val_quant = 4;
+
+    const int factor = 0x7ff;  // 11 bits
     int integerBinaryValue;
 
     for (int i = 0; i < 256; i++) {
-        binaryValue = static_cast<double>(factor) * static_cast<double>(histogram[i]) / static_cast<double>(imageHeight * imageWidth);
-        integerBinaryValue = static_cast<int>(binaryValue + 0.49999);
+        integerBinaryValue = static_cast<int>(binValues[i] + 0.49999);
 
         if (integerBinaryValue > factor) {
             integerBinaryValue = factor;
@@ -213,7 +401,7 @@ Descriptor * ScalableColorExtractor::extract(Image & image, const char ** params
 
 int * ScalableColorExtractor::rgb2hsv(const int r, const int g, const int b, const int hue_quant, const int sat_quant, const int val_quant) {
     int max, min;
-    static char order;
+    char order;
     double h;
     int s, v;
 
@@ -7,6 +7,16 @@
 
 #include "../../DescriptorExtractor.h"
 #include "../ScalableColor/ScalableColor.h"
+#include "../../../TOOLS/Tile/TileSource.h"
+
+#include <vector>
+
+/** Aggregation of histograms of group of frames or pictures (GoFGoPColor of MPEG-7), applied bin by bin */
+enum GroupAggregation {
+    GROUP_AVERAGE      = 0,
+    GROUP_MEDIAN       = 1,
+    GROUP_INTERSECTION = 2  // minimum over frames, colors present in all of them
+};
 
 class ScalableColorExtractor : public DescriptorExtractor {
     private:
@@ -15,6 +25,25 @@ class ScalableColorExtractor : public DescriptorExtractor {
         // RGB -> HSV and with quantization
         int * rgb2hsv(int r, int g, int b, int hue_quant, int sat_quant, int val_quant);
 
+        // HSV histogram of pixels added to counts, descriptor of histogram of pixelCount pixels
+        void AccumulateHistogram(const unsigned char * rgb, unsigned long pixelCount, unsigned long long * counts);
+        Descriptor * HistogramDescriptor(const unsigned long long * counts, unsigned long long pixelCount);
+
+        // Histogram of pixelCount pixels scaled to 11 bits, descriptor of scaled (possibly aggregated) histogram
+        void ScaleHistogram(const unsigned long long * counts, unsigned long long pixelCount, double * binValues);
+        Descriptor * BinValuesDescriptor(const double * binValues);
+
+        // Group of frames - sums or minimums of scaled histograms (histograms of all frames for median)
+        GroupAggregation groupAggregation = GROUP_AVERAGE;
+        int groupFrameCount = 0;
+        double groupBinValues[256] = {};
+        std::vector<double> groupFrameHistograms;
+
+        // HSV histogram bins of pixels of image prepared for extraction of regions
+        std::vector<unsigned char> regionBins;
+        int regionImageWidth  = 0;
+        int regionImageHeight = 0;
+
         // LUT
         static const double H[16][16];
         static const int    tabelle[5][255];
@@ -23,5 +52,43 @@ class ScalableColorExtractor : public DescriptorExtractor {
     public:
 	    ScalableColorExtractor();
 	    Descriptor * extract(Image & image, const char ** params);
+
+        /** @brief
+        * Extraction from bands of rows read from source, histograms of bands are summed */
+        Descriptor * extract(TileSource & source, const char ** params);
+
+        /** @brief
+        * Quantizes all pixels of image into HSV histogram bins once for extraction of its regions with extractRegion */
+        void prepareRegions(Image & image);
+
+        /** @brief
+        * Extraction from width x height region at (x, y) of prepared image (the same descriptor as of cropped image),
+        * throws ErrorCode (GRID_NOT_VALID for region outside of image) */
+        Descriptor * extractRegion(int x, int y, int width, int height, const char ** params);
+
+        /** @brief
+        * Starts new group of frames (shot), frames added with addFrame are aggregated into one descriptor by extractGroup.
+        * Throws ErrorCode (GROUP_AGGREGATION_NOT_SUPPORTED) */
+        void beginGroup(GroupAggregation aggregation);
+
+        /** @brief
+        * Adds HSV histogram of frame to group, frame itself is not kept */
+        void addFrame(Image & image);
+
+        int getGroupFrameCount() const;
+
+        /** @brief
+        * Descriptor of aggregated histogram of group (the same as of single image for group of one frame),
+        * group is kept, throws ErrorCode (GROUP_EMPTY) */
+        Descriptor * extractGroup(const char ** params);
+
+        /** @brief
+        * Histogram of frame as addFrame adds it to group (256 HSV bins scaled to 11 bits) */
+        void frameBinValues(Image & image, double * binValues);
+
+        /** @brief
+        * Descriptor of histogram of 256 bins scaled to 11 bits (e.g. aggregated by caller) */
+        Descriptor * extractBinValues(const double * binValues, const char ** params);
+
         ~ScalableColorExtractor();
 };
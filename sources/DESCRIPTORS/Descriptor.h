@@ -21,6 +21,9 @@
 #include "../TOOLS/ErrorCode.h"
 #include "../TOOLS/Image/Image.h"
 #include "../TOOLS/XML/tinyxml2.h"
+#include "../TOOLS/XML/XMLWriter.h"
+
+#include "DescriptorBinary.h"
 
 using namespace tinyxml2;
 
@@ -31,12 +34,56 @@ class Descriptor {
         * @param descriptorElement - <Descriptor> element of XML data */
         virtual void readFromXML(XMLElement * descriptorElement) = 0;
         /** @brief
+        * Writes extraction XML of descriptor data
+        * @param writer - output, document is appended after its current content */
+        virtual void writeXML(XMLWriter & writer) = 0;
+        /** @brief
         * Generates extraction XML from descriptor data
         * @return std::string - created XML string */
-        virtual std::string generateXML() = 0;
+        std::string generateXML() {
+            XMLWriter writer;
+            writeXML(writer);
+            return writer.str();
+        }
+        /** @brief
+        * Size of descriptor data in binary form (see DescriptorBinary.h)
+        * @return unsigned long - record size in bytes */
+        virtual unsigned long getBinarySize() = 0;
+        /** @brief
+        * Writes descriptor data in binary form
+        * @param buffer - output of getBinarySize() bytes */
+        virtual void writeBinary(unsigned char * buffer) = 0;
+        /** @brief
+        * Reads descriptor data from its binary form
+        * @param buffer - record written by writeBinary
+        * @param size - record size in bytes */
+        virtual void readFromBinary(const unsigned char * buffer, unsigned long size) = 0;
         /** @brief
         * General destructor */
         virtual ~ Descriptor() = 0;
+
+    protected:
+        /** @brief
+        * Writes declaration and opens <Mpeg7>, <DescriptionUnit> and <Descriptor> elements,
+        * the last one is left open for its attributes and payload
+        * @param descriptorType - xsi:type of <Descriptor> element (e.g. "ColorLayoutType") */
+        static void beginXML(XMLWriter & writer, const char * descriptorType) {
+            writer.declaration("xml version='1.0' encoding='ISO-8859-1' ");
+            writer.openElement("Mpeg7");
+            writer.attribute("xmlns", "urn:mpeg:mpeg7:schema:2001");
+            writer.attribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
+            writer.openElement("DescriptionUnit");
+            writer.attribute("xsi:type", "DescriptorCollectionType");
+            writer.openElement("Descriptor");
+            writer.attribute("xsi:type", descriptorType);
+        }
+        /** @brief
+        * Closes elements opened by beginXML */
+        static void endXML(XMLWriter & writer) {
+            writer.closeElement();
+            writer.closeElement();
+            writer.closeElement();
+        }
 };
 
 inline Descriptor::~Descriptor () = default;
@@ -0,0 +1,60 @@
+#include "DescriptorBinary.h"
+
+void DescriptorBinary::writeUInt8(unsigned char * buffer, const long value) {
+    if (value < 0 || value > 0xFF) {
+        throw BINARY_VALUE_ERROR;
+    }
+    buffer[0] = static_cast<unsigned char>(value);
+}
+
+void DescriptorBinary::writeUInt16(unsigned char * buffer, const long value) {
+    if (value < 0 || value > 0xFFFF) {
+        throw BINARY_VALUE_ERROR;
+    }
+    buffer[0] = static_cast<unsigned char>(value & 0xFF);
+    buffer[1] = static_cast<unsigned char>((value >> 8) & 0xFF);
+}
+
+void DescriptorBinary::writeInt16(unsigned char * buffer, const long value) {
+    if (value < -0x8000 || value > 0x7FFF) {
+        throw BINARY_VALUE_ERROR;
+    }
+    writeUInt16(buffer, value & 0xFFFF);
+}
+
+unsigned int DescriptorBinary::readUInt16(const unsigned char * buffer) {
+    return static_cast<unsigned int>(buffer[0]) | (static_cast<unsigned int>(buffer[1]) << 8);
+}
+
+int DescriptorBinary::readInt16(const unsigned char * buffer) {
+    const int value = static_cast<int>(readUInt16(buffer));
+    return value >= 0x8000 ? value - 0x10000 : value;
+}
+
+void DescriptorBinary::checkSize(const unsigned long size, const unsigned long expected) {
+    if (size != expected) {
+        throw BINARY_SIZE_ERROR;
+    }
+}
+
+void DescriptorBinary::writeHeader(unsigned char * buffer, const DescriptorType type) {
+    buffer[0] = 'M';
+    buffer[1] = '7';
+    buffer[2] = static_cast<unsigned char>(type);
+    buffer[3] = DESCRIPTOR_BINARY_VERSION;
+}
+
+DescriptorType DescriptorBinary::readHeader(const unsigned char * buffer, const unsigned long size) {
+    if (buffer == nullptr) {
+        throw BINARY_BUFFER_NULL;
+    }
+
+    if (size < DESCRIPTOR_BINARY_HEADER_SIZE || buffer[0] != 'M' || buffer[1] != '7' || buffer[3] != DESCRIPTOR_BINARY_VERSION) {
+        throw BINARY_HEADER_ERROR;
+    }
+
+    if (buffer[2] < DOMINANT_COLOR_D || buffer[2] > CONTOUR_SHAPE_D) {
+        throw BINARY_HEADER_ERROR;
+    }
+    return static_cast<DescriptorType>(buffer[2]);
+}
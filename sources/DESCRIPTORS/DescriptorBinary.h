@@ -0,0 +1,68 @@
+/** @file   DescriptorBinary.h
+ *  @brief  Compact binary form of descriptor data.
+ *
+ *          Every descriptor can write its data as a little-endian byte record
+ *          (Descriptor::writeBinary) and read it back (Descriptor::readFromBinary)
+ *          without going through XML. Records carry no descriptor type,
+ *          so a packet exchanged through the library API is a record
+ *          prefixed by DESCRIPTOR_BINARY_HEADER_SIZE bytes:
+ *
+ *          Offset | Size | Value
+ *          ------ | ---- | ----------------------------------------
+ *          0      | 2    | 'M' '7'
+ *          2      | 1    | DescriptorType
+ *          3      | 1    | DESCRIPTOR_BINARY_VERSION
+ *          4      | n    | descriptor record
+ *
+ *          Record layouts (u8 / u16 / s16, multi-byte values little-endian):
+ *
+ *          Descriptor          | Record
+ *          ------------------- | ------------------------------------------------------------
+ *          Dominant Color      | u8 flags (1 - variance), u8 coherency (0 - not present), u8 count,
+ *                              | count x (u8 percentage, 3 x u8 index [, 3 x u8 variance])
+ *          Scalable Color      | u16 coefficients, u8 bitplanes discarded, coefficients x s16
+ *          Color Layout        | u8 Y count, u8 C count, Y + 2 * C x u8 (Y, Cb, Cr)
+ *          Color Structure     | u16 size, size x u8
+ *          CT Browsing         | u8 category, u8 subrange index
+ *          Homogeneous Texture | u8 energy deviation flag, 62 x u8 feature
+ *          Texture Browsing    | u8 component number flag, 5 x u8 component
+ *          Edge Histogram      | 80 x u8 bin
+ *          Region Shape        | 35 x u8 ART magnitude (all but element (0, 0), as in XML)
+ *          Contour Shape       | u8 peaks, 2 x u16 global curvature, 2 x u16 prototype curvature,
+ *                              | u16 highest peak y, (peaks - 1) x (u16 x, u16 y)
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include "DescriptorType.h"
+#include "../TOOLS/ErrorCode.h"
+
+#define DESCRIPTOR_BINARY_VERSION     1
+#define DESCRIPTOR_BINARY_HEADER_SIZE 4
+#define DESCRIPTOR_BINARY_MAX_SIZE    1024 // upper bound of any packet (header included)
+
+class DescriptorBinary {
+    public:
+        static void writeUInt8(unsigned char * buffer, long value);
+        static void writeUInt16(unsigned char * buffer, long value);
+        static void writeInt16(unsigned char * buffer, long value);
+
+        static unsigned int readUInt16(const unsigned char * buffer);
+        static int readInt16(const unsigned char * buffer);
+
+        /** @brief
+        * Throws BINARY_SIZE_ERROR, when size is different than expected */
+        static void checkSize(unsigned long size, unsigned long expected);
+
+        /** @brief
+        * Writes packet header
+        * @param buffer - output of DESCRIPTOR_BINARY_HEADER_SIZE bytes */
+        static void writeHeader(unsigned char * buffer, DescriptorType type);
+
+        /** @brief
+        * Validates packet header
+        * @return DescriptorType - type stored in header */
+        static DescriptorType readHeader(const unsigned char * buffer, unsigned long size);
+};
@@ -120,81 +120,36 @@ void ContourShape::readFromXML(XMLElement * descriptorElement) {
     }
 }
 
-std::string ContourShape::generateXML() {
-    XMLDocument xmlDoc;
-
-    XMLDeclaration * p_Declaration = xmlDoc.NewDeclaration("xml version='1.0' encoding='ISO-8859-1' ");
-    XMLElement * p_Root               = xmlDoc.NewElement("Mpeg7");
-    XMLElement * p_DescriptionUnit    = xmlDoc.NewElement("DescriptionUnit");
-    XMLElement * p_Descriptor         = xmlDoc.NewElement("Descriptor");
-    XMLElement * p_GlobalCurvature    = xmlDoc.NewElement("GlobalCurvature");
-    XMLElement * p_PrototypeCurvature = nullptr;
-    XMLElement * p_HighestPeak        = xmlDoc.NewElement("HighestPeakY");
-
-    p_Root->SetAttribute("xmlns", "urn:mpeg:mpeg7:schema:2001");
-    p_Root->SetAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
-    p_DescriptionUnit->SetAttribute("xsi:type", "DescriptorCollectionType");
-    p_Descriptor->SetAttribute("xsi:type", "ContourShapeType");
-
-    p_Root->InsertEndChild(p_DescriptionUnit);
-    p_DescriptionUnit->InsertEndChild(p_Descriptor);
-    p_Descriptor->InsertEndChild(p_GlobalCurvature);
-
+void ContourShape::writeXML(XMLWriter & writer) {
+    beginXML(writer, "ContourShapeType");
 
     /* Set GlobalCurvature node */
-    std::string globalCurvature_string;
-
-    for (unsigned long i : descriptorGlobalCurvatureVector) {
-        globalCurvature_string.append(std::to_string(i) + " ");
-    }
-    p_GlobalCurvature->SetText(globalCurvature_string.c_str());
+    writer.openElement("GlobalCurvature");
+    writer.textValues(descriptorGlobalCurvatureVector, 2);
+    writer.closeElement();
 
     /* Set PrototypeCurvature node if needed */
     if (descriptorPeaksCount > 0) {
-        p_PrototypeCurvature = xmlDoc.NewElement("PrototypeCurvature");
-
-        std::string prototypeCurvature_string;
-        
-        for (unsigned long i : descriptorPrototypeCurvatureVector) {
-            prototypeCurvature_string.append(std::to_string(i) + " ");
-        }
-
-        p_Descriptor->InsertEndChild(p_PrototypeCurvature);
-        p_PrototypeCurvature->SetText(prototypeCurvature_string.c_str());
-
-        p_Descriptor->InsertEndChild(p_PrototypeCurvature);
+        writer.openElement("PrototypeCurvature");
+        writer.textValues(descriptorPrototypeCurvatureVector, 2);
+        writer.closeElement();
     }
 
-    p_Descriptor->InsertEndChild(p_HighestPeak);
-
     /* Set HighestPeakY node */
-    std::string highestPeakY_string;
-    highestPeakY_string.append(std::to_string(descriptorHighestPeakY));
-    p_HighestPeak->SetText(highestPeakY_string.c_str());
+    writer.textElement("HighestPeakY", descriptorHighestPeakY);
 
     /* Set Peak nodes */
-    if (descriptorPeaksCount > 1) {
-        std::vector<XMLElement *> peakNodes(descriptorPeaksCount - 1, nullptr);
-
-        for (int i = 1; i < descriptorPeaksCount; i++) {
-            peakNodes[i - 1] = xmlDoc.NewElement("Peak");
-
-            unsigned short xp, yp;
-            GetPeak(i, xp, yp);
-
-            peakNodes[i - 1]->SetAttribute("peakX", xp);
-            peakNodes[i - 1]->SetAttribute("peakY", yp);
-
-            p_Descriptor->InsertEndChild(peakNodes[i - 1]);
-        }
+    for (int i = 1; i < descriptorPeaksCount; i++) {
+        unsigned short xp, yp;
+        GetPeak(i, xp, yp);
+
+        writer.openElement("Peak");
+        writer.attribute("peakX", xp);
+        writer.attribute("peakY", yp);
+        writer.closeElement();
     }
 
-    xmlDoc.InsertFirstChild(p_Declaration);
-    xmlDoc.InsertEndChild(p_Root);
-
-    XMLPrinter xmlPrinter;
-    xmlDoc.Accept(&xmlPrinter);
-    return xmlPrinter.CStr();
+    endXML(writer);
 }
 
 void ContourShape::SetNumberOfPeaks(const unsigned char cPeaks) {
@@ -273,4 +228,55 @@ void ContourShape::GetPeak(const unsigned char cIndex, unsigned short & iX, unsi
     }
 }
 
-ContourShape::~ContourShape() = default;
+unsigned long ContourShape::getBinarySize() {
+    return 11 + (descriptorPeaksCount > 0 ? 4 * (descriptorPeaksCount - 1) : 0);
+}
+
+void ContourShape::writeBinary(unsigned char * buffer) {
+    DescriptorBinary::writeUInt8(buffer, descriptorPeaksCount);
+    DescriptorBinary::writeUInt16(buffer + 1, descriptorGlobalCurvatureVector[0]);
+    DescriptorBinary::writeUInt16(buffer + 3, descriptorGlobalCurvatureVector[1]);
+    DescriptorBinary::writeUInt16(buffer + 5, descriptorPrototypeCurvatureVector[0]);
+    DescriptorBinary::writeUInt16(buffer + 7, descriptorPrototypeCurvatureVector[1]);
+    DescriptorBinary::writeUInt16(buffer + 9, descriptorHighestPeakY);
+
+    // Peak 0 is (0, HighestPeakY), so as in XML only the rest of peaks is stored
+    for (int i = 1; i < descriptorPeaksCount; i++) {
+        DescriptorBinary::writeUInt16(buffer + 11 + 4 * (i - 1), descriptorPeaks[2 * i]);
+        DescriptorBinary::writeUInt16(buffer + 13 + 4 * (i - 1), descriptorPeaks[2 * i + 1]);
+    }
+}
+
+void ContourShape::readFromBinary(const unsigned char * buffer, const unsigned long size) {
+    if (size < 11) {
+        throw BINARY_SIZE_ERROR;
+    }
+
+    if (buffer[0] > CONTOURSHAPE_CSSPEAKMASK) {
+        throw BINARY_VALUE_ERROR;
+    }
+
+    SetNumberOfPeaks(buffer[0]);
+
+    DescriptorBinary::checkSize(size, getBinarySize());
+
+    descriptorGlobalCurvatureVector[0]    = DescriptorBinary::readUInt16(buffer + 1);
+    descriptorGlobalCurvatureVector[1]    = DescriptorBinary::readUInt16(buffer + 3);
+    descriptorPrototypeCurvatureVector[0] = DescriptorBinary::readUInt16(buffer + 5);
+    descriptorPrototypeCurvatureVector[1] = DescriptorBinary::readUInt16(buffer + 7);
+    descriptorHighestPeakY                = static_cast<unsigned short>(DescriptorBinary::readUInt16(buffer + 9));
+
+    if (descriptorPeaksCount > 0) {
+        SetPeak(0, 0, descriptorHighestPeakY);
+    }
+
+    for (int i = 1; i < descriptorPeaksCount; i++) {
+        SetPeak(static_cast<unsigned char>(i),
+                static_cast<unsigned short>(DescriptorBinary::readUInt16(buffer + 11 + 4 * (i - 1))),
+                static_cast<unsigned short>(DescriptorBinary::readUInt16(buffer + 13 + 4 * (i - 1))));
+    }
+}
+
+ContourShape::~ContourShape() {
+    delete[] descriptorPeaks;
+}
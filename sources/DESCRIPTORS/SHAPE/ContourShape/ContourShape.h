@@ -77,7 +77,10 @@ class ContourShape : public Descriptor {
 
         void loadParameters(const char ** params);
 		void readFromXML(XMLElement * descriptorElement);
-        std::string generateXML();
+        void writeXML(XMLWriter & writer);
+        unsigned long getBinarySize();
+        void writeBinary(unsigned char * buffer);
+        void readFromBinary(const unsigned char * buffer, unsigned long size);
 
         void SetNumberOfPeaks(unsigned char cPeaks);
         void SetHighestPeakY(unsigned short iHigh);
@@ -1,17 +1,22 @@
 #include "ContourShapeExtractor.h"
+#include "../../../TOOLS/Trace/Trace.h"
 
 ContourShapeExtractor::ContourShapeExtractor() {
     descriptor = new ContourShape();
 }
 
 Descriptor * ContourShapeExtractor::extract(Image & image, const char ** params) {
-    descriptor->loadParameters(params);
+    TRACE_SCOPE("ContourShapeExtractor::extract");
 
-    const int CONTOUR_SIZE = 500;
+    // Image without contour leaves descriptor empty, so data of previous extraction must not be kept
+    delete descriptor;
+    descriptor = new ContourShape();
+
+    descriptor->loadParameters(params);
 
-    const auto coords = new Point2[CONTOUR_SIZE];
+    const auto coords = new Point2[CONTOURSHAPE_CONTOUR_POINTS];
 
-    const int nContour = ExtractContour(CONTOUR_SIZE, image, coords);
+    const int nContour = ExtractContour(CONTOURSHAPE_CONTOUR_POINTS, image, coords);
 
     if (nContour > 0) {
         ExtractPeaks(nContour, coords);
@@ -22,24 +27,78 @@ Descriptor * ContourShapeExtractor::extract(Image & image, const char ** params)
     return descriptor;
 }
 
-unsigned long ContourShapeExtractor::ExtractContour(const int n, Image & image, Point2 * const & ishp) {
-    const int dr[] = { 0, -1, -1, -1,  0,  1,  1,  1 };
-    const int dc[] = { 1,  1,  0, -1, -1, -1,  0,  1 };
+Descriptor * ContourShapeExtractor::extract(const ShapeMask & mask, const char ** params) {
+    TRACE_SCOPE("ContourShapeExtractor::extract(mask)");
 
+    delete descriptor;
+    descriptor = new ContourShape();
+
+    descriptor->loadParameters(params);
+
+    Point2 * xy = nullptr;
     int size = 0;
-    Point2 *xy = nullptr;
-    unsigned char *mask_chan;
 
+    if (!mask.getPolygon().empty()) {
+        size = PolygonContour(mask.getPolygon(), xy);
+    }
+    else {
+        // Bounding box of runs with background border is traced like the whole image
+        int left, top, width, height;
+        std::vector<unsigned char> raster = mask.rasterize(1, left, top, width, height);
+
+        size = TraceContour(raster.data(), width, height, xy);
+
+        for (int i = 0; i < size; i++) {
+            xy[i].x += left;
+            xy[i].y += top;
+        }
+    }
+
+    if (size > 0) {
+        const auto coords = new Point2[CONTOURSHAPE_CONTOUR_POINTS];
 
-    mask_chan = image.getGray(GRAYSCALE_AVERAGE);
+        ResampleContour(CONTOURSHAPE_CONTOUR_POINTS, xy, size, coords);
+        ExtractPeaks(CONTOURSHAPE_CONTOUR_POINTS, coords);
 
-    const int imageWidth = image.getWidth();
-    const int imageHeight = image.getHeight();
+        delete[] coords;
+    }
+
+    delete[] xy;
+
+    return descriptor;
+}
+
+unsigned long ContourShapeExtractor::ExtractContour(const int n, Image & image, Point2 * const & ishp) {
+    TRACE_SCOPE("ContourShapeExtractor::ExtractContour");
+
+    unsigned char * mask_chan = image.getGray(GRAYSCALE_AVERAGE);
+
+    Point2 * xy = nullptr;
+    const int size = TraceContour(mask_chan, image.getWidth(), image.getHeight(), xy);
+
+    delete[] mask_chan;
+
+    if (size == 0)
+        return 0;
+
+    ResampleContour(n, xy, size, ishp);
+
+    delete[] xy;
 
-    for (int r = 0; (r < image.getHeight()) && (size == 0); r++) {
+    return n;
+}
+
+int ContourShapeExtractor::TraceContour(unsigned char * mask_chan, const int imageWidth, const int imageHeight, Point2 * & xy) {
+    const int dr[] = { 0, -1, -1, -1,  0,  1,  1,  1 };
+    const int dc[] = { 1,  1,  0, -1, -1, -1,  0,  1 };
+
+    int size = 0;
+    xy = nullptr;
+
+    for (int r = 0; (r < imageHeight) && (size == 0); r++) {
         const unsigned char lastPel = 0;
 
-        for (int c = 0; (c < image.getWidth()) && (size == 0); c++) {
+        for (int c = 0; (c < imageWidth) && (size == 0); c++) {
             const unsigned char thisPel = *getPixel(mask_chan, c, r, imageWidth, imageHeight);
 
             if (thisPel != lastPel) {
@@ -116,13 +175,65 @@ unsigned long ContourShapeExtractor::ExtractContour(const int n, Image & image,
         }
     }
 
-    delete[] mask_chan;
+    return size;
+}
 
+int ContourShapeExtractor::PolygonContour(const std::vector<double> & polygon, Point2 * & xy) {
+    const int vertexCount = static_cast<int>(polygon.size() / 2);
 
+    xy = new Point2[vertexCount];
+    int size = 0;
 
-    if (size == 0)
+    // Repeated vertices (and closing vertex equal to first one) would give zero length steps
+    for (int i = 0; i < vertexCount; i++) {
+        const double x = polygon[i * 2];
+        const double y = polygon[i * 2 + 1];
+
+        if (size == 0 || x != xy[size - 1].x || y != xy[size - 1].y) {
+            xy[size].x = x;
+            xy[size].y = y;
+            size++;
+        }
+    }
+
+    while (size > 1 && xy[size - 1].x == xy[0].x && xy[size - 1].y == xy[0].y) {
+        size--;
+    }
+
+    if (size < 3) {
+        delete[] xy;
+        xy = nullptr;
         return 0;
+    }
+
+    /* Traced contours start at top left pixel and go right along top edge (clockwise with y axis pointing down),
+       polygon is brought to the same start and direction, so both give the same descriptor for the same shape */
+    double area = 0.0;
+    int start = 0;
+
+    for (int i = 0; i < size; i++) {
+        const Point2 & a = xy[i];
+        const Point2 & b = xy[(i + 1) % size];
+        area += a.x * b.y - b.x * a.y;
+
+        if (a.y < xy[start].y || (a.y == xy[start].y && a.x < xy[start].x)) {
+            start = i;
+        }
+    }
+
+    const auto ordered = new Point2[size];
+
+    for (int i = 0; i < size; i++) {
+        ordered[i] = area >= 0 ? xy[(start + i) % size] : xy[(start - i + size) % size];
+    }
 
+    delete[] xy;
+    xy = ordered;
+
+    return size;
+}
+
+void ContourShapeExtractor::ResampleContour(const int n, const Point2 * xy, const int size, Point2 * const & ishp) {
     double per = 0.0;
     const auto dst = new double[size];
     for (int i1 = 0; i1 < size; i1++) {
@@ -163,12 +274,11 @@ unsigned long ContourShapeExtractor::ExtractContour(const int n, Image & image,
     }
 
     delete[] dst;
-    delete[] xy;
-
-    return n;
 }
 
 unsigned long ContourShapeExtractor::ExtractPeaks(int n, const Point2 * const & ishp) {
+    TRACE_SCOPE("ContourShapeExtractor::ExtractPeaks");
+
     auto fshp = new Point2[n];
 
     auto peaks = new Point2[CONTOURSHAPE_MAXCSS];
@@ -458,6 +568,8 @@ unsigned long ContourShapeExtractor::ExtractPeaks(int n, const Point2 * const &
 }
 
 void ContourShapeExtractor::ExtractCurvature(const int n, const Point2 * const & shp, unsigned long & qc, unsigned long & qe) {
+    TRACE_SCOPE("ContourShapeExtractor::ExtractCurvature");
+
     double ecc = 0.0, cir = 0.0;
 
     const auto ind = new IndexCoords[n];
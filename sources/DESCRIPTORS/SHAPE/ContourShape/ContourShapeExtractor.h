@@ -7,9 +7,12 @@
 
 #include "../../DescriptorExtractor.h"
 #include "../ContourShape/ContourShape.h"
+#include "../../../TOOLS/Mask/ShapeMask.h"
 
 #define WHITE_ON_BLACK
 
+#define CONTOURSHAPE_CONTOUR_POINTS 500 // contour is resampled to this number of equally spaced points
+
 class ContourShapeExtractor : public DescriptorExtractor {
     private:
         ContourShape * descriptor = nullptr;
@@ -18,7 +21,26 @@ class ContourShapeExtractor : public DescriptorExtractor {
 	    ContourShapeExtractor();
 	    Descriptor * extract(Image & image, const char ** params);
 
+        /** @brief
+        * Extracts descriptor of segmentation mask: contour of polygon mask is its vertex list
+        * (no rasterization), contour of RLE mask is traced in bounding box of its runs only */
+        Descriptor * extract(const ShapeMask & mask, const char ** params);
+
         unsigned long ExtractContour(int n, Image & image, Point2 * const & ishp);
+
+        /** @brief
+        * Traces first contour of mask (non-zero pixels) into new array xy (nullptr when there is none)
+        * @return int - number of contour points */
+        int TraceContour(unsigned char * mask_chan, int imageWidth, int imageHeight, Point2 * & xy);
+
+        /** @brief
+        * Polygon vertices as contour in direction and from start point of traced contours
+        * @return int - number of contour points (0 for degenerate polygon, xy is then nullptr) */
+        int PolygonContour(const std::vector<double> & polygon, Point2 * & xy);
+
+        /** @brief
+        * Resamples closed contour of 'size' points to n points equally spaced along its perimeter */
+        void ResampleContour(int n, const Point2 * xy, int size, Point2 * const & ishp);
         unsigned long ExtractPeaks(int n, const Point2 * const &ishp);
         void ExtractCurvature(int n, const Point2 * const &shp, unsigned long &qc, unsigned long &qe);
 
@@ -79,25 +79,19 @@ double RegionShape::GetRealValue(const char p, const char r) {
     return IQuantTable[m_ArtDE[p][r]];
 }
 
-std::string RegionShape::generateXML() {
-	XMLDocument xmlDoc;
-
-	XMLDeclaration * p_Declaration = xmlDoc.NewDeclaration("xml version='1.0' encoding='ISO-8859-1' ");
-	XMLElement * p_Root = xmlDoc.NewElement("Mpeg7");
-	XMLElement * p_DescriptionUnit = xmlDoc.NewElement("DescriptionUnit");
-	XMLElement * p_Descriptor = xmlDoc.NewElement("Descriptor");
-	XMLElement * p_MagnitudeOfART = xmlDoc.NewElement("MagnitudeOfART");
-
-	p_Root->SetAttribute("xmlns", "urn:mpeg:mpeg7:schema:2001");
-	p_Root->SetAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
-	p_DescriptionUnit->SetAttribute("xsi:type", "DescriptorCollectionType");
-	p_Descriptor->SetAttribute("xsi:type", "RegionShapeType");
-
-	p_Root->InsertEndChild(p_DescriptionUnit);
-	p_DescriptionUnit->InsertEndChild(p_Descriptor);
-	p_Descriptor->InsertEndChild(p_MagnitudeOfART);
+void RegionShape::GetRealValues(float * values) {
+    // Packed search layout: ART_ANGULAR * ART_RADIAL dequantized values, p-major.
+    // Element (0, 0) is not part of the descriptor and is stored as 0,
+    // so the plain L1 over all values equals RegionShapeDistance result
+    for (int p = 0; p < ART_ANGULAR; p++) {
+        for (int r = 0; r < ART_RADIAL; r++) {
+            values[p * ART_RADIAL + r] = (p != 0 || r != 0) ? static_cast<float>(IQuantTable[m_ArtDE[p][r]]) : 0.0f;
+        }
+    }
+}
 
-	std::vector<int> V(35);
+void RegionShape::writeXML(XMLWriter & writer) {
+	char V[ART_ANGULAR * ART_RADIAL - 1];
 
 	int i, j;
 	int n = 0;
@@ -109,20 +103,49 @@ std::string RegionShape::generateXML() {
 		}
 	}
 
-	std::string binCounts_string;
+	beginXML(writer, "RegionShapeType");
 
-	for (unsigned int i = 0; i < V.size(); i++) {
-		binCounts_string.append(std::to_string(V[i]) + " ");
-	}
+	writer.openElement("MagnitudeOfART");
+	writer.textValues(V, n);
+	writer.closeElement();
+
+	endXML(writer);
+}
+
+unsigned long RegionShape::getBinarySize() {
+    return ART_ANGULAR * ART_RADIAL - 1;
+}
 
-	p_MagnitudeOfART->SetText(binCounts_string.c_str());
+void RegionShape::writeBinary(unsigned char * buffer) {
+    int index = 0;
 
-	xmlDoc.InsertFirstChild(p_Declaration);
-	xmlDoc.InsertEndChild(p_Root);
+    for (int i = 0; i < ART_ANGULAR; i++) {
+        for (int j = 0; j < ART_RADIAL; j++) {
+            if (i != 0 || j != 0) {
+                DescriptorBinary::writeUInt8(buffer + index++, m_ArtDE[i][j]);
+            }
+        }
+    }
+}
+
+void RegionShape::readFromBinary(const unsigned char * buffer, const unsigned long size) {
+    DescriptorBinary::checkSize(size, getBinarySize());
+
+    int index = 0;
 
-	XMLPrinter xmlPrinter;
-	xmlDoc.Accept(&xmlPrinter);
-	return xmlPrinter.CStr();
+    for (int i = 0; i < ART_ANGULAR; i++) {
+        for (int j = 0; j < ART_RADIAL; j++) {
+            if (i != 0 || j != 0) {
+                if (buffer[index] > 15) { // 4 bit quantized magnitude
+                    throw BINARY_VALUE_ERROR;
+                }
+                m_ArtDE[i][j] = static_cast<char>(buffer[index++]);
+            }
+            else {
+                m_ArtDE[i][j] = 0;
+            }
+        }
+    }
 }
 
 RegionShape::~RegionShape() = default;
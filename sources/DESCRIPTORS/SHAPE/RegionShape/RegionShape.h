@@ -27,10 +27,14 @@ class RegionShape : public Descriptor {
 
         void loadParameters(const char ** params);
         void readFromXML(XMLElement * descriptorElement);
-        std::string generateXML();
+        void writeXML(XMLWriter & writer);
+        unsigned long getBinarySize();
+        void writeBinary(unsigned char * buffer);
+        void readFromBinary(const unsigned char * buffer, unsigned long size);
 
         bool SetElement(char p, char r, double value);
         char GetElement(char p, char r);
         double GetRealValue(char p, char r);
+        void GetRealValues(float * values);
 		~RegionShape();
 };
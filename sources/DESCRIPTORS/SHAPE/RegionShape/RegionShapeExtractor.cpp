@@ -1,55 +1,23 @@
 #include "RegionShapeExtractor.h"
+#include "../../../TOOLS/Trace/Trace.h"
 
-RegionShapeExtractor::RegionShapeExtractor(): m_mass(0), m_centerX(0), m_centerY(0), m_radius(0), m_pBasisR{}, m_pBasisI{}, m_pCoeffR{}, m_pCoeffI{} {
+#include <algorithm>
+#include <cstring>
+
+RegionShapeExtractor::RegionShapeExtractor(): m_mass(0), m_centerX(0), m_centerY(0), m_radius(0), m_pCoeffR{}, m_pCoeffI{} {
+    // Basis LUT is not cleared here, it is generated as a whole on first extraction
     descriptor = new RegionShape();
 }
 
 Descriptor * RegionShapeExtractor::extract(Image & image, const char ** params) {
-    descriptor->loadParameters(params);
-
-    /* Generate basis LUT */
-    double angle, temp, radius;
-    int p, r;
-    int x, y;
-    int maxradius;
-
-    maxradius = ART_LUT_SIZE / 2;
-
-    for (y = 0; y < ART_LUT_SIZE; y++) {
-        for (x = 0; x < ART_LUT_SIZE; x++) {
-            radius = HYPOT((double) (x - maxradius), y - maxradius);
-            if (radius < maxradius) {
-                angle = atan2(y - maxradius, x - maxradius);
+    TRACE_SCOPE("RegionShapeExtractor::extract");
 
-                for (p = 0; p < ART_ANGULAR; p++) {
-                    for (r = 0; r < ART_RADIAL; r++) {
-
-                        temp = cos(radius * M_PI * r / maxradius);
+    descriptor->loadParameters(params);
 
-                        m_pBasisR[p][r][x][y] = temp * cos(angle * p);
-                        m_pBasisI[p][r][x][y] = temp * sin(angle * p);
-                    }
-                }
-            }
-            else {
-                for (p = 0; p < ART_ANGULAR; p++) {
-                    for (r = 0; r < ART_RADIAL; r++) {
-                        m_pBasisR[p][r][x][y] = 0;
-                        m_pBasisI[p][r][x][y] = 0;
-                    }
-                }
-            }
-        }
-    }
+    generateLUT();
+    resetCoefficients();
 
-    /* Reset */
-    for (int p = 0; p < ART_ANGULAR; p++) {
-        for (int r = 0; r < ART_RADIAL; r++) {
-            m_pCoeffR[p][r] = 0;
-            m_pCoeffI[p][r] = 0;
-        }
-    }
-    m_radius = 0;
+    int x, y;
 
     /* Find center of mass */
     unsigned int m10 = 0;
@@ -93,13 +61,10 @@ Descriptor * RegionShapeExtractor::extract(Image & image, const char ** params)
       - there is no need to use redundant gray conversion method, because OpenCV does it already.  */
 
     const unsigned char * pImage = image.getGray(GRAYSCALE_AVERAGE);
-    unsigned char size = 1;
 
     const int imageWidth  = image.getWidth();
     const int imageHeight = image.getHeight();
 
-    m_mass = 0;
-
     int i = 0;
     for (y = 0; y < imageHeight; y++) {
         for (x = 0; x < imageWidth; x++) {
@@ -132,42 +97,240 @@ Descriptor * RegionShapeExtractor::extract(Image & image, const char ** params)
     }
 
     // Extract coefficients:
-    double dx, dy, tx, ty;
+    const bool splat = useSplat();
+
+    if (splat) {
+        memset(m_pGrid, 0, sizeof(m_pGrid));
+    }
 
     i = 0;
     for (y = 0; y < imageHeight; y++) {
         for (x = 0; x < imageWidth; x++) {
             if (pImage[i] < 128) {
-                // Map image coordinate (x, y) to basis function coordinate (tx, ty)
-                dx = x - m_centerX;
-                dy = y - m_centerY;
-                tx = ((dx * ART_LUT_RADIUS) / m_radius) + ART_LUT_RADIUS;
-                ty = ((dy * ART_LUT_RADIUS) / m_radius) + ART_LUT_RADIUS;
-
-                // Summation of basis function
-                if (tx >= 0 && tx < ART_LUT_SIZE && ty >= 0 && ty < ART_LUT_SIZE) {
-                    for (p = 0; p < ART_ANGULAR; p++) {
-                        for (r = 0; r < ART_RADIAL; r++) {
-                            m_pCoeffR[p][r] += GetReal(p, r, tx, ty);
-                            m_pCoeffI[p][r] -= GetImg(p, r, tx, ty);
-                        }
-                    }
+                if (splat) {
+                    addSplat(x, y);
+                }
+                else {
+                    addDirect(x, y);
                 }
             }
             i++;
         }
     }
 
+    if (splat) {
+        projectGrid();
+    }
+
     delete[] pImage;
 
+    setElements();
+    return descriptor;
+}
+
+Descriptor * RegionShapeExtractor::extract(const ShapeMask & mask, const char ** params) {
+    TRACE_SCOPE("RegionShapeExtractor::extract(mask)");
+
+    descriptor->loadParameters(params);
+
+    generateLUT();
+    resetCoefficients();
+
+    // Same moments, radius and coefficients as for image, with mask pixels as dark pixels of image
+    const std::vector<MaskRun> & runs = mask.getRuns();
+
+    const int dx = mask.getOrder() == MASK_ROW_MAJOR ? 1 : 0;
+    const int dy = mask.getOrder() == MASK_ROW_MAJOR ? 0 : 1;
+
+    /* Find center of mass (sum of run coordinates is arithmetic series) */
+    unsigned int m10 = 0;
+    unsigned int m01 = 0;
+
+    for (const MaskRun & run : runs) {
+        const unsigned int length = static_cast<unsigned int>(run.length);
+        const unsigned int series = static_cast<unsigned int>(static_cast<unsigned long long>(length) * (length - 1) / 2);
+
+        m_mass += run.length;
+        m10 += length * run.x + series * dx;
+        m01 += length * run.y + series * dy;
+    }
+
+    m_centerX = static_cast<double>(m10) / static_cast<double>(m_mass);
+    m_centerY = static_cast<double>(m01) / static_cast<double>(m_mass);
+
+    // Find radius (distance from center along run is largest at one of its ends):
+    for (const MaskRun & run : runs) {
+        const int endX = run.x + (run.length - 1) * dx;
+        const int endY = run.y + (run.length - 1) * dy;
+
+        m_radius = std::max(m_radius, HYPOT(run.x - m_centerX, run.y - m_centerY));
+        m_radius = std::max(m_radius, HYPOT(endX - m_centerX, endY - m_centerY));
+    }
+
+    // Extract coefficients:
+    const bool splat = useSplat();
+
+    if (splat) {
+        memset(m_pGrid, 0, sizeof(m_pGrid));
+    }
+
+    for (const MaskRun & run : runs) {
+        for (int i = 0; i < run.length; i++) {
+            if (splat) {
+                addSplat(run.x + i * dx, run.y + i * dy);
+            }
+            else {
+                addDirect(run.x + i * dx, run.y + i * dy);
+            }
+        }
+    }
+
+    if (splat) {
+        projectGrid();
+    }
+
+    setElements();
+    return descriptor;
+}
+
+void RegionShapeExtractor::generateLUT() {
+    /* Generate basis LUT (once, extractor reused for many images keeps it) */
+    if (m_bLUTInit) {
+        return;
+    }
+
+    double angle, temp, radius;
+    int p, r;
+    int x, y;
+    int maxradius;
+
+    maxradius = ART_LUT_SIZE / 2;
+
+    for (y = 0; y < ART_LUT_SIZE; y++) {
+        for (x = 0; x < ART_LUT_SIZE; x++) {
+            radius = HYPOT((double) (x - maxradius), y - maxradius);
+            if (radius < maxradius) {
+                angle = atan2(y - maxradius, x - maxradius);
+
+                for (p = 0; p < ART_ANGULAR; p++) {
+                    for (r = 0; r < ART_RADIAL; r++) {
+
+                        temp = cos(radius * M_PI * r / maxradius);
+
+                        m_pBasisR[p][r][x][y] = temp * cos(angle * p);
+                        m_pBasisI[p][r][x][y] = temp * sin(angle * p);
+                    }
+                }
+            }
+            else {
+                for (p = 0; p < ART_ANGULAR; p++) {
+                    for (r = 0; r < ART_RADIAL; r++) {
+                        m_pBasisR[p][r][x][y] = 0;
+                        m_pBasisI[p][r][x][y] = 0;
+                    }
+                }
+            }
+        }
+    }
+
+    m_bLUTInit = true;
+}
+
+void RegionShapeExtractor::resetCoefficients() {
+    for (int p = 0; p < ART_ANGULAR; p++) {
+        for (int r = 0; r < ART_RADIAL; r++) {
+            m_pCoeffR[p][r] = 0;
+            m_pCoeffI[p][r] = 0;
+        }
+    }
+    m_mass   = 0;
+    m_radius = 0;
+}
+
+bool RegionShapeExtractor::useSplat() const {
+    return m_engine == ART_ENGINE_SPLAT || (m_engine == ART_ENGINE_AUTO && m_mass >= ART_SPLAT_MIN_MASS);
+}
+
+void RegionShapeExtractor::addDirect(const int x, const int y) {
+    // Map image coordinate (x, y) to basis function coordinate (tx, ty)
+    const double dx = x - m_centerX;
+    const double dy = y - m_centerY;
+    const double tx = ((dx * ART_LUT_RADIUS) / m_radius) + ART_LUT_RADIUS;
+    const double ty = ((dy * ART_LUT_RADIUS) / m_radius) + ART_LUT_RADIUS;
+
+    // Summation of basis function
+    if (tx >= 0 && tx < ART_LUT_SIZE && ty >= 0 && ty < ART_LUT_SIZE) {
+        for (int p = 0; p < ART_ANGULAR; p++) {
+            for (int r = 0; r < ART_RADIAL; r++) {
+                m_pCoeffR[p][r] += GetReal(p, r, tx, ty);
+                m_pCoeffI[p][r] -= GetImg(p, r, tx, ty);
+            }
+        }
+    }
+}
+
+void RegionShapeExtractor::addSplat(const int x, const int y) {
+    /* Sum of bilinear interpolations is linear in basis values, so instead of interpolating
+       36 basis functions at every pixel, the interpolation weights of all pixels are accumulated
+       at LUT nodes first and every coefficient is then a single dot product of grid and basis. */
+    const double dx = x - m_centerX;
+    const double dy = y - m_centerY;
+    const double tx = ((dx * ART_LUT_RADIUS) / m_radius) + ART_LUT_RADIUS;
+    const double ty = ((dy * ART_LUT_RADIUS) / m_radius) + ART_LUT_RADIUS;
+
+    if (tx >= 0 && tx < ART_LUT_SIZE && ty >= 0 && ty < ART_LUT_SIZE) {
+        const int gx = static_cast<int>(tx);
+        const int gy = static_cast<int>(ty);
+
+        const double ix = tx - gx;
+        const double iy = ty - gy;
+
+        m_pGrid[gx][gy]         += (1 - ix) * (1 - iy);
+        m_pGrid[gx + 1][gy]     += ix * (1 - iy);
+        m_pGrid[gx][gy + 1]     += (1 - ix) * iy;
+        m_pGrid[gx + 1][gy + 1] += ix * iy;
+    }
+}
+
+void RegionShapeExtractor::projectGrid() {
+    // Extra row and column (weights of nodes outside LUT) are left out, basis is zero there
+    for (int p = 0; p < ART_ANGULAR; p++) {
+        for (int r = 0; r < ART_RADIAL; r++) {
+            double sumR = 0;
+            double sumI = 0;
+
+            for (int x = 0; x < ART_LUT_SIZE; x++) {
+                const double * grid   = m_pGrid[x];
+                const double * basisR = m_pBasisR[p][r][x];
+                const double * basisI = m_pBasisI[p][r][x];
+
+                for (int y = 0; y < ART_LUT_SIZE; y++) {
+                    sumR += grid[y] * basisR[y];
+                    sumI += grid[y] * basisI[y];
+                }
+            }
+
+            m_pCoeffR[p][r] = sumR;
+            m_pCoeffI[p][r] = -sumI;
+        }
+    }
+}
+
+void RegionShapeExtractor::setElements() {
     // Set descriptor data:
     for (int r = 0; r < ART_RADIAL; r++) {
         for (int p = 0; p < ART_ANGULAR; p++) {
             descriptor->SetElement(p, r, HYPOT(m_pCoeffR[p][r] / m_mass, m_pCoeffI[p][r] / m_mass));
         }
     }
+}
 
-    return descriptor;
+void RegionShapeExtractor::setEngine(const RegionShapeEngine engine) {
+    m_engine = engine;
+}
+
+double RegionShapeExtractor::getMagnitude(const int p, const int r) const {
+    return HYPOT(m_pCoeffR[p][r] / m_mass, m_pCoeffI[p][r] / m_mass);
 }
 
 double RegionShapeExtractor::GetReal(const int p, const int r, const double dx, const double dy) {
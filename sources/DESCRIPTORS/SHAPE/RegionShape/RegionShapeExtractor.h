@@ -14,8 +14,18 @@
 #define ART_LUT_RADIUS 50 // Zernike basis function radius
 #define ART_LUT_SIZE (ART_LUT_RADIUS * 2 + 1)
 
+#define ART_SPLAT_MIN_MASS 2048 // foreground pixels from which ART_ENGINE_AUTO splats mask into LUT grid
+
 #include "../../DescriptorExtractor.h"
 #include "../RegionShape/RegionShape.h"
+#include "../../../TOOLS/Mask/ShapeMask.h"
+
+/** Computation of ART coefficients, all engines give the same values (up to rounding) */
+enum RegionShapeEngine {
+    ART_ENGINE_AUTO,    // splat for masks of at least ART_SPLAT_MIN_MASS pixels, direct for smaller ones
+    ART_ENGINE_DIRECT,  // basis interpolated at every foreground pixel (36 bilinear lookups per pixel)
+    ART_ENGINE_SPLAT    // bilinear weights of foreground pixels summed in LUT grid, then projected on basis once
+};
 
 class RegionShapeExtractor : public DescriptorExtractor {
     private:
@@ -35,10 +45,38 @@ class RegionShapeExtractor : public DescriptorExtractor {
         double m_pCoeffR[ART_ANGULAR][ART_RADIAL];
         double m_pCoeffI[ART_ANGULAR][ART_RADIAL];
 
+        RegionShapeEngine m_engine = ART_ENGINE_AUTO;
+
+        // Mass of foreground splatted at LUT coordinates (one extra row and column for weights at the edge)
+        double m_pGrid[ART_LUT_SIZE + 1][ART_LUT_SIZE + 1];
+
         double GetReal(int p, int r, double dx, double dy);
         double GetImg(int p, int r, double dx, double dy);
+
+        void generateLUT();
+        void resetCoefficients();
+        bool useSplat() const;
+
+        // Coefficients of foreground pixel (x, y)
+        void addDirect(int x, int y);
+        void addSplat(int x, int y);
+        void projectGrid();
+
+        void setElements();
     public:
 	    RegionShapeExtractor();
 	    Descriptor * extract(Image & image, const char ** params);
+
+        /** @brief
+        * Extracts descriptor of segmentation mask (mask pixels stand for dark pixels of image),
+        * moments and radius are computed per run */
+        Descriptor * extract(const ShapeMask & mask, const char ** params);
+
+        void setEngine(RegionShapeEngine engine);
+
+        /** @brief
+        * Unquantized magnitude of ART coefficient (p, r) of last extraction */
+        double getMagnitude(int p, int r) const;
+
         ~RegionShapeExtractor();
 };
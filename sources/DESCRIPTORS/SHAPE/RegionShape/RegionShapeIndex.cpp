@@ -0,0 +1,113 @@
+#include "RegionShapeIndex.h"
+
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define ART_SIMD_SSE
+#endif
+
+RegionShapeIndex::RegionShapeIndex() = default;
+
+void RegionShapeIndex::reserve(const unsigned long size) {
+    references.reserve(size * ART_COEFF_STRIDE);
+}
+
+unsigned long RegionShapeIndex::add(RegionShape * descriptor) {
+    float values[ART_COEFF_STRIDE];
+    descriptor->GetRealValues(values);
+    return add(values);
+}
+
+unsigned long RegionShapeIndex::add(const float * values) {
+    references.insert(references.end(), values, values + ART_COEFF_STRIDE);
+    return count++;
+}
+
+unsigned long RegionShapeIndex::size() {
+    return count;
+}
+
+void RegionShapeIndex::clear() {
+    references.clear();
+    count = 0;
+}
+
+const float * RegionShapeIndex::getReference(const unsigned long id) {
+    return id < count ? &references[id * ART_COEFF_STRIDE] : nullptr;
+}
+
+float RegionShapeIndex::distance(const float * values1, const float * values2) {
+#ifdef ART_SIMD_SSE
+    // ART_COEFF_STRIDE (36) is a multiple of 4, so there is no scalar tail
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 sum = _mm_setzero_ps();
+
+    for (int i = 0; i < ART_COEFF_STRIDE; i += 4) {
+        const __m128 diff = _mm_sub_ps(_mm_loadu_ps(values1 + i), _mm_loadu_ps(values2 + i));
+        sum = _mm_add_ps(sum, _mm_andnot_ps(signMask, diff));
+    }
+
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+#else
+    float sum = 0.0f;
+
+    for (int i = 0; i < ART_COEFF_STRIDE; i++) {
+        sum += std::fabs(values1[i] - values2[i]);
+    }
+    return sum;
+#endif
+}
+
+void RegionShapeIndex::getDistances(RegionShape * query, float * distances) {
+    float queryValues[ART_COEFF_STRIDE];
+    query->GetRealValues(queryValues);
+
+    const float * reference = references.data();
+
+    for (unsigned long i = 0; i < count; i++, reference += ART_COEFF_STRIDE) {
+        distances[i] = distance(queryValues, reference);
+    }
+}
+
+std::vector<std::pair<unsigned long, float>> RegionShapeIndex::search(RegionShape * query, unsigned long k) {
+    std::vector<std::pair<unsigned long, float>> result;
+
+    if (k == 0 || count == 0) {
+        return result;
+    }
+    k = std::min(k, count);
+
+    float queryValues[ART_COEFF_STRIDE];
+    query->GetRealValues(queryValues);
+
+    // Max-heap on distance, holding the k best references found so far
+    const auto farther = [](const std::pair<unsigned long, float> & a, const std::pair<unsigned long, float> & b) {
+        return a.second < b.second;
+    };
+
+    result.reserve(k);
+
+    const float * reference = references.data();
+
+    for (unsigned long i = 0; i < count; i++, reference += ART_COEFF_STRIDE) {
+        const float d = distance(queryValues, reference);
+
+        if (result.size() < k) {
+            result.emplace_back(i, d);
+            std::push_heap(result.begin(), result.end(), farther);
+        }
+        else if (d < result.front().second) {
+            std::pop_heap(result.begin(), result.end(), farther);
+            result.back() = std::make_pair(i, d);
+            std::push_heap(result.begin(), result.end(), farther);
+        }
+    }
+
+    std::sort_heap(result.begin(), result.end(), farther);
+    return result;
+}
+
+RegionShapeIndex::~RegionShapeIndex() = default;
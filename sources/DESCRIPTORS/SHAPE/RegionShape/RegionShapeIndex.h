@@ -0,0 +1,54 @@
+/** @file   RegionShapeIndex.h
+ *  @brief  Region Shape search layout for scanning many reference descriptors.
+ *
+ *          Each added reference is stored as ART_COEFF_STRIDE contiguous floats
+ *          holding already dequantized ART magnitudes (see RegionShape::GetRealValues),
+ *          so a query is compared against the whole corpus with a single
+ *          L1 kernel, without any per-coefficient IQuantTable lookups.
+ *
+ *          Distances are the same as RegionShapeDistance::getDistance,
+ *          computed in single precision.
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "RegionShape.h"
+
+#define ART_COEFF_STRIDE (ART_ANGULAR * ART_RADIAL)
+
+class RegionShapeIndex {
+    private:
+        std::vector<float> references;
+        unsigned long count = 0;
+
+    public:
+        RegionShapeIndex();
+
+        void reserve(unsigned long size);
+        unsigned long add(RegionShape * descriptor);
+        unsigned long add(const float * values);
+        unsigned long size();
+        void clear();
+
+        const float * getReference(unsigned long id);
+
+        /** @brief
+        * Computes L1 distance between query and every reference
+        * @param query - query descriptor
+        * @param distances - output array of size() elements */
+        void getDistances(RegionShape * query, float * distances);
+
+        /** @brief
+        * Finds k nearest references to query
+        * @return vector of (reference id, distance) pairs sorted by ascending distance */
+        std::vector<std::pair<unsigned long, float>> search(RegionShape * query, unsigned long k);
+
+        static float distance(const float * values1, const float * values2);
+
+        ~RegionShapeIndex();
+};
@@ -54,38 +54,39 @@ void EdgeHistogram::readFromXML(XMLElement * descriptorElement) {
     setEdgeHistogramElement(tempBins);
 }
 
-std::string EdgeHistogram::generateXML() {
-	XMLDocument xmlDoc;
+void EdgeHistogram::writeXML(XMLWriter & writer) {
+	beginXML(writer, "EdgeHistogramType");
 
-	XMLDeclaration * p_Declaration = xmlDoc.NewDeclaration("xml version='1.0' encoding='ISO-8859-1' ");
-	XMLElement * p_Root = xmlDoc.NewElement("Mpeg7");
-	XMLElement * p_DescriptionUnit = xmlDoc.NewElement("DescriptionUnit");
-	XMLElement * p_Descriptor = xmlDoc.NewElement("Descriptor");
-	XMLElement * p_BinCounts = xmlDoc.NewElement("BinCounts");
+	writer.openElement("BinCounts");
+	writer.textValues(m_pEdge_HistogramElement, 80);
+	writer.closeElement();
 
-	p_Root->SetAttribute("xmlns", "urn:mpeg:mpeg7:schema:2001");
-	p_Root->SetAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
-	p_DescriptionUnit->SetAttribute("xsi:type", "DescriptorCollectionType");
-	p_Descriptor->SetAttribute("xsi:type", "EdgeHistogramType");
+	endXML(writer);
+}
 
-	p_Root->InsertEndChild(p_DescriptionUnit);
-	p_DescriptionUnit->InsertEndChild(p_Descriptor);
-	p_Descriptor->InsertEndChild(p_BinCounts);
+unsigned long EdgeHistogram::getBinarySize() {
+    return 80;
+}
 
-	std::string binCounts_string;
+void EdgeHistogram::writeBinary(unsigned char * buffer) {
+    for (int i = 0; i < 80; i++) {
+        DescriptorBinary::writeUInt8(buffer + i, m_pEdge_HistogramElement[i]);
+    }
+}
 
-	for (unsigned int i = 0; i < 80; i++) {
-		binCounts_string.append(std::to_string(m_pEdge_HistogramElement[i]) + " ");
-	}
+void EdgeHistogram::readFromBinary(const unsigned char * buffer, const unsigned long size) {
+    DescriptorBinary::checkSize(size, getBinarySize());
 
-	p_BinCounts->SetText(binCounts_string.c_str());
+    char tempBins[80];
 
-	xmlDoc.InsertFirstChild(p_Declaration);
-	xmlDoc.InsertEndChild(p_Root);
+    for (int i = 0; i < 80; i++) {
+        if (buffer[i] > 7) { // QuantTable has 8 levels per bin
+            throw BINARY_VALUE_ERROR;
+        }
+        tempBins[i] = static_cast<char>(buffer[i]);
+    }
 
-	XMLPrinter xmlPrinter;
-	xmlDoc.Accept(&xmlPrinter);
-	return xmlPrinter.CStr();
+    setEdgeHistogramElement(tempBins);
 }
 
 EdgeHistogram::~EdgeHistogram() {
@@ -32,7 +32,10 @@ class EdgeHistogram : public Descriptor {
 
         void loadParameters(const char ** params);
         void readFromXML(XMLElement * descriptorElement);
-        std::string generateXML();
+        void writeXML(XMLWriter & writer);
+        unsigned long getBinarySize();
+        void writeBinary(unsigned char * buffer);
+        void readFromBinary(const unsigned char * buffer, unsigned long size);
 
         void setEdgeHistogramElement(int index, int value);
         void setEdgeHistogramElement(char * pEdgeHistogram);
@@ -1,10 +1,16 @@
 #include "EdgeHistogramExtractor.h"
+#include "../../../TOOLS/Trace/Trace.h"
+
+#include <algorithm>
+#include <vector>
 
 EdgeHistogramExtractor::EdgeHistogramExtractor() {
     descriptor = new EdgeHistogram();
 }
 
 Descriptor * EdgeHistogramExtractor::extract(Image & image, const char ** params) {
+    TRACE_SCOPE("EdgeHistogramExtractor::extract");
+
     descriptor->loadParameters(params);
 
     // Get image information
@@ -12,10 +18,12 @@ Descriptor * EdgeHistogramExtractor::extract(Image & image, const char ** params
     const int imageHeight    = image.getHeight();
     const bool isTransparent = image.getTransparencyPresent();
 
-    // Get image data
-    const unsigned char * R = image.getChannel_R();
-    const unsigned char * G = image.getChannel_G();
-    const unsigned char * B = image.getChannel_B();
+    // Get image data (luma of YUV view directly, without conversion to RGB)
+    const bool luma = image.getLumaPresent();
+
+    const unsigned char * R = luma ? image.getGray(GRAYSCALE_AVERAGE) : image.getChannel_R();
+    const unsigned char * G = luma ? R : image.getChannel_G();
+    const unsigned char * B = luma ? R : image.getChannel_B();
 
     const unsigned char * A = nullptr;
 
@@ -24,9 +32,6 @@ Descriptor * EdgeHistogramExtractor::extract(Image & image, const char ** params
     }
 
 
-    unsigned long desired_num_of_blocks;
-    unsigned long block_size;
-
     int	Te_Value;
     EHD	* pLocal_Edge;
 
@@ -34,25 +39,18 @@ Descriptor * EdgeHistogramExtractor::extract(Image & image, const char ** params
     pLocal_Edge = new EHD[1];
 
     Te_Value = Te_Define;
-    desired_num_of_blocks = Desired_Num_of_Blocks;
 
     // Create gray image
     int i, j, xsize, ysize;
     unsigned char * pGrayImage;
 
     // Arbitrary shape (Modified by Dongguk)
-    unsigned char * pResampleImage = nullptr;
-
     int max_x = 0;
     int max_y = 0;
 
     int min_x = imageWidth - 1;
     int min_y = imageHeight - 1;
 
-    double scale, EWweight, NSweight, EWtop, EWbottom;
-    unsigned char NW, NE, SW, SE;
-    int min_size, re_xsize, re_ysize;
-
     if (isTransparent) {
         for (j = 0; j < imageHeight; j++) {
             for (i = 0; i < imageWidth; i++) {
@@ -107,14 +105,266 @@ Descriptor * EdgeHistogramExtractor::extract(Image & image, const char ** params
     }
 
     delete[] R;
-    delete[] G;
-    delete[] B;
+
+    if (!luma) {
+        delete[] G;
+        delete[] B;
+    }
 
     if (A) {
         delete[] A;
     }
 
+    GrayEdgeHistogram(pGrayImage, xsize, ysize, pLocal_Edge, Te_Value);
+
+    // Set descriptor data
+    SetEdgeHistogram(pLocal_Edge);
+
+    // Free memory
+    delete[] pLocal_Edge;
+    delete[] pGrayImage;
+
+    return descriptor;
+}
+
+Descriptor * EdgeHistogramExtractor::extract(TileSource & source, const char ** params) {
+    TRACE_SCOPE("EdgeHistogramExtractor::extractTiles");
+
+    descriptor->loadParameters(params);
+
+    const int sourceWidth    = source.getWidth();
+    const int sourceHeight   = source.getHeight();
+    const bool isTransparent = source.getTransparencyPresent();
+    const int bandHeight     = std::max(1, std::min(source.getTileHeight(), sourceHeight));
+
+    const int Te_Value = Te_Define;
+
+    std::vector<unsigned char> rgb(static_cast<size_t>(sourceWidth) * bandHeight * 3);
+    std::vector<unsigned char> alpha(isTransparent ? static_cast<size_t>(sourceWidth) * bandHeight : 0);
 
+    // Arbitrary shape - bounding box of opaque pixels is found in first pass over source
+    int min_x = 0, min_y = 0;
+    int xsize = sourceWidth;
+    int ysize = sourceHeight;
+
+    if (isTransparent) {
+        int max_x = 0, max_y = 0;
+        min_x = sourceWidth - 1;
+        min_y = sourceHeight - 1;
+
+        for (int top = 0; top < sourceHeight; top += bandHeight) {
+            const int rows = std::min(bandHeight, sourceHeight - top);
+            source.read(0, top, sourceWidth, rows, nullptr, alpha.data());
+
+            for (int j = 0; j < rows; j++) {
+                for (int i = 0; i < sourceWidth; i++) {
+                    if (alpha[static_cast<size_t>(j) * sourceWidth + i]) {
+                        max_x = std::max(max_x, i);
+                        max_y = std::max(max_y, top + j);
+                        min_x = std::min(min_x, i);
+                        min_y = std::min(min_y, top + j);
+                    }
+                }
+            }
+        }
+
+        // Fully transparent source is taken as whole (all of its pixels are 0)
+        if (max_x >= min_x && max_y >= min_y) {
+            xsize = max_x - min_x + 1;
+            ysize = max_y - min_y + 1;
+        }
+        else {
+            min_x = min_y = 0;
+        }
+    }
+
+    EHD Local_Edge;
+
+    // Small region is upsampled, so it is read whole (as in extraction from image)
+    if (std::min(xsize, ysize) < 70) {
+        std::vector<unsigned char> gray(static_cast<size_t>(xsize) * ysize);
+
+        for (int top = 0; top < ysize; top += bandHeight) {
+            const int rows = std::min(bandHeight, ysize - top);
+            source.read(min_x, min_y + top, xsize, rows, rgb.data(), isTransparent ? alpha.data() : nullptr);
+            GrayBand(rgb.data(), isTransparent ? alpha.data() : nullptr, static_cast<size_t>(xsize) * rows, gray.data() + static_cast<size_t>(top) * xsize);
+        }
+
+        GrayEdgeHistogram(gray.data(), xsize, ysize, &Local_Edge, Te_Value);
+        SetEdgeHistogram(&Local_Edge);
+
+        return descriptor;
+    }
+
+    unsigned long block_size = GetBlockSize(xsize, ysize, Desired_Num_of_Blocks);
+
+    if (block_size < 2) {
+        block_size = 2;
+    }
+
+    /* Blocks may be taller than bands, so only quadrant sums of current row of blocks are kept,
+    sums of integer gray values are exact in any order */
+    const unsigned long half         = block_size / 2;
+    const unsigned long blockColumns = xsize / block_size;
+    const int usedWidth              = static_cast<int>(blockColumns * block_size);
+    const int usedHeight             = static_cast<int>(ysize / block_size * block_size);
+
+    std::vector<double> quadrants(blockColumns * 4, 0.0);
+    std::vector<unsigned char> gray(static_cast<size_t>(usedWidth) * bandHeight);
+
+    int  Count_Local[16]        = {0};
+    long LongTyp_Local_Edge[80] = {0};
+
+    for (int top = 0; top < usedHeight; top += bandHeight) {
+        const int rows = std::min(bandHeight, usedHeight - top);
+
+        source.read(min_x, min_y + top, usedWidth, rows, rgb.data(), isTransparent ? alpha.data() : nullptr);
+        GrayBand(rgb.data(), isTransparent ? alpha.data() : nullptr, static_cast<size_t>(usedWidth) * rows, gray.data());
+
+        for (int r = 0; r < rows; r++) {
+            const unsigned long y     = top + r;
+            const unsigned long lower = (y % block_size) < half ? 0 : 2;
+            const unsigned char * row = gray.data() + static_cast<size_t>(r) * usedWidth;
+
+            for (unsigned long x = 0; x < static_cast<unsigned long>(usedWidth); x++) {
+                quadrants[(x / block_size) * 4 + lower + ((x % block_size) < half ? 0 : 1)] += row[x];
+            }
+
+            // Row of blocks is complete
+            if (y % block_size == block_size - 1) {
+                for (unsigned long c = 0; c < blockColumns; c++) {
+                    const double * d = &quadrants[c * 4];
+
+                    AddBlock(c * block_size, y + 1 - block_size, xsize, ysize,
+                             EdgeType(d[0], d[1], d[2], d[3], block_size, Te_Value), Count_Local, LongTyp_Local_Edge);
+                }
+                std::fill(quadrants.begin(), quadrants.end(), 0.0);
+            }
+        }
+    }
+
+    LocalEdges(Count_Local, LongTyp_Local_Edge, &Local_Edge);
+    SetEdgeHistogram(&Local_Edge);
+
+    return descriptor;
+}
+
+void EdgeHistogramExtractor::prepareRegions(Image & image) {
+    TRACE_SCOPE("EdgeHistogramExtractor::prepareRegions");
+
+    regionImageWidth   = image.getWidth();
+    regionImageHeight  = image.getHeight();
+    regionTransparency = image.getTransparencyPresent();
+
+    const size_t size = static_cast<size_t>(regionImageWidth) * regionImageHeight;
+
+    const bool luma = image.getLumaPresent();
+
+    const unsigned char * R = luma ? image.getGray(GRAYSCALE_AVERAGE) : image.getChannel_R();
+    const unsigned char * G = luma ? R : image.getChannel_G();
+    const unsigned char * B = luma ? R : image.getChannel_B();
+    const unsigned char * A = regionTransparency ? image.getChannel_A() : nullptr;
+
+    // Transparent pixels are 0 in gray image of every region
+    regionGray.resize(size);
+
+    for (size_t i = 0; i < size; i++) {
+        regionGray[i] = A && !A[i] ? 0 : static_cast<unsigned char>((float)(R[i] + G[i] + B[i]) / 3.0f);
+    }
+
+    regionAlpha.clear();
+
+    if (A) {
+        regionAlpha.assign(A, A + size);
+    }
+
+    delete[] R;
+
+    if (!luma) {
+        delete[] G;
+        delete[] B;
+    }
+
+    delete[] A;
+}
+
+Descriptor * EdgeHistogramExtractor::extractRegion(const int x, const int y, const int width, const int height, const char ** params) {
+    TRACE_SCOPE("EdgeHistogramExtractor::extractRegion");
+
+    if (x < 0 || y < 0 || width <= 0 || height <= 0 || width > regionImageWidth - x || height > regionImageHeight - y) {
+        throw GRID_NOT_VALID;
+    }
+
+    descriptor->loadParameters(params);
+
+    // Arbitrary shape - bounding box of opaque pixels of region
+    int min_x = x, min_y = y;
+    int xsize = width;
+    int ysize = height;
+
+    if (regionTransparency) {
+        int max_x = x, max_y = y;
+        min_x = x + width - 1;
+        min_y = y + height - 1;
+
+        for (int j = y; j < y + height; j++) {
+            for (int i = x; i < x + width; i++) {
+                if (regionAlpha[static_cast<size_t>(j) * regionImageWidth + i]) {
+                    max_x = std::max(max_x, i);
+                    max_y = std::max(max_y, j);
+                    min_x = std::min(min_x, i);
+                    min_y = std::min(min_y, j);
+                }
+            }
+        }
+
+        // Fully transparent region is taken as whole (as in tiled extraction)
+        if (max_x >= min_x && max_y >= min_y) {
+            xsize = max_x - min_x + 1;
+            ysize = max_y - min_y + 1;
+        }
+        else {
+            min_x = x;
+            min_y = y;
+        }
+    }
+
+    std::vector<unsigned char> gray(static_cast<size_t>(xsize) * ysize);
+
+    for (int j = 0; j < ysize; j++) {
+        const unsigned char * row = &regionGray[static_cast<size_t>(min_y + j) * regionImageWidth + min_x];
+        std::copy(row, row + xsize, gray.begin() + static_cast<size_t>(j) * xsize);
+    }
+
+    EHD Local_Edge;
+
+    GrayEdgeHistogram(gray.data(), xsize, ysize, &Local_Edge, Te_Define);
+    SetEdgeHistogram(&Local_Edge);
+
+    return descriptor;
+}
+
+void EdgeHistogramExtractor::GrayBand(const unsigned char * rgb, const unsigned char * alpha, const size_t pixelCount, unsigned char * gray) {
+    for (size_t i = 0; i < pixelCount; i++) {
+        if (alpha && !alpha[i]) {
+            gray[i] = 0;
+        }
+        else {
+            gray[i] = static_cast<unsigned char>((float)(rgb[i * 3] + rgb[i * 3 + 1] + rgb[i * 3 + 2]) / 3.0f);
+        }
+    }
+}
+
+void EdgeHistogramExtractor::GrayEdgeHistogram(unsigned char * pGrayImage, const int xsize, const int ysize, EHD * pLocal_Edge, const int Te_Value) {
+    int i, j;
+    unsigned long block_size;
+    const unsigned long desired_num_of_blocks = Desired_Num_of_Blocks;
+
+    unsigned char * pResampleImage = nullptr;
+
+    double scale, EWweight, NSweight, EWtop, EWbottom;
+    unsigned char NW, NE, SW, SE;
+    int min_size, re_xsize, re_ysize;
 
     min_size = (xsize>ysize) ? ysize : xsize;
 
@@ -132,11 +382,17 @@ Descriptor * EdgeHistogramExtractor::extract(Image & image, const char ** params
                 EWweight = i / scale - floor(i / scale);
                 NSweight = j / scale - floor(j / scale);
 
-                NW = pGrayImage[static_cast<int>(floor(i / scale))     + static_cast<int>(floor(j / scale)) * xsize];
-                NE = pGrayImage[static_cast<int>(floor(i / scale)) + 1 + static_cast<int>(floor(j / scale)) * xsize];
+                // Neighbours of last column and row are clamped to the image (reading past the buffer made results random)
+                const int x0 = static_cast<int>(floor(i / scale));
+                const int y0 = static_cast<int>(floor(j / scale));
+                const int x1 = x0 + 1 < xsize ? x0 + 1 : xsize - 1;
+                const int y1 = y0 + 1 < ysize ? y0 + 1 : ysize - 1;
 
-                SW = pGrayImage[static_cast<int>(floor(i / scale))     + static_cast<int>(floor(j / scale) + 1) * xsize];
-                SE = pGrayImage[static_cast<int>(floor(i / scale)) + 1 + static_cast<int>(floor(j / scale) + 1) * xsize];
+                NW = pGrayImage[x0 + y0 * xsize];
+                NE = pGrayImage[x1 + y0 * xsize];
+
+                SW = pGrayImage[x0 + y1 * xsize];
+                SE = pGrayImage[x1 + y1 * xsize];
 
                 EWtop    = NW + EWweight * (NE - NW);
                 EWbottom = SW + EWweight * (SE - SW);
@@ -163,23 +419,15 @@ Descriptor * EdgeHistogramExtractor::extract(Image & image, const char ** params
 
         EdgeHistogramGeneration(pGrayImage, xsize, ysize, block_size, pLocal_Edge, Te_Value);
     }
-
-    // Set descriptor data
-    SetEdgeHistogram(pLocal_Edge);
-
-    // Free memory
-    delete[] pLocal_Edge;
-    delete[] pGrayImage;
-
-    return descriptor;
 }
 
 void EdgeHistogramExtractor::EdgeHistogramGeneration(unsigned char * pImage_Y, const unsigned long image_width, const unsigned long image_height, const unsigned long block_size, EHD * pLocal_Edge, const int Te_Value) {
+    TRACE_SCOPE("EdgeHistogramExtractor::EdgeHistogramGeneration");
+
     int  Count_Local[16];
     long LongTyp_Local_Edge[80];
 
-    int sub_local_index;
-    int Offset, EdgeTypeOfBlock;
+    int EdgeTypeOfBlock;
     unsigned int i, j;
 
     // Clear
@@ -188,38 +436,50 @@ void EdgeHistogramExtractor::EdgeHistogramGeneration(unsigned char * pImage_Y, c
 
     for (j = 0; j <= image_height - block_size; j += block_size) {
         for (i = 0; i <= image_width - block_size; i += block_size) {
-
-            sub_local_index = static_cast<int>(i * 4 / image_width) + static_cast<int>(j * 4 / image_height) * 4;
-
-            Count_Local[sub_local_index]++;
-
-            Offset = image_width * j + i;
-
-            EdgeTypeOfBlock = GetEdgeFeature(pImage_Y + Offset, image_width, block_size, Te_Value);
-            switch (EdgeTypeOfBlock) {
-                case NoEdge:
-                    break;
-                case vertical_edge:
-                    LongTyp_Local_Edge[sub_local_index * 5]++;
-                    break;
-                case horizontal_edge:
-                    LongTyp_Local_Edge[sub_local_index * 5 + 1]++;
-                    break;
-                case diagonal_45_degree_edge:
-                    LongTyp_Local_Edge[sub_local_index * 5 + 2]++;
-                    break;
-                case diagonal_135_degree_edge:
-                    LongTyp_Local_Edge[sub_local_index * 5 + 3]++;
-                    break;
-                case non_directional_edge:
-                    LongTyp_Local_Edge[sub_local_index * 5 + 4]++;
-                    break;
-            }
+            EdgeTypeOfBlock = GetEdgeFeature(pImage_Y + image_width * j + i, image_width, block_size, Te_Value);
+            AddBlock(i, j, image_width, image_height, EdgeTypeOfBlock, Count_Local, LongTyp_Local_Edge);
         } 
     }
 
-    for (i = 0; i < 80; i++) { // Range 0.0 ~ 1.0
-        sub_local_index = static_cast<int>(i / 5);
+    LocalEdges(Count_Local, LongTyp_Local_Edge, pLocal_Edge);
+}
+
+void EdgeHistogramExtractor::AddBlock(const unsigned long i, const unsigned long j, const unsigned long image_width, const unsigned long image_height,
+                                      const int EdgeTypeOfBlock, int * Count_Local, long * LongTyp_Local_Edge) {
+    const int sub_local_index = static_cast<int>(i * 4 / image_width) + static_cast<int>(j * 4 / image_height) * 4;
+
+    Count_Local[sub_local_index]++;
+
+    switch (EdgeTypeOfBlock) {
+        case NoEdge:
+            break;
+        case vertical_edge:
+            LongTyp_Local_Edge[sub_local_index * 5]++;
+            break;
+        case horizontal_edge:
+            LongTyp_Local_Edge[sub_local_index * 5 + 1]++;
+            break;
+        case diagonal_45_degree_edge:
+            LongTyp_Local_Edge[sub_local_index * 5 + 2]++;
+            break;
+        case diagonal_135_degree_edge:
+            LongTyp_Local_Edge[sub_local_index * 5 + 3]++;
+            break;
+        case non_directional_edge:
+            LongTyp_Local_Edge[sub_local_index * 5 + 4]++;
+            break;
+    }
+}
+
+void EdgeHistogramExtractor::LocalEdges(const int * Count_Local, const long * LongTyp_Local_Edge, EHD * pLocal_Edge) {
+    for (int i = 0; i < 80; i++) { // Range 0.0 ~ 1.0
+        const int sub_local_index = i / 5;
+
+        // Sub-image of elongated image may get no block (0 / 0 made quantization run past its table)
+        if (Count_Local[sub_local_index] == 0) {
+            pLocal_Edge->Local_Edge[i] = 0.0;
+            continue;
+        }
         pLocal_Edge->Local_Edge[i] = static_cast<double>(LongTyp_Local_Edge[i]) / Count_Local[sub_local_index];
     }
 }
@@ -227,9 +487,6 @@ void EdgeHistogramExtractor::EdgeHistogramGeneration(unsigned char * pImage_Y, c
 int EdgeHistogramExtractor::GetEdgeFeature(unsigned char * pImage_Y, const int image_width, const int block_size, const int Te_Value) {
     int		i, j;
     double	d1, d2, d3, d4;
-    int		e_index;
-    const double  dc_th = Te_Value;
-    double  e_h, e_v, e_45, e_135, e_m, e_max;
 
     d1 = 0.0;
     d2 = 0.0;
@@ -252,6 +509,14 @@ int EdgeHistogramExtractor::GetEdgeFeature(unsigned char * pImage_Y, const int i
             }
         }
     }
+    return EdgeType(d1, d2, d3, d4, block_size, Te_Value);
+}
+
+int EdgeHistogramExtractor::EdgeType(double d1, double d2, double d3, double d4, const unsigned long block_size, const int Te_Value) {
+    int		e_index;
+    const double  dc_th = Te_Value;
+    double  e_h, e_v, e_45, e_135, e_m, e_max;
+
     d1 = d1 / (block_size * block_size / 4.0);
     d2 = d2 / (block_size * block_size / 4.0);
     d3 = d3 / (block_size * block_size / 4.0);
@@ -7,6 +7,9 @@
 
 #include "../../DescriptorExtractor.h"
 #include "../EdgeHistogram/EdgeHistogram.h"
+#include "../../../TOOLS/Tile/TileSource.h"
+
+#include <vector>
 
 typedef	struct Edge_Histogram_Descriptor {
     double Local_Edge[80];
@@ -18,13 +21,43 @@ class EdgeHistogramExtractor : public DescriptorExtractor {
 
         EHD	 * m_pEdge_Histogram = new EHD[1];
 
+        void GrayEdgeHistogram(unsigned char * pGrayImage, int xsize, int ysize, EHD * pLocal_Edge, int Te_Value);
+        void GrayBand(const unsigned char * rgb, const unsigned char * alpha, size_t pixelCount, unsigned char * gray);
+
         void EdgeHistogramGeneration(unsigned char * pImage_Y, unsigned long image_width, unsigned long image_height, unsigned long block_size, EHD * pLocal_Edge, int Te_Value);
         int GetEdgeFeature(unsigned char * pImage_Y, int image_width, int block_size, int Te_Value);
+
+        // Edge type of block from sums of its quadrants (d1 top left, d2 top right, d3 bottom left, d4 bottom right)
+        int EdgeType(double d1, double d2, double d3, double d4, unsigned long block_size, int Te_Value);
+        void AddBlock(unsigned long i, unsigned long j, unsigned long image_width, unsigned long image_height, int EdgeTypeOfBlock, int * Count_Local, long * LongTyp_Local_Edge);
+        void LocalEdges(const int * Count_Local, const long * LongTyp_Local_Edge, EHD * pLocal_Edge);
         unsigned long GetBlockSize(unsigned long image_width, unsigned long image_height, unsigned long desired_num_of_blocks);
         void SetEdgeHistogram(EHD * pEdge_Histogram);
 
+        // Gray values (and alpha) of pixels of image prepared for extraction of regions
+        std::vector<unsigned char> regionGray;
+        std::vector<unsigned char> regionAlpha;
+        int regionImageWidth    = 0;
+        int regionImageHeight   = 0;
+        bool regionTransparency = false;
+
     public:
 	    EdgeHistogramExtractor();
 	    Descriptor * extract(Image & image, const char ** params);
+
+        /** @brief
+        * Extraction from bands of rows read from source, quadrant sums of blocks are accumulated across bands
+        * (transparent source is read twice, first pass finds bounding box of opaque pixels) */
+        Descriptor * extract(TileSource & source, const char ** params);
+
+        /** @brief
+        * Converts image to gray once for extraction of its regions with extractRegion */
+        void prepareRegions(Image & image);
+
+        /** @brief
+        * Extraction from width x height region at (x, y) of prepared image (the same descriptor as of cropped image),
+        * throws ErrorCode (GRID_NOT_VALID for region outside of image) */
+        Descriptor * extractRegion(int x, int y, int width, int height, const char ** params);
+
         ~EdgeHistogramExtractor();
 };
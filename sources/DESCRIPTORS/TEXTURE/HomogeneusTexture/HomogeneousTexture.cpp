@@ -43,66 +43,28 @@ void HomogeneousTexture::loadParameters(const char ** params) {
     }
 }
 
-std::string HomogeneousTexture::generateXML() {
-    XMLDocument xmlDoc;
-
-    XMLDeclaration * p_Declaration = xmlDoc.NewDeclaration("xml version='1.0' encoding='ISO-8859-1' ");
-
-    XMLElement     * p_Root = xmlDoc.NewElement("Mpeg7");
-    XMLElement     * p_DescriptionUnit = xmlDoc.NewElement("DescriptionUnit");
-    XMLElement	   * p_Descriptor = xmlDoc.NewElement("Descriptor");
-    XMLElement     * p_Average = xmlDoc.NewElement("Average");
-    XMLElement     * p_StandardDeviation = xmlDoc.NewElement("StandardDeviation");
-    XMLElement     * p_Energy = xmlDoc.NewElement("Energy");
-    XMLElement     * p_EnergyDeviation = nullptr;
-
-    p_Root->SetAttribute("xmlns", "urn:mpeg:mpeg7:schema:2001");
-    p_Root->SetAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
-    p_DescriptionUnit->SetAttribute("xsi:type", "DescriptorCollectionType");
-    p_Descriptor->SetAttribute("xsi:type", "HomogeneousTextureType");
-
-    p_Root->InsertEndChild(p_DescriptionUnit);
-    p_DescriptionUnit->InsertEndChild(p_Descriptor);
-    p_Descriptor->InsertEndChild(p_Average);
-    p_Descriptor->InsertEndChild(p_StandardDeviation);
-    p_Descriptor->InsertEndChild(p_Energy);
+void HomogeneousTexture::writeXML(XMLWriter & writer) {
+    beginXML(writer, "HomogeneousTextureType");
 
     // Set Average node
-    p_Average->SetText(std::to_string(outputFeature[0]).c_str());
+    writer.textElement("Average", outputFeature[0]);
 
     // Set StandardDeviation node
-    p_StandardDeviation->SetText(std::to_string(outputFeature[1]).c_str());
-
-    std::vector<int> energy(30), energydeviation(30);
+    writer.textElement("StandardDeviation", outputFeature[1]);
 
     // Set Energy node
-    std::string energy_string;
-
-    for (int i = 0; i < 30; i++) {
-        energy_string.append(std::to_string(outputFeature[i + 2]));
-        energy_string.append(" ");
-    }
-    p_Energy->SetText(energy_string.c_str());
+    writer.openElement("Energy");
+    writer.textValues(outputFeature + 2, 30);
+    writer.closeElement();
 
     // Set EnergyDeviation node
-    std::string energyDeviation_string;
-
     if (energyDeviationFlag == 1) {
-        p_EnergyDeviation = xmlDoc.NewElement("EnergyDeviation");
-
-        for (int i = 0; i < 30; i++) {
-            energyDeviation_string.append(std::to_string(outputFeature[i + 32]));
-            energyDeviation_string.append(" ");
-            p_EnergyDeviation->SetText(energyDeviation_string.c_str());
-        }
-        p_Descriptor->InsertEndChild(p_EnergyDeviation);
+        writer.openElement("EnergyDeviation");
+        writer.textValues(outputFeature + 32, 30);
+        writer.closeElement();
     }
-    xmlDoc.InsertFirstChild(p_Declaration);
-    xmlDoc.InsertEndChild(p_Root);
 
-    XMLPrinter xmlPrinter;
-    xmlDoc.Accept(&xmlPrinter);
-    return xmlPrinter.CStr();
+    endXML(writer);
 }
 
 void HomogeneousTexture::readFromXML(XMLElement * descriptorElement) {
@@ -196,4 +158,31 @@ int HomogeneousTexture::GetHomogeneousTextureFeatureFlag() const {
     return energyDeviationFlag;
 }
 
+unsigned long HomogeneousTexture::getBinarySize() {
+    return 63;
+}
+
+void HomogeneousTexture::writeBinary(unsigned char * buffer) {
+    DescriptorBinary::writeUInt8(buffer, energyDeviationFlag);
+
+    // Energy deviation is stored even if flag is not set, zeroed (as readFromXML leaves it)
+    for (int i = 0; i < 62; i++) {
+        DescriptorBinary::writeUInt8(buffer + 1 + i, i < 32 || energyDeviationFlag ? outputFeature[i] : 0);
+    }
+}
+
+void HomogeneousTexture::readFromBinary(const unsigned char * buffer, const unsigned long size) {
+    DescriptorBinary::checkSize(size, getBinarySize());
+
+    if (buffer[0] > 1) {
+        throw BINARY_VALUE_ERROR;
+    }
+
+    energyDeviationFlag = buffer[0];
+
+    for (int i = 0; i < 62; i++) {
+        outputFeature[i] = buffer[1 + i];
+    }
+}
+
 HomogeneousTexture::~HomogeneousTexture() = default;
\ No newline at end of file
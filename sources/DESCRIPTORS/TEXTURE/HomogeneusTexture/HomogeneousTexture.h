@@ -43,7 +43,10 @@ class HomogeneousTexture : public Descriptor {
         HomogeneousTexture();
 
         void loadParameters(const char ** params);
-        std::string generateXML();
+        void writeXML(XMLWriter & writer);
+        unsigned long getBinarySize();
+        void writeBinary(unsigned char * buffer);
+        void readFromBinary(const unsigned char * buffer, unsigned long size);
         void readFromXML(XMLElement * descriptorElement);
 
         void SetHomogeneousTextureFeature(const int * pHomogeneousTextureFeature);
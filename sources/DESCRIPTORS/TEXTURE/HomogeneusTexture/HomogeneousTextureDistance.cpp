@@ -53,6 +53,10 @@ void HomogeneousTextureDistance::loadParameters(const char ** params) {
     }
 }
 
+const char * HomogeneousTextureDistance::GetOption() const {
+    return option;
+}
+
 double HomogeneousTextureDistance::getDistance(Descriptor * descriptor1, Descriptor * descriptor2, const char ** params) {
     const auto homogeneousTextureDescriptor1 = static_cast<HomogeneousTexture *>(descriptor1);
     const auto homogeneousTextureDescriptor2 = static_cast<HomogeneousTexture *>(descriptor2);
@@ -30,6 +30,7 @@ class HomogeneousTextureDistance : public DescriptorDistance {
         double getDistance(Descriptor * descriptor1, Descriptor * descriptor2, const char ** params);
 
         void loadParameters(const char ** params);
+        const char * GetOption() const;
 
         void Dequantization(int * integerFeature, float * floatFeature);
         void Normalization(float * feature);
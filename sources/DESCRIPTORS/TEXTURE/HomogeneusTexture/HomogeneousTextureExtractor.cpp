@@ -1,11 +1,18 @@
 #include "HomogeneousTextureExtractor.h"
+#include "../../../TOOLS/Trace/Trace.h"
 
-HomogeneousTextureExtractor::HomogeneousTextureExtractor(): timage{}, inimage{}, image{}, mean2{}, dev2{}, m_dc(0), m_std(0), Num_pixel(0), hdata{}, vdata{}, dc(0), stdev(0), vec{}, dvec{} {
+#ifdef HTD_RADON_SSE2
+#include <emmintrin.h>
+#endif
+
+HomogeneousTextureExtractor::HomogeneousTextureExtractor(): timage{}, inimage{}, image{}, mean2{}, dev2{}, m_dc(0), m_std(0), Num_pixel(0), hdata{}, vdata{}, dc(0), stdev(0), vec{}, dvec{}, polarRays{}, projection{} {
     descriptor = new HomogeneousTexture();
 }
 
 // Top level extraction
 Descriptor * HomogeneousTextureExtractor::extract(Image & image, const char ** params) {
+    TRACE_SCOPE("HomogeneousTextureExtractor::extract");
+
     descriptor->loadParameters(params);
 
     // Get image information
@@ -22,31 +29,30 @@ Descriptor * HomogeneousTextureExtractor::extract(Image & image, const char ** p
     unsigned char * grayImg  = image.getGray(GRAYSCALE_AVERAGE);
     unsigned char * aChannel = transparencyPresent ? image.getChannel_A() : nullptr;
 
-    if (transparencyPresent && aChannel) {
-        // If alpha channel present, get only not transparent part
-        try {
-            ArbitraryShape(aChannel, grayImg, imageHeight, imageWidth);
-        }
-        catch (ErrorCode exception) {
-            // Cleanup
-            if (grayImg) {
-                delete[] grayImg;
-            }
-            if (aChannel) {
-                delete[] aChannel;
-            }
-            throw;
-        }
+    try {
+        GrayFeatures(grayImg, aChannel, imageHeight, imageWidth);
+    }
+    catch (ErrorCode exception) {
+        delete[] grayImg;
+        delete[] aChannel;
+        throw;
     }
-    // Extract feature
-    FeatureExtraction(grayImg, imageHeight, imageWidth);
 
     delete[] grayImg;
+    delete[] aChannel;
 
+    return descriptor;
+}
+
+void HomogeneousTextureExtractor::GrayFeatures(unsigned char * grayImg, unsigned char * aChannel, const int imageHeight, const int imageWidth) {
     if (aChannel) {
-        delete[] aChannel;
+        // If alpha channel present, get only not transparent part
+        ArbitraryShape(aChannel, grayImg, imageHeight, imageWidth);
     }
 
+    // Extract feature
+    FeatureExtraction(grayImg, imageHeight, imageWidth);
+
     int HomogeneousTextureFeature[62];
 
     // Save 62 features to temporary feature array
@@ -75,6 +81,58 @@ Descriptor * HomogeneousTextureExtractor::extract(Image & image, const char ** p
 
     // Set descriptor data
     descriptor->SetHomogeneousTextureFeature(HomogeneousTextureFeature);
+}
+
+void HomogeneousTextureExtractor::prepareRegions(Image & image) {
+    TRACE_SCOPE("HomogeneousTextureExtractor::prepareRegions");
+
+    regionImageWidth  = image.getWidth();
+    regionImageHeight = image.getHeight();
+
+    const size_t size = static_cast<size_t>(regionImageWidth) * regionImageHeight;
+
+    unsigned char * grayImg  = image.getGray(GRAYSCALE_AVERAGE);
+    unsigned char * aChannel = image.getTransparencyPresent() ? image.getChannel_A() : nullptr;
+
+    regionGray.assign(grayImg, grayImg + size);
+    regionAlpha.clear();
+
+    if (aChannel) {
+        regionAlpha.assign(aChannel, aChannel + size);
+    }
+
+    delete[] grayImg;
+    delete[] aChannel;
+}
+
+Descriptor * HomogeneousTextureExtractor::extractRegion(const int x, const int y, const int width, const int height, const char ** params) {
+    TRACE_SCOPE("HomogeneousTextureExtractor::extractRegion");
+
+    if (x < 0 || y < 0 || width <= 0 || height <= 0 || width > regionImageWidth - x || height > regionImageHeight - y) {
+        throw GRID_NOT_VALID;
+    }
+
+    descriptor->loadParameters(params);
+
+    if (width < 128 || height < 128) {
+        throw HOMOG_TEXT_IMAGE_TOO_SMALL_128;
+    }
+
+    // Region is cropped from prepared planes, arbitrary shape modifies its gray copy
+    std::vector<unsigned char> gray(static_cast<size_t>(width) * height);
+    std::vector<unsigned char> alpha(regionAlpha.empty() ? 0 : gray.size());
+
+    for (int j = 0; j < height; j++) {
+        const size_t source = static_cast<size_t>(y + j) * regionImageWidth + x;
+
+        std::copy(&regionGray[source], &regionGray[source] + width, gray.begin() + static_cast<size_t>(j) * width);
+
+        if (!alpha.empty()) {
+            std::copy(&regionAlpha[source], &regionAlpha[source] + width, alpha.begin() + static_cast<size_t>(j) * width);
+        }
+    }
+
+    GrayFeatures(gray.data(), alpha.empty() ? nullptr : alpha.data(), height, width);
 
     return descriptor;
 }
@@ -235,6 +293,8 @@ bool HomogeneousTextureExtractor::maxtest(const int a, int & max) {
 
 // (KK) First level extraction
 void HomogeneousTextureExtractor::FeatureExtraction(unsigned char * image, const int image_height, const int image_width) {
+    TRACE_SCOPE("HomogeneousTextureExtractor::FeatureExtraction");
+
     int n, m;
     Num_pixel = 180 * 64;
 
@@ -332,22 +392,29 @@ void HomogeneousTextureExtractor::hatomdesign() {
 
 // (KK) Second level extraction
 void HomogeneousTextureExtractor::SecondLevelExtraction(unsigned char * imagedata, int image_height, const int image_width) {
+    TRACE_SCOPE("HomogeneousTextureExtractor::SecondLevelExtraction");
+
     int	i;
     const auto cin = new unsigned char[imsize][imsize];
 
-    const auto fin = new double[Nview][Nray];
+    // Projection is kept by extractor (see getProjection)
+    const auto fin = projection;
 
     double count = 0, count2 = 0, count3 = 0, count4 = 0, count5 = 0;
 
     double sum = 0;
     double min = 1.e10;
 
-    for (i = 0; i < 1024; i++) {
-        timage[i]  = static_cast<COMPLEX *>(calloc(1024, sizeof(COMPLEX)));
-    }
-    for (i = 0; i < 512; i++) {
-        inimage[i] = static_cast<COMPLEX *>(calloc(512, sizeof(COMPLEX)));
-        image[i]   = static_cast<COMPLEX *>(calloc(512, sizeof(COMPLEX)));
+    // FFT buffers are allocated once and kept by extractor. Every extraction overwrites the same
+    // parts of them (imsize x imsize of inimage and image, projected rows of timage), rest stays zero
+    if (timage[0] == nullptr) {
+        for (i = 0; i < 1024; i++) {
+            timage[i]  = static_cast<COMPLEX *>(calloc(1024, sizeof(COMPLEX)));
+        }
+        for (i = 0; i < 512; i++) {
+            inimage[i] = static_cast<COMPLEX *>(calloc(512, sizeof(COMPLEX)));
+            image[i]   = static_cast<COMPLEX *>(calloc(512, sizeof(COMPLEX)));
+        }
     }
 
     // 2000.10.11 - yjyu@samsung.com
@@ -365,16 +432,6 @@ void HomogeneousTextureExtractor::SecondLevelExtraction(unsigned char * imagedat
     Feature(fin, vec, dvec); 
 
     // Cleanup
-    for (i = 0; i < 1024; i++) {
-        free(timage[i]);
-    }
-
-    for (i = 0; i < 512; i++) {
-        free(inimage[i]);
-        free(image[i]);
-    }
-
-    delete[] fin;
     delete[] cin;
 
     // Quantization of features min max extract
@@ -382,6 +439,8 @@ void HomogeneousTextureExtractor::SecondLevelExtraction(unsigned char * imagedat
 }
 
 void HomogeneousTextureExtractor::RadonTransform(unsigned char(*cin)[imsize], double(*fin)[Nray], const int nr, const int nv) {
+    TRACE_SCOPE("HomogeneousTextureExtractor::RadonTransform");
+
     int i, j;
     int size2, size3, nr2;
 
@@ -424,28 +483,36 @@ void HomogeneousTextureExtractor::RadonTransform(unsigned char(*cin)[imsize], do
     nr2 = nr / 2;
     size2 = imsize * 3;
 
-    stepray  = 1.0 / nr;
-    stepview = M_PI / nv;
+    if (radonEngine == HT_RADON_TABLE) {
+        if (!polarTableInit) {
+            BuildPolarTable(nr, nv, size2);
+        }
+        ProjectPolarTable(fin, nr, nv);
+    }
+    else {
+        stepray  = 1.0 / nr;
+        stepview = M_PI / nv;
 
-    for (i = 0, view = 0; i < nv; i++, view = view + stepview) {
-        cosv = cos(view) * nr;
-        sinv = sin(view) * nr;
+        for (i = 0, view = 0; i < nv; i++, view = view + stepview) {
+            cosv = cos(view) * nr;
+            sinv = sin(view) * nr;
 
-        for (j = 0, ray = 0; j < nr2; j++, ray = ray + stepray * 3) { // there are errors at this module.
-            cartesian.x = (ray * cosv + size2 / 2); //nr * size;
-            cartesian.y = (ray * sinv + size2 / 2); //nr * size;
-            out[j + nr2] = GetProjectionFromFFT(cartesian, timage, size2);
-        }
+            for (j = 0, ray = 0; j < nr2; j++, ray = ray + stepray * 3) { // there are errors at this module.
+                cartesian.x = (ray * cosv + size2 / 2); //nr * size;
+                cartesian.y = (ray * sinv + size2 / 2); //nr * size;
+                out[j + nr2] = GetProjectionFromFFT(cartesian, timage, size2);
+            }
 
-        for (j = 0; j < nr2; j++) {
-            out[-j + nr2].r =  out[nr2 + j].r;
-            out[-j + nr2].i = -out[nr2 + j].i;
-        }
+            for (j = 0; j < nr2; j++) {
+                out[-j + nr2].r =  out[nr2 + j].r;
+                out[-j + nr2].i = -out[nr2 + j].i;
+            }
 
-        out[0].r = out[0].i = 0;
+            out[0].r = out[0].i = 0;
 
-        for (j = 0; j < nr; j++) {
-            fin[i][j] = out[j].r * out[j].r + out[j].i * out[j].i; // power spectrum
+            for (j = 0; j < nr; j++) {
+                fin[i][j] = out[j].r * out[j].r + out[j].i * out[j].i; // power spectrum
+            }
         }
     }
 
@@ -460,6 +527,8 @@ void HomogeneousTextureExtractor::RadonTransform(unsigned char(*cin)[imsize], do
 }
 
 void HomogeneousTextureExtractor::Feature(double(*fin)[128], double(*vec)[6], double(*dvec)[6]) {
+    TRACE_SCOPE("HomogeneousTextureExtractor::Feature");
+
     int i, j, n, m;
     double t;
     double deviation[5][6];
@@ -688,6 +757,113 @@ COMPLEX HomogeneousTextureExtractor::GetProjectionFromFFT(const CARTESIAN cart,
     return ret;
 }
 
+void HomogeneousTextureExtractor::BuildPolarTable(const int nr, const int nv, const int size2) {
+    // Same coordinates (accumulated steps included) and weights as GetProjectionFromFFT computes for every image
+    const int nr2 = nr / 2;
+
+    const double stepray  = 1.0 / nr;
+    const double stepview = M_PI / nv;
+
+    double view, ray;
+    int i, j;
+
+    for (i = 0, view = 0; i < nv; i++, view = view + stepview) {
+        const double cosv = cos(view) * nr;
+        const double sinv = sin(view) * nr;
+
+        // timage is square around center of rays, so samples inside it form prefix of view
+        polarRays[i] = 0;
+
+        for (j = 0, ray = 0; j < nr2; j++, ray = ray + stepray * 3) {
+            const double cx = (ray * cosv + size2 / 2);
+            const double cy = (ray * sinv + size2 / 2);
+
+            const int x = static_cast<int>(cx);
+            const int y = static_cast<int>(cy);
+
+            if (x < 0 || y < 0 || x > size2 - 1 || y > size2 - 1) {
+                break;
+            }
+
+            PolarSample & sample = polarTable[i][j];
+            sample.x  = x;
+            sample.y  = y;
+            sample.x2 = x + 1 == size2 ? 0 : x + 1;
+            sample.y2 = y + 1 == size2 ? 0 : y + 1;
+            sample.rx = cx - x;
+            sample.ry = cy - y;
+
+            polarRays[i] = j + 1;
+        }
+    }
+
+    polarTableInit = true;
+}
+
+void HomogeneousTextureExtractor::ProjectPolarTable(double(*fin)[Nray], const int nr, const int nv) {
+    TRACE_SCOPE("HomogeneousTextureExtractor::ProjectPolarTable");
+
+    /* Power spectrum is symmetric (out[nr2 - j] is conjugate of out[nr2 + j]), so every sample fills two rays.
+       Interpolation keeps operation order of GetProjectionFromFFT (no fused multiply-add), projection is bit exact. */
+    const int nr2 = nr / 2;
+
+    for (int i = 0; i < nv; i++) {
+        double * row = fin[i];
+
+        for (int j = 0; j < nr2; j++) {
+            double power = 0;
+
+            if (j < polarRays[i]) {
+                const PolarSample & s = polarTable[i][j];
+
+#ifdef HTD_RADON_SSE2
+                const __m128d a = _mm_loadu_pd(&timage[s.y][s.x].r);
+                const __m128d b = _mm_loadu_pd(&timage[s.y][s.x2].r);
+                const __m128d c = _mm_loadu_pd(&timage[s.y2][s.x].r);
+                const __m128d d = _mm_loadu_pd(&timage[s.y2][s.x2].r);
+
+                const __m128d rx = _mm_set1_pd(s.rx);
+
+                const __m128d buf1  = _mm_add_pd(a, _mm_mul_pd(_mm_sub_pd(b, a), rx));
+                const __m128d buf2  = _mm_add_pd(c, _mm_mul_pd(_mm_sub_pd(d, c), rx));
+                const __m128d value = _mm_add_pd(buf1, _mm_mul_pd(_mm_sub_pd(buf2, buf1), _mm_set1_pd(s.ry)));
+
+                const __m128d square = _mm_mul_pd(value, value);
+                power = _mm_cvtsd_f64(_mm_add_sd(square, _mm_unpackhi_pd(square, square)));
+#else
+                const COMPLEX & a = timage[s.y][s.x];
+                const COMPLEX & b = timage[s.y][s.x2];
+                const COMPLEX & c = timage[s.y2][s.x];
+                const COMPLEX & d = timage[s.y2][s.x2];
+
+                const double buf1r = a.r + (b.r - a.r) * s.rx;
+                const double buf1i = a.i + (b.i - a.i) * s.rx;
+                const double buf2r = c.r + (d.r - c.r) * s.rx;
+                const double buf2i = c.i + (d.i - c.i) * s.rx;
+
+                const double r  = buf1r + (buf2r - buf1r) * s.ry;
+                const double im = buf1i + (buf2i - buf1i) * s.ry;
+
+                power = r * r + im * im;
+#endif
+            }
+
+            row[nr2 + j] = power;
+            row[nr2 - j] = power;
+        }
+
+        row[0] = 0;
+    }
+}
+
+void HomogeneousTextureExtractor::setRadonEngine(const RadonEngine engine) {
+    radonEngine = engine;
+}
+
+double HomogeneousTextureExtractor::getProjection(const int view, const int ray) const {
+    return projection[view][ray];
+}
+
 // Final quantization
 void HomogeneousTextureExtractor::Quantization() {
     int dc1, std1, m1, d1, n, m;
@@ -755,6 +931,14 @@ void HomogeneousTextureExtractor::Quantization() {
 }
 
 HomogeneousTextureExtractor::~HomogeneousTextureExtractor() {
+    for (int i = 0; i < 1024; i++) {
+        free(timage[i]);
+    }
+
+    for (int i = 0; i < 512; i++) {
+        free(inimage[i]);
+        free(image[i]);
+    }
     delete descriptor;
 }
 
@@ -8,6 +8,25 @@
 #include "../../DescriptorExtractor.h"
 #include "../HomogeneusTexture/HomogeneousTexture.h"
 
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define HTD_RADON_SSE2
+#endif
+
+/** Sampling of spectrum on polar grid of Radon transform, both engines give the same projection */
+enum RadonEngine {
+    HT_RADON_TABLE,  // precomputed indices and weights of polar grid, SSE2 kernel (one COMPLEX per register)
+    HT_RADON_DIRECT  // coordinates and weights computed for every sample (GetProjectionFromFFT)
+};
+
+/** Bilinear interpolation of one polar grid sample in timage */
+struct PolarSample {
+    int y, y2;     // rows of timage
+    int x, x2;     // columns of timage
+    double rx, ry; // weights of x2 and y2
+};
+
 class HomogeneousTextureExtractor : public DescriptorExtractor {
     private:
         HomogeneousTexture * descriptor = nullptr;
@@ -37,6 +56,15 @@ class HomogeneousTextureExtractor : public DescriptorExtractor {
         double vec [5][6];
         double dvec[5][6];
 
+        // Polar grid of Radon transform, the same for every image
+        RadonEngine radonEngine = HT_RADON_TABLE;
+        bool polarTableInit = false;
+        PolarSample polarTable[Nview][Nray / 2];
+        int polarRays[Nview]; // samples of view inside timage, rays further from center are zero
+
+        // Filtered power spectrum projection of last extraction
+        double projection[Nview][Nray];
+
         double dcmin = 0.0;
         double dcmax = 255.0; // 2001.01.31 - yjyu@samsung.com
         
@@ -58,6 +86,10 @@ class HomogeneousTextureExtractor : public DescriptorExtractor {
         void RadonTransform(unsigned char(*cin)[imsize], double(*fin)[Nray], int nr, int nv);
         void Feature(double(*fin)[128], double(*vec)[6], double(*dvec)[6]);
         COMPLEX GetProjectionFromFFT(CARTESIAN cart, COMPLEX **inimage, int size2);
+
+        // Polar grid table and kernel filling power spectrum projection from it
+        void BuildPolarTable(int nr, int nv, int size2);
+        void ProjectPolarTable(double(*fin)[Nray], int nr, int nv);
         
         // FFTs
         void FastFourierTransform2d(COMPLEX ** inimage, COMPLEX ** timage, int size2, int x, int y, int inc, double dx, double dy);
@@ -69,9 +101,34 @@ class HomogeneousTextureExtractor : public DescriptorExtractor {
         // Final quantization
         void Quantization();
 
+        // Features of gray image (masked by alpha, when not NULL) saved to descriptor, modifies grayImage
+        void GrayFeatures(unsigned char * grayImage, unsigned char * aChannel, int imageHeight, int imageWidth);
+
+        // Gray and alpha planes of image prepared for extraction of regions
+        std::vector<unsigned char> regionGray;
+        std::vector<unsigned char> regionAlpha;
+        int regionImageWidth  = 0;
+        int regionImageHeight = 0;
+
 
     public:
         HomogeneousTextureExtractor();
         Descriptor * extract(Image & image, const char ** params);
+
+        /** @brief
+        * Converts image to gray once for extraction of its regions with extractRegion */
+        void prepareRegions(Image & image);
+
+        /** @brief
+        * Extraction from width x height region at (x, y) of prepared image (the same descriptor as of cropped image),
+        * throws ErrorCode (GRID_NOT_VALID for region outside of image, HOMOG_TEXT_IMAGE_TOO_SMALL_128) */
+        Descriptor * extractRegion(int x, int y, int width, int height, const char ** params);
+
+        void setRadonEngine(RadonEngine engine);
+
+        /** @brief
+        * Filtered power spectrum projection of last extraction (view in [0, Nview), ray in [0, Nray)) */
+        double getProjection(int view, int ray) const;
+
         ~HomogeneousTextureExtractor();
 };
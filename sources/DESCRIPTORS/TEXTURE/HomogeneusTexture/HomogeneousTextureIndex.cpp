@@ -0,0 +1,227 @@
+#include "HomogeneousTextureIndex.h"
+
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define HTD_SIMD_SSE
+#endif
+
+HomogeneousTextureIndex::HomogeneousTextureIndex() = default;
+
+void HomogeneousTextureIndex::reserve(const unsigned long size) {
+    references.reserve(size * HTD_RECORD_SIZE);
+    bases.reserve(size * 2);
+    flags.reserve(size);
+}
+
+void HomogeneousTextureIndex::pack(HomogeneousTexture * descriptor, float * variants, float * base) {
+    int integerFeature[NUMofFEATURE];
+    float feature[NUMofFEATURE];
+
+    memcpy(integerFeature, descriptor->GetHomogeneousTextureFeature(), sizeof(int) * NUMofFEATURE);
+
+    // Dequantization and normalization of HomogeneousTextureDistance, without its options
+    HomogeneousTextureDistance distance;
+    distance.Dequantization(integerFeature, feature);
+    distance.Normalization(feature);
+
+    base[0] = feature[0];
+    base[1] = feature[1];
+
+    // Variant k holds feature rotated by k angular steps (with padding left as zero),
+    // which is the reference shift used by rotation invariant matching
+    std::fill(variants, variants + HTD_RECORD_SIZE, 0.0f);
+
+    for (int k = 0; k < AngularDivision; k++) {
+        float * variant = variants + k * HTD_VARIANT_SIZE;
+
+        for (int n = 0; n < RadialDivision; n++) {
+            for (int m = 0; m < AngularDivision; m++) {
+                const int source = n * AngularDivision + (m - k + AngularDivision) % AngularDivision;
+
+                variant[n * HTD_ROW_STRIDE + m]                  = feature[source + 2];
+                variant[HTD_BLOCK_SIZE + n * HTD_ROW_STRIDE + m] = feature[source + 32];
+            }
+        }
+    }
+}
+
+unsigned long HomogeneousTextureIndex::add(HomogeneousTexture * descriptor) {
+    references.resize(references.size() + HTD_RECORD_SIZE);
+    bases.resize(bases.size() + 2);
+
+    pack(descriptor, &references[count * HTD_RECORD_SIZE], &bases[count * 2]);
+    flags.push_back(static_cast<unsigned char>(descriptor->GetHomogeneousTextureFeatureFlag()));
+
+    return count++;
+}
+
+unsigned long HomogeneousTextureIndex::size() {
+    return count;
+}
+
+void HomogeneousTextureIndex::clear() {
+    references.clear();
+    bases.clear();
+    flags.clear();
+    count = 0;
+}
+
+float HomogeneousTextureIndex::weightedL1(const float * values1, const float * values2, const float * w, const int length) {
+#ifdef HTD_SIMD_SSE
+    // length is always a multiple of HTD_ROW_STRIDE, so there is no scalar tail
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 sum = _mm_setzero_ps();
+
+    for (int i = 0; i < length; i += 4) {
+        const __m128 diff = _mm_sub_ps(_mm_loadu_ps(values1 + i), _mm_loadu_ps(values2 + i));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(w + i), _mm_andnot_ps(signMask, diff)));
+    }
+
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+#else
+    float sum = 0.0f;
+
+    for (int i = 0; i < length; i++) {
+        sum += w[i] * std::fabs(values1[i] - values2[i]);
+    }
+    return sum;
+#endif
+}
+
+float HomogeneousTextureIndex::rowsDistance(const float * reference, const float * query, const int referenceRow, const int queryRow, const int weightRow, const int rows, const int flag) {
+    const int length = rows * HTD_ROW_STRIDE;
+
+    float result = weightedL1(reference + referenceRow * HTD_ROW_STRIDE, query + queryRow * HTD_ROW_STRIDE, weights + weightRow * HTD_ROW_STRIDE, length);
+
+    if (flag) {
+        result += weightedL1(reference + HTD_BLOCK_SIZE + referenceRow * HTD_ROW_STRIDE,
+                             query + HTD_BLOCK_SIZE + queryRow * HTD_ROW_STRIDE,
+                             weights + HTD_BLOCK_SIZE + weightRow * HTD_ROW_STRIDE, length);
+    }
+    return result;
+}
+
+float HomogeneousTextureIndex::referenceDistance(const unsigned long id, const float * query, const float * queryBase, const int queryFlag, const char * option) {
+    const float * record = &references[id * HTD_RECORD_SIZE];
+    const float * base   = &bases[id * 2];
+    const int flag       = queryFlag * flags[id];
+
+    // Rows and weights follow HomogeneousTextureDistance::getDistance exactly,
+    // only the loops over shifted features became offsets into packed variants
+    const float baseDistance = 0.28f * std::fabs(base[0] - queryBase[0]) + 0.22f * std::fabs(base[1] - queryBase[1]);
+
+    float min = FLT_MAX;
+
+    // ROTATION INVARIANT
+    if (option != nullptr && strcmp(option, "r") == 0) {
+        for (int k = 0; k < AngularDivision; k++) {
+            min = std::min(min, rowsDistance(record + k * HTD_VARIANT_SIZE, query, 0, 0, 0, RadialDivision, flag));
+        }
+        return baseDistance + min;
+    }
+
+    // SCALE INVARIANT
+    if (option != nullptr && strcmp(option, "s") == 0) {
+        for (int i = 0; i < 3; i++) {
+            min = std::min(min, rowsDistance(record, query, 2, 2 - i, 2, RadialDivision - 2, flag));
+        }
+        for (int i = 1; i < 3; i++) {
+            min = std::min(min, baseDistance + rowsDistance(record, query, 2 - i, 2, 2, RadialDivision - 2, flag));
+        }
+        return baseDistance + min;
+    }
+
+    // ROTATION AND SCALE INVARIANT
+    if (option != nullptr && strcmp(option, "rs") == 0) {
+        for (int k = 0; k < AngularDivision; k++) {
+            const float * variant = record + k * HTD_VARIANT_SIZE;
+
+            for (int j = 0; j < 3; j++) {
+                min = std::min(min, rowsDistance(variant, query, 2, 2 - j, 2, RadialDivision - 2, flag));
+            }
+            for (int j = 1; j < 3; j++) {
+                min = std::min(min, rowsDistance(variant, query, 2 - j, 2, 2, RadialDivision - 2, flag));
+            }
+        }
+        return baseDistance + min;
+    }
+
+    // DEFAULT
+    return baseDistance + rowsDistance(record, query, 0, 0, 0, RadialDivision, flag);
+}
+
+void HomogeneousTextureIndex::getDistances(HomogeneousTexture * query, const char ** params, float * distances) {
+    // Option of this query only (loadParameters keeps previous option, when params are empty)
+    HomogeneousTextureDistance distance;
+    distance.loadParameters(params);
+
+    std::vector<float> queryRecord(HTD_RECORD_SIZE);
+    float queryBase[2];
+
+    pack(query, queryRecord.data(), queryBase);
+
+    const int queryFlag = query->GetHomogeneousTextureFeatureFlag();
+
+    for (unsigned long i = 0; i < count; i++) {
+        distances[i] = referenceDistance(i, queryRecord.data(), queryBase, queryFlag, distance.GetOption());
+    }
+}
+
+std::vector<std::pair<unsigned long, float>> HomogeneousTextureIndex::search(HomogeneousTexture * query, const char ** params, unsigned long k) {
+    std::vector<std::pair<unsigned long, float>> result;
+
+    // Option of this query only (loadParameters keeps previous option, when params are empty)
+    HomogeneousTextureDistance distance;
+    distance.loadParameters(params);
+
+    if (k == 0 || count == 0) {
+        return result;
+    }
+    k = std::min(k, count);
+
+    std::vector<float> queryRecord(HTD_RECORD_SIZE);
+    float queryBase[2];
+
+    pack(query, queryRecord.data(), queryBase);
+
+    const int queryFlag = query->GetHomogeneousTextureFeatureFlag();
+
+    // Max-heap on distance, holding the k best references found so far
+    const auto farther = [](const std::pair<unsigned long, float> & a, const std::pair<unsigned long, float> & b) {
+        return a.second < b.second;
+    };
+
+    result.reserve(k);
+
+    for (unsigned long i = 0; i < count; i++) {
+        const float d = referenceDistance(i, queryRecord.data(), queryBase, queryFlag, distance.GetOption());
+
+        if (result.size() < k) {
+            result.emplace_back(i, d);
+            std::push_heap(result.begin(), result.end(), farther);
+        }
+        else if (d < result.front().second) {
+            std::pop_heap(result.begin(), result.end(), farther);
+            result.back() = std::make_pair(i, d);
+            std::push_heap(result.begin(), result.end(), farther);
+        }
+    }
+
+    std::sort_heap(result.begin(), result.end(), farther);
+    return result;
+}
+
+HomogeneousTextureIndex::~HomogeneousTextureIndex() = default;
+
+#define HTD_W_ROW(w) w, w, w, w, w, w, 0.0f, 0.0f
+
+const float HomogeneousTextureIndex::weights[HTD_VARIANT_SIZE] = {
+    // Energy rows (wm)
+    HTD_W_ROW(0.42f), HTD_W_ROW(1.00f), HTD_W_ROW(1.00f), HTD_W_ROW(0.08f), HTD_W_ROW(1.00f),
+    // Energy deviation rows (wd)
+    HTD_W_ROW(0.32f), HTD_W_ROW(1.00f), HTD_W_ROW(1.00f), HTD_W_ROW(1.00f), HTD_W_ROW(1.00f)
+};
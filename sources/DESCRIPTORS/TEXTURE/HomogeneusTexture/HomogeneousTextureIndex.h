@@ -0,0 +1,71 @@
+/** @file   HomogeneousTextureIndex.h
+ *  @brief  Homogeneous Texture search layout for scanning many reference descriptors.
+ *
+ *          Every added reference is dequantized and normalized once and stored
+ *          in all AngularDivision rotations. Each rotation is a variant of
+ *          HTD_VARIANT_SIZE floats: energy block followed by energy deviation block,
+ *          both made of RadialDivision rows padded to HTD_ROW_STRIDE values.
+ *
+ *          Rotation invariant matching picks one of the stored variants,
+ *          scale invariant matching only shifts the row offset inside a variant,
+ *          so no feature is re-derived while searching and every comparison
+ *          is a single weighted L1 kernel over contiguous memory.
+ *
+ *          Supported options are the same as in HomogeneousTextureDistance
+ *          ("n", "r", "s", "rs"); distances are computed in single precision.
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "HomogeneousTexture.h"
+#include "HomogeneousTextureDistance.h"
+
+#define HTD_ROW_STRIDE   8
+#define HTD_BLOCK_SIZE   (RadialDivision * HTD_ROW_STRIDE)
+#define HTD_VARIANT_SIZE (2 * HTD_BLOCK_SIZE)
+#define HTD_RECORD_SIZE  (AngularDivision * HTD_VARIANT_SIZE)
+
+class HomogeneousTextureIndex {
+    private:
+        std::vector<float> references; // HTD_RECORD_SIZE floats per reference
+        std::vector<float> bases;      // normalized average and standard deviation per reference
+        std::vector<unsigned char> flags;
+
+        unsigned long count = 0;
+
+        static const float weights[HTD_VARIANT_SIZE];
+
+        void pack(HomogeneousTexture * descriptor, float * variants, float * base);
+
+        static float weightedL1(const float * values1, const float * values2, const float * w, int length);
+        static float rowsDistance(const float * reference, const float * query, int referenceRow, int queryRow, int weightRow, int rows, int flag);
+
+        float referenceDistance(unsigned long id, const float * query, const float * queryBase, int queryFlag, const char * option);
+
+    public:
+        HomogeneousTextureIndex();
+
+        void reserve(unsigned long size);
+        unsigned long add(HomogeneousTexture * descriptor);
+        unsigned long size();
+        void clear();
+
+        /** @brief
+        * Computes distance between query and every reference
+        * @param query - query descriptor (first descriptor of HomogeneousTextureDistance::getDistance)
+        * @param params - distance parameters, same as for HomogeneousTextureDistance
+        * @param distances - output array of size() elements */
+        void getDistances(HomogeneousTexture * query, const char ** params, float * distances);
+
+        /** @brief
+        * Finds k nearest references to query
+        * @return vector of (reference id, distance) pairs sorted by ascending distance */
+        std::vector<std::pair<unsigned long, float>> search(HomogeneousTexture * query, const char ** params, unsigned long k);
+
+        ~HomogeneousTextureIndex();
+};
@@ -170,170 +170,73 @@ int * TextureBrowsing::getBrowsingComponent() {
     return m_Browsing_Component;
 }
 
-std::string TextureBrowsing::generateXML() {
-	XMLDocument xmlDoc;
-
-	XMLDeclaration * p_Declaration = xmlDoc.NewDeclaration("xml version='1.0' encoding='ISO-8859-1' ");
-	XMLElement * p_Root = xmlDoc.NewElement("Mpeg7");
-	XMLElement * p_DescriptionUnit = xmlDoc.NewElement("DescriptionUnit");
-	XMLElement * p_Descriptor = xmlDoc.NewElement("Descriptor");
-	XMLElement * p_Regularity = xmlDoc.NewElement("Regularity");
-	XMLElement * p_Direction1 = xmlDoc.NewElement("Direction");
-	XMLElement * p_Scale1 = xmlDoc.NewElement("Scale");
-	XMLElement * p_Direction2 = nullptr;
-	XMLElement * p_Scale2 = nullptr;
-
-	p_Root->SetAttribute("xmlns", "urn:mpeg:mpeg7:schema:2001");
-	p_Root->SetAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
-	p_DescriptionUnit->SetAttribute("xsi:type", "DescriptorCollectionType");
-	p_Descriptor->SetAttribute("xsi:type", "TextureBrowsingType");
-
-	p_Root->InsertEndChild(p_DescriptionUnit);
-	p_DescriptionUnit->InsertEndChild(p_Descriptor);
-
-	p_Descriptor->InsertEndChild(p_Regularity);
-	p_Descriptor->InsertEndChild(p_Direction1);
-	p_Descriptor->InsertEndChild(p_Scale1);
-
-	std::string regularity_string = "";
-	std::string direction1_string = "";
-	std::string scale1_string	  = "";
+void TextureBrowsing::writeXML(XMLWriter & writer) {
+	static const char * regularityNames[] = { "irregular", "slightly regular", "regular", "highly regular" };
+	static const char * directionNames[]  = { "No directionality", "0 degree", "30 degree", "60 degree", "90 degree", "120 degree", "150 degree" };
+	static const char * scaleNames[]      = { "fine", "medium", "coarse", "very coarse" };
 
-	/*
-    Set regularity node */
-	switch (m_Browsing_Component[0]) {
-		case 1:
-			regularity_string.append("irregular");
-			break;
-		case 2:
-			regularity_string.append("slightly regular");
-			break;
-		case 3:
-			regularity_string.append("regular");
-			break;
-		case 4:
-			regularity_string.append("highly regular");
-			break;
-		default:
-            throw TEXT_BROWS_WRONG_COMPONENT_VALUE;
+	if (!validComponents(m_Browsing_Component, m_ComponentNumberFlag)) {
+		throw TEXT_BROWS_WRONG_COMPONENT_VALUE;
 	}
-	p_Regularity->SetText(regularity_string.c_str());
 
-	/*
-    Set first direction node */
-	switch (m_Browsing_Component[1]) {
-		case 0:
-			direction1_string.append("No directionality");
-			break;
-		case 1:
-			direction1_string.append("0 degree");
-			break;
-		case 2:
-			direction1_string.append("30 degree");
-			break;
-		case 3:
-			direction1_string.append("60 degree");
-			break;
-		case 4:
-			direction1_string.append("90 degree");
-			break;
-		case 5:
-			direction1_string.append("120 degree");
-			break;
-		case 6:
-			direction1_string.append("150 degree");
-			break;
-		default:
-            throw TEXT_BROWS_WRONG_COMPONENT_VALUE;
-	}
-	p_Direction1->SetText(direction1_string.c_str());
+	beginXML(writer, "TextureBrowsingType");
+
+	writer.textElement("Regularity", regularityNames[m_Browsing_Component[0] - 1]);
+	writer.textElement("Direction", directionNames[m_Browsing_Component[1]]);
+	writer.textElement("Scale", scaleNames[m_Browsing_Component[2] - 1]);
 
 	/*
-    Set first scale node */
-	switch (m_Browsing_Component[2]) {
-		case 1:
-			scale1_string.append("fine");
-			break;
-		case 2:
-			scale1_string.append("medium");
-			break;
-		case 3:
-			scale1_string.append("coarse");
-			break;
-		case 4:
-			scale1_string.append("very coarse");
-			break;
-		default:
-            throw TEXT_BROWS_WRONG_COMPONENT_VALUE;
-	}
-	p_Scale1->SetText(scale1_string.c_str());
-
-    /*
-    Set second direction node if flag requires */
-	if (m_ComponentNumberFlag != 0) { 
-		std::string direction2_string = "";
-		std::string scale2_string = "";
-
-		p_Direction2 = xmlDoc.NewElement("Direction");
-		p_Descriptor->InsertEndChild(p_Direction2);
-
-		switch (m_Browsing_Component[3]) {
-			case 0:
-				direction2_string.append("No directionality");
-				break;
-			case 1:
-				direction2_string.append("0 degree");
-				break;
-			case 2:
-				direction2_string.append("30 degree");
-				break;
-			case 3:
-				direction2_string.append("60 degree");
-				break;
-			case 4:
-				direction2_string.append("90 degree");
-				break;
-			case 5:
-				direction2_string.append("120 degree");
-				break;
-			case 6:
-				direction2_string.append("150 degree");
-				break;
-			default:
-                throw TEXT_BROWS_WRONG_COMPONENT_VALUE;
-		}
-		p_Direction2->SetText(direction2_string.c_str());
-
-		/*
-        Set second scale node: */
-		p_Scale2 = xmlDoc.NewElement("Scale");
-		p_Descriptor->InsertEndChild(p_Scale2);
-
-		switch (m_Browsing_Component[4]) {
-			case 1:
-				scale2_string.append("fine");
-				break;
-			case 2:
-				scale2_string.append("medium");
-				break;
-			case 3:
-				scale2_string.append("coarse");
-				break;
-			case 4:
-				scale2_string.append("very coarse");
-				break;
-			default:
-                throw TEXT_BROWS_WRONG_COMPONENT_VALUE;
-		}
-		p_Scale2->SetText(scale2_string.c_str());
+    Set second direction and scale nodes if flag requires */
+	if (m_ComponentNumberFlag != 0) {
+		writer.textElement("Direction", directionNames[m_Browsing_Component[3]]);
+		writer.textElement("Scale", scaleNames[m_Browsing_Component[4] - 1]);
 	}
 
-	xmlDoc.InsertFirstChild(p_Declaration);
-	xmlDoc.InsertEndChild(p_Root);
+	endXML(writer);
+}
+
+unsigned long TextureBrowsing::getBinarySize() {
+    return 6;
+}
+
+bool TextureBrowsing::validComponents(const int * components, const int componentNumberFlag) {
+    // Same ranges as accepted by writeXML and readFromXML
+    const auto validDirection = [](const int value) { return value >= 0 && value <= 6; };
+    const auto validScale     = [](const int value) { return value >= 1 && value <= 4; };
+
+    if (components[0] < 1 || components[0] > 4 || !validDirection(components[1]) || !validScale(components[2])) {
+        return false;
+    }
+    return componentNumberFlag == 0 || (validDirection(components[3]) && validScale(components[4]));
+}
+
+void TextureBrowsing::writeBinary(unsigned char * buffer) {
+    if (!validComponents(m_Browsing_Component, m_ComponentNumberFlag)) {
+        throw TEXT_BROWS_WRONG_COMPONENT_VALUE;
+    }
+
+    DescriptorBinary::writeUInt8(buffer, m_ComponentNumberFlag != 0 ? 1 : 0);
+
+    for (int i = 0; i < 5; i++) {
+        DescriptorBinary::writeUInt8(buffer + 1 + i, i < 3 || m_ComponentNumberFlag != 0 ? m_Browsing_Component[i] : 0);
+    }
+}
+
+void TextureBrowsing::readFromBinary(const unsigned char * buffer, const unsigned long size) {
+    DescriptorBinary::checkSize(size, getBinarySize());
+
+    int components[5];
+
+    for (int i = 0; i < 5; i++) {
+        components[i] = buffer[1 + i];
+    }
+
+    if (buffer[0] > 1 || !validComponents(components, buffer[0])) {
+        throw BINARY_VALUE_ERROR;
+    }
 
-	XMLPrinter xmlPrinter;
-	xmlDoc.Accept(&xmlPrinter);
-	return xmlPrinter.CStr();
+    m_ComponentNumberFlag = buffer[0];
+    SetBrowsing_Component(components);
 }
 
 TextureBrowsing::~TextureBrowsing() {
@@ -14,6 +14,8 @@ class TextureBrowsing : public Descriptor {
 	private:
         int m_ComponentNumberFlag  = 1;
         int * m_Browsing_Component = nullptr;
+
+        static bool validComponents(const int * components, int componentNumberFlag);
 	public:
         TextureBrowsing();
         void loadParameters(const char ** params);
@@ -25,7 +27,10 @@ class TextureBrowsing : public Descriptor {
         int GetComponentNumberFlag();
         int * getBrowsingComponent();
 
-        std::string generateXML();
+        void writeXML(XMLWriter & writer);
+        unsigned long getBinarySize();
+        void writeBinary(unsigned char * buffer);
+        void readFromBinary(const unsigned char * buffer, unsigned long size);
 
 		~TextureBrowsing();
 };
@@ -1,4 +1,5 @@
 #include "TextureBrowsingExtractor.h"
+#include "../../../TOOLS/Trace/Trace.h"
 
 /* ----- CONSTRUCTOR ----- */
 TextureBrowsingExtractor::TextureBrowsingExtractor() {
@@ -7,11 +8,19 @@ TextureBrowsingExtractor::TextureBrowsingExtractor() {
 
 /* ----- EXTRACTION ----- */
 Descriptor * TextureBrowsingExtractor::extract(Image & image, const char ** params) {
+    TRACE_SCOPE("TextureBrowsingExtractor::extract");
+
     descriptor->loadParameters(params);
 
     // 2. Get image data
     const int imageHeight = image.getHeight();
     const int imageWidth = image.getWidth();
+
+    // Check size - image is mirrored by XM_SIDE pixels on each side before filtering
+    if (imageWidth < XM_SIDE || imageHeight < XM_SIDE) {
+        throw TEXT_BROWS_IMAGE_TOO_SMALL;
+    }
+
     unsigned char * grayImage = image.getGray(GRAYSCALE_AVERAGE);
     unsigned char * aChannel = nullptr;
 
@@ -201,6 +210,8 @@ bool TextureBrowsingExtractor::max_test(const int a, int & max) {
 
 /* ----- TBC EXTRACTION ----- */
 void TextureBrowsingExtractor::PBC_Extraction(Matrix * img, const int width, int height, int * pbc_out) {
+    TRACE_SCOPE("TextureBrowsingExtractor::PBC_Extraction");
+
     /* (KK) Method extracting TBC from image matrix */
 
 
@@ -298,16 +309,16 @@ void TextureBrowsingExtractor::cleaupMainVariables(const int orientation, const
 }
 
 int TextureBrowsingExtractor::GaborFeature(Matrix * img, int side, double Ul, double Uh, int scale, int orientation, int flag, int * pbc) {
+    TRACE_SCOPE("TextureBrowsingExtractor::GaborFeature");
+
     /* (KK) Main steps of calculating directions (more at page 281-282 from 15938-8):
        - create new image matrix from default image matrix passed as argument
        - make Gabor Transform filtered image for each scale-direction combination for that matrix
        - calculate directions from those filtered images (using histograms)
-       - calculate projections from filtered images and save them to files (later usage) */
+       - calculate projections from filtered images and keep them in memory (later usage in pbcmain) */
 
     /* (KK) FIRST ALLOCATIONS AND VARIABLES */
-    char  str[200];
     unsigned char dummy2;
-    FILE * fp;
 
     int i, h, w, wid, hei, imgwid, imghei, s, n, base;
     int border, r1, r2, r3, r4;
@@ -368,6 +379,9 @@ int TextureBrowsingExtractor::GaborFeature(Matrix * img, int side, double Ul, do
     for (i = 0; i < orientation * scale; i++) {
         columnProjections[i] = static_cast<double *>(malloc(ProjectionSize * sizeof(double)));
     }
+
+    rowProjectionData.assign(orientation * scale * ProjectionSize, 0.0);
+    columnProjectionData.assign(orientation * scale * ProjectionSize, 0.0);
     /* (KK) Allocate all the ImageHeaders, imageData and Matrices.
     Newly created images are all initialized to 0 by default */
 
@@ -705,40 +719,8 @@ int TextureBrowsingExtractor::GaborFeature(Matrix * img, int side, double Ul, do
                 rowProjections[s * orientation + n][h] = temp_proj[h];
             }
 
-            /* (KK) Create directory for temporary projection files (based on operating system)
-            On Windows when using tinyXML header it was not possible to create directory by classic way
-            using windows.h header (XMLDocument redefinition error) */
-            std::string directory_name = "text_brows_tmp";
-
-            #if defined(_WIN32) || defined(_WIN64) // Windows
-                struct stat info;
-                // If directory does not exist
-                if (stat(directory_name.c_str(), &info) != 0) {
-                    std::string command = "mkdir " +  directory_name;
-                    system(command.c_str());
-                }
-            #else // Linux
-                struct stat st = {0};
-                // If directory does not exist
-                if (stat("text_brows_tmp", &st) == -1) {
-                    mkdir("text_brows_tmp", 0700);
-                }
-            #endif
-
-            /* (KK) Save projection rows to files */
-            sprintf(str, "text_brows_tmp/default_Row_%d%d", s, n);
-
-            if ((fp = fopen(str, "wb")) == nullptr) {
-                // Cleanup
-                cleaupMainVariables(orientation, scale, temp_proj, rowProjections, columnProjections, histo,
-                                    FilteredImageBuffer, Gr, Gi, Tmp_1, Tmp_2, F_1, F_2, G_real, G_imag,
-                                    F_real, F_imag, IMG, IMG_imag, temp_FilteredImage);
-                // Throw level higher
-                throw TEXT_BROWSING_CANNOT_OPEN_FILE;
-            }
-
-            fwrite(rowProjections[s * orientation + n], sizeof(double), ProjectionSize, fp);
-            fclose(fp);
+            /* Keep projection rows for scale calculation */
+            memcpy(&rowProjectionData[(s * orientation + n) * ProjectionSize], rowProjections[s * orientation + n], ProjectionSize * sizeof(double));
 
             for (h = 0; h < imghei; h++) {
                 for (w = 0; w < imgwid; w++) {
@@ -769,22 +751,10 @@ int TextureBrowsingExtractor::GaborFeature(Matrix * img, int side, double Ul, do
                 columnProjections[s * orientation + n][h] = temp_proj[h];
             }
 
-            /* (KK) Save projection columns to files */
-            sprintf(str, "text_brows_tmp/default_Column_%d%d", s, n);
-
-            if ((fp = fopen(str, "wb")) == nullptr) {
-                // Cleanup
-                cleaupMainVariables(orientation, scale, temp_proj, rowProjections, columnProjections, histo,
-                    FilteredImageBuffer, Gr, Gi, Tmp_1, Tmp_2, F_1, F_2, G_real, G_imag,
-                    F_real, F_imag, IMG, IMG_imag, temp_FilteredImage);
-                // Throw level higher
-                throw TEXT_BROWSING_CANNOT_OPEN_FILE;
-            }
+            /* Keep projection columns for scale calculation */
+            memcpy(&columnProjectionData[(s * orientation + n) * ProjectionSize], columnProjections[s * orientation + n], ProjectionSize * sizeof(double));
 
             free(temp_proj);
-
-            fwrite(columnProjections[s * orientation + n], sizeof(double), ProjectionSize, fp);
-            fclose(fp);
         }
     }
 
@@ -1141,18 +1111,17 @@ void TextureBrowsingExtractor::ComputeProjection(Matrix * inputImage, const int
 
 /* ----- SCALE CALCULATION MAIN METHODS I GUESS  ----- */
 void TextureBrowsingExtractor::pbcmain(struct pbc_struct * pbc, const int size) {
-    char c5[200];
+    TRACE_SCOPE("TextureBrowsingExtractor::pbcmain");
+
     float row_credit[3], column_credit[3], image_credit;
 
     int img_size;
 
     img_size = static_cast<int>(size * 0.625);
 
-    sprintf(c5, "default");
-
     try {
-        ProjectionAnalysis(c5, 1, row_credit, pbc, img_size);
-        ProjectionAnalysis(c5, 2, column_credit, pbc, img_size);
+        ProjectionAnalysis(rowProjectionData.data(), 1, row_credit, pbc, img_size);
+        ProjectionAnalysis(columnProjectionData.data(), 2, column_credit, pbc, img_size);
     }
     catch (ErrorCode exception) {
         throw;
@@ -1275,9 +1244,7 @@ int TextureBrowsingExtractor::RadonAutocorrelation(double * x_in, const int x_lo
     return 2 * cut + 1;
 }
 
-void TextureBrowsingExtractor::ProjectionAnalysis(char * image_name, const int proj_type, float * credit, pbc_struct * pbc, const int img_size) {
-    char c5[200];
-
+void TextureBrowsingExtractor::ProjectionAnalysis(const double * projections, const int proj_type, float * credit, pbc_struct * pbc, const int img_size) {
     float ** Proj_Candi_Valu = nullptr;
     float ** contrast = nullptr;
     float * Peak, peak_diff, dis_ratio, dis_peak, var_dis;
@@ -1288,8 +1255,6 @@ void TextureBrowsingExtractor::ProjectionAnalysis(char * image_name, const int p
     int i, j, k;
     double * A, *B;
 
-    FILE * fp;
-
     Proj_Candi_Posi = AllocateMatrixInteger(24, 2);
     Proj_Candi_Valu = AllocateMatrixFloat(24, 2);
     Candi_Avail = 0;
@@ -1302,32 +1267,8 @@ void TextureBrowsingExtractor::ProjectionAnalysis(char * image_name, const int p
     // For each filtered image W_mn(x,y) (4.3.2.1.4 Computation of the scale, Projection)
     for (i = 0; i < 4; i++) {
         for (j = 0; j < 6; j++) {
-            /* PROJECTION READ FROM FILE
-            Choose projection files names based on projection type currently calculated
-            for corresponding scale and orientation (i, j) */
-            if (proj_type == 1) {
-                sprintf(c5, "text_brows_tmp/%s_Row_%d%d", image_name, i, j);
-            }
-            else if (proj_type == 2) {
-                sprintf(c5, "text_brows_tmp/%s_Column_%d%d", image_name, i, j);
-            }
-
-            /* Open current scale and orientation projection file */
-            fp = fopen(c5, "rb");
-
-            if (!fp) { // Could not open file
-                free(A);
-                FreeMatrixInteger(Proj_Candi_Posi, 24);
-                FreeMatrixFloat(Proj_Candi_Valu, 24);
-                FreeMatrixFloat(contrast, 4);
-                throw TEXT_BROWS_FILE_READ_ERROR;
-            }
-
-            /* Read projection file to A array */
-            fread(A, sizeof(double), img_size, fp);
-            fclose(fp);
-
-            /* PROJECTION READ END */
+            /* Projection of current scale and orientation (i, j), computed in GaborFeature */
+            memcpy(A, projections + (i * 6 + j) * img_size, img_size * sizeof(double));
 
             /* (KK)
             Autocorreclation of Radon transform (which projections aready went through before) */
@@ -8,14 +8,6 @@
 #include "../../DescriptorExtractor.h"
 #include "../TextureBrowsing/TextureBrowsing.h"
 
-// Headers for directory creation in Linux
-#include <sys/types.h>
-#include <sys/stat.h>
-
-#if !defined(_WIN32) && !defined(_WIN64)
-    #include <unistd.h>
-#endif
-
 #ifndef M_PI
 #define M_PI 3.141592653589793115997963468544185161590576171875
 #endif
@@ -73,6 +65,11 @@ class TextureBrowsingExtractor : public DescriptorExtractor {
     private:
         TextureBrowsing * descriptor = nullptr;
 
+        // Row and column projections of filtered images (scale x orientation x projection size),
+        // computed in GaborFeature and analysed in pbcmain
+        std::vector<double> rowProjectionData;
+        std::vector<double> columnProjectionData;
+
         // Aribtrary shape methods
         void ArbitraryShape(unsigned char * a_image, unsigned char * y_image, int image_height, int image_width);
         bool max_test(int a, int & max);
@@ -95,7 +92,7 @@ class TextureBrowsingExtractor : public DescriptorExtractor {
         // Lower level methods:
         void Gabor(Matrix * Gr, Matrix * Gi, int s, int n, double Ul, double Uh, int scale, int orientation, int flag);
         void ComputeProjection(Matrix * inputImage, int xsize, int ysize, double angle, int proj_size, double * proj);
-        void ProjectionAnalysis(char * image_name, int proj_type, float * credit, struct pbc_struct * pbc, int img_size);
+        void ProjectionAnalysis(const double * projections, int proj_type, float * credit, struct pbc_struct * pbc, int img_size);
         float ComputeProjectionContrast(double * B, int leng_B, int * PeakI, float * Peak, int num_peak);
         double ComputeHistogramContrast(int index, double * histo, int len);
          
@@ -1,10 +1,14 @@
 #include <jni.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "../Mpeg7.h"
 #include "com_mpeg7_bridge_libmpeg7.h"
 
 jstring createJniMessage(JNIEnv * env, const char * message);
 const char ** getParameters(JNIEnv * env, jobjectArray parameters);
+void releaseParameters(JNIEnv * env, jobjectArray parameters, const char ** params);
 unsigned char * getImageBuffer(JNIEnv * env, jbyteArray data, int size);
 
 JNIEXPORT jstring JNICALL Java_com_mpeg7_bridge_libmpeg7_extractDescriptor
@@ -88,11 +92,13 @@ JNIEXPORT jstring JNICALL Java_com_mpeg7_bridge_libmpeg7_extractDescriptorFromDa
         params = getParameters(env, parameters);
     }
     catch (ErrorCode exception) {
-        env->NewStringUTF(message(exception));
+        delete[] imgData;
+        return createJniMessage(env, message(exception));
     }
 
     if (params == nullptr) {
-        env->NewStringUTF(message(JNI_PARAMS_NULL));
+        delete[] imgData;
+        return createJniMessage(env, message(JNI_PARAMS_NULL));
     }
 
     const char * result = extractDescriptorFromData(static_cast<DescriptorType>(desType), imgData, data_len, params);
@@ -159,9 +165,226 @@ JNIEXPORT jstring JNICALL Java_com_mpeg7_bridge_libmpeg7_calculateDistance
     return createJniMessage(env, result);
 }
 
+JNIEXPORT jint JNICALL Java_com_mpeg7_bridge_libmpeg7_extractDescriptorFromBuffer
+(JNIEnv * env, jobject, const jint descriptorType, const jobject imageBuffer, const jint imageSize, const jobjectArray parameters, const jobject outputBuffer) {
+    if (!descriptorType) {
+        return -JNI_DESCRIPTOR_TYPE_NULL;
+    }
+
+    if (!imageBuffer) {
+        return -JNI_IMG_NULL;
+    }
+
+    if (!parameters) {
+        return -JNI_PARAMS_NULL;
+    }
+
+    if (!outputBuffer) {
+        return -BINARY_BUFFER_NULL;
+    }
+
+    // Both buffers have to be direct, their memory is used in place without any copy
+    const auto imgData = static_cast<unsigned char *>(env->GetDirectBufferAddress(imageBuffer));
+    const auto output  = static_cast<unsigned char *>(env->GetDirectBufferAddress(outputBuffer));
+
+    if (imgData == nullptr || imageSize <= 0 || imageSize > env->GetDirectBufferCapacity(imageBuffer)) {
+        return -JNI_IMG_NULL;
+    }
+
+    if (output == nullptr) {
+        return -BINARY_BUFFER_NULL;
+    }
+
+    const jlong capacity = env->GetDirectBufferCapacity(outputBuffer);
+
+    const char ** params = nullptr;
+
+    try {
+        params = getParameters(env, parameters);
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+
+    const int result = extractDescriptorBinaryFromData(static_cast<DescriptorType>(descriptorType), imgData, imageSize, params, output,
+                                                       static_cast<int>(std::min<jlong>(capacity, DESCRIPTOR_BINARY_MAX_SIZE)));
+
+    releaseParameters(env, parameters, params);
+    return result;
+}
+
+JNIEXPORT jint JNICALL Java_com_mpeg7_bridge_libmpeg7_extractDescriptorFromArray
+(JNIEnv * env, jobject, const jint descriptorType, const jbyteArray data, const jint offset, const jint length, const jobjectArray parameters, const jbyteArray output) {
+    if (!descriptorType) {
+        return -JNI_DESCRIPTOR_TYPE_NULL;
+    }
+
+    if (!data) {
+        return -JNI_IMG_NULL;
+    }
+
+    if (!parameters) {
+        return -JNI_PARAMS_NULL;
+    }
+
+    if (!output) {
+        return -BINARY_BUFFER_NULL;
+    }
+
+    const jsize dataLength   = env->GetArrayLength(data);
+    const jsize outputLength = env->GetArrayLength(output);
+
+    if (offset < 0 || length <= 0 || offset > dataLength - length) {
+        return -JNI_IMG_NULL;
+    }
+
+    const char ** params = nullptr;
+
+    try {
+        params = getParameters(env, parameters);
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+
+    Image image;
+    int result = 0;
+
+    // No JNI call is allowed while array is held critical, so only decoding happens inside,
+    // decoded image does not reference encoded data anymore
+    const auto imgData = static_cast<unsigned char *>(env->GetPrimitiveArrayCritical(data, nullptr));
+
+    if (imgData == nullptr) {
+        result = -JNI_IMG_NULL;
+    }
+    else {
+        try {
+            image.load(imgData + offset, length, IMAGE_UNCHANGED);
+        }
+        catch (ErrorCode exception) {
+            result = -exception;
+        }
+        env->ReleasePrimitiveArrayCritical(data, imgData, JNI_ABORT);
+    }
+
+    if (result == 0) {
+        unsigned char packet[DESCRIPTOR_BINARY_MAX_SIZE];
+
+        result = binaryExtraction(static_cast<DescriptorType>(descriptorType), image, params, packet, std::min<jsize>(outputLength, DESCRIPTOR_BINARY_MAX_SIZE));
+
+        if (result > 0) {
+            env->SetByteArrayRegion(output, 0, result, reinterpret_cast<const jbyte *>(packet));
+        }
+    }
+
+    releaseParameters(env, parameters, params);
+    return result;
+}
+
+JNIEXPORT jbyteArray JNICALL Java_com_mpeg7_bridge_libmpeg7_extractDescriptorsBatch
+(JNIEnv * env, jobject, const jintArray descriptorTypes, const jobjectArray parameters, const jobjectArray images, const jint threads) {
+    /* Result is packed array of imageCount * typeCount records (image major),
+       every record is 4 byte little-endian size of packet (or negative ErrorCode) followed by packet bytes.
+       Invalid arguments return NULL. */
+    if (!descriptorTypes || !parameters || !images) {
+        return nullptr;
+    }
+
+    const jsize typeCount  = env->GetArrayLength(descriptorTypes);
+    const jsize imageCount = env->GetArrayLength(images);
+
+    if (typeCount == 0 || env->GetArrayLength(parameters) != typeCount) {
+        return nullptr;
+    }
+
+    std::vector<jint> types(typeCount);
+    env->GetIntArrayRegion(descriptorTypes, 0, typeCount, types.data());
+
+    std::vector<DescriptorType> descriptorTypeList(typeCount);
+
+    for (jsize t = 0; t < typeCount; t++) {
+        descriptorTypeList[t] = static_cast<DescriptorType>(types[t]);
+    }
+
+    // Parameters are marshalled once per descriptor type, not once per image
+    std::vector<jobjectArray> parameterArrays(typeCount, nullptr);
+    std::vector<const char **> params(typeCount, nullptr);
+
+    bool valid = true;
+
+    for (jsize t = 0; t < typeCount && valid; t++) {
+        parameterArrays[t] = static_cast<jobjectArray>(env->GetObjectArrayElement(parameters, t));
+
+        try {
+            params[t] = parameterArrays[t] ? getParameters(env, parameterArrays[t]) : nullptr;
+        }
+        catch (ErrorCode) {
+            params[t] = nullptr;
+        }
+        valid = params[t] != nullptr;
+    }
+
+    // Encoded images are copied once into native memory, so worker threads never touch Java heap
+    std::vector<std::vector<unsigned char>> imageData(imageCount);
+    std::vector<unsigned char *> imagePointers(imageCount, nullptr);
+    std::vector<int> imageSizes(imageCount, 0);
+
+    for (jsize i = 0; i < imageCount && valid; i++) {
+        const auto data = static_cast<jbyteArray>(env->GetObjectArrayElement(images, i));
+
+        if (data) {
+            imageSizes[i] = env->GetArrayLength(data);
+            imageData[i].resize(imageSizes[i]);
+            env->GetByteArrayRegion(data, 0, imageSizes[i], reinterpret_cast<jbyte *>(imageData[i].data()));
+            imagePointers[i] = imageData[i].data();
+            env->DeleteLocalRef(data);
+        }
+    }
+
+    jbyteArray packed = nullptr;
+
+    if (valid) {
+        const unsigned long records = static_cast<unsigned long>(imageCount) * typeCount;
+
+        std::vector<unsigned char> output(records * DESCRIPTOR_BINARY_MAX_SIZE);
+        std::vector<int> results(records, 0);
+
+        extractDescriptorsBinaryBatch(descriptorTypeList.data(), params.data(), typeCount, imagePointers.data(), imageSizes.data(), imageCount,
+                                      threads, output.data(), results.data());
+
+        std::vector<unsigned char> result;
+
+        for (unsigned long r = 0; r < records; r++) {
+            const int size = results[r];
+
+            for (int b = 0; b < 4; b++) {
+                result.push_back(static_cast<unsigned char>((static_cast<unsigned int>(size) >> (8 * b)) & 0xFF));
+            }
+
+            if (size > 0) {
+                result.insert(result.end(), &output[r * DESCRIPTOR_BINARY_MAX_SIZE], &output[r * DESCRIPTOR_BINARY_MAX_SIZE] + size);
+            }
+        }
+
+        packed = env->NewByteArray(static_cast<jsize>(result.size()));
+
+        if (packed) {
+            env->SetByteArrayRegion(packed, 0, static_cast<jsize>(result.size()), reinterpret_cast<const jbyte *>(result.data()));
+        }
+    }
+
+    for (jsize t = 0; t < typeCount; t++) {
+        if (params[t]) {
+            releaseParameters(env, parameterArrays[t], params[t]);
+        }
+    }
+
+    return packed;
+}
+
 jstring createJniMessage(JNIEnv * env, const char * message) {
     const jstring jniMessage = env->NewStringUTF(message);
-    delete[] message;
+    freeResultPointer(const_cast<char *>(message));
     return jniMessage;
 }
 
@@ -205,18 +428,18 @@ const char ** getParameters(JNIEnv * env, const jobjectArray parameters) {
     return params;
 }
 
-unsigned char * getImageBuffer(JNIEnv * env, const jbyteArray data, const int size) {
-    jbyte * jniBufferPtr = env->GetByteArrayElements(data, nullptr);
+void releaseParameters(JNIEnv * env, const jobjectArray parameters, const char ** params) {
+    for (int i = 0; params[i] != nullptr; i++) {
+        env->ReleaseStringUTFChars(static_cast<jstring>(env->GetObjectArrayElement(parameters, i)), params[i]);
+    }
+    delete[] params;
+}
 
+unsigned char * getImageBuffer(JNIEnv * env, const jbyteArray data, const int size) {
     const auto imgBuffer = new unsigned char[size];
 
-    int i = 0;
-
-    for (int i = 0; i < size; i++) {
-        imgBuffer[i] = jniBufferPtr[i];
-    }
-
-    env->ReleaseByteArrayElements(data, jniBufferPtr, 0);
+    // Single copy straight into native buffer (no pinned or copied array elements in between)
+    env->GetByteArrayRegion(data, 0, size, reinterpret_cast<jbyte *>(imgBuffer));
 
     return imgBuffer;
 }
@@ -15,6 +15,15 @@ JNIEXPORT jstring JNICALL Java_com_mpeg7_bridge_libmpeg7_extractDescriptorFromDa
 JNIEXPORT jstring JNICALL Java_com_mpeg7_bridge_libmpeg7_calculateDistance
         (JNIEnv *, jobject, jstring, jstring, jobjectArray);
 
+JNIEXPORT jint JNICALL Java_com_mpeg7_bridge_libmpeg7_extractDescriptorFromBuffer
+        (JNIEnv *, jobject, jint, jobject, jint, jobjectArray, jobject);
+
+JNIEXPORT jint JNICALL Java_com_mpeg7_bridge_libmpeg7_extractDescriptorFromArray
+        (JNIEnv *, jobject, jint, jbyteArray, jint, jint, jobjectArray, jbyteArray);
+
+JNIEXPORT jbyteArray JNICALL Java_com_mpeg7_bridge_libmpeg7_extractDescriptorsBatch
+        (JNIEnv *, jobject, jintArray, jobjectArray, jobjectArray, jint);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,12 +1,36 @@
 #include "Mpeg7.h"
+#include "TOOLS/Parallel/Parallel.h"
+#include "TOOLS/Trace/Trace.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
 
 const char * message(int error);
 const char * message(const std::string &xml);
+const char * message(const XMLWriter &xml);
 const char * message(double distance);
+const char * message(const char * text, size_t length);
 
 const char * mainExtraction(DescriptorType & descriptorType, Image & image, const char ** params);
-
-DescriptorType detectType(const char * xmlDescriptorType);
+int bufferExtraction(DescriptorType descriptorType, Image & image, const char ** params, char * output, size_t capacity, size_t * needed);
+void writeExtraction(DescriptorType descriptorType, Image & image, const char ** params, XMLWriter & writer);
+void writeExtraction(DescriptorExtractor & extractor, Image & image, const char ** params, XMLWriter & writer);
+double distanceBetween(const char * xml1, const char * xml2, const char ** params);
+double distanceBetween(Descriptor * descriptor1, DescriptorType type1, Descriptor * descriptor2, DescriptorType type2, const char ** params);
+int formatDistance(double distance, char * text);
+int bufferResult(XMLWriter & writer, char * output, size_t * needed);
+int bufferError(ErrorCode error, char * output, size_t capacity, size_t * needed);
+int writePacket(DescriptorType descriptorType, Descriptor * descriptor, unsigned char * output, int capacity);
+void prepareRegions(DescriptorType descriptorType, DescriptorExtractor & extractor, Image & image);
+void copyParams(const char ** params, std::vector<std::string> & values, std::vector<const char *> & pointers);
+void frameThumbnail(const unsigned char * pixels, int width, int height, int stride, PixelFormat format, float * thumbnail);
+Descriptor * extractRegion(DescriptorType descriptorType, DescriptorExtractor & extractor, int x, int y, int width, int height, const char ** params);
 
 const char * extractDescriptor(DescriptorType descriptorType, const char * imgURL, const char ** params) {
     if (params == nullptr) {
@@ -40,247 +64,1459 @@ const char * extractDescriptorFromData(DescriptorType descriptorType, unsigned c
     return mainExtraction(descriptorType, image, params);
 }
 
-const char * getDistance(const char * xml1, const char * xml2, const char ** params) {
-    if (xml1 == nullptr || xml2 == nullptr) {
-        return message(XML_NULL);
+int extractDescriptorBinary(DescriptorType descriptorType, const char * imgURL, const char ** params, unsigned char * output, const int capacity) {
+    if (params == nullptr) {
+        return -PARAMS_NULL;
     }
-    
-    XMLDocument document1, document2;
+    Image image;
 
-    XMLError parseResult1 = document1.Parse(xml1);
-    XMLError parseResult2 = document2.Parse(xml2);
+    try {
+        image.load(imgURL, IMAGE_UNCHANGED);
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+    return binaryExtraction(descriptorType, image, params, output, capacity);
+}
 
-    if (parseResult1 != XML_NO_ERROR || parseResult2 != XML_NO_ERROR) {
-        return message(PARSE_ERROR);
+int extractDescriptorBinaryFromData(DescriptorType descriptorType, unsigned char * buffer, const int size, const char ** params, unsigned char * output, const int capacity) {
+    if (params == nullptr) {
+        return -PARAMS_NULL;
     }
+    Image image;
 
-    XMLElement * mpeg7Element1 = document1.FirstChildElement("Mpeg7");
-    XMLElement * mpeg7Element2 = document2.FirstChildElement("Mpeg7");
+    try {
+        image.load(buffer, size, IMAGE_UNCHANGED);
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+    return binaryExtraction(descriptorType, image, params, output, capacity);
+}
 
-    if (mpeg7Element1 == nullptr || mpeg7Element2 == nullptr) {
-        return message(MPEG7_NODE_NOT_FOUND);
+int extractDescriptorsBinaryBatch(const DescriptorType * descriptorTypes, const char *** params, const int typeCount,
+                                  unsigned char ** images, const int * sizes, const int imageCount,
+                                  const int threads, unsigned char * output, int * results) {
+    if (descriptorTypes == nullptr || typeCount <= 0) {
+        return -UNRECOGNIZED_DESCRIPTOR_TYPE;
     }
 
-    XMLElement * descriptionUnitElement1 = mpeg7Element1->FirstChildElement("DescriptionUnit");
-    XMLElement * descriptionUnitElement2 = mpeg7Element2->FirstChildElement("DescriptionUnit");
+    if (params == nullptr) {
+        return -PARAMS_NULL;
+    }
 
-    if (descriptionUnitElement1 == nullptr || descriptionUnitElement2 == nullptr) {
-        return message(DESCRIPTION_UNIT_NODE_NOT_FOUND); 
+    for (int t = 0; t < typeCount; t++) {
+        if (params[t] == nullptr) {
+            return -PARAMS_NULL;
+        }
     }
 
-    XMLElement * descriptorElement1 = descriptionUnitElement1->FirstChildElement("Descriptor");
-    XMLElement * descriptorElement2 = descriptionUnitElement2->FirstChildElement("Descriptor");
+    if (images == nullptr || sizes == nullptr || imageCount < 0) {
+        return -CANNOT_OPEN_IMAGE;
+    }
 
-    if (descriptorElement1 == nullptr || descriptorElement2 == nullptr) {
-        return message(DESCRIPTOR_NODE_NOT_FOUND);
+    if (output == nullptr || results == nullptr) {
+        return -BINARY_BUFFER_NULL;
     }
 
-    const char * xml1DescriptorType = descriptorElement1->Attribute("xsi:type");
-    const char * xml2DescriptorType = descriptorElement2->Attribute("xsi:type");
+    // Every worker keeps its own extractors, so tables and buffers of extractors are set up once per worker
+    std::vector<std::unique_ptr<DescriptorExtractor>> extractors(static_cast<size_t>(Parallel::resolveThreads(threads) * typeCount));
+
+    Parallel::forEach(static_cast<unsigned long>(imageCount), threads, [&](const unsigned long i, const int worker) {
+        int * imageResults          = results + i * typeCount;
+        unsigned char * imageOutput = output + i * typeCount * DESCRIPTOR_BINARY_MAX_SIZE;
+
+        Image image;
+
+        try {
+            image.load(images[i], sizes[i], IMAGE_UNCHANGED);
+        }
+        catch (ErrorCode exception) {
+            std::fill(imageResults, imageResults + typeCount, -exception);
+            return;
+        }
+
+        for (int t = 0; t < typeCount; t++) {
+            std::unique_ptr<DescriptorExtractor> & extractor = extractors[worker * typeCount + t];
+
+            try {
+                if (!extractor) {
+                    extractor.reset(createExtractor(descriptorTypes[t]));
+                }
+            }
+            catch (ErrorCode exception) {
+                imageResults[t] = -exception;
+                continue;
+            }
+            imageResults[t] = binaryExtraction(descriptorTypes[t], *extractor, image, params[t],
+                                               imageOutput + t * DESCRIPTOR_BINARY_MAX_SIZE, DESCRIPTOR_BINARY_MAX_SIZE);
+        }
+    });
+
+    return 0;
+}
+
+const char * getDistance(const char * xml1, const char * xml2, const char ** params) {
+    double distance = DBL_MAX;
 
-    if (xml1DescriptorType == nullptr || xml1DescriptorType == nullptr) {
-        return message(TYPE_ATTRIBUTE_NOT_FOUND);
+    try {
+        distance = distanceBetween(xml1, xml2, params);
+    }
+    catch (ErrorCode exception) {
+        return message(exception);
     }
 
-    DescriptorType type1 = detectType(xml1DescriptorType);
-    DescriptorType type2 = detectType(xml2DescriptorType);
+    const char * distanceMessage = message(distance);
 
-    if (type1 == NONE || type2 == NONE) {
-        return message(XML_TYPE_NOT_RECOGNIZED);
+    if (distanceMessage == nullptr) {
+        return message(DISTANCE_MESSAGE_NULL);
     }
+    return distanceMessage;
+}
 
-    if (type1 != type2) {
-        return message(XML_TYPES_NOT_EQUAL);
+int extractDescriptorToBuffer(DescriptorType descriptorType, const char * imgURL, const char ** params, char * output, const size_t capacity, size_t * needed) {
+    if (output == nullptr && capacity > 0) {
+        return bufferError(RESULT_BUFFER_NULL, output, 0, needed);
     }
 
-    Descriptor * descriptor1 = nullptr;
-    Descriptor * descriptor2 = nullptr;
-    DescriptorDistance * descriptorDistanceInterface = nullptr;
+    if (params == nullptr) {
+        return bufferError(PARAMS_NULL, output, capacity, needed);
+    }
+    Image image;
 
     try {
-        switch (type1) {
-            case COLOR_LAYOUT_D:
-                descriptorDistanceInterface = new ColorLayoutDistance(); 
-                descriptor1 = new ColorLayout(); 
-                descriptor2 = new ColorLayout();
-                break;
-            case COLOR_STRUCTURE_D:
-                descriptorDistanceInterface = new ColorStructureDistance(); 
-                descriptor1 = new ColorStructure(); 
-                descriptor2 = new ColorStructure();
-                break;
-            case CT_BROWSING_D:
-                descriptorDistanceInterface = new CTBrowsingDistance(); 
-                descriptor1 = new CTBrowsing(); 
-                descriptor2 = new CTBrowsing();
-                break;
-            case DOMINANT_COLOR_D:
-                descriptorDistanceInterface = new DominantColorDistance(); 
-                descriptor1 = new DominantColor();
-                descriptor2 = new DominantColor();
-                break;
-            case SCALABLE_COLOR_D:
-                descriptorDistanceInterface = new ScalableColorDistance(); 
-                descriptor1 = new ScalableColor(); 
-                descriptor2 = new ScalableColor();
-                break;
-            case HOMOGENEOUS_TEXTURE_D:
-                descriptorDistanceInterface = new HomogeneousTextureDistance(); 
-                descriptor1 = new HomogeneousTexture(); 
-                descriptor2 = new HomogeneousTexture();
-                break;
-            case TEXTURE_BROWSING_D:
-                descriptorDistanceInterface = new TextureBrowsingDistance(); 
-                descriptor1 = new TextureBrowsing(); 
-                descriptor2 = new TextureBrowsing();
-                break;
-            case EDGE_HISTOGRAM_D:
-                descriptorDistanceInterface = new EdgeHistogramDistance();
-                descriptor1 = new EdgeHistogram(); 
-                descriptor2 = new EdgeHistogram();
-                break;
-            case REGION_SHAPE_D:
-                descriptorDistanceInterface = new RegionShapeDistance(); 
-                descriptor1 = new RegionShape(); 
-                descriptor2 = new RegionShape();
-                break;
-            case CONTOUR_SHAPE_D:
-                descriptorDistanceInterface = new ContourShapeDistance(); 
-                descriptor1 = new ContourShape(); 
-                descriptor2 = new ContourShape();
-                break;
-            default:
-                throw XML_TYPE_NOT_RECOGNIZED;
-        }
+        image.load(imgURL, IMAGE_UNCHANGED);
     }
     catch (ErrorCode exception) {
-        return message(exception);
+        return bufferError(exception, output, capacity, needed);
+    }
+    return bufferExtraction(descriptorType, image, params, output, capacity, needed);
+}
+
+int extractDescriptorFromDataToBuffer(DescriptorType descriptorType, unsigned char * data, const int size, const char ** params,
+                                      char * output, const size_t capacity, size_t * needed) {
+    if (output == nullptr && capacity > 0) {
+        return bufferError(RESULT_BUFFER_NULL, output, 0, needed);
+    }
+
+    if (params == nullptr) {
+        return bufferError(PARAMS_NULL, output, capacity, needed);
     }
+    Image image;
 
     try {
-        descriptor1->readFromXML(descriptorElement1);
-        descriptor2->readFromXML(descriptorElement2);
+        image.load(data, size, IMAGE_UNCHANGED);
     }
     catch (ErrorCode exception) {
-        delete descriptor1;
-        delete descriptor2;
-        delete descriptorDistanceInterface;
-        return message(exception);
+        return bufferError(exception, output, capacity, needed);
+    }
+    return bufferExtraction(descriptorType, image, params, output, capacity, needed);
+}
+
+int getDistanceToBuffer(const char * xml1, const char * xml2, const char ** params, char * output, const size_t capacity, size_t * needed) {
+    if (output == nullptr && capacity > 0) {
+        return bufferError(RESULT_BUFFER_NULL, output, 0, needed);
     }
 
     double distance = DBL_MAX;
 
     try {
-        distance = descriptorDistanceInterface->getDistance(descriptor1, descriptor2, params);
+        distance = distanceBetween(xml1, xml2, params);
     }
     catch (ErrorCode exception) {
-        delete descriptor1;
-        delete descriptor2;
-        delete descriptorDistanceInterface;
-        return message(exception);
+        return bufferError(exception, output, capacity, needed);
     }
 
-    delete descriptor1;
-    delete descriptor2;
-    delete descriptorDistanceInterface;
+    char text[DISTANCE_TEXT_MAX_SIZE];
+    const int length = formatDistance(distance, text);
 
-    const char * distanceMessage = message(distance);
-   
-    if (distanceMessage == nullptr) {
-        return message(DISTANCE_MESSAGE_NULL);
+    XMLWriter writer(output, capacity);
+    writer.write(text, static_cast<size_t>(length));
+    return bufferResult(writer, output, needed);
+}
+
+int getDistanceValue(const char * xml1, const char * xml2, const char ** params, double * distance) {
+    if (distance == nullptr) {
+        return -DISTANCE_RESULT_NULL;
+    }
+
+    try {
+        *distance = distanceBetween(xml1, xml2, params);
+    }
+    catch (ErrorCode exception) {
+        return -exception;
     }
-    return distanceMessage; 
+    return 0;
 }
 
-void freeResultPointer(char * ptr) {
-    #ifdef DEBUG
-        printf("freeing address: %p\n", ptr);
-    #endif
-    free(ptr);
+int getDistanceBinary(const unsigned char * packet1, const int size1, const unsigned char * packet2, const int size2,
+                      const char ** params, double * distance) {
+    TRACE_SCOPE("getDistanceBinary");
+
+    if (distance == nullptr) {
+        return -DISTANCE_RESULT_NULL;
+    }
+
+    if (size1 < 0 || size2 < 0) {
+        return -BINARY_SIZE_ERROR;
+    }
+
+    try {
+        DescriptorType type1 = NONE, type2 = NONE;
+
+        const std::unique_ptr<Descriptor> descriptor1(readDescriptorBinary(packet1, static_cast<unsigned long>(size1), type1));
+        const std::unique_ptr<Descriptor> descriptor2(readDescriptorBinary(packet2, static_cast<unsigned long>(size2), type2));
+
+        *distance = distanceBetween(descriptor1.get(), type1, descriptor2.get(), type2, params);
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+    return 0;
 }
 
-const char * message(const int error) {
-    const std::string msg_str = std::to_string(error);
+int getDistancesBinary(const unsigned char * query, const int querySize, const unsigned char * const * packets, const int * sizes,
+                       const int count, const char ** params, double * distances, int * results) {
+    TRACE_SCOPE("getDistancesBinary");
 
-    const auto msg = new char[msg_str.size() + 1];
-    strcpy(msg, msg_str.c_str());
+    if (distances == nullptr || results == nullptr) {
+        return -DISTANCE_RESULT_NULL;
+    }
 
-    return msg;
+    if (count < 0 || querySize < 0) {
+        return -BINARY_SIZE_ERROR;
+    }
+
+    if (count > 0 && (packets == nullptr || sizes == nullptr)) {
+        return -BINARY_BUFFER_NULL;
+    }
+
+    // Query and distance object are read once for all packets
+    DescriptorType queryType = NONE;
+    std::unique_ptr<Descriptor> queryDescriptor;
+    std::unique_ptr<DescriptorDistance> descriptorDistanceInterface;
+
+    try {
+        queryDescriptor.reset(readDescriptorBinary(query, static_cast<unsigned long>(querySize), queryType));
+        descriptorDistanceInterface.reset(createDistance(queryType));
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+
+    for (int i = 0; i < count; i++) {
+        distances[i] = DBL_MAX;
+
+        try {
+            if (sizes[i] < 0) {
+                throw BINARY_SIZE_ERROR;
+            }
+
+            DescriptorType type = NONE;
+            const std::unique_ptr<Descriptor> descriptor(readDescriptorBinary(packets[i], static_cast<unsigned long>(sizes[i]), type));
+
+            if (type != queryType) {
+                throw XML_TYPES_NOT_EQUAL;
+            }
+
+            distances[i] = descriptorDistanceInterface->getDistance(queryDescriptor.get(), descriptor.get(), params);
+            results[i]   = 0;
+        }
+        catch (ErrorCode exception) {
+            results[i] = -exception;
+        }
+    }
+    return 0;
 }
 
-const char * message(const std::string &xml) {
-    const auto msg = new char[xml.size() + 1];
-    strcpy(msg, xml.c_str());
-    return msg;
+int getDescriptorPacketInfo(const unsigned char * packet, const int size, DescriptorPacketInfo * info) {
+    if (info == nullptr) {
+        return -RESULT_BUFFER_NULL;
+    }
+
+    if (size < 0) {
+        return -BINARY_SIZE_ERROR;
+    }
+
+    try {
+        info->type       = DescriptorBinary::readHeader(packet, static_cast<unsigned long>(size));
+        info->recordSize = size - DESCRIPTOR_BINARY_HEADER_SIZE;
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+    return 0;
 }
 
-const char * message(const double distance) {
-    std::stringstream msg_str_stream;
-    msg_str_stream << std::fixed << std::setprecision(17) << distance;
+struct ExtractionContext {
+    DescriptorType type;
+    std::vector<std::string> paramValues;
+    std::vector<const char *> params;
+    std::unique_ptr<DescriptorExtractor> extractor;
+};
+
+int createExtractionContext(const DescriptorType descriptorType, const char ** params, ExtractionContext ** context) {
+    if (context == nullptr) {
+        return -CONTEXT_NULL;
+    }
+    *context = nullptr;
 
-    const std::string msg_str = msg_str_stream.str();
+    if (params == nullptr) {
+        return -PARAMS_NULL;
+    }
 
-    const auto msg = new char[msg_str.size() + 1];
-    strcpy(msg, msg_str.c_str());
+    std::unique_ptr<ExtractionContext> created(new ExtractionContext());
+    created->type = descriptorType;
 
-    return msg;
+    try {
+        created->extractor.reset(createExtractor(descriptorType));
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+
+    // Parameters are copied, caller strings do not have to outlive context
+    copyParams(params, created->paramValues, created->params);
+
+    *context = created.release();
+    return 0;
 }
 
-DescriptorType detectType(const char * xmlDescriptorType) {
-    return strcmp(xmlDescriptorType, "ColorLayoutType")              == 0 ? COLOR_LAYOUT_D        :
-           strcmp(xmlDescriptorType, "ColorStructureType")           == 0 ? COLOR_STRUCTURE_D     :
-           strcmp(xmlDescriptorType, "ColorTemperatureBrowsingType") == 0 ? CT_BROWSING_D         :
-           strcmp(xmlDescriptorType, "DominantColorType")            == 0 ? DOMINANT_COLOR_D      :
-           strcmp(xmlDescriptorType, "ScalableColorType")            == 0 ? SCALABLE_COLOR_D      :
-           strcmp(xmlDescriptorType, "ContourShapeType")             == 0 ? CONTOUR_SHAPE_D       :
-           strcmp(xmlDescriptorType, "RegionShapeType")              == 0 ? REGION_SHAPE_D        :
-           strcmp(xmlDescriptorType, "EdgeHistogramType")            == 0 ? EDGE_HISTOGRAM_D      :
-           strcmp(xmlDescriptorType, "HomogeneousTextureType")       == 0 ? HOMOGENEOUS_TEXTURE_D :
-           strcmp(xmlDescriptorType, "TextureBrowsingType")          == 0 ? TEXTURE_BROWSING_D    : NONE;
+int extractWithContext(ExtractionContext * context, unsigned char * data, const int size, char * output, const size_t capacity, size_t * needed) {
+    if (output == nullptr && capacity > 0) {
+        return bufferError(RESULT_BUFFER_NULL, output, 0, needed);
+    }
+
+    if (context == nullptr) {
+        return bufferError(CONTEXT_NULL, output, capacity, needed);
+    }
+
+    XMLWriter writer(output, capacity);
+    Image image;
+
+    try {
+        image.load(data, size, IMAGE_UNCHANGED);
+        writeExtraction(*context->extractor, image, context->params.data(), writer);
+    }
+    catch (ErrorCode exception) {
+        return bufferError(exception, output, capacity, needed);
+    }
+    return bufferResult(writer, output, needed);
 }
 
-const char * mainExtraction(DescriptorType & descriptorType, Image & image, const char ** params) {
-    DescriptorExtractor * extractor = nullptr;
+int extractBinaryWithContext(ExtractionContext * context, unsigned char * data, const int size, unsigned char * output, const int capacity) {
+    if (context == nullptr) {
+        return -CONTEXT_NULL;
+    }
+
+    Image image;
 
     try {
-        extractor = descriptorType == DOMINANT_COLOR_D      ? static_cast<DescriptorExtractor *>(new DominantColorExtractor())      :
-                    descriptorType == SCALABLE_COLOR_D      ? static_cast<DescriptorExtractor *>(new ScalableColorExtractor())      :
-                    descriptorType == COLOR_LAYOUT_D        ? static_cast<DescriptorExtractor *>(new ColorLayoutExtractor())        :
-                    descriptorType == COLOR_STRUCTURE_D     ? static_cast<DescriptorExtractor *>(new ColorStructureExtractor())     :
-                    descriptorType == CT_BROWSING_D         ? static_cast<DescriptorExtractor *>(new CTBrowsingExtractor())         :
-                    descriptorType == HOMOGENEOUS_TEXTURE_D ? static_cast<DescriptorExtractor *>(new HomogeneousTextureExtractor()) :
-                    descriptorType == TEXTURE_BROWSING_D    ? static_cast<DescriptorExtractor *>(new TextureBrowsingExtractor())    :
-                    descriptorType == EDGE_HISTOGRAM_D      ? static_cast<DescriptorExtractor *>(new EdgeHistogramExtractor())      :
-                    descriptorType == REGION_SHAPE_D        ? static_cast<DescriptorExtractor *>(new RegionShapeExtractor())        :
-                    descriptorType == CONTOUR_SHAPE_D       ? static_cast<DescriptorExtractor *>(new ContourShapeExtractor())       :
-                                                            throw UNRECOGNIZED_DESCRIPTOR_TYPE;
+        image.load(data, size, IMAGE_UNCHANGED);
     }
     catch (ErrorCode exception) {
-        return message(exception);
+        return -exception;
+    }
+    return binaryExtraction(context->type, *context->extractor, image, context->params.data(), output, capacity);
+}
+
+int getDistanceWithContext(ExtractionContext * context, const unsigned char * packet1, const int size1, const unsigned char * packet2, const int size2,
+                           const char ** params, double * distance) {
+    TRACE_SCOPE("getDistanceWithContext");
+
+    if (context == nullptr) {
+        return -CONTEXT_NULL;
+    }
+
+    if (distance == nullptr) {
+        return -DISTANCE_RESULT_NULL;
+    }
+
+    if (size1 < 0 || size2 < 0) {
+        return -BINARY_SIZE_ERROR;
     }
-    Descriptor * descriptor = nullptr;
 
     try {
-        descriptor = extractor->extract(image, params);
+        DescriptorType type1 = NONE, type2 = NONE;
+
+        const std::unique_ptr<Descriptor> descriptor1(readDescriptorBinary(packet1, static_cast<unsigned long>(size1), type1));
+        const std::unique_ptr<Descriptor> descriptor2(readDescriptorBinary(packet2, static_cast<unsigned long>(size2), type2));
+
+        if (type1 != context->type || type2 != context->type) {
+            throw XML_TYPES_NOT_EQUAL;
+        }
+
+        // New distance for every call, distances keep options of previous call, when params are empty
+        const std::unique_ptr<DescriptorDistance> descriptorDistance(createDistance(context->type));
+        *distance = descriptorDistance->getDistance(descriptor1.get(), descriptor2.get(), params);
     }
     catch (ErrorCode exception) {
-        return message(exception);
+        return -exception;
     }
+    return 0;
+}
+
+void freeExtractionContext(ExtractionContext * context) {
+    delete context;
+}
 
-    const char * extractionMessage = nullptr;
+int extractDescriptorBinaryFromPixels(const DescriptorType descriptorType, const unsigned char * pixels, const int width, const int height,
+                                      const int stride, const PixelFormat format, const char ** params,
+                                      unsigned char * output, const int capacity) {
+    if (params == nullptr) {
+        return -PARAMS_NULL;
+    }
+    Image image;
 
     try {
-        extractionMessage = message(descriptor->generateXML());
+        image.view(pixels, width, height, stride, format);
     }
     catch (ErrorCode exception) {
-        delete extractor;
-        return message(exception);
+        return -exception;
     }
+    return binaryExtraction(descriptorType, image, params, output, capacity);
+}
 
-    delete extractor;
+int extractDescriptorBinaryFromPlanes(const DescriptorType descriptorType, const int width, const int height, const PixelFormat format,
+                                      const unsigned char * y, const int yStride, const unsigned char * u,
+                                      const unsigned char * v, const int uvStride, const char ** params,
+                                      unsigned char * output, const int capacity) {
+    if (params == nullptr) {
+        return -PARAMS_NULL;
+    }
+    Image image;
 
-    if (extractionMessage == nullptr) {
-        return message(EXTRACTION_MESSAGE_NULL);
+    try {
+        image.view(width, height, format, y, yStride, u, v, uvStride);
     }
-    return extractionMessage;
-}
\ No newline at end of file
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+    return binaryExtraction(descriptorType, image, params, output, capacity);
+}
+
+#define FRAME_THUMBNAIL_SIZE 16 // cells of frame thumbnail per row and column
+
+struct StreamSession {
+    std::vector<DescriptorType> types;
+    std::vector<std::vector<std::string>> paramValues;
+    std::vector<std::vector<const char *>> params;
+    std::vector<std::unique_ptr<DescriptorExtractor>> extractors;
+    double threshold = 0.0;
+
+    // View of pixels of current frame (pixels of caller are not copied)
+    Image frame;
+
+    // Last extracted frame and its packets
+    bool extracted = false;
+    int width  = 0;
+    int height = 0;
+    float thumbnail[FRAME_THUMBNAIL_SIZE * FRAME_THUMBNAIL_SIZE];
+    std::vector<unsigned char> packets;
+    std::vector<int> results;
+};
+
+int createStreamSession(const DescriptorType * descriptorTypes, const char *** params, const int typeCount,
+                        const double threshold, StreamSession ** session) {
+    if (session == nullptr) {
+        return -SESSION_NULL;
+    }
+    *session = nullptr;
+
+    if (descriptorTypes == nullptr || typeCount <= 0) {
+        return -UNRECOGNIZED_DESCRIPTOR_TYPE;
+    }
+
+    if (params == nullptr) {
+        return -PARAMS_NULL;
+    }
+
+    for (int t = 0; t < typeCount; t++) {
+        if (params[t] == nullptr) {
+            return -PARAMS_NULL;
+        }
+    }
+
+    std::unique_ptr<StreamSession> created(new StreamSession());
+    created->types.assign(descriptorTypes, descriptorTypes + typeCount);
+    created->paramValues.resize(typeCount);
+    created->params.resize(typeCount);
+    created->extractors.resize(typeCount);
+    created->threshold = threshold;
+
+    try {
+        for (int t = 0; t < typeCount; t++) {
+            created->extractors[t].reset(createExtractor(descriptorTypes[t]));
+            copyParams(params[t], created->paramValues[t], created->params[t]);
+        }
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+
+    created->packets.resize(static_cast<size_t>(typeCount) * DESCRIPTOR_BINARY_MAX_SIZE);
+    created->results.resize(typeCount);
+
+    *session = created.release();
+    return 0;
+}
+
+int extractFrameBinary(StreamSession * session, const unsigned char * pixels, const int width, const int height, const int stride,
+                       const PixelFormat format, unsigned char * output, int * results) {
+    TRACE_SCOPE("extractFrameBinary");
+
+    if (session == nullptr) {
+        return -SESSION_NULL;
+    }
+
+    if (output == nullptr || results == nullptr) {
+        return -BINARY_BUFFER_NULL;
+    }
+
+    const int typeCount = static_cast<int>(session->types.size());
+    float thumbnail[FRAME_THUMBNAIL_SIZE * FRAME_THUMBNAIL_SIZE];
+
+    try {
+        if (pixels == nullptr || width <= 0 || height <= 0 || stride < width * Image::pixelSize(format)) {
+            throw PIXELS_NOT_VALID;
+        }
+        frameThumbnail(pixels, width, height, stride, format, thumbnail);
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+
+    // Frame close to last extracted frame gets its packets
+    if (session->extracted && width == session->width && height == session->height) {
+        double difference = 0.0;
+        int cells = 0;
+
+        // Cells without sampled pixel (frames below 32 pixels) are the same in both thumbnails and are not counted
+        for (int i = 0; i < FRAME_THUMBNAIL_SIZE * FRAME_THUMBNAIL_SIZE; i++) {
+            if (thumbnail[i] >= 0.0f) {
+                difference += std::fabs(thumbnail[i] - session->thumbnail[i]);
+                cells++;
+            }
+        }
+
+        if (difference / cells < session->threshold) {
+            std::copy(session->packets.begin(), session->packets.end(), output);
+            std::copy(session->results.begin(), session->results.end(), results);
+            return 0;
+        }
+    }
+
+    try {
+        session->frame.view(pixels, width, height, stride, format);
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+
+    for (int t = 0; t < typeCount; t++) {
+        session->results[t] = binaryExtraction(session->types[t], *session->extractors[t], session->frame, session->params[t].data(),
+                                               session->packets.data() + t * DESCRIPTOR_BINARY_MAX_SIZE, DESCRIPTOR_BINARY_MAX_SIZE);
+    }
+
+    session->extracted = true;
+    session->width     = width;
+    session->height    = height;
+    std::copy(thumbnail, thumbnail + FRAME_THUMBNAIL_SIZE * FRAME_THUMBNAIL_SIZE, session->thumbnail);
+
+    std::copy(session->packets.begin(), session->packets.end(), output);
+    std::copy(session->results.begin(), session->results.end(), results);
+    return 1;
+}
+
+void freeStreamSession(StreamSession * session) {
+    delete session;
+}
+
+struct FrameGroup {
+    std::vector<std::string> paramValues;
+    std::vector<const char *> params;
+    GroupAggregation aggregation;
+    ScalableColorExtractor extractor;
+
+    // View of pixels of current frame (pixels of caller are not copied)
+    Image frame;
+};
+
+int createFrameGroup(const char ** params, const GroupAggregation aggregation, FrameGroup ** group) {
+    if (group == nullptr) {
+        return -GROUP_NULL;
+    }
+    *group = nullptr;
+
+    if (params == nullptr) {
+        return -PARAMS_NULL;
+    }
+
+    std::unique_ptr<FrameGroup> created(new FrameGroup());
+    created->aggregation = aggregation;
+
+    try {
+        created->extractor.beginGroup(aggregation);
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+
+    copyParams(params, created->paramValues, created->params);
+
+    *group = created.release();
+    return 0;
+}
+
+int addFrameToGroup(FrameGroup * group, const unsigned char * pixels, const int width, const int height, const int stride,
+                    const PixelFormat format) {
+    if (group == nullptr) {
+        return -GROUP_NULL;
+    }
+
+    try {
+        group->frame.view(pixels, width, height, stride, format);
+        group->extractor.addFrame(group->frame);
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+    return 0;
+}
+
+int extractGroupBinary(FrameGroup * group, unsigned char * output, const int capacity) {
+    TRACE_SCOPE("extractGroupBinary");
+
+    if (group == nullptr) {
+        return -GROUP_NULL;
+    }
+
+    if (output == nullptr) {
+        return -BINARY_BUFFER_NULL;
+    }
+
+    try {
+        const int packetSize = writePacket(SCALABLE_COLOR_D, group->extractor.extractGroup(group->params.data()), output, capacity);
+
+        // Next frames belong to next shot
+        group->extractor.beginGroup(group->aggregation);
+        return packetSize;
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+}
+
+void freeFrameGroup(FrameGroup * group) {
+    delete group;
+}
+
+int extractShapeBinaryFromRLE(const DescriptorType descriptorType, const int width, const int height, const unsigned int * counts, const int countSize,
+                              const int columnMajor, const char ** params, unsigned char * output, const int capacity) {
+    if (params == nullptr) {
+        return -PARAMS_NULL;
+    }
+    ShapeMask mask;
+
+    try {
+        mask.loadRLE(width, height, counts, countSize, columnMajor != 0 ? MASK_COLUMN_MAJOR : MASK_ROW_MAJOR);
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+    return binaryExtraction(descriptorType, mask, params, output, capacity);
+}
+
+int extractShapesBinaryFromLabels(const DescriptorType * descriptorTypes, const char *** params, const int typeCount,
+                                  const int width, const int height, const unsigned short * labels, const int labelCount,
+                                  const int threads, unsigned char * output, int * results) {
+    if (descriptorTypes == nullptr || typeCount <= 0) {
+        return -UNRECOGNIZED_DESCRIPTOR_TYPE;
+    }
+
+    if (params == nullptr) {
+        return -PARAMS_NULL;
+    }
+
+    for (int t = 0; t < typeCount; t++) {
+        if (descriptorTypes[t] != REGION_SHAPE_D && descriptorTypes[t] != CONTOUR_SHAPE_D) {
+            return -MASK_DESCRIPTOR_NOT_SUPPORTED;
+        }
+
+        if (params[t] == nullptr) {
+            return -PARAMS_NULL;
+        }
+    }
+
+    if (output == nullptr || results == nullptr) {
+        return -BINARY_BUFFER_NULL;
+    }
+
+    // Single pass over label map, objects are then extracted from their runs only
+    std::vector<ShapeMask> masks;
+
+    try {
+        ShapeMask::loadLabels(width, height, labels, labelCount, masks);
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+
+    std::vector<std::unique_ptr<DescriptorExtractor>> extractors(static_cast<size_t>(Parallel::resolveThreads(threads) * typeCount));
+
+    Parallel::forEach(static_cast<unsigned long>(labelCount), threads, [&](const unsigned long i, const int worker) {
+        const ShapeMask & mask      = masks[i + 1];
+        int * labelResults          = results + i * typeCount;
+        unsigned char * labelOutput = output + i * typeCount * DESCRIPTOR_BINARY_MAX_SIZE;
+
+        for (int t = 0; t < typeCount; t++) {
+            if (mask.getRuns().empty()) {
+                labelResults[t] = 0;
+                continue;
+            }
+
+            std::unique_ptr<DescriptorExtractor> & extractor = extractors[worker * typeCount + t];
+
+            if (!extractor) {
+                extractor.reset(createExtractor(descriptorTypes[t]));
+            }
+
+            labelResults[t] = binaryExtraction(descriptorTypes[t], *extractor, mask, params[t],
+                                               labelOutput + t * DESCRIPTOR_BINARY_MAX_SIZE, DESCRIPTOR_BINARY_MAX_SIZE);
+        }
+    });
+
+    return 0;
+}
+
+int extractShapeBinaryFromPolygon(const DescriptorType descriptorType, const int width, const int height, const double * xy, const int vertexCount,
+                                  const char ** params, unsigned char * output, const int capacity) {
+    if (params == nullptr) {
+        return -PARAMS_NULL;
+    }
+    ShapeMask mask;
+
+    try {
+        mask.loadPolygon(width, height, xy, vertexCount);
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+    return binaryExtraction(descriptorType, mask, params, output, capacity);
+}
+
+int extractDescriptorBinaryFromTiles(const DescriptorType descriptorType, const int width, const int height, const int alphaPresent, const int tileHeight,
+                                     const TileReader reader, void * user, const char ** params, unsigned char * output, const int capacity) {
+    if (params == nullptr) {
+        return -PARAMS_NULL;
+    }
+
+    try {
+        CallbackTileSource source(reader, user, width, height, alphaPresent != 0, tileHeight);
+        return binaryExtraction(descriptorType, source, params, output, capacity);
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+}
+
+int extractDescriptorGridBinary(const DescriptorType * descriptorTypes, const char *** params, const int typeCount,
+                                unsigned char * data, const int size, const int columns, const int rows,
+                                unsigned char * output, const int capacity, int * results, int * needed) {
+    Image image;
+
+    if (needed != nullptr) {
+        *needed = 0;
+    }
+
+    try {
+        image.load(data, size, IMAGE_UNCHANGED);
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+    return gridExtraction(descriptorTypes, params, typeCount, image, columns, rows, output, capacity, results, needed);
+}
+
+int enableTracing(const int enabled) {
+    if (!Trace::available()) {
+        return -TRACE_NOT_AVAILABLE;
+    }
+    Trace::enable(enabled != 0);
+    return 0;
+}
+
+void clearTrace() {
+    Trace::clear();
+}
+
+const char * exportTrace() {
+    return message(Trace::exportChrome());
+}
+
+int exportTraceToBuffer(char * output, const size_t capacity, size_t * needed) {
+    if (output == nullptr && capacity > 0) {
+        return bufferError(RESULT_BUFFER_NULL, output, 0, needed);
+    }
+
+    const std::string trace = Trace::exportChrome();
+
+    XMLWriter writer(output, capacity);
+    writer.write(trace.data(), trace.size());
+    return bufferResult(writer, output, needed);
+}
+
+void freeResultPointer(char * ptr) {
+    #ifdef DEBUG
+        printf("freeing address: %p\n", ptr);
+    #endif
+    free(ptr);
+}
+
+const char * message(const int error) {
+    return message(std::to_string(error));
+}
+
+const char * message(const std::string &xml) {
+    return message(xml.c_str(), xml.size());
+}
+
+const char * message(const XMLWriter &xml) {
+    return message(xml.c_str(), xml.size());
+}
+
+const char * message(const double distance) {
+    char text[DISTANCE_TEXT_MAX_SIZE];
+    const int length = formatDistance(distance, text);
+    return message(text, static_cast<size_t>(length));
+}
+
+const char * message(const char * text, const size_t length) {
+    // Allocated with malloc, so every returned message is released with free() by freeResultPointer
+    const auto msg = static_cast<char *>(malloc(length + 1));
+
+    if (msg == nullptr) {
+        return nullptr;
+    }
+    memcpy(msg, text, length);
+    msg[length] = '\0';
+    return msg;
+}
+
+int formatDistance(const double distance, char * text) {
+    // Same text as std::fixed with precision of 17 digits, DISTANCE_TEXT_MAX_SIZE holds DBL_MAX
+    return snprintf(text, DISTANCE_TEXT_MAX_SIZE, "%.17f", distance);
+}
+
+int bufferResult(XMLWriter & writer, char * output, size_t * needed) {
+    if (needed != nullptr) {
+        *needed = writer.size() + 1;
+    }
+
+    if (!writer.fits()) {
+        if (output != nullptr) {
+            output[0] = '\0';
+        }
+        return -RESULT_BUFFER_TOO_SMALL;
+    }
+    writer.c_str(); // terminates output
+    return static_cast<int>(writer.size());
+}
+
+int bufferError(const ErrorCode error, char * output, const size_t capacity, size_t * needed) {
+    if (needed != nullptr) {
+        *needed = 0;
+    }
+
+    if (output != nullptr && capacity > 0) {
+        output[0] = '\0';
+    }
+    return -error;
+}
+
+Descriptor * readDescriptorXML(const char * xml, DescriptorType & descriptorType) {
+    TRACE_SCOPE("Descriptor::readFromXML");
+
+    if (xml == nullptr) {
+        throw XML_NULL;
+    }
+
+    XMLDocument document;
+
+    if (document.Parse(xml) != XML_NO_ERROR) {
+        throw PARSE_ERROR;
+    }
+
+    XMLElement * mpeg7Element = document.FirstChildElement("Mpeg7");
+
+    if (mpeg7Element == nullptr) {
+        throw MPEG7_NODE_NOT_FOUND;
+    }
+
+    XMLElement * descriptionUnitElement = mpeg7Element->FirstChildElement("DescriptionUnit");
+
+    if (descriptionUnitElement == nullptr) {
+        throw DESCRIPTION_UNIT_NODE_NOT_FOUND;
+    }
+
+    XMLElement * descriptorElement = descriptionUnitElement->FirstChildElement("Descriptor");
+
+    if (descriptorElement == nullptr) {
+        throw DESCRIPTOR_NODE_NOT_FOUND;
+    }
+
+    const char * xmlDescriptorType = descriptorElement->Attribute("xsi:type");
+
+    if (xmlDescriptorType == nullptr) {
+        throw TYPE_ATTRIBUTE_NOT_FOUND;
+    }
+
+    descriptorType = detectType(xmlDescriptorType);
+
+    if (descriptorType == NONE) {
+        throw XML_TYPE_NOT_RECOGNIZED;
+    }
+
+    Descriptor * descriptor = createDescriptor(descriptorType);
+
+    try {
+        descriptor->readFromXML(descriptorElement);
+    }
+    catch (ErrorCode exception) {
+        delete descriptor;
+        throw;
+    }
+    return descriptor;
+}
+
+Descriptor * readDescriptorBinary(const unsigned char * packet, const unsigned long size, DescriptorType & descriptorType) {
+    TRACE_SCOPE("Descriptor::readFromBinary");
+
+    descriptorType = DescriptorBinary::readHeader(packet, size);
+
+    Descriptor * descriptor = createDescriptor(descriptorType);
+
+    try {
+        descriptor->readFromBinary(packet + DESCRIPTOR_BINARY_HEADER_SIZE, size - DESCRIPTOR_BINARY_HEADER_SIZE);
+    }
+    catch (ErrorCode exception) {
+        delete descriptor;
+        throw;
+    }
+    return descriptor;
+}
+
+DescriptorType detectType(const char * xmlDescriptorType) {
+    return strcmp(xmlDescriptorType, "ColorLayoutType")              == 0 ? COLOR_LAYOUT_D        :
+           strcmp(xmlDescriptorType, "ColorStructureType")           == 0 ? COLOR_STRUCTURE_D     :
+           strcmp(xmlDescriptorType, "ColorTemperatureBrowsingType") == 0 ? CT_BROWSING_D         :
+           strcmp(xmlDescriptorType, "DominantColorType")            == 0 ? DOMINANT_COLOR_D      :
+           strcmp(xmlDescriptorType, "ScalableColorType")            == 0 ? SCALABLE_COLOR_D      :
+           strcmp(xmlDescriptorType, "ContourShapeType")             == 0 ? CONTOUR_SHAPE_D       :
+           strcmp(xmlDescriptorType, "RegionShapeType")              == 0 ? REGION_SHAPE_D        :
+           strcmp(xmlDescriptorType, "EdgeHistogramType")            == 0 ? EDGE_HISTOGRAM_D      :
+           strcmp(xmlDescriptorType, "HomogeneousTextureType")       == 0 ? HOMOGENEOUS_TEXTURE_D :
+           strcmp(xmlDescriptorType, "TextureBrowsingType")          == 0 ? TEXTURE_BROWSING_D    : NONE;
+}
+
+const char * mainExtraction(DescriptorType & descriptorType, Image & image, const char ** params) {
+    // Storage of writer is kept by calling thread, so only returned message is allocated
+    static thread_local XMLWriter writer;
+    writer.clear();
+
+    try {
+        writeExtraction(descriptorType, image, params, writer);
+    }
+    catch (ErrorCode exception) {
+        return message(exception);
+    }
+
+    const char * extractionMessage = message(writer);
+
+    if (extractionMessage == nullptr) {
+        return message(EXTRACTION_MESSAGE_NULL);
+    }
+    return extractionMessage;
+}
+
+int bufferExtraction(const DescriptorType descriptorType, Image & image, const char ** params, char * output, const size_t capacity, size_t * needed) {
+    // XML is written straight into caller buffer, nothing is allocated for result
+    XMLWriter writer(output, capacity);
+
+    try {
+        writeExtraction(descriptorType, image, params, writer);
+    }
+    catch (ErrorCode exception) {
+        return bufferError(exception, output, capacity, needed);
+    }
+    return bufferResult(writer, output, needed);
+}
+
+void writeExtraction(const DescriptorType descriptorType, Image & image, const char ** params, XMLWriter & writer) {
+    const std::unique_ptr<DescriptorExtractor> extractor(createExtractor(descriptorType));
+    writeExtraction(*extractor, image, params, writer);
+}
+
+void writeExtraction(DescriptorExtractor & extractor, Image & image, const char ** params, XMLWriter & writer) {
+    TRACE_SCOPE("extractDescriptor");
+
+    // Descriptor is owned by extractor
+    Descriptor * descriptor = extractor.extract(image, params);
+
+    TRACE_SCOPE("Descriptor::writeXML");
+    descriptor->writeXML(writer);
+}
+
+double distanceBetween(const char * xml1, const char * xml2, const char ** params) {
+    TRACE_SCOPE("getDistance");
+
+    if (xml1 == nullptr || xml2 == nullptr) {
+        throw XML_NULL;
+    }
+
+    XMLDocument document1, document2;
+
+    XMLError parseResult1 = document1.Parse(xml1);
+    XMLError parseResult2 = document2.Parse(xml2);
+
+    if (parseResult1 != XML_NO_ERROR || parseResult2 != XML_NO_ERROR) {
+        throw PARSE_ERROR;
+    }
+
+    XMLElement * mpeg7Element1 = document1.FirstChildElement("Mpeg7");
+    XMLElement * mpeg7Element2 = document2.FirstChildElement("Mpeg7");
+
+    if (mpeg7Element1 == nullptr || mpeg7Element2 == nullptr) {
+        throw MPEG7_NODE_NOT_FOUND;
+    }
+
+    XMLElement * descriptionUnitElement1 = mpeg7Element1->FirstChildElement("DescriptionUnit");
+    XMLElement * descriptionUnitElement2 = mpeg7Element2->FirstChildElement("DescriptionUnit");
+
+    if (descriptionUnitElement1 == nullptr || descriptionUnitElement2 == nullptr) {
+        throw DESCRIPTION_UNIT_NODE_NOT_FOUND;
+    }
+
+    XMLElement * descriptorElement1 = descriptionUnitElement1->FirstChildElement("Descriptor");
+    XMLElement * descriptorElement2 = descriptionUnitElement2->FirstChildElement("Descriptor");
+
+    if (descriptorElement1 == nullptr || descriptorElement2 == nullptr) {
+        throw DESCRIPTOR_NODE_NOT_FOUND;
+    }
+
+    const char * xml1DescriptorType = descriptorElement1->Attribute("xsi:type");
+    const char * xml2DescriptorType = descriptorElement2->Attribute("xsi:type");
+
+    if (xml1DescriptorType == nullptr || xml2DescriptorType == nullptr) {
+        throw TYPE_ATTRIBUTE_NOT_FOUND;
+    }
+
+    DescriptorType type1 = detectType(xml1DescriptorType);
+    DescriptorType type2 = detectType(xml2DescriptorType);
+
+    if (type1 == NONE || type2 == NONE) {
+        throw XML_TYPE_NOT_RECOGNIZED;
+    }
+
+    if (type1 != type2) {
+        throw XML_TYPES_NOT_EQUAL;
+    }
+
+    const std::unique_ptr<Descriptor> descriptor1(createDescriptor(type1));
+    const std::unique_ptr<Descriptor> descriptor2(createDescriptor(type1));
+
+    {
+        TRACE_SCOPE("Descriptor::readFromXML");
+        descriptor1->readFromXML(descriptorElement1);
+        descriptor2->readFromXML(descriptorElement2);
+    }
+    return distanceBetween(descriptor1.get(), type1, descriptor2.get(), type2, params);
+}
+
+double distanceBetween(Descriptor * descriptor1, const DescriptorType type1, Descriptor * descriptor2, const DescriptorType type2, const char ** params) {
+    if (type1 != type2) {
+        throw XML_TYPES_NOT_EQUAL;
+    }
+
+    const std::unique_ptr<DescriptorDistance> descriptorDistanceInterface(createDistance(type1));
+
+    TRACE_SCOPE("DescriptorDistance::getDistance");
+    return descriptorDistanceInterface->getDistance(descriptor1, descriptor2, params);
+}
+
+Descriptor * createDescriptor(const DescriptorType descriptorType) {
+    return descriptorType == DOMINANT_COLOR_D      ? static_cast<Descriptor *>(new DominantColor())      :
+           descriptorType == SCALABLE_COLOR_D      ? static_cast<Descriptor *>(new ScalableColor())      :
+           descriptorType == COLOR_LAYOUT_D        ? static_cast<Descriptor *>(new ColorLayout())        :
+           descriptorType == COLOR_STRUCTURE_D     ? static_cast<Descriptor *>(new ColorStructure())     :
+           descriptorType == CT_BROWSING_D         ? static_cast<Descriptor *>(new CTBrowsing())         :
+           descriptorType == HOMOGENEOUS_TEXTURE_D ? static_cast<Descriptor *>(new HomogeneousTexture()) :
+           descriptorType == TEXTURE_BROWSING_D    ? static_cast<Descriptor *>(new TextureBrowsing())    :
+           descriptorType == EDGE_HISTOGRAM_D      ? static_cast<Descriptor *>(new EdgeHistogram())      :
+           descriptorType == REGION_SHAPE_D        ? static_cast<Descriptor *>(new RegionShape())        :
+           descriptorType == CONTOUR_SHAPE_D       ? static_cast<Descriptor *>(new ContourShape())       :
+                                                     throw UNRECOGNIZED_DESCRIPTOR_TYPE;
+}
+
+DescriptorExtractor * createExtractor(const DescriptorType descriptorType) {
+    return descriptorType == DOMINANT_COLOR_D      ? static_cast<DescriptorExtractor *>(new DominantColorExtractor())      :
+           descriptorType == SCALABLE_COLOR_D      ? static_cast<DescriptorExtractor *>(new ScalableColorExtractor())      :
+           descriptorType == COLOR_LAYOUT_D        ? static_cast<DescriptorExtractor *>(new ColorLayoutExtractor())        :
+           descriptorType == COLOR_STRUCTURE_D     ? static_cast<DescriptorExtractor *>(new ColorStructureExtractor())     :
+           descriptorType == CT_BROWSING_D         ? static_cast<DescriptorExtractor *>(new CTBrowsingExtractor())         :
+           descriptorType == HOMOGENEOUS_TEXTURE_D ? static_cast<DescriptorExtractor *>(new HomogeneousTextureExtractor()) :
+           descriptorType == TEXTURE_BROWSING_D    ? static_cast<DescriptorExtractor *>(new TextureBrowsingExtractor())    :
+           descriptorType == EDGE_HISTOGRAM_D      ? static_cast<DescriptorExtractor *>(new EdgeHistogramExtractor())      :
+           descriptorType == REGION_SHAPE_D        ? static_cast<DescriptorExtractor *>(new RegionShapeExtractor())        :
+           descriptorType == CONTOUR_SHAPE_D       ? static_cast<DescriptorExtractor *>(new ContourShapeExtractor())       :
+                                                     throw UNRECOGNIZED_DESCRIPTOR_TYPE;
+}
+
+DescriptorDistance * createDistance(const DescriptorType descriptorType) {
+    return descriptorType == DOMINANT_COLOR_D      ? static_cast<DescriptorDistance *>(new DominantColorDistance())      :
+           descriptorType == SCALABLE_COLOR_D      ? static_cast<DescriptorDistance *>(new ScalableColorDistance())      :
+           descriptorType == COLOR_LAYOUT_D        ? static_cast<DescriptorDistance *>(new ColorLayoutDistance())        :
+           descriptorType == COLOR_STRUCTURE_D     ? static_cast<DescriptorDistance *>(new ColorStructureDistance())     :
+           descriptorType == CT_BROWSING_D         ? static_cast<DescriptorDistance *>(new CTBrowsingDistance())         :
+           descriptorType == HOMOGENEOUS_TEXTURE_D ? static_cast<DescriptorDistance *>(new HomogeneousTextureDistance()) :
+           descriptorType == TEXTURE_BROWSING_D    ? static_cast<DescriptorDistance *>(new TextureBrowsingDistance())    :
+           descriptorType == EDGE_HISTOGRAM_D      ? static_cast<DescriptorDistance *>(new EdgeHistogramDistance())      :
+           descriptorType == REGION_SHAPE_D        ? static_cast<DescriptorDistance *>(new RegionShapeDistance())        :
+           descriptorType == CONTOUR_SHAPE_D       ? static_cast<DescriptorDistance *>(new ContourShapeDistance())       :
+                                                     throw UNRECOGNIZED_DESCRIPTOR_TYPE;
+}
+
+const char * descriptorName(const DescriptorType descriptorType) {
+    switch (descriptorType) {
+        case DOMINANT_COLOR_D:      return "DOMINANT_COLOR";
+        case SCALABLE_COLOR_D:      return "SCALABLE_COLOR";
+        case COLOR_LAYOUT_D:        return "COLOR_LAYOUT";
+        case COLOR_STRUCTURE_D:     return "COLOR_STRUCTURE";
+        case CT_BROWSING_D:         return "CT_BROWSING";
+        case HOMOGENEOUS_TEXTURE_D: return "HOMOGENEOUS_TEXTURE";
+        case TEXTURE_BROWSING_D:    return "TEXTURE_BROWSING";
+        case EDGE_HISTOGRAM_D:      return "EDGE_HISTOGRAM";
+        case REGION_SHAPE_D:        return "REGION_SHAPE";
+        case CONTOUR_SHAPE_D:       return "CONTOUR_SHAPE";
+        default:                    return "NONE";
+    }
+}
+
+int binaryExtraction(const DescriptorType descriptorType, Image & image, const char ** params, unsigned char * output, const int capacity) {
+    DescriptorExtractor * extractor = nullptr;
+
+    try {
+        extractor = createExtractor(descriptorType);
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+
+    const int packetSize = binaryExtraction(descriptorType, *extractor, image, params, output, capacity);
+
+    delete extractor;
+    return packetSize;
+}
+
+int binaryExtraction(const DescriptorType descriptorType, DescriptorExtractor & extractor, Image & image, const char ** params,
+                     unsigned char * output, const int capacity) {
+    TRACE_SCOPE("extractDescriptorBinary");
+
+    if (output == nullptr) {
+        return -BINARY_BUFFER_NULL;
+    }
+
+    try {
+        return writePacket(descriptorType, extractor.extract(image, params), output, capacity);
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+}
+
+int binaryExtraction(const DescriptorType descriptorType, const ShapeMask & mask, const char ** params, unsigned char * output, const int capacity) {
+    // Only shape descriptors are extracted from masks
+    if (descriptorType != REGION_SHAPE_D && descriptorType != CONTOUR_SHAPE_D) {
+        return -MASK_DESCRIPTOR_NOT_SUPPORTED;
+    }
+
+    const std::unique_ptr<DescriptorExtractor> extractor(createExtractor(descriptorType));
+    return binaryExtraction(descriptorType, *extractor, mask, params, output, capacity);
+}
+
+int binaryExtraction(const DescriptorType descriptorType, DescriptorExtractor & extractor, const ShapeMask & mask, const char ** params,
+                     unsigned char * output, const int capacity) {
+    TRACE_SCOPE("extractDescriptorBinary");
+
+    if (output == nullptr) {
+        return -BINARY_BUFFER_NULL;
+    }
+
+    try {
+        // Extractor was created for descriptorType
+        if (descriptorType == REGION_SHAPE_D) {
+            return writePacket(descriptorType, static_cast<RegionShapeExtractor &>(extractor).extract(mask, params), output, capacity);
+        }
+
+        if (descriptorType == CONTOUR_SHAPE_D) {
+            return writePacket(descriptorType, static_cast<ContourShapeExtractor &>(extractor).extract(mask, params), output, capacity);
+        }
+        throw MASK_DESCRIPTOR_NOT_SUPPORTED;
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+}
+
+int binaryExtraction(const DescriptorType descriptorType, TileSource & source, const char ** params, unsigned char * output, const int capacity) {
+    // Only descriptors merged from partial results of bands are extracted from tiles
+    if (descriptorType != SCALABLE_COLOR_D && descriptorType != COLOR_STRUCTURE_D &&
+        descriptorType != EDGE_HISTOGRAM_D && descriptorType != CT_BROWSING_D) {
+        return -TILE_DESCRIPTOR_NOT_SUPPORTED;
+    }
+
+    const std::unique_ptr<DescriptorExtractor> extractor(createExtractor(descriptorType));
+    return binaryExtraction(descriptorType, *extractor, source, params, output, capacity);
+}
+
+int binaryExtraction(const DescriptorType descriptorType, DescriptorExtractor & extractor, TileSource & source, const char ** params,
+                     unsigned char * output, const int capacity) {
+    TRACE_SCOPE("extractDescriptorBinary");
+
+    if (output == nullptr) {
+        return -BINARY_BUFFER_NULL;
+    }
+
+    try {
+        // Extractor was created for descriptorType
+        switch (descriptorType) {
+            case SCALABLE_COLOR_D:
+                return writePacket(descriptorType, static_cast<ScalableColorExtractor &>(extractor).extract(source, params), output, capacity);
+            case COLOR_STRUCTURE_D:
+                return writePacket(descriptorType, static_cast<ColorStructureExtractor &>(extractor).extract(source, params), output, capacity);
+            case EDGE_HISTOGRAM_D:
+                return writePacket(descriptorType, static_cast<EdgeHistogramExtractor &>(extractor).extract(source, params), output, capacity);
+            case CT_BROWSING_D:
+                return writePacket(descriptorType, static_cast<CTBrowsingExtractor &>(extractor).extract(source, params), output, capacity);
+            default:
+                throw TILE_DESCRIPTOR_NOT_SUPPORTED;
+        }
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+}
+
+int gridExtraction(const DescriptorType * descriptorTypes, const char *** params, const int typeCount, Image & image,
+                   const int columns, const int rows, unsigned char * output, const int capacity, int * results, int * needed) {
+    TRACE_SCOPE("extractDescriptorGrid");
+
+    if (needed != nullptr) {
+        *needed = 0;
+    }
+
+    if (descriptorTypes == nullptr || typeCount <= 0) {
+        return -UNRECOGNIZED_DESCRIPTOR_TYPE;
+    }
+
+    if (params == nullptr) {
+        return -PARAMS_NULL;
+    }
+
+    for (int t = 0; t < typeCount; t++) {
+        // Only descriptors of image region without global normalization are extracted per cell
+        if (descriptorTypes[t] != EDGE_HISTOGRAM_D && descriptorTypes[t] != COLOR_LAYOUT_D &&
+            descriptorTypes[t] != SCALABLE_COLOR_D && descriptorTypes[t] != HOMOGENEOUS_TEXTURE_D) {
+            return -GRID_DESCRIPTOR_NOT_SUPPORTED;
+        }
+
+        if (params[t] == nullptr) {
+            return -PARAMS_NULL;
+        }
+    }
+
+    // Buffer may be NULL only to query record size
+    if ((output == nullptr && capacity > 0) || results == nullptr) {
+        return -BINARY_BUFFER_NULL;
+    }
+
+    const int width  = image.getWidth();
+    const int height = image.getHeight();
+
+    if (columns <= 0 || rows <= 0 || columns > width || rows > height) {
+        return -GRID_NOT_VALID;
+    }
+
+    const size_t cells = static_cast<size_t>(columns) * rows;
+
+    // Packets of every type in order of cells (packet of failed cell is left out), size of packet of type (0 when no cell has it)
+    std::vector<std::vector<unsigned char>> packets(static_cast<size_t>(typeCount));
+    std::vector<int> packetSizes(static_cast<size_t>(typeCount), 0);
+
+    try {
+        unsigned char packet[DESCRIPTOR_BINARY_MAX_SIZE];
+
+        for (int t = 0; t < typeCount; t++) {
+            std::unique_ptr<DescriptorExtractor> extractor(createExtractor(descriptorTypes[t]));
+            prepareRegions(descriptorTypes[t], *extractor, image);
+
+            for (int r = 0; r < rows; r++) {
+                const int top    = static_cast<int>(static_cast<long long>(r) * height / rows);
+                const int bottom = static_cast<int>(static_cast<long long>(r + 1) * height / rows);
+
+                for (int c = 0; c < columns; c++) {
+                    const int left  = static_cast<int>(static_cast<long long>(c) * width / columns);
+                    const int right = static_cast<int>(static_cast<long long>(c + 1) * width / columns);
+
+                    int & result = results[(static_cast<size_t>(r) * columns + c) * typeCount + t];
+
+                    // Cell which cannot be extracted (e.g. below 128 x 128 pixels of Homogeneous Texture) gets its error
+                    try {
+                        Descriptor * descriptor = extractRegion(descriptorTypes[t], *extractor, left, top, right - left, bottom - top, params[t]);
+                        result = writePacket(descriptorTypes[t], descriptor, packet, DESCRIPTOR_BINARY_MAX_SIZE);
+                    }
+                    catch (ErrorCode exception) {
+                        result = -exception;
+                        continue;
+                    }
+
+                    packetSizes[t] = result;
+                    packets[t].insert(packets[t].end(), packet, packet + result);
+                }
+            }
+        }
+    }
+    catch (ErrorCode exception) {
+        return -exception;
+    }
+
+    int recordSize = 0;
+
+    for (int t = 0; t < typeCount; t++) {
+        recordSize += packetSizes[t];
+    }
+
+    if (static_cast<long long>(recordSize) * columns * rows > INT_MAX) {
+        return -BINARY_BUFFER_TOO_SMALL;
+    }
+
+    if (needed != nullptr) {
+        *needed = static_cast<int>(recordSize * cells);
+    }
+
+    if (static_cast<long long>(recordSize) * columns * rows > capacity) {
+        return -BINARY_BUFFER_TOO_SMALL;
+    }
+
+    // Packets are scattered into records, slots of failed cells are zeroed
+    int offset = 0;
+
+    for (int t = 0; t < typeCount; t++) {
+        const unsigned char * packet = packets[t].data();
+
+        for (size_t cell = 0; cell < cells; cell++) {
+            unsigned char * slot = output + cell * recordSize + offset;
+
+            if (results[cell * typeCount + t] > 0) {
+                std::copy(packet, packet + packetSizes[t], slot);
+                packet += packetSizes[t];
+            }
+            else {
+                std::fill(slot, slot + packetSizes[t], 0);
+            }
+        }
+        offset += packetSizes[t];
+    }
+
+    return recordSize;
+}
+
+void prepareRegions(const DescriptorType descriptorType, DescriptorExtractor & extractor, Image & image) {
+    // Extractor was created for descriptorType
+    switch (descriptorType) {
+        case EDGE_HISTOGRAM_D:
+            static_cast<EdgeHistogramExtractor &>(extractor).prepareRegions(image);
+            break;
+        case COLOR_LAYOUT_D:
+            static_cast<ColorLayoutExtractor &>(extractor).prepareRegions(image);
+            break;
+        case SCALABLE_COLOR_D:
+            static_cast<ScalableColorExtractor &>(extractor).prepareRegions(image);
+            break;
+        case HOMOGENEOUS_TEXTURE_D:
+            static_cast<HomogeneousTextureExtractor &>(extractor).prepareRegions(image);
+            break;
+        default:
+            throw GRID_DESCRIPTOR_NOT_SUPPORTED;
+    }
+}
+
+Descriptor * extractRegion(const DescriptorType descriptorType, DescriptorExtractor & extractor, const int x, const int y,
+                           const int width, const int height, const char ** params) {
+    switch (descriptorType) {
+        case EDGE_HISTOGRAM_D:
+            return static_cast<EdgeHistogramExtractor &>(extractor).extractRegion(x, y, width, height, params);
+        case COLOR_LAYOUT_D:
+            return static_cast<ColorLayoutExtractor &>(extractor).extractRegion(x, y, width, height, params);
+        case SCALABLE_COLOR_D:
+            return static_cast<ScalableColorExtractor &>(extractor).extractRegion(x, y, width, height, params);
+        case HOMOGENEOUS_TEXTURE_D:
+            return static_cast<HomogeneousTextureExtractor &>(extractor).extractRegion(x, y, width, height, params);
+        default:
+            throw GRID_DESCRIPTOR_NOT_SUPPORTED;
+    }
+}
+
+void copyParams(const char ** params, std::vector<std::string> & values, std::vector<const char *> & pointers) {
+    for (const char ** param = params; *param != nullptr; param++) {
+        values.push_back(*param);
+    }
+
+    // Pointers are taken after all values are stored (reallocation of vector moves strings)
+    for (const std::string & value : values) {
+        pointers.push_back(value.c_str());
+    }
+    pointers.push_back(nullptr);
+}
+
+void frameThumbnail(const unsigned char * pixels, const int width, const int height, const int stride, const PixelFormat format,
+                    float * thumbnail) {
+    const int pixelSize = Image::pixelSize(format);
+
+    // Gray level of pixel is its first channel (gray formats, Y plane of YUV formats) or mean of its three color channels
+    const int colorChannels = format == PIXEL_GRAY || format == PIXEL_GRAY_ALPHA || format == PIXEL_NV12 ||
+                              format == PIXEL_NV21 || format == PIXEL_I420 ? 1 : 3;
+
+    unsigned long sums  [FRAME_THUMBNAIL_SIZE * FRAME_THUMBNAIL_SIZE] = {0};
+    unsigned long counts[FRAME_THUMBNAIL_SIZE * FRAME_THUMBNAIL_SIZE] = {0};
+
+    for (int y = 0; y < height; y += 2) {
+        const unsigned char * pixel = pixels + static_cast<size_t>(y) * stride;
+        const int cellRow = static_cast<int>(static_cast<long long>(y) * FRAME_THUMBNAIL_SIZE / height) * FRAME_THUMBNAIL_SIZE;
+
+        for (int x = 0; x < width; x += 2, pixel += 2 * pixelSize) {
+            const int cell = cellRow + static_cast<int>(static_cast<long long>(x) * FRAME_THUMBNAIL_SIZE / width);
+
+            sums[cell] += colorChannels == 1 ? 3 * pixel[0] : pixel[0] + pixel[1] + pixel[2];
+            counts[cell]++;
+        }
+    }
+
+    for (int i = 0; i < FRAME_THUMBNAIL_SIZE * FRAME_THUMBNAIL_SIZE; i++) {
+        thumbnail[i] = counts[i] ? static_cast<float>(sums[i]) / (3.0f * counts[i]) : -1.0f;
+    }
+}
+
+int writePacket(const DescriptorType descriptorType, Descriptor * descriptor, unsigned char * output, const int capacity) {
+    const int packetSize = static_cast<int>(DESCRIPTOR_BINARY_HEADER_SIZE + descriptor->getBinarySize());
+
+    if (packetSize > capacity) {
+        throw BINARY_BUFFER_TOO_SMALL;
+    }
+
+    TRACE_SCOPE("Descriptor::writeBinary");
+    DescriptorBinary::writeHeader(output, descriptorType);
+    descriptor->writeBinary(output + DESCRIPTOR_BINARY_HEADER_SIZE);
+
+    return packetSize;
+}
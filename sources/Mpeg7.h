@@ -2,6 +2,7 @@
 
 #include "TOOLS/ErrorCode.h"
 #include "DESCRIPTORS/DescriptorType.h"
+#include "DESCRIPTORS/DescriptorBinary.h"
 
 #include "DESCRIPTORS/COLOR/ColorLayout/ColorLayout.h"
 #include "DESCRIPTORS/COLOR/ColorStructure/ColorStructure.h"
@@ -35,21 +36,114 @@
 
 #include "DESCRIPTORS/COLOR/ColorLayout/ColorLayoutDistance.h"
 #include "DESCRIPTORS/COLOR/ColorStructure/ColorStructureDistance.h"
+#include "DESCRIPTORS/COLOR/ColorStructure/ColorStructureIndex.h"
 #include "DESCRIPTORS/COLOR/CTBrowsing/CTBrowsingDistance.h"
 #include "DESCRIPTORS/COLOR/DominantColor/DominantColorDistance.h"
 #include "DESCRIPTORS/COLOR/ScalableColor/ScalableColorDistance.h"
 
 #include "DESCRIPTORS/SHAPE/ContourShape/ContourShapeDistance.h"
 #include "DESCRIPTORS/SHAPE/RegionShape/RegionShapeDistance.h"
+#include "DESCRIPTORS/SHAPE/RegionShape/RegionShapeIndex.h"
 
 #include "DESCRIPTORS/TEXTURE/EdgeHistogram/EdgeHistogramDistance.h"
 #include "DESCRIPTORS/TEXTURE/HomogeneusTexture/HomogeneousTextureDistance.h"
+#include "DESCRIPTORS/TEXTURE/HomogeneusTexture/HomogeneousTextureIndex.h"
 #include "DESCRIPTORS/TEXTURE/TextureBrowsing/TextureBrowsingDistance.h"
 
 #include <iomanip>
 
+#define DESCRIPTOR_XML_MAX_SIZE 8192 // bytes, enough for XML of any extracted descriptor (with terminating null)
+#define DISTANCE_TEXT_MAX_SIZE  512  // bytes, enough for any distance printed with 17 decimal digits
+
+/** @brief
+* Copies text into new result, allocated with malloc (release with freeResultPointer) */
 const char * message(int error);
 
+Descriptor * createDescriptor(DescriptorType descriptorType);
+DescriptorExtractor * createExtractor(DescriptorType descriptorType);
+DescriptorDistance * createDistance(DescriptorType descriptorType);
+
+/** @brief
+* Upper case name of descriptor type (e.g. "COLOR_LAYOUT"), used in file names and reports
+* @return const char * - name or "NONE" for unknown type */
+const char * descriptorName(DescriptorType descriptorType);
+
+/** @brief
+* Descriptor type of xsi:type attribute value (e.g. "ColorLayoutType")
+* @return DescriptorType - type or NONE for unknown value */
+DescriptorType detectType(const char * xmlDescriptorType);
+
+/** @brief
+* Reads extraction XML (as returned by extractDescriptor) into new descriptor object,
+* throws ErrorCode, when XML is not valid
+* @param descriptorType - output, type of read descriptor
+* @return Descriptor * - descriptor to be deleted by caller */
+Descriptor * readDescriptorXML(const char * xml, DescriptorType & descriptorType);
+
+/** @brief
+* Reads binary packet (as written by extractDescriptorBinary) into new descriptor object,
+* throws ErrorCode, when packet is not valid
+* @param descriptorType - output, type of read descriptor
+* @return Descriptor * - descriptor to be deleted by caller */
+Descriptor * readDescriptorBinary(const unsigned char * packet, unsigned long size, DescriptorType & descriptorType);
+
+/** @brief
+* Extracts descriptor from already decoded image and writes binary packet
+* (see DescriptorBinary.h) into caller buffer
+* @return int - packet size in bytes or negative ErrorCode */
+int binaryExtraction(DescriptorType descriptorType, Image & image, const char ** params, unsigned char * output, int capacity);
+
+/** @brief
+* Same as above with extractor kept by caller (reused for many images) */
+int binaryExtraction(DescriptorType descriptorType, DescriptorExtractor & extractor, Image & image, const char ** params,
+                     unsigned char * output, int capacity);
+
+/** @brief
+* Extracts shape descriptor (REGION_SHAPE_D or CONTOUR_SHAPE_D) of segmentation mask
+* and writes binary packet into caller buffer
+* @return int - packet size in bytes or negative ErrorCode (-MASK_DESCRIPTOR_NOT_SUPPORTED for other types) */
+int binaryExtraction(DescriptorType descriptorType, const ShapeMask & mask, const char ** params, unsigned char * output, int capacity);
+
+/** @brief
+* Same as above with extractor of descriptorType kept by caller (reused for many masks) */
+int binaryExtraction(DescriptorType descriptorType, DescriptorExtractor & extractor, const ShapeMask & mask, const char ** params,
+                     unsigned char * output, int capacity);
+
+/** @brief
+* Extracts decomposable descriptor (SCALABLE_COLOR_D, COLOR_STRUCTURE_D, EDGE_HISTOGRAM_D or CT_BROWSING_D)
+* from regions read from tile source and writes binary packet into caller buffer, packet is the same as of whole image
+* @return int - packet size in bytes or negative ErrorCode (-TILE_DESCRIPTOR_NOT_SUPPORTED for other types) */
+int binaryExtraction(DescriptorType descriptorType, TileSource & source, const char ** params, unsigned char * output, int capacity);
+
+/** @brief
+* Same as above with extractor of descriptorType kept by caller (reused for many sources) */
+int binaryExtraction(DescriptorType descriptorType, DescriptorExtractor & extractor, TileSource & source, const char ** params,
+                     unsigned char * output, int capacity);
+
+/** @brief
+* Extracts descriptors (EDGE_HISTOGRAM_D, COLOR_LAYOUT_D, SCALABLE_COLOR_D or HOMOGENEOUS_TEXTURE_D) of every cell
+* of columns x rows grid of already decoded image, image is prepared once per descriptor type. Record of cell (c, r)
+* (packets of all types in order of descriptorTypes) is written to output + (r * columns + c) * record size,
+* packet size (or negative ErrorCode of cell, its packet is zeroed) to results[(r * columns + c) * typeCount + t]
+* @return int - record size in bytes or negative ErrorCode (-GRID_DESCRIPTOR_NOT_SUPPORTED for other types) */
+int gridExtraction(const DescriptorType * descriptorTypes, const char *** params, int typeCount, Image & image,
+                   int columns, int rows, unsigned char * output, int capacity, int * results, int * needed);
+
+/** Opaque handle of extraction context (see createExtractionContext) */
+struct ExtractionContext;
+
+/** Opaque handle of frame stream session (see createStreamSession) */
+struct StreamSession;
+
+/** Opaque handle of group of frames (see createFrameGroup) */
+struct FrameGroup;
+
+/** Header of binary packet (see DescriptorBinary.h) */
+struct DescriptorPacketInfo {
+    DescriptorType type;
+    int recordSize; // bytes of descriptor record following header
+};
+
 #if defined(_WIN32) || defined(_WIN64)
     #define MODULE_API __declspec(dllexport)
 #else
@@ -57,8 +151,165 @@ const char * message(int error);
 #endif
 
 extern "C" {
+    /* Results of functions returning const char * (XML, distance or error code as text)
+     * are allocated with malloc and must be released with freeResultPointer. */
     MODULE_API const char * extractDescriptor (DescriptorType descriptorType, const char * imgURL, const char ** params);
     MODULE_API const char * extractDescriptorFromData (DescriptorType descriptorType, unsigned char * data, int size, const char ** params);
     MODULE_API const char * getDistance (const char * xml1, const char * xml2, const char ** params);
+    MODULE_API int extractDescriptorBinary (DescriptorType descriptorType, const char * imgURL, const char ** params, unsigned char * output, int capacity);
+    MODULE_API int extractDescriptorBinaryFromData (DescriptorType descriptorType, unsigned char * data, int size, const char ** params, unsigned char * output, int capacity);
+
+    /* Decodes every image once and extracts all typeCount descriptors from it
+     * (params[t] are parameters of descriptorTypes[t]) on 'threads' worker threads (0 - all hardware threads).
+     * Packet of image i and type t is written to output + (i * typeCount + t) * DESCRIPTOR_BINARY_MAX_SIZE,
+     * its size (or negative ErrorCode) to results[i * typeCount + t].
+     * Returns 0 or negative ErrorCode of invalid arguments. */
+    MODULE_API int extractDescriptorsBinaryBatch (const DescriptorType * descriptorTypes, const char *** params, int typeCount,
+                                                  unsigned char ** images, const int * sizes, int imageCount,
+                                                  int threads, unsigned char * output, int * results);
+
+    /* Variants writing result text into caller buffer, so buffers can be reused across calls
+     * and nothing is allocated for results. Return text length (without terminating null) or negative ErrorCode,
+     * *needed (optional, may be NULL) receives required buffer size in bytes (text length + 1, 0 on error).
+     * When text does not fit, -RESULT_BUFFER_TOO_SMALL is returned, so calling with NULL buffer
+     * and capacity 0 only queries the size. Buffer holds empty string after any error.
+     * Buffer of DESCRIPTOR_XML_MAX_SIZE bytes fits every extraction, DISTANCE_TEXT_MAX_SIZE every distance. */
+    MODULE_API int extractDescriptorToBuffer (DescriptorType descriptorType, const char * imgURL, const char ** params,
+                                              char * output, size_t capacity, size_t * needed);
+    MODULE_API int extractDescriptorFromDataToBuffer (DescriptorType descriptorType, unsigned char * data, int size, const char ** params,
+                                                      char * output, size_t capacity, size_t * needed);
+    MODULE_API int getDistanceToBuffer (const char * xml1, const char * xml2, const char ** params,
+                                        char * output, size_t capacity, size_t * needed);
+
+    /* Typed results, written to outputs instead of returned as text, so nothing is allocated, formatted or parsed.
+     * Functions return 0 or negative ErrorCode (-DISTANCE_RESULT_NULL for NULL distance output).
+     * getDistanceBinary compares packets of extractDescriptorBinary, getDistancesBinary compares query
+     * with 'count' packets at once, distance of packet i goes to distances[i] and its status (0 or negative ErrorCode)
+     * to results[i] (return value reports invalid arguments and query only). */
+    MODULE_API int getDistanceValue (const char * xml1, const char * xml2, const char ** params, double * distance);
+    MODULE_API int getDistanceBinary (const unsigned char * packet1, int size1, const unsigned char * packet2, int size2,
+                                      const char ** params, double * distance);
+    MODULE_API int getDistancesBinary (const unsigned char * query, int querySize, const unsigned char * const * packets, const int * sizes,
+                                       int count, const char ** params, double * distances, int * results);
+    MODULE_API int getDescriptorPacketInfo (const unsigned char * packet, int size, DescriptorPacketInfo * info);
+
+    /* Extraction context keeps extractor (with its tables and scratch buffers) and copy of parameters of one descriptor type
+     * alive across calls, so repeated extractions do not set them up again. Distance parameters are not kept (every
+     * getDistanceWithContext uses only its own params, like getDistanceBinary).
+     * Context must not be used by several threads at once (create one per thread).
+     * createExtractionContext returns 0 or negative ErrorCode, context is released with freeExtractionContext.
+     * extractWithContext writes XML like extractDescriptorFromDataToBuffer, extractBinaryWithContext writes packet
+     * like extractDescriptorBinaryFromData, getDistanceWithContext compares packets like getDistanceBinary. */
+    MODULE_API int createExtractionContext (DescriptorType descriptorType, const char ** params, ExtractionContext ** context);
+    MODULE_API int extractWithContext (ExtractionContext * context, unsigned char * data, int size,
+                                       char * output, size_t capacity, size_t * needed);
+    MODULE_API int extractBinaryWithContext (ExtractionContext * context, unsigned char * data, int size,
+                                             unsigned char * output, int capacity);
+    MODULE_API int getDistanceWithContext (ExtractionContext * context, const unsigned char * packet1, int size1,
+                                           const unsigned char * packet2, int size2, const char ** params, double * distance);
+    MODULE_API void freeExtractionContext (ExtractionContext * context);
+
+    /* Extraction from already decoded pixels (e.g. frame of video decoder), image is not encoded and decoded again
+     * and pixels are not copied (extractors read them through view of Image in their native layout).
+     * Rows of width x height image start every 'stride' bytes, pixel layout is given by format (PixelFormat
+     * in TOOLS/Image/Image.h: gray, gray + alpha, RGB, RGBA, BGR, BGRA or contiguous NV12, NV21, I420 with chroma
+     * rows following luma rows). Descriptors of gray image (EDGE_HISTOGRAM_D, HOMOGENEOUS_TEXTURE_D, TEXTURE_BROWSING_D,
+     * REGION_SHAPE_D, CONTOUR_SHAPE_D) of YUV formats use Y plane directly. Packet is written like extractDescriptorBinary,
+     * packet size or negative ErrorCode is returned (-PIXELS_NOT_VALID, -PIXEL_FORMAT_NOT_SUPPORTED). */
+    MODULE_API int extractDescriptorBinaryFromPixels (DescriptorType descriptorType, const unsigned char * pixels, int width, int height,
+                                                      int stride, PixelFormat format, const char ** params,
+                                                      unsigned char * output, int capacity);
+
+    /* Like extractDescriptorBinaryFromPixels for YUV frame with separate planes (NV12 and NV21: interleaved chroma
+     * in u, v is NULL; I420: u and v planes), e.g. planes of hardware decoder with their own strides. */
+    MODULE_API int extractDescriptorBinaryFromPlanes (DescriptorType descriptorType, int width, int height, PixelFormat format,
+                                                      const unsigned char * y, int yStride, const unsigned char * u,
+                                                      const unsigned char * v, int uvStride, const char ** params,
+                                                      unsigned char * output, int capacity);
+
+    /* Stream session extracts typeCount descriptors from consecutive frames of video. Like extraction context it keeps
+     * extractors and copies of parameters alive across frames, frame pixels are read through view (not copied).
+     * Frame is compared with last extracted frame by mean absolute difference of their 16 x 16 thumbnails of mean
+     * gray level (every second row and column sampled, 0 to 255, cells without sampled pixel of small frames are
+     * left out), frame of the same size differing less than 'threshold' is not extracted again (threshold 0 extracts
+     * every frame).
+     * extractFrameBinary writes packet of type t to output + t * DESCRIPTOR_BINARY_MAX_SIZE and its size (or negative ErrorCode)
+     * to results[t], packets of skipped frame are those of last extracted frame. It returns 1 for extracted frame, 0 for skipped
+     * frame or negative ErrorCode of invalid arguments (-SESSION_NULL, -PIXELS_NOT_VALID, -PIXEL_FORMAT_NOT_SUPPORTED).
+     * Session must not be used by several threads at once, it is released with freeStreamSession. */
+    MODULE_API int createStreamSession (const DescriptorType * descriptorTypes, const char *** params, int typeCount,
+                                        double threshold, StreamSession ** session);
+    MODULE_API int extractFrameBinary (StreamSession * session, const unsigned char * pixels, int width, int height, int stride,
+                                       PixelFormat format, unsigned char * output, int * results);
+    MODULE_API void freeStreamSession (StreamSession * session);
+
+    /* Scalable Color of group of frames (shot, GoFGoPColor of MPEG-7). Every added frame (raw pixels like
+     * extractDescriptorBinaryFromPixels) contributes only its HSV histogram, frames are not kept. Histograms are aggregated
+     * bin by bin with aggregation (GROUP_AVERAGE, GROUP_MEDIAN or GROUP_INTERSECTION, see ScalableColorExtractor.h),
+     * median keeps one histogram per frame. extractGroupBinary writes SCALABLE_COLOR_D packet of aggregated histogram
+     * like extractDescriptorBinary (packet size or negative ErrorCode, -GROUP_EMPTY for group without frames) and starts
+     * new group for next shot. Other functions return 0 or negative ErrorCode (-GROUP_NULL, -GROUP_AGGREGATION_NOT_SUPPORTED).
+     * Group must not be used by several threads at once, it is released with freeFrameGroup. */
+    MODULE_API int createFrameGroup (const char ** params, GroupAggregation aggregation, FrameGroup ** group);
+    MODULE_API int addFrameToGroup (FrameGroup * group, const unsigned char * pixels, int width, int height, int stride, PixelFormat format);
+    MODULE_API int extractGroupBinary (FrameGroup * group, unsigned char * output, int capacity);
+    MODULE_API void freeFrameGroup (FrameGroup * group);
+
+    /* Shape descriptors (REGION_SHAPE_D, CONTOUR_SHAPE_D) of segmentation masks, without encoding masks as images.
+     * RLE counts alternate background and foreground runs (first one is background, may be 0) of width x height mask
+     * in column-major (COCO, columnMajor 1) or row-major (columnMajor 0) pixel order. Polygon is list of vertexCount (x, y) pairs
+     * in pixel coordinates, its pixels are those with center inside, Contour Shape uses its vertices as contour.
+     * Packet is written like extractDescriptorBinary, packet size or negative ErrorCode is returned
+     * (-MASK_DESCRIPTOR_NOT_SUPPORTED for other descriptor types). */
+    MODULE_API int extractShapeBinaryFromRLE (DescriptorType descriptorType, int width, int height, const unsigned int * counts, int countSize,
+                                              int columnMajor, const char ** params, unsigned char * output, int capacity);
+    MODULE_API int extractShapeBinaryFromPolygon (DescriptorType descriptorType, int width, int height, const double * xy, int vertexCount,
+                                                  const char ** params, unsigned char * output, int capacity);
+
+    /* Shape descriptors of all objects of label map (width x height labels, row by row, 0 is background) of instance segmentation.
+     * Map is scanned once and split into runs of every label, each object is then extracted from its own runs
+     * (moments per run, contour traced in its bounding box) on 'threads' worker threads (0 - all hardware threads).
+     * Labels 1 to labelCount are extracted (higher ones are ignored), packet of label l and type t is written
+     * to output + ((l - 1) * typeCount + t) * DESCRIPTOR_BINARY_MAX_SIZE, its size (0 for label missing in map,
+     * or negative ErrorCode) to results[(l - 1) * typeCount + t]. Returns 0 or negative ErrorCode of invalid arguments. */
+    MODULE_API int extractShapesBinaryFromLabels (const DescriptorType * descriptorTypes, const char *** params, int typeCount,
+                                                  int width, int height, const unsigned short * labels, int labelCount,
+                                                  int threads, unsigned char * output, int * results);
+
+    /* Descriptors of images too large to be decoded at once (satellite, slide-scanner imagery), read region by region.
+     * Reader (see TileReader in TOOLS/Tile/TileSource.h) is called with 'user' for bands of about tileHeight full rows
+     * (0 - default height) of width x height image, alphaPresent tells whether image has alpha channel.
+     * Scalable Color, Color Structure (rows of its subsampling lattice only), Edge Histogram (transparent image is read twice)
+     * and CT Browsing (read once per averaging iteration) merge partial results of bands into the same packet as extraction
+     * of whole image gives. Packet is written like extractDescriptorBinary, packet size or negative ErrorCode is returned
+     * (-TILE_DESCRIPTOR_NOT_SUPPORTED for other descriptor types, -TILE_READ_FAILED when reader fails). */
+    MODULE_API int extractDescriptorBinaryFromTiles (DescriptorType descriptorType, int width, int height, int alphaPresent, int tileHeight,
+                                                     TileReader reader, void * user, const char ** params, unsigned char * output, int capacity);
+
+    /* Descriptors of every cell of columns x rows grid of image (localized search, region proposals).
+     * Cell (c, r) covers columns c * width / columns to (c + 1) * width / columns - 1 and likewise rows, its descriptors
+     * are the same as of cropped cell. Image is decoded once and preprocessing shared by cells (gray image of Edge Histogram
+     * and Homogeneous Texture, YCbCr of Color Layout, HSV bins of Scalable Color) is done once per descriptor type.
+     * Output is compact tensor of records of fixed size (packets of all types, in order of descriptorTypes), record of cell
+     * (c, r) starts at output + (r * columns + c) * record size. Size of packet of type t of the cell (or negative ErrorCode
+     * of the cell, e.g. -HOMOG_TEXT_IMAGE_TOO_SMALL_128 for cell below 128 x 128 pixels, its packet is zeroed) is written
+     * to results[(r * columns + c) * typeCount + t]. Record size is returned (packet sizes depend on params only, type
+     * failing in every cell takes no bytes) or negative ErrorCode: -GRID_DESCRIPTOR_NOT_SUPPORTED for types other than
+     * EDGE_HISTOGRAM_D, COLOR_LAYOUT_D, SCALABLE_COLOR_D and HOMOGENEOUS_TEXTURE_D, -GRID_NOT_VALID for grid with more cells
+     * than pixels, -BINARY_BUFFER_TOO_SMALL for capacity below columns * rows * record size. *needed (optional, may be NULL)
+     * receives required buffer size in bytes (0 on error other than -BINARY_BUFFER_TOO_SMALL), so calling with NULL buffer
+     * and capacity 0 only queries the size (cells are extracted to know it, results are written). */
+    MODULE_API int extractDescriptorGridBinary (const DescriptorType * descriptorTypes, const char *** params, int typeCount,
+                                                unsigned char * data, int size, int columns, int rows,
+                                                unsigned char * output, int capacity, int * results, int * needed);
+
+    /* Per-stage tracing (library built with MPEG7_TRACE, see TOOLS/Trace/Trace.h).
+     * enableTracing returns 0 or -TRACE_NOT_AVAILABLE, exportTrace returns recorded
+     * stages as Chrome trace JSON (release with freeResultPointer). */
+    MODULE_API int enableTracing (int enabled);
+    MODULE_API void clearTrace ();
+    MODULE_API const char * exportTrace ();
+    MODULE_API int exportTraceToBuffer (char * output, size_t capacity, size_t * needed);
+
     MODULE_API void freeResultPointer(char * ptr);
 }
\ No newline at end of file
@@ -0,0 +1,368 @@
+#include "DescriptorStore.h"
+
+#include <cstring>
+
+namespace {
+    void putUInt64(unsigned char * buffer, const unsigned long long value) {
+        for (int i = 0; i < 8; i++) {
+            buffer[i] = static_cast<unsigned char>(value >> (8 * i));
+        }
+    }
+
+    unsigned long long getUInt64(const unsigned char * buffer) {
+        unsigned long long value = 0;
+
+        for (int i = 7; i >= 0; i--) {
+            value = (value << 8) | buffer[i];
+        }
+        return value;
+    }
+
+    unsigned long getUInt32(const unsigned char * buffer) {
+        return static_cast<unsigned long>(buffer[0]) | static_cast<unsigned long>(buffer[1]) << 8 |
+               static_cast<unsigned long>(buffer[2]) << 16 | static_cast<unsigned long>(buffer[3]) << 24;
+    }
+
+    unsigned long long padding(const unsigned long long position) {
+        return (8 - position % 8) % 8;
+    }
+}
+
+bool DescriptorStore::isVariableSize(const DescriptorType type) {
+    return type == DOMINANT_COLOR_D || type == CONTOUR_SHAPE_D;
+}
+
+/* ----- WRITER ----- */
+
+DescriptorStoreWriter::DescriptorStoreWriter() : type(NONE), recordSize(0), count(0), recordsSize(0) {
+}
+
+void DescriptorStoreWriter::open(const char * path, const DescriptorType type) {
+    if (type < DOMINANT_COLOR_D || type > CONTOUR_SHAPE_D) {
+        throw UNRECOGNIZED_DESCRIPTOR_TYPE;
+    }
+
+    if (file.is_open()) {
+        close();
+    }
+
+    file.open(path, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open()) {
+        throw STORE_CANNOT_OPEN_FILE;
+    }
+
+    this->type  = type;
+    recordSize  = 0;
+    count       = 0;
+    recordsSize = 0;
+    recordOffsets.assign(1, 0);
+    keyOffsets.assign(1, 0);
+    keys.clear();
+
+    // Header is written again by close(), when all sections are known
+    const unsigned char header[DESCRIPTOR_STORE_HEADER_SIZE] = {};
+    write(header, DESCRIPTOR_STORE_HEADER_SIZE);
+}
+
+void DescriptorStoreWriter::write(const void * data, const unsigned long long size) {
+    file.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+
+    if (!file) {
+        throw STORE_WRITE_ERROR;
+    }
+}
+
+void DescriptorStoreWriter::add(Descriptor * descriptor, const char * key) {
+    buffer.resize(descriptor->getBinarySize());
+    descriptor->writeBinary(buffer.data());
+    addRecord(buffer.data(), static_cast<unsigned long>(buffer.size()), key);
+}
+
+void DescriptorStoreWriter::addRecord(const unsigned char * record, const unsigned long size, const char * key) {
+    if (!file.is_open()) {
+        throw STORE_WRITE_ERROR;
+    }
+
+    if (record == nullptr) {
+        throw BINARY_BUFFER_NULL;
+    }
+
+    if (DescriptorStore::isVariableSize(type)) {
+        recordOffsets.push_back(recordsSize + size);
+    }
+    else if (count == 0) {
+        recordSize = size;
+    }
+    else if (size != recordSize) {
+        throw STORE_RECORD_SIZE_ERROR;
+    }
+
+    write(record, size);
+    recordsSize += size;
+
+    if (key != nullptr) {
+        keys.insert(keys.end(), key, key + strlen(key));
+    }
+    keyOffsets.push_back(keys.size());
+
+    count++;
+}
+
+void DescriptorStoreWriter::addPacket(const unsigned char * packet, const unsigned long size, const char * key) {
+    if (DescriptorBinary::readHeader(packet, size) != type) {
+        throw STORE_TYPE_ERROR;
+    }
+    addRecord(packet + DESCRIPTOR_BINARY_HEADER_SIZE, size - DESCRIPTOR_BINARY_HEADER_SIZE, key);
+}
+
+unsigned long long DescriptorStoreWriter::size() const {
+    return count;
+}
+
+void DescriptorStoreWriter::close() {
+    if (!file.is_open()) {
+        return;
+    }
+
+    const unsigned char zeros[8] = {};
+    unsigned char value[8];
+
+    unsigned long long position = DESCRIPTOR_STORE_HEADER_SIZE + recordsSize;
+
+    const auto align = [&]() {
+        const unsigned long long pad = padding(position);
+        write(zeros, pad);
+        position += pad;
+    };
+
+    const auto writeTable = [&](const std::vector<unsigned long long> & table) {
+        for (const unsigned long long offset : table) {
+            putUInt64(value, offset);
+            write(value, 8);
+        }
+        position += 8 * table.size();
+    };
+
+    align();
+
+    unsigned long long recordTableOffset = 0;
+
+    if (DescriptorStore::isVariableSize(type)) {
+        recordTableOffset = position;
+        writeTable(recordOffsets);
+    }
+
+    unsigned long long keyTableOffset = 0;
+
+    if (!keys.empty()) {
+        keyTableOffset = position;
+        writeTable(keyOffsets);
+        write(keys.data(), keys.size());
+        position += keys.size();
+        align();
+    }
+
+    unsigned char header[DESCRIPTOR_STORE_HEADER_SIZE] = { 'M', '7', 'D', 'S' };
+    header[4] = static_cast<unsigned char>(DESCRIPTOR_STORE_VERSION & 0xFF);
+    header[5] = static_cast<unsigned char>(DESCRIPTOR_STORE_VERSION >> 8);
+    header[6] = static_cast<unsigned char>(type);
+    header[7] = DESCRIPTOR_BINARY_VERSION;
+    header[8]  = static_cast<unsigned char>(recordSize);
+    header[9]  = static_cast<unsigned char>(recordSize >> 8);
+    header[10] = static_cast<unsigned char>(recordSize >> 16);
+    header[11] = static_cast<unsigned char>(recordSize >> 24);
+    putUInt64(header + 16, count);
+    putUInt64(header + 24, DESCRIPTOR_STORE_HEADER_SIZE);
+    putUInt64(header + 32, recordTableOffset);
+    putUInt64(header + 40, keyTableOffset);
+    putUInt64(header + 48, position);
+
+    file.seekp(0);
+    write(header, DESCRIPTOR_STORE_HEADER_SIZE);
+
+    file.close();
+
+    if (file.fail()) {
+        throw STORE_WRITE_ERROR;
+    }
+}
+
+DescriptorStoreWriter::~DescriptorStoreWriter() {
+    try {
+        close();
+    }
+    catch (ErrorCode exception) {
+    }
+}
+
+/* ----- READER ----- */
+
+DescriptorStoreReader::DescriptorStoreReader() : data(nullptr), fileSize(0), type(NONE), recordSize(0), count(0),
+                                                 records(nullptr), recordOffsets(nullptr), keyOffsets(nullptr), keys(nullptr) {
+}
+
+void DescriptorStoreReader::open(const char * path) {
+    close();
+
+    file.open(path);
+
+    if (file.size() < DESCRIPTOR_STORE_HEADER_SIZE) {
+        close();
+        throw STORE_HEADER_ERROR;
+    }
+
+    data     = file.data();
+    fileSize = file.size();
+
+    try {
+        validate();
+    }
+    catch (ErrorCode exception) {
+        close();
+        throw;
+    }
+}
+
+void DescriptorStoreReader::validate() {
+    if (memcmp(data, "M7DS", 4) != 0 || (data[4] | data[5] << 8) != DESCRIPTOR_STORE_VERSION || data[7] != DESCRIPTOR_BINARY_VERSION) {
+        throw STORE_HEADER_ERROR;
+    }
+
+    if (data[6] < DOMINANT_COLOR_D || data[6] > CONTOUR_SHAPE_D) {
+        throw STORE_HEADER_ERROR;
+    }
+
+    type       = static_cast<DescriptorType>(data[6]);
+    recordSize = getUInt32(data + 8);
+    count      = getUInt64(data + 16);
+
+    const unsigned long long recordsOffset     = getUInt64(data + 24);
+    const unsigned long long recordTableOffset = getUInt64(data + 32);
+    const unsigned long long keyTableOffset    = getUInt64(data + 40);
+
+    if (getUInt64(data + 48) != fileSize || recordsOffset < DESCRIPTOR_STORE_HEADER_SIZE || recordsOffset > fileSize) {
+        throw STORE_HEADER_ERROR;
+    }
+
+    // Only bounds of sections are checked here, so opening does not touch all pages of file
+    const auto checkTable = [this](const unsigned long long offset) {
+        if (offset < DESCRIPTOR_STORE_HEADER_SIZE || offset > fileSize || (fileSize - offset) / 8 <= count) {
+            throw STORE_HEADER_ERROR;
+        }
+    };
+
+    records = data + recordsOffset;
+
+    if (DescriptorStore::isVariableSize(type)) {
+        if (recordSize != 0) {
+            throw STORE_HEADER_ERROR;
+        }
+
+        checkTable(recordTableOffset);
+
+        if (recordTableOffset < recordsOffset) {
+            throw STORE_HEADER_ERROR;
+        }
+        recordOffsets = data + recordTableOffset;
+
+        if (getUInt64(recordOffsets + 8 * count) > recordTableOffset - recordsOffset) {
+            throw STORE_HEADER_ERROR;
+        }
+    }
+    else if (count > 0 && (recordSize == 0 || (fileSize - recordsOffset) / recordSize < count)) {
+        throw STORE_HEADER_ERROR;
+    }
+
+    if (keyTableOffset != 0) {
+        checkTable(keyTableOffset);
+        keyOffsets = data + keyTableOffset;
+        keys = keyOffsets + 8 * (count + 1);
+
+        if (getUInt64(keyOffsets + 8 * count) > fileSize - (keyTableOffset + 8 * (count + 1))) {
+            throw STORE_HEADER_ERROR;
+        }
+    }
+}
+
+void DescriptorStoreReader::close() {
+    file.close();
+
+    data          = nullptr;
+    fileSize      = 0;
+    type          = NONE;
+    recordSize    = 0;
+    count         = 0;
+    records       = nullptr;
+    recordOffsets = nullptr;
+    keyOffsets    = nullptr;
+    keys          = nullptr;
+}
+
+bool DescriptorStoreReader::isOpen() const {
+    return data != nullptr;
+}
+
+DescriptorType DescriptorStoreReader::getType() const {
+    return type;
+}
+
+unsigned long long DescriptorStoreReader::size() const {
+    return count;
+}
+
+unsigned long DescriptorStoreReader::getRecordSize() const {
+    return recordSize;
+}
+
+const unsigned char * DescriptorStoreReader::record(const unsigned long long index, unsigned long & size) const {
+    if (index >= count) {
+        throw STORE_INDEX_OUT_OF_RANGE;
+    }
+
+    if (recordOffsets == nullptr) {
+        size = recordSize;
+        return records + index * recordSize;
+    }
+
+    const unsigned long long begin = getUInt64(recordOffsets + 8 * index);
+    const unsigned long long end   = getUInt64(recordOffsets + 8 * (index + 1));
+
+    if (begin > end || end > getUInt64(recordOffsets + 8 * count)) {
+        throw STORE_HEADER_ERROR;
+    }
+
+    size = static_cast<unsigned long>(end - begin);
+    return records + begin;
+}
+
+const char * DescriptorStoreReader::key(const unsigned long long index, unsigned long & length) const {
+    if (index >= count) {
+        throw STORE_INDEX_OUT_OF_RANGE;
+    }
+
+    if (keyOffsets == nullptr) {
+        length = 0;
+        return "";
+    }
+
+    const unsigned long long begin = getUInt64(keyOffsets + 8 * index);
+    const unsigned long long end   = getUInt64(keyOffsets + 8 * (index + 1));
+
+    if (begin > end || end > getUInt64(keyOffsets + 8 * count)) {
+        throw STORE_HEADER_ERROR;
+    }
+
+    length = static_cast<unsigned long>(end - begin);
+    return reinterpret_cast<const char *>(keys + begin);
+}
+
+void DescriptorStoreReader::read(const unsigned long long index, Descriptor * descriptor) const {
+    unsigned long size = 0;
+    const unsigned char * buffer = record(index, size);
+    descriptor->readFromBinary(buffer, size);
+}
+
+DescriptorStoreReader::~DescriptorStoreReader() {
+    close();
+}
@@ -0,0 +1,149 @@
+/** @file   DescriptorStore.h
+ *  @brief  Columnar on-disk store of descriptors of a single type, designed to be memory mapped.
+ *
+ *          A store file holds binary records (see DescriptorBinary.h, without packet header)
+ *          of one descriptor type and optional key (e.g. image path) of every record.
+ *          Reader maps the whole file read-only, so opening costs no parsing,
+ *          records are accessed in place and the page cache is shared by all processes
+ *          reading the same store.
+ *
+ *          Records of Edge Histogram, Scalable Color, Color Layout, Color Structure,
+ *          Homogeneous Texture, Texture Browsing, CT Browsing and Region Shape have fixed size
+ *          for given extraction parameters, so they are stored back to back and record i is found
+ *          at records + i * record size. Dominant Color and Contour Shape records vary in size
+ *          and are located through offset table. Descriptors extracted with other parameters
+ *          (e.g. other NumberOfYCoeff) go to separate stores.
+ *
+ *          File layout (multi-byte values little-endian, sections aligned to 8 bytes):
+ *
+ *          Offset | Size | Value
+ *          ------ | ---- | ----------------------------------------
+ *          0      | 4    | 'M' '7' 'D' 'S'
+ *          4      | 2    | u16 DESCRIPTOR_STORE_VERSION
+ *          6      | 1    | DescriptorType
+ *          7      | 1    | DESCRIPTOR_BINARY_VERSION of records
+ *          8      | 4    | u32 record size (fixed layout) or 0 (variable layout)
+ *          12     | 4    | reserved (0)
+ *          16     | 8    | u64 record count
+ *          24     | 8    | u64 records section offset
+ *          32     | 8    | u64 record offset table offset (variable layout) or 0
+ *          40     | 8    | u64 key offset table offset or 0 (no keys stored)
+ *          48     | 8    | u64 file size
+ *          56     | 8    | reserved (0)
+ *
+ *          Offset tables hold count + 1 u64 values: record i spans [offset[i], offset[i + 1])
+ *          of records section, key i spans [offset[i], offset[i + 1]) of key bytes following key table.
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include "../DESCRIPTORS/Descriptor.h"
+#include "../DESCRIPTORS/DescriptorType.h"
+#include "MappedFile.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#define DESCRIPTOR_STORE_VERSION     1
+#define DESCRIPTOR_STORE_HEADER_SIZE 64
+
+class DescriptorStore {
+    public:
+        /** @brief
+        * @return bool - true, when records of type are located through offset table (Dominant Color, Contour Shape) */
+        static bool isVariableSize(DescriptorType type);
+};
+
+class DescriptorStoreWriter {
+    private:
+        std::ofstream file;
+        DescriptorType type;
+        unsigned long recordSize;
+        unsigned long long count;
+        unsigned long long recordsSize;
+        std::vector<unsigned long long> recordOffsets;
+        std::vector<unsigned long long> keyOffsets;
+        std::vector<char> keys;
+        std::vector<unsigned char> buffer;
+
+        void write(const void * data, unsigned long long size);
+
+    public:
+        DescriptorStoreWriter();
+
+        /** @brief
+        * Creates (or overwrites) store file for descriptors of given type */
+        void open(const char * path, DescriptorType type);
+
+        /** @brief
+        * Appends descriptor record
+        * @param key - record key (e.g. image path), nullptr or "" for none */
+        void add(Descriptor * descriptor, const char * key);
+
+        /** @brief
+        * Appends record already in binary form (Descriptor::writeBinary) */
+        void addRecord(const unsigned char * record, unsigned long size, const char * key);
+
+        /** @brief
+        * Appends binary packet (record with DescriptorBinary header), its type has to match store type */
+        void addPacket(const unsigned char * packet, unsigned long size, const char * key);
+
+        unsigned long long size() const;
+
+        /** @brief
+        * Writes offset tables and header, store is complete after that */
+        void close();
+
+        ~DescriptorStoreWriter();
+};
+
+class DescriptorStoreReader {
+    private:
+        MappedFile file;
+        const unsigned char * data;
+        unsigned long long fileSize;
+        DescriptorType type;
+        unsigned long recordSize;
+        unsigned long long count;
+        const unsigned char * records;
+        const unsigned char * recordOffsets;
+        const unsigned char * keyOffsets;
+        const unsigned char * keys;
+
+        void validate();
+
+    public:
+        DescriptorStoreReader();
+
+        /** @brief
+        * Maps store file read-only and validates its header and sections */
+        void open(const char * path);
+        void close();
+        bool isOpen() const;
+
+        DescriptorType getType() const;
+        unsigned long long size() const;
+
+        /** @brief
+        * @return unsigned long - size of every record, 0 for variable size records */
+        unsigned long getRecordSize() const;
+
+        /** @brief
+        * Record i in mapped memory (valid until close)
+        * @param size - output, record size in bytes */
+        const unsigned char * record(unsigned long long index, unsigned long & size) const;
+
+        /** @brief
+        * Key of record i in mapped memory (not null terminated, valid until close)
+        * @param length - output, key length (0 when store has no keys) */
+        const char * key(unsigned long long index, unsigned long & length) const;
+
+        /** @brief
+        * Reads record i into descriptor of store type (see createDescriptor(getType())) */
+        void read(unsigned long long index, Descriptor * descriptor) const;
+
+        ~DescriptorStoreReader();
+};
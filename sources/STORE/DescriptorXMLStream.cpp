@@ -0,0 +1,824 @@
+#include "DescriptorXMLStream.h"
+
+#include "../Mpeg7.h"
+#include "../TOOLS/Parallel/Parallel.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+    bool isSpace(const char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    /* Reads whitespace separated integers the way stream extraction (ss >> value) does:
+       reading stops at first value which is not an integer. Values above capacity are counted only.
+       Returns number of read values. */
+    int parseIntegers(const XMLSpan & text, long * values, const int capacity) {
+        const char * c = text.data;
+        const char * end = text.data + text.length;
+        int count = 0;
+
+        for (;;) {
+            while (c < end && isSpace(*c)) {
+                c++;
+            }
+
+            const bool negative = c < end && *c == '-';
+
+            if (c < end && (*c == '-' || *c == '+')) {
+                c++;
+            }
+
+            if (c == end || *c < '0' || *c > '9') {
+                return count;
+            }
+
+            long long value = 0;
+
+            while (c < end && *c >= '0' && *c <= '9') {
+                value = value * 10 + (*c++ - '0');
+
+                if (value > 0x7FFFFFFFLL) {
+                    return count; // does not fit into int, extraction fails
+                }
+            }
+
+            if (count < capacity) {
+                values[count] = static_cast<long>(negative ? -value : value);
+            }
+            count++;
+        }
+    }
+
+    /* Single value, 0 when text does not start with an integer (as failed extraction leaves it) */
+    long parseInteger(const XMLSpan & text) {
+        long value = 0;
+        parseIntegers(text, &value, 1);
+        return value;
+    }
+
+    float parseFloat(const XMLSpan & text) {
+        char buffer[64];
+        const size_t length = text.length < sizeof(buffer) - 1 ? text.length : sizeof(buffer) - 1;
+
+        memcpy(buffer, text.data, length);
+        buffer[length] = '\0';
+        return strtof(buffer, nullptr);
+    }
+
+    /* Calls visitor(name) for every child element of element started last. Visitor may consume
+       child (readText, skipElement, forEachChild), children left unread are skipped. */
+    template <typename Visitor>
+    void forEachChild(XMLScanner & scanner, Visitor visitor) {
+        const int depth = scanner.getDepth();
+
+        for (;;) {
+            const XMLToken token = scanner.next();
+
+            if (token == XML_END) {
+                throw PARSE_ERROR;
+            }
+
+            if (scanner.getDepth() < depth) {
+                return;
+            }
+
+            if (token == XML_ELEMENT_START) {
+                visitor(scanner.name());
+
+                if (scanner.getDepth() > depth) {
+                    scanner.skipElement();
+                }
+            }
+        }
+    }
+
+    long intAttribute(const XMLScanner & scanner, const char * name) {
+        XMLSpan value;
+        return scanner.attribute(name, value) ? parseInteger(value) : 0;
+    }
+
+    /* ----- Decoders, one per descriptor type, mirroring its readFromXML and writeBinary ----- */
+
+    unsigned long decodeDominantColor(XMLScanner & scanner, unsigned char * record) {
+        // Percentage, index and variance of every value, variance flag of the last value is used (as in readFromXML)
+        const int valueCapacity = (DESCRIPTOR_BINARY_MAX_SIZE - DESCRIPTOR_BINARY_HEADER_SIZE - 3) / 7;
+
+        long values[valueCapacity][7];
+        bool valueVariance[valueCapacity];
+        int count = 0;
+        bool variancePresent = false;
+        float coherency = 0.0f;
+
+        forEachChild(scanner, [&](const XMLSpan & name) {
+            if (name.equals("SpatialCoherency")) {
+                coherency = parseFloat(scanner.readText());
+            }
+            else if (name.equals("Value")) {
+                XMLSpan percentage, index, variance;
+                bool hasPercentage = false, hasIndex = false, hasVariance = false;
+
+                forEachChild(scanner, [&](const XMLSpan & valueName) {
+                    if (valueName.equals("Percentage") && !hasPercentage) {
+                        percentage = scanner.readText();
+                        hasPercentage = true;
+                    }
+                    else if (valueName.equals("Index") && !hasIndex) {
+                        index = scanner.readText();
+                        hasIndex = true;
+                    }
+                    else if (valueName.equals("ColorVariance") && !hasVariance) {
+                        variance = scanner.readText();
+                        hasVariance = true;
+                    }
+                });
+
+                if (!hasPercentage) {
+                    throw DOM_COL_XML_NO_PERCENTAGE_ELEMENT;
+                }
+
+                if (!hasIndex) {
+                    throw DOM_COL_XML_NO_INDEX_ELEMENT;
+                }
+
+                if (count == valueCapacity) {
+                    throw BINARY_VALUE_ERROR;
+                }
+
+                if (parseIntegers(percentage, values[count], 1) < 1) {
+                    throw DOM_COL_XML_PERCENTAGE_NOT_INTEGER;
+                }
+
+                if (parseIntegers(index, values[count] + 1, 3) < 3) {
+                    throw DOM_COL_XML_INDEX_VALUE_NOT_INTEGER;
+                }
+
+                if (hasVariance && parseIntegers(variance, values[count] + 4, 3) < 3) {
+                    throw DOM_COL_XML_VARIANCE_VALUE_NOT_INTEGER;
+                }
+
+                valueVariance[count++] = hasVariance;
+                variancePresent = hasVariance;
+            }
+        });
+
+        const long integerCoherency = static_cast<long>(coherency);
+
+        if (integerCoherency != coherency) {
+            throw BINARY_VALUE_ERROR;
+        }
+
+        DescriptorBinary::writeUInt8(record, variancePresent ? 1 : 0);
+        DescriptorBinary::writeUInt8(record + 1, integerCoherency);
+        DescriptorBinary::writeUInt8(record + 2, count);
+
+        unsigned char * value = record + 3;
+
+        for (int i = 0; i < count; i++) {
+            if (variancePresent && !valueVariance[i]) {
+                throw DOM_COL_XML_VARIANCE_VALUE_NOT_INTEGER;
+            }
+
+            for (int j = 0; j < (variancePresent ? 7 : 4); j++) {
+                DescriptorBinary::writeUInt8(value++, values[i][j]);
+            }
+        }
+        return static_cast<unsigned long>(value - record);
+    }
+
+    unsigned long decodeScalableColor(XMLScanner & scanner, unsigned char * record) {
+        const long coefficientsCode = intAttribute(scanner, "NumberOfCoefficients");
+        const long bitplanesCode    = intAttribute(scanner, "NumberOfBitplanesDiscarded");
+
+        static const int COEFFICIENTS[] = { 16, 32, 64, 128, 256 };
+        static const int BITPLANES[]    = { 0, 1, 2, 3, 4, 6, 8 };
+
+        if (coefficientsCode < 0 || coefficientsCode > 4) {
+            throw SCAL_COL_XML_COEFF_ERROR;
+        }
+
+        if (bitplanesCode < 0 || bitplanesCode > 6) {
+            throw SCAL_COL_XML_BITS_DISC_ERROR;
+        }
+
+        const int coefficientCount = COEFFICIENTS[coefficientsCode];
+
+        long coefficients[256];
+        int count = -1;
+
+        forEachChild(scanner, [&](const XMLSpan & name) {
+            if (name.equals("Coefficients") && count < 0) {
+                count = parseIntegers(scanner.readText(), coefficients, 256);
+            }
+        });
+
+        if (count < 0) {
+            throw SCAL_COL_XML_COEFF_NODE_MISSING;
+        }
+
+        if (count != coefficientCount) {
+            throw SCAL_COL_XML_COEFF_MATCH_ERROR;
+        }
+
+        DescriptorBinary::writeUInt16(record, coefficientCount);
+        DescriptorBinary::writeUInt8(record + 2, BITPLANES[bitplanesCode]);
+
+        for (int i = 0; i < coefficientCount; i++) {
+            DescriptorBinary::writeInt16(record + 3 + 2 * i, coefficients[i]);
+        }
+        return 3 + 2 * coefficientCount;
+    }
+
+    unsigned long decodeColorLayout(XMLScanner & scanner, unsigned char * record) {
+        // AC element with lowest coefficient number is used, when more of them are present (as in readFromXML)
+        static const char * SUFFIXES[] = { "2", "5", "9", "14", "20", "27", "63" };
+        static const char * CHANNELS[] = { "Y", "Cb", "Cr" };
+
+        XMLSpan dc[3];
+        XMLSpan ac[3];
+        bool hasDC[3] = { false, false, false };
+        int acRank[3] = { 7, 7, 7 };
+
+        forEachChild(scanner, [&](const XMLSpan & name) {
+            for (int channel = 0; channel < 3; channel++) {
+                const size_t prefix = strlen(CHANNELS[channel]);
+
+                if (name.length <= prefix || memcmp(name.data, CHANNELS[channel], prefix) != 0) {
+                    continue;
+                }
+
+                const XMLSpan rest = { name.data + prefix, name.length - prefix };
+
+                if (rest.equals("DCCoeff")) {
+                    if (!hasDC[channel]) {
+                        dc[channel] = scanner.readText();
+                        hasDC[channel] = true;
+                    }
+                    return;
+                }
+
+                if (rest.length > 7 && memcmp(rest.data, "ACCoeff", 7) == 0) {
+                    const XMLSpan suffix = { rest.data + 7, rest.length - 7 };
+
+                    for (int rank = 0; rank < acRank[channel]; rank++) {
+                        if (suffix.equals(SUFFIXES[rank])) {
+                            ac[channel] = scanner.readText();
+                            acRank[channel] = rank;
+                            return;
+                        }
+                    }
+                }
+                return;
+            }
+        });
+
+        if (!hasDC[0] || !hasDC[1] || !hasDC[2]) {
+            throw COL_LAY_DC_NODE_ERROR;
+        }
+
+        if (acRank[0] == 7 || acRank[1] == 7 || acRank[2] == 7) {
+            throw COL_LAY_AC_NODE_ERROR;
+        }
+
+        long coefficients[3][64];
+        int counts[3];
+
+        for (int channel = 0; channel < 3; channel++) {
+            if (parseIntegers(dc[channel], coefficients[channel], 1) != 1) {
+                throw COL_LAY_WRONG_COEFF_NUMBER;
+            }
+            counts[channel] = 1 + parseIntegers(ac[channel], coefficients[channel] + 1, 63);
+        }
+
+        const auto validCount = [](const int count) {
+            return count == 3 || count == 6 || count == 10 || count == 15 || count == 21 || count == 28 || count == 64;
+        };
+
+        if (!validCount(counts[0])) {
+            throw COL_LAY_WRONG_COEFF_NUMBER;
+        }
+
+        if (counts[1] != counts[2]) {
+            throw COL_LAY_COEFF_NUMBER_DIFFERENT;
+        }
+
+        if (!validCount(counts[1])) {
+            throw COL_LAY_WRONG_COEFF_NUMBER;
+        }
+
+        DescriptorBinary::writeUInt8(record, counts[0]);
+        DescriptorBinary::writeUInt8(record + 1, counts[1]);
+
+        unsigned char * value = record + 2;
+
+        for (int channel = 0; channel < 3; channel++) {
+            for (int i = 0; i < counts[channel]; i++) {
+                DescriptorBinary::writeUInt8(value++, coefficients[channel][i]);
+            }
+        }
+        return static_cast<unsigned long>(value - record);
+    }
+
+    unsigned long decodeColorStructure(XMLScanner & scanner, unsigned char * record) {
+        const long colorQuant = intAttribute(scanner, "colorQuant");
+
+        if (colorQuant < 1 || colorQuant > 4) {
+            throw COL_STRUCT_XML_QUANT_VAL_ERROR;
+        }
+
+        const int size = 16 << colorQuant;
+
+        long values[256];
+        int count = -1;
+
+        forEachChild(scanner, [&](const XMLSpan & name) {
+            if (name.equals("Values") && count < 0) {
+                count = parseIntegers(scanner.readText(), values, 256);
+            }
+        });
+
+        if (count < 0) {
+            throw COL_STRUCT_VALUES_NODE_NOT_FOUND;
+        }
+
+        if (count != size) {
+            throw COL_STRUCT_VALUES_COUNT_ERROR;
+        }
+
+        DescriptorBinary::writeUInt16(record, size);
+
+        for (int i = 0; i < size; i++) {
+            DescriptorBinary::writeUInt8(record + 2 + i, values[i]);
+        }
+        return 2 + size;
+    }
+
+    unsigned long decodeCTBrowsing(XMLScanner & scanner, unsigned char * record) {
+        XMLSpan category, subRange;
+        bool hasCategory = false, hasSubRange = false;
+
+        forEachChild(scanner, [&](const XMLSpan & name) {
+            if (name.equals("BrowsingCategory") && !hasCategory) {
+                category = scanner.readText();
+                hasCategory = true;
+            }
+            else if (name.equals("SubRangeIndex") && !hasSubRange) {
+                subRange = scanner.readText();
+                hasSubRange = true;
+            }
+        });
+
+        if (!hasCategory) {
+            throw CT_BROWSING_BROWSING_CATEGORY_NOT_FOUND;
+        }
+
+        const long categoryValue = category.equals("hot")      ? 0 :
+                                   category.equals("warm")     ? 1 :
+                                   category.equals("moderate") ? 2 :
+                                   category.equals("cool")     ? 3 : throw CT_BROWSING_UNRECOGNIZED_CATEGORY;
+
+        if (!hasSubRange) {
+            throw CT_BROWSING_SUBRANGE_IDX_NOT_FOUND;
+        }
+
+        DescriptorBinary::writeUInt8(record, categoryValue);
+        DescriptorBinary::writeUInt8(record + 1, parseInteger(subRange));
+        return 2;
+    }
+
+    unsigned long decodeHomogeneousTexture(XMLScanner & scanner, unsigned char * record) {
+        XMLSpan texts[4];
+        bool found[4] = { false, false, false, false };
+        static const char * NAMES[] = { "Average", "StandardDeviation", "Energy", "EnergyDeviation" };
+
+        forEachChild(scanner, [&](const XMLSpan & name) {
+            for (int i = 0; i < 4; i++) {
+                if (!found[i] && name.equals(NAMES[i])) {
+                    texts[i] = scanner.readText();
+                    found[i] = true;
+                    return;
+                }
+            }
+        });
+
+        if (!found[0]) {
+            throw HOMOG_TEXT_XML_AVERAGE_MISSING;
+        }
+
+        if (!found[1]) {
+            throw HOMOG_TEXT_XML_STANDDEV_MISSING;
+        }
+
+        if (!found[2]) {
+            throw HOMOG_TEXT_XML_ENERGY_MISSING;
+        }
+
+        long feature[62];
+
+        feature[0] = parseInteger(texts[0]);
+        feature[1] = parseInteger(texts[1]);
+
+        if (parseIntegers(texts[2], feature + 2, 30) != 30) {
+            throw HOMOG_TEXT_XML_ENERGY_SIZE_ERROR;
+        }
+
+        // Energy deviation with other count of values is dropped (as in readFromXML)
+        const bool deviation = found[3] && parseIntegers(texts[3], feature + 32, 30) == 30;
+
+        DescriptorBinary::writeUInt8(record, deviation ? 1 : 0);
+
+        for (int i = 0; i < 62; i++) {
+            DescriptorBinary::writeUInt8(record + 1 + i, i < 32 || deviation ? feature[i] : 0);
+        }
+        return 63;
+    }
+
+    long textureDirection(const XMLSpan & text) {
+        return text.equals("No directionality") ? 0 :
+               text.equals("0 degree")          ? 1 :
+               text.equals("30 degree")         ? 2 :
+               text.equals("60 degree")         ? 3 :
+               text.equals("90 degree")         ? 4 :
+               text.equals("120 degree")        ? 5 :
+               text.equals("150 degree")        ? 6 : -1;
+    }
+
+    long textureScale(const XMLSpan & text) {
+        return text.equals("fine")        ? 1 :
+               text.equals("medium")      ? 2 :
+               text.equals("coarse")      ? 3 :
+               text.equals("very coarse") ? 4 : -1;
+    }
+
+    unsigned long decodeTextureBrowsing(XMLScanner & scanner, unsigned char * record) {
+        XMLSpan regularity, direction[2], scale[2];
+        bool hasRegularity = false;
+        int directions = 0, scales = 0;
+
+        forEachChild(scanner, [&](const XMLSpan & name) {
+            if (name.equals("Regularity")) {
+                regularity = scanner.readText();
+                hasRegularity = true;
+            }
+            else if (name.equals("Direction")) {
+                direction[directions == 0 ? 0 : 1] = scanner.readText();
+                directions++;
+            }
+            else if (name.equals("Scale")) {
+                scale[scales == 0 ? 0 : 1] = scanner.readText();
+                scales++;
+            }
+        });
+
+        if (!hasRegularity) {
+            throw TEXT_BROWS_XML_REGULARITY_MISSING;
+        }
+
+        if (directions == 0) {
+            throw TEXT_BROWS_XML_DIRECTION_MISSING;
+        }
+
+        if (scales == 0 || (directions > 1 && scales < 2)) {
+            throw TEXT_BROWS_XML_SCALE_MISSING;
+        }
+
+        const bool second = directions > 1;
+
+        const long components[5] = {
+            regularity.equals("irregular")        ? 1 :
+            regularity.equals("slightly regular") ? 2 :
+            regularity.equals("regular")          ? 3 :
+            regularity.equals("highly regular")   ? 4 : -1,
+            textureDirection(direction[0]),
+            textureScale(scale[0]),
+            second ? textureDirection(direction[1]) : 0,
+            second ? textureScale(scale[1]) : 0
+        };
+
+        for (int i = 0; i < 5; i++) {
+            if (components[i] == -1) {
+                throw TEXT_BROWS_XML_WRONG_VALUES;
+            }
+        }
+
+        DescriptorBinary::writeUInt8(record, second ? 1 : 0);
+
+        for (int i = 0; i < 5; i++) {
+            DescriptorBinary::writeUInt8(record + 1 + i, components[i]);
+        }
+        return 6;
+    }
+
+    /* Edge Histogram and Region Shape keep values as char, so they are narrowed the same way */
+    unsigned long decodeCharValues(XMLScanner & scanner, unsigned char * record, const char * elementName, const int size,
+                                   const ErrorCode missing, const ErrorCode countError) {
+        long values[80];
+        int count = -1;
+
+        forEachChild(scanner, [&](const XMLSpan & name) {
+            if (name.equals(elementName) && count < 0) {
+                count = parseIntegers(scanner.readText(), values, 80);
+            }
+        });
+
+        if (count < 0) {
+            throw missing;
+        }
+
+        if (count != size) {
+            throw countError;
+        }
+
+        for (int i = 0; i < size; i++) {
+            DescriptorBinary::writeUInt8(record + i, static_cast<char>(values[i]));
+        }
+        return size;
+    }
+
+    unsigned long decodeContourShape(XMLScanner & scanner, unsigned char * record) {
+        XMLSpan globalCurvature, prototypeCurvature, highestPeakY;
+        bool hasGlobal = false, hasPrototype = false, hasHighestPeak = false;
+
+        const int peakCapacity = CONTOURSHAPE_CSSPEAKMASK - 1;
+        long peaks[peakCapacity][2];
+        int peakCount = 0;
+
+        // Last of repeated elements is used (as in readFromXML)
+        forEachChild(scanner, [&](const XMLSpan & name) {
+            if (name.equals("GlobalCurvature")) {
+                globalCurvature = scanner.readText();
+                hasGlobal = true;
+            }
+            else if (name.equals("PrototypeCurvature")) {
+                prototypeCurvature = scanner.readText();
+                hasPrototype = true;
+            }
+            else if (name.equals("HighestPeakY")) {
+                highestPeakY = scanner.readText();
+                hasHighestPeak = true;
+            }
+            else if (name.equals("Peak")) {
+                if (peakCount < peakCapacity) {
+                    peaks[peakCount][0] = intAttribute(scanner, "peakX");
+                    peaks[peakCount][1] = intAttribute(scanner, "peakY");
+                }
+                peakCount++;
+            }
+        });
+
+        if (!hasGlobal) {
+            throw CONT_SHAPE_XML_GLOBAL_CURVATURE_MISSING;
+        }
+
+        if (!hasHighestPeak) {
+            throw CONT_SHAPE_XML_HIGHEST_PEAK_MISSING;
+        }
+
+        long global[2];
+        long prototype[2] = { 0, 0 };
+
+        if (parseIntegers(globalCurvature, global, 2) != 2) {
+            throw CONT_SHAPE_XML_GLOBAL_CURVARURE_SIZE_ERROR;
+        }
+
+        if (hasPrototype && parseIntegers(prototypeCurvature, prototype, 2) < 2) {
+            throw CONT_SHAPE_XML_PROTOTYPE_CURVARURE_SIZE_ERROR;
+        }
+
+        const long highest = parseInteger(highestPeakY);
+
+        // Highest peak is peak 0, count is limited to CONTOURSHAPE_CSSPEAKMASK
+        int peaksStored = 0;
+
+        if (highest > 0) {
+            peaksStored = peakCount + 1 > CONTOURSHAPE_CSSPEAKMASK ? CONTOURSHAPE_CSSPEAKMASK : peakCount + 1;
+        }
+
+        DescriptorBinary::writeUInt8(record, peaksStored);
+        DescriptorBinary::writeUInt16(record + 1, global[0]);
+        DescriptorBinary::writeUInt16(record + 3, global[1]);
+        DescriptorBinary::writeUInt16(record + 5, prototype[0]);
+        DescriptorBinary::writeUInt16(record + 7, prototype[1]);
+        DescriptorBinary::writeUInt16(record + 9, highest);
+
+        for (int i = 1; i < peaksStored; i++) {
+            DescriptorBinary::writeUInt16(record + 11 + 4 * (i - 1), peaks[i - 1][0]);
+            DescriptorBinary::writeUInt16(record + 13 + 4 * (i - 1), peaks[i - 1][1]);
+        }
+        return 11 + (peaksStored > 0 ? 4 * (peaksStored - 1) : 0);
+    }
+
+    bool isDocumentStart(const char * data, const size_t size, const size_t offset) {
+        return offset + 6 < size && memcmp(data + offset, "<Mpeg7", 6) == 0 &&
+               (isSpace(data[offset + 6]) || data[offset + 6] == '>' || data[offset + 6] == '/');
+    }
+
+    /* Offset of first <Mpeg7> element at or after offset, size when there is none */
+    size_t findDocument(const char * data, const size_t size, size_t offset) {
+        while (offset < size) {
+            const char * c = static_cast<const char *>(memchr(data + offset, '<', size - offset));
+
+            if (c == nullptr) {
+                return size;
+            }
+
+            offset = c - data;
+
+            if (isDocumentStart(data, size, offset)) {
+                return offset;
+            }
+            offset++;
+        }
+        return size;
+    }
+}
+
+DescriptorXMLStream::DescriptorXMLStream(const char * data, const size_t size, const size_t begin, const size_t limit)
+    : scanner(data, size), data(data), size(size), limit(limit), documentOffset(0), documentHasDescriptor(false) {
+
+    if (begin > 0) {
+        documentOffset = findDocument(data, size, begin);
+        scanner.reset(documentOffset);
+    }
+}
+
+void DescriptorXMLStream::resync() {
+    // Failure before start of document was read (e.g. broken <Mpeg7> tag) belongs to document starting there
+    const size_t failure = scanner.getOffset();
+
+    if (scanner.getDepth() == 0 || failure < documentOffset) {
+        documentOffset = failure;
+    }
+    scanner.reset(findDocument(data, size, failure + 1));
+}
+
+long DescriptorXMLStream::next(unsigned char * record, DescriptorType & type) {
+    type = NONE;
+
+    try {
+        for (;;) {
+            const XMLToken token = scanner.next();
+
+            if (token == XML_END) {
+                return -1;
+            }
+
+            const int depth = scanner.getDepth();
+
+            if (token == XML_ELEMENT_END && depth == 0 && !documentHasDescriptor) {
+                throw DESCRIPTOR_NODE_NOT_FOUND;
+            }
+
+            if (token != XML_ELEMENT_START) {
+                continue;
+            }
+
+            if (depth == 1) {
+                documentOffset = scanner.getOffset();
+
+                if (documentOffset >= limit) {
+                    return -1;
+                }
+
+                documentHasDescriptor = false;
+
+                if (!scanner.name().equals("Mpeg7")) {
+                    throw MPEG7_NODE_NOT_FOUND;
+                }
+            }
+            else if (depth == 2 && scanner.name().equals("DescriptionUnit")) {
+                continue;
+            }
+            else if (depth == 3 && scanner.name().equals("Descriptor")) {
+                documentHasDescriptor = true;
+
+                XMLSpan typeName;
+
+                if (!scanner.attribute("xsi:type", typeName)) {
+                    throw TYPE_ATTRIBUTE_NOT_FOUND;
+                }
+
+                char name[64];
+
+                if (typeName.length >= sizeof(name)) {
+                    throw XML_TYPE_NOT_RECOGNIZED;
+                }
+
+                memcpy(name, typeName.data, typeName.length);
+                name[typeName.length] = '\0';
+
+                type = detectType(name);
+
+                if (type == NONE) {
+                    throw XML_TYPE_NOT_RECOGNIZED;
+                }
+                return static_cast<long>(decode(scanner, type, record));
+            }
+            else {
+                scanner.skipElement();
+            }
+        }
+    }
+    catch (ErrorCode exception) {
+        documentHasDescriptor = true; // error is reported once per document
+
+        // Document without descriptor is complete, other errors leave the scanner inside of malformed document
+        if (exception != DESCRIPTOR_NODE_NOT_FOUND) {
+            resync();
+        }
+        throw;
+    }
+}
+
+unsigned long long DescriptorXMLStream::getDocumentOffset() const {
+    return documentOffset;
+}
+
+unsigned long DescriptorXMLStream::decode(XMLScanner & scanner, const DescriptorType type, unsigned char * record) {
+    switch (type) {
+        case DOMINANT_COLOR_D:      return decodeDominantColor(scanner, record);
+        case SCALABLE_COLOR_D:      return decodeScalableColor(scanner, record);
+        case COLOR_LAYOUT_D:        return decodeColorLayout(scanner, record);
+        case COLOR_STRUCTURE_D:     return decodeColorStructure(scanner, record);
+        case CT_BROWSING_D:         return decodeCTBrowsing(scanner, record);
+        case HOMOGENEOUS_TEXTURE_D: return decodeHomogeneousTexture(scanner, record);
+        case TEXTURE_BROWSING_D:    return decodeTextureBrowsing(scanner, record);
+        case EDGE_HISTOGRAM_D:
+            return decodeCharValues(scanner, record, "BinCounts", 80, EDGE_HIST_XML_BINCOUNTS_MISSING, EDGE_HIST_BIN_COUNTS_SIZE_ERROR);
+        case REGION_SHAPE_D:
+            return decodeCharValues(scanner, record, "MagnitudeOfART", ART_ANGULAR * ART_RADIAL - 1,
+                                    REG_SHAPE_MAGNITUDE_ART_MISSING, REG_SHAPE_COEFF_COUNT_ERROR);
+        case CONTOUR_SHAPE_D:       return decodeContourShape(scanner, record);
+        default:
+            throw XML_TYPE_NOT_RECOGNIZED;
+    }
+}
+
+void DescriptorXMLStream::forEach(const char * data, const size_t size, const int threads,
+                                  const std::function<void(const DescriptorXMLRecord & record)> & callback) {
+    struct ChunkResult {
+        std::vector<DescriptorXMLRecord> records;
+        std::vector<size_t> recordOffsets;
+        std::vector<unsigned char> bytes;
+    };
+
+    const size_t chunks = size == 0 ? 0 : (size + DESCRIPTOR_XML_CHUNK_SIZE - 1) / DESCRIPTOR_XML_CHUNK_SIZE;
+    const size_t round = static_cast<size_t>(Parallel::resolveThreads(threads)) * DESCRIPTOR_XML_CHUNKS_PER_ROUND;
+
+    // Chunks are decoded a round at a time, so only records of one round are held in memory
+    for (size_t first = 0; first < chunks; first += round) {
+        const size_t count = chunks - first < round ? chunks - first : round;
+        std::vector<ChunkResult> results(count);
+
+        Parallel::forEach(static_cast<unsigned long>(count), threads, [&](const unsigned long index, int) {
+            const size_t chunk = first + index;
+            const size_t chunkEnd = (chunk + 1) * DESCRIPTOR_XML_CHUNK_SIZE;
+
+            DescriptorXMLStream stream(data, size, chunk * DESCRIPTOR_XML_CHUNK_SIZE, chunkEnd);
+            ChunkResult & result = results[index];
+            unsigned char record[DESCRIPTOR_BINARY_MAX_SIZE];
+
+            for (;;) {
+                DescriptorXMLRecord decoded;
+                long recordSize;
+
+                try {
+                    recordSize = stream.next(record, decoded.type);
+
+                    if (recordSize < 0) {
+                        break;
+                    }
+                }
+                catch (ErrorCode exception) {
+                    recordSize = -static_cast<long>(exception);
+                }
+
+                decoded.result = static_cast<int>(recordSize);
+                decoded.offset = stream.getDocumentOffset();
+                decoded.record = nullptr;
+
+                // Stream continues after error with next document, which may lie in next chunk
+                if (decoded.offset >= chunkEnd) {
+                    break;
+                }
+
+                result.recordOffsets.push_back(result.bytes.size());
+
+                if (recordSize > 0) {
+                    result.bytes.insert(result.bytes.end(), record, record + recordSize);
+                }
+                result.records.push_back(decoded);
+            }
+        });
+
+        for (ChunkResult & result : results) {
+            for (size_t i = 0; i < result.records.size(); i++) {
+                DescriptorXMLRecord & decoded = result.records[i];
+                decoded.record = decoded.result > 0 ? result.bytes.data() + result.recordOffsets[i] : nullptr;
+                callback(decoded);
+            }
+        }
+    }
+}
@@ -0,0 +1,78 @@
+/** @file   DescriptorXMLStream.h
+ *  @brief  Streaming import of descriptors from XML archives (concatenated documents
+ *          produced by Descriptor::generateXML) without building a DOM.
+ *
+ *          Input is scanned with XMLScanner and payloads of every Descriptor element
+ *          (BinCounts, Coefficients, Values...) are decoded straight into the binary record
+ *          (see DescriptorBinary.h), which can be stored as is (DescriptorStoreWriter::addRecord)
+ *          or read into descriptor object (Descriptor::readFromBinary). Records are equal to those
+ *          written by Descriptor::writeBinary after Descriptor::readFromXML of the same document,
+ *          missing or malformed payloads are reported with the same ErrorCode as readFromXML.
+ *
+ *          An error stops only the document containing it, scanning continues with next <Mpeg7> element.
+ *          Large inputs are split into chunks starting at document boundaries and decoded on
+ *          worker threads (forEach), records are still passed to callback in input order.
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include "../DESCRIPTORS/DescriptorBinary.h"
+#include "../DESCRIPTORS/DescriptorType.h"
+#include "../TOOLS/XML/XMLScanner.h"
+
+#include <functional>
+
+#define DESCRIPTOR_XML_CHUNK_SIZE       (4 * 1024 * 1024) // bytes of input decoded by one task
+#define DESCRIPTOR_XML_CHUNKS_PER_ROUND 4                 // chunks per worker held in memory at once
+
+/** Descriptor decoded from XML stream */
+struct DescriptorXMLRecord {
+    DescriptorType type;
+    int result;                    // record size or negative ErrorCode
+    unsigned long long offset;     // offset of its <Mpeg7> document in input
+    const unsigned char * record;  // binary record, valid during callback only
+};
+
+class DescriptorXMLStream {
+    private:
+        XMLScanner scanner;
+        const char * data;
+        size_t size;
+        size_t limit;
+        unsigned long long documentOffset;
+        bool documentHasDescriptor;
+
+        void resync();
+
+    public:
+        /** @brief
+        * Stream over documents starting in [begin, limit) of input (document started before limit
+        * is read to its end), begin is moved forward to first <Mpeg7> element */
+        DescriptorXMLStream(const char * data, size_t size, size_t begin = 0, size_t limit = static_cast<size_t>(-1));
+
+        /** @brief
+        * Decodes next descriptor, throws ErrorCode for malformed document (next call continues with following document)
+        * @param record - output buffer of DESCRIPTOR_BINARY_MAX_SIZE bytes
+        * @param type - output, descriptor type
+        * @return long - record size, -1 at end of stream */
+        long next(unsigned char * record, DescriptorType & type);
+
+        /** @brief
+        * Offset of document containing last decoded (or failed) descriptor */
+        unsigned long long getDocumentOffset() const;
+
+        /** @brief
+        * Decodes Descriptor element, scanner has just reported its start
+        * @param record - output buffer of DESCRIPTOR_BINARY_MAX_SIZE bytes
+        * @return unsigned long - record size */
+        static unsigned long decode(XMLScanner & scanner, DescriptorType type, unsigned char * record);
+
+        /** @brief
+        * Decodes all descriptors of input on worker threads
+        * @param threads - worker threads, 0 or less means all hardware threads
+        * @param callback - called for every descriptor (and failed document) in input order, from calling thread */
+        static void forEach(const char * data, size_t size, int threads,
+                            const std::function<void(const DescriptorXMLRecord & record)> & callback);
+};
@@ -0,0 +1,118 @@
+#include "MappedFile.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : mapping(nullptr), mappingSize(0), opened(false) {
+#if defined(_WIN32) || defined(_WIN64)
+    fileHandle    = INVALID_HANDLE_VALUE;
+    mappingHandle = nullptr;
+#endif
+}
+
+void MappedFile::open(const char * path) {
+    close();
+
+#if defined(_WIN32) || defined(_WIN64)
+    fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        throw STORE_CANNOT_OPEN_FILE;
+    }
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(fileHandle, &size)) {
+        close();
+        throw STORE_CANNOT_OPEN_FILE;
+    }
+
+    if (size.QuadPart > 0) {
+        mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (mappingHandle != nullptr) {
+            mapping = static_cast<const unsigned char *>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        }
+
+        if (mapping == nullptr) {
+            close();
+            throw STORE_CANNOT_OPEN_FILE;
+        }
+    }
+    mappingSize = static_cast<unsigned long long>(size.QuadPart);
+#else
+    const int descriptor = ::open(path, O_RDONLY);
+
+    if (descriptor < 0) {
+        throw STORE_CANNOT_OPEN_FILE;
+    }
+
+    struct stat status;
+
+    if (fstat(descriptor, &status) != 0) {
+        ::close(descriptor);
+        throw STORE_CANNOT_OPEN_FILE;
+    }
+
+    if (status.st_size > 0) {
+        void * view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, descriptor, 0);
+
+        if (view == MAP_FAILED) {
+            ::close(descriptor);
+            throw STORE_CANNOT_OPEN_FILE;
+        }
+        mapping = static_cast<const unsigned char *>(view);
+    }
+    ::close(descriptor); // mapping stays valid
+
+    mappingSize = static_cast<unsigned long long>(status.st_size);
+#endif
+
+    opened = true;
+}
+
+void MappedFile::close() {
+#if defined(_WIN32) || defined(_WIN64)
+    if (mapping != nullptr) {
+        UnmapViewOfFile(mapping);
+    }
+    if (mappingHandle != nullptr) {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+    if (fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(fileHandle);
+        fileHandle = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (mapping != nullptr) {
+        munmap(const_cast<unsigned char *>(mapping), static_cast<size_t>(mappingSize));
+    }
+#endif
+
+    mapping     = nullptr;
+    mappingSize = 0;
+    opened      = false;
+}
+
+bool MappedFile::isOpen() const {
+    return opened;
+}
+
+const unsigned char * MappedFile::data() const {
+    return mapping;
+}
+
+unsigned long long MappedFile::size() const {
+    return mappingSize;
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
@@ -0,0 +1,41 @@
+/** @file   MappedFile.h
+ *  @brief  Read-only memory mapping of a whole file (POSIX mmap, Windows file mapping).
+ *
+ *          Pages are loaded on first access and shared through the page cache,
+ *          so large stores and XML archives are read without copying them into the heap.
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include "../TOOLS/ErrorCode.h"
+
+class MappedFile {
+    private:
+        const unsigned char * mapping;
+        unsigned long long mappingSize;
+        bool opened;
+
+#if defined(_WIN32) || defined(_WIN64)
+        void * fileHandle;
+        void * mappingHandle;
+#endif
+
+    public:
+        MappedFile();
+        MappedFile(const MappedFile &) = delete;
+        MappedFile & operator=(const MappedFile &) = delete;
+
+        /** @brief
+        * Maps file read-only, throws STORE_CANNOT_OPEN_FILE, when file cannot be opened or mapped
+        * (empty file is opened with data() == nullptr) */
+        void open(const char * path);
+        void close();
+        bool isOpen() const;
+
+        const unsigned char * data() const;
+        unsigned long long size() const;
+
+        ~MappedFile();
+};
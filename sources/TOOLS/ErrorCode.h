@@ -129,4 +129,60 @@ enum ErrorCode {
     // Edge Histogram
     EDGE_HIST_BIN_COUNTS_SIZE_ERROR = 105, //!< BinCounts size in XML
     EDGE_HIST_XML_BINCOUNTS_MISSING = 106, //!< <BinCounts> element missing from XML
+
+    // Binary descriptor data
+    BINARY_BUFFER_NULL      = 107, //!< Binary data pointer is NULL
+    BINARY_SIZE_ERROR       = 108, //!< Binary data size does not match descriptor record
+    BINARY_VALUE_ERROR      = 109, //!< Descriptor value does not fit or is out of range of its binary field
+    BINARY_HEADER_ERROR     = 110, //!< Binary packet header not recognized
+    BINARY_BUFFER_TOO_SMALL = 111, //!< Output buffer is too small for binary descriptor
+
+    // Tracing
+    TRACE_NOT_AVAILABLE = 112, //!< Library was built without MPEG7_TRACE
+
+    // Image too small for extraction
+    COL_STRUCT_IMAGE_TOO_SMALL = 113, //!< Image is smaller than Color Structure structuring element (8 x 8 pix for images up to 256 x 256 pix)
+    TEXT_BROWS_IMAGE_TOO_SMALL = 114, //!< Analyzed image is smaller than Texture Browsing filter border (XM_SIDE x XM_SIDE pix)
+
+    // Descriptor store
+    STORE_CANNOT_OPEN_FILE   = 115, //!< Store file cannot be opened, created or mapped
+    STORE_HEADER_ERROR       = 116, //!< Store header not recognized or its sections lie outside of file
+    STORE_TYPE_ERROR         = 117, //!< Descriptor type differs from type of store
+    STORE_RECORD_SIZE_ERROR  = 118, //!< Record size differs from fixed record size of store
+    STORE_INDEX_OUT_OF_RANGE = 119, //!< Record index is not lower than record count
+    STORE_WRITE_ERROR        = 120, //!< Store file could not be written
+
+    // Caller output buffers
+    RESULT_BUFFER_NULL      = 121, //!< Output buffer is NULL, while its capacity is not 0
+    RESULT_BUFFER_TOO_SMALL = 122, //!< Result does not fit into output buffer (required size is returned in 'needed')
+
+    // Extraction contexts
+    CONTEXT_NULL = 123, //!< Extraction context pointer is NULL
+
+    // Segmentation masks
+    MASK_DATA_NULL                = 124, //!< RLE counts or polygon vertices pointer is NULL
+    MASK_NOT_VALID                = 125, //!< Mask size, RLE counts or polygon vertices are not valid
+    MASK_DESCRIPTOR_NOT_SUPPORTED = 126, //!< Descriptor is not extracted from masks (only Region Shape and Contour Shape are)
+
+    // Tiled extraction
+    TILE_SOURCE_NOT_VALID         = 127, //!< Tile reader is NULL, source size is not positive or region lies outside of source
+    TILE_READ_FAILED              = 128, //!< Tile source could not read region
+    TILE_DESCRIPTOR_NOT_SUPPORTED = 129, //!< Descriptor is not extracted from tiles (only Scalable Color, Color Structure, Edge Histogram and CT Browsing are)
+
+    // Descriptor grids
+    GRID_NOT_VALID                = 130, //!< Grid has no cells or more cells than pixels, region lies outside of prepared image
+    GRID_DESCRIPTOR_NOT_SUPPORTED = 131, //!< Descriptor is not extracted on grid (only Edge Histogram, Color Layout, Scalable Color and Homogeneous Texture are)
+
+    // Raw pixels and frame streams
+    PIXELS_NOT_VALID           = 132, //!< Pixel pointer is NULL, size is not positive or stride is shorter than row
+    PIXEL_FORMAT_NOT_SUPPORTED = 133, //!< Pixel format is not one of PixelFormat values
+    SESSION_NULL               = 134, //!< Stream session pointer is NULL
+
+    // Groups of frames
+    GROUP_NULL                      = 135, //!< Frame group pointer is NULL
+    GROUP_EMPTY                     = 136, //!< Descriptor of group is requested before any frame was added
+    GROUP_AGGREGATION_NOT_SUPPORTED = 137, //!< Aggregation is not one of GroupAggregation values
+
+    // Image decoders
+    DECODE_SCALE_NOT_SUPPORTED = 138, //!< Decode scale is not 1, 2, 4 or 8
 };
@@ -1,14 +1,23 @@
 #include "Image.h"
 #include "../ErrorCode.h"
+#include "../Trace/Trace.h"
+
+#include "ImageDecoder.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 
-#define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
 Image::Image() : imageData(nullptr), imageWidth(0), imageHeight(0), imageSize(0), totalImageSize(0), channels(0), depth(0) {
 }
 
 void Image::load(unsigned char* data, const int size, const LoadMode decode_mode) {
-    std::cout << "Loading image of size: " << size << std::endl;
+    TRACE_SCOPE("Image::load");
 
     int desiredChannels = 0; // 0 means keep original format
 
@@ -28,18 +37,24 @@ void Image::load(unsigned char* data, const int size, const LoadMode decode_mode
     }
 
     // Free previous image if any
-    if (imageData != nullptr) {
-        stbi_image_free(imageData);
-        imageData = nullptr;
+    ReleaseData();
+
+    // Decode image from memory, by decoder set with setDecoder or by first one supporting its format
+    ImageDecoder & selected = decoder != nullptr ? *decoder : ImageDecoders::select(data, size);
+    ImageDecoder * used = &selected;
+
+    int width, height;
+    imageData = selected.decode(data, size, desiredChannels, decodeScale, &width, &height, &channels);
+
+    // Variants of format not supported by selected decoder (e.g. CMYK JPEG) are left to stb_image
+    if (imageData == nullptr && decoder == nullptr && used != &ImageDecoders::fallback()) {
+        used = &ImageDecoders::fallback();
+        imageData = used->decode(data, size, desiredChannels, decodeScale, &width, &height, &channels);
     }
 
-    // Load image from memory
-    int width, height, channels_in_file;
-    imageData = stbi_load_from_memory(data, size, &width, &height, &channels_in_file, desiredChannels);
-    
     // Check if image was loaded properly
     if (imageData == nullptr) {
-        std::cout << "Failed to load image: " << stbi_failure_reason() << std::endl;
+        std::cout << "Failed to load image: " << used->getFailureReason() << std::endl;
         throw CANNOT_OPEN_IMAGE;
     }
 
@@ -47,10 +62,7 @@ void Image::load(unsigned char* data, const int size, const LoadMode decode_mode
     imageWidth = width;
     imageHeight = height;
     imageSize = imageWidth * imageHeight;
-    
-    // If we specified channels, use that value, otherwise use what was in the file
-    channels = (desiredChannels != 0) ? desiredChannels : channels_in_file;
-    
+
     // Set transparency and total size based on channels
     if (channels == 4) { // RGBA
         transparencyPresent = true;
@@ -74,79 +86,341 @@ void Image::load(unsigned char* data, const int size, const LoadMode decode_mode
         throw IMAGE_CHANNELS_NOT_SUPPORTED;
     }
 
-    depth = 8; // stb_image always returns 8-bit channels
+    depth = 8; // decoders always return 8-bit channels
+
+    SetLayout(static_cast<PixelFormat>(channels), imageData, imageWidth * channels, nullptr, nullptr, 0);
 }
 
 void Image::load(const char* filename, const LoadMode load_mode) {
-    int desiredChannels = 0; // 0 means keep original format
-    
-    switch (load_mode) {
-        // Load image as it is
-        case IMAGE_UNCHANGED:
-            desiredChannels = 0; // Keep original format
-            break;
-        case IMAGE_COLOR:
-            desiredChannels = 3; // Force 3 channels (RGB)
+    TRACE_SCOPE("Image::load");
+
+    // File is read whole and decoded from memory by the same decoders
+    std::ifstream file(filename, std::ios::binary);
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (!file.is_open() || data.size() > INT_MAX) {
+        std::cout << "Failed to load image: " << (file.is_open() ? "too large" : "can't fopen") << std::endl;
+        throw CANNOT_OPEN_IMAGE;
+    }
+
+    load(data.data(), static_cast<int>(data.size()), load_mode);
+}
+
+void Image::setDecoder(ImageDecoder * imageDecoder) {
+    decoder = imageDecoder;
+}
+
+void Image::setDecodeScale(const int scale) {
+    if (scale != 1 && scale != 2 && scale != 4 && scale != 8) {
+        throw DECODE_SCALE_NOT_SUPPORTED;
+    }
+    decodeScale = scale;
+}
+
+void Image::load(const unsigned char * pixels, const int width, const int height, const int stride, const PixelFormat format) {
+    TRACE_SCOPE("Image::load");
+
+    // Pixels are validated and read through view of them, YUV formats are converted to RGB
+    const bool yuv   = format == PIXEL_NV12 || format == PIXEL_NV21 || format == PIXEL_I420;
+    const int  size  = width * height * (yuv ? 3 : pixelSize(format));
+    unsigned char * buffer = nullptr;
+
+    // Frames of stream have the same size, their buffer is allocated once (freed by stbi_image_free like decoded images)
+    if (!isView && imageData != nullptr && totalImageSize == size) {
+        buffer = imageData;
+        imageData = nullptr;
+    }
+
+    try {
+        view(pixels, width, height, stride, format);
+    }
+    catch (ErrorCode exception) {
+        // Previous image is kept
+        imageData = buffer;
+        throw;
+    }
+
+    if (buffer == nullptr) {
+        buffer = static_cast<unsigned char *>(malloc(size));
+
+        if (buffer == nullptr) {
+            throw CANNOT_OPEN_IMAGE;
+        }
+    }
+
+    const int pixelChannels = size / (width * height);
+    const size_t rowSize = static_cast<size_t>(width) * pixelChannels;
+
+    for (int y = 0; y < height; y++) {
+        const unsigned char * source = pixels + static_cast<size_t>(y) * stride;
+        unsigned char * row = buffer + y * rowSize;
+
+        if (yuv) {
+            getRow(y, 0, width, row, nullptr);
+        }
+        else if (format == PIXEL_BGR || format == PIXEL_BGRA) {
+            for (size_t i = 0; i < rowSize; i += pixelChannels) {
+                row[i]     = source[i + 2];
+                row[i + 1] = source[i + 1];
+                row[i + 2] = source[i];
+
+                if (pixelChannels == 4) {
+                    row[i + 3] = source[i + 3];
+                }
+            }
+        }
+        else {
+            memcpy(row, source, rowSize);
+        }
+    }
+
+    isView    = false;
+    imageData = buffer;
+    SetLayout(static_cast<PixelFormat>(channels), imageData, width * channels, nullptr, nullptr, 0);
+}
+
+void Image::view(const unsigned char * pixels, const int width, const int height, const int stride, const PixelFormat format) {
+    const int pixelChannels = pixelSize(format);
+
+    if (pixels == nullptr || width <= 0 || height <= 0 || static_cast<long long>(width) * height > INT_MAX / 4 ||
+        stride < width * pixelChannels) {
+        throw PIXELS_NOT_VALID;
+    }
+
+    // Chroma planes of YUV formats follow Y plane (rows of I420 chroma are half as long)
+    const unsigned char * chroma = pixels + static_cast<size_t>(stride) * height;
+
+    switch (format) {
+        case PIXEL_NV12:
+        case PIXEL_NV21:
+            view(width, height, format, pixels, stride, chroma, nullptr, stride);
             break;
-        case IMAGE_GRAYSCALE:
-            desiredChannels = 1; // Force 1 channel (Grayscale)
+        case PIXEL_I420:
+            view(width, height, format, pixels, stride, chroma, chroma + static_cast<size_t>((stride + 1) / 2) * ((height + 1) / 2), (stride + 1) / 2);
             break;
         default:
-            desiredChannels = 0; // Keep original format
+            ReleaseData();
+            isView = true;
+            SetLayout(format, pixels, stride, nullptr, nullptr, 0);
+
+            imageWidth  = width;
+            imageHeight = height;
+            imageSize   = width * height;
+
+            // Channels of image loaded from the same pixels
+            channels            = format == PIXEL_BGR ? 3 : format == PIXEL_BGRA ? 4 : static_cast<int>(format);
+            totalImageSize      = imageSize * channels;
+            transparencyPresent = channels == 2 || channels == 4;
+            depth = 8;
             break;
     }
+}
 
-    // Free previous image if any
-    if (imageData != nullptr) {
-        stbi_image_free(imageData);
-        imageData = nullptr;
+void Image::view(const int width, const int height, const PixelFormat format, const unsigned char * y, const int yStride,
+                 const unsigned char * u, const unsigned char * v, const int uvStride) {
+    if (format != PIXEL_NV12 && format != PIXEL_NV21 && format != PIXEL_I420) {
+        throw PIXEL_FORMAT_NOT_SUPPORTED;
     }
 
-    // Load image from file
-    int width, height, channels_in_file;
-    imageData = stbi_load(filename, &width, &height, &channels_in_file, desiredChannels);
-    
-    // Check if image was loaded properly
-    if (imageData == nullptr) {
-        std::cout << "Failed to load image: " << stbi_failure_reason() << std::endl;
-        throw CANNOT_OPEN_IMAGE;
+    const int chromaWidth = (width + 1) / 2;
+
+    if (y == nullptr || u == nullptr || (format == PIXEL_I420 && v == nullptr) || width <= 0 || height <= 0 ||
+        static_cast<long long>(width) * height > INT_MAX / 4 || yStride < width ||
+        uvStride < (format == PIXEL_I420 ? chromaWidth : 2 * chromaWidth)) {
+        throw PIXELS_NOT_VALID;
     }
 
-    // Save image information
-    imageWidth = width;
+    ReleaseData();
+    isView = true;
+    SetLayout(format, y, yStride, u, v, uvStride);
+
+    imageWidth  = width;
     imageHeight = height;
-    imageSize = imageWidth * imageHeight;
-    
-    // If we specified channels, use that value, otherwise use what was in the file
-    channels = (desiredChannels != 0) ? desiredChannels : channels_in_file;
-    
-    // Set transparency and total size based on channels
-    if (channels == 4) { // RGBA
-        transparencyPresent = true;
-        totalImageSize = 4 * imageSize;
+    imageSize   = width * height;
+
+    channels            = 3;
+    totalImageSize      = imageSize * 3;
+    transparencyPresent = false;
+    depth = 8;
+}
+
+void Image::SetLayout(const PixelFormat format, const unsigned char * y, const int yStride, const unsigned char * u,
+                      const unsigned char * v, const int uvStride) {
+    layout     = format;
+    planes[0]  = y;
+    planes[1]  = u;
+    planes[2]  = v;
+    strides[0] = yStride;
+    strides[1] = uvStride;
+    strides[2] = uvStride;
+
+    maxAlpha = -1;
+    minAlpha = -1;
+}
+
+void Image::ReleaseData() {
+    if (imageData != nullptr) {
+        stbi_image_free(imageData);
+        imageData = nullptr;
     }
-    else if (channels == 3) { // RGB
-        transparencyPresent = false;
-        totalImageSize = 3 * imageSize;
+
+    isView = false;
+    SetLayout(PIXEL_RGB, nullptr, 0, nullptr, nullptr, 0);
+}
+
+bool Image::getLumaPresent() {
+    return isView && (layout == PIXEL_NV12 || layout == PIXEL_NV21 || layout == PIXEL_I420);
+}
+
+bool Image::getRow(const int y, const int x, const int width, unsigned char * rgb, unsigned char * alpha) {
+    if (planes[0] == nullptr) {
+        return false;
+    }
+
+    const unsigned char * row = planes[0] + static_cast<size_t>(y) * strides[0];
+
+    switch (layout) {
+        case PIXEL_GRAY:
+        case PIXEL_GRAY_ALPHA:
+        case PIXEL_RGB:
+        case PIXEL_RGBA:
+        case PIXEL_BGR:
+        case PIXEL_BGRA: {
+            const int size   = pixelSize(layout);
+            const bool bgr   = layout == PIXEL_BGR || layout == PIXEL_BGRA;
+            const bool color = size >= 3;
+            const unsigned char * pixel = row + static_cast<size_t>(x) * size;
+
+            for (int i = 0; i < width; i++, pixel += size) {
+                // Gray value goes to all of R, G and B (as in getRGB)
+                if (rgb != nullptr) {
+                    rgb[i * 3]     = color && bgr ? pixel[2] : pixel[0];
+                    rgb[i * 3 + 1] = color ? pixel[1] : pixel[0];
+                    rgb[i * 3 + 2] = color && !bgr ? pixel[2] : pixel[0];
+                }
+
+                if (alpha != nullptr) {
+                    alpha[i] = size == 4 ? pixel[3] : size == 2 ? pixel[1] : 255;
+                }
+            }
+            break;
+        }
+        default: {
+            // YUV 4:2:0 - BT.601 limited range to RGB in 8-bit fixed point
+            const unsigned char * chroma = planes[1] + static_cast<size_t>(y / 2) * strides[1];
+            const unsigned char * chromaV = layout == PIXEL_I420 ? planes[2] + static_cast<size_t>(y / 2) * strides[2] : nullptr;
+
+            for (int i = 0; i < width; i++) {
+                const int column = (x + i) / 2;
+                int u, v;
+
+                if (layout == PIXEL_I420) {
+                    u = chroma[column];
+                    v = chromaV[column];
+                }
+                else {
+                    u = chroma[column * 2 + (layout == PIXEL_NV21 ? 1 : 0)];
+                    v = chroma[column * 2 + (layout == PIXEL_NV21 ? 0 : 1)];
+                }
+
+                const int c = 298 * (row[x + i] - 16);
+                const int d = u - 128;
+                const int e = v - 128;
+
+                if (rgb != nullptr) {
+                    rgb[i * 3]     = static_cast<unsigned char>(std::min(255, std::max(0, (c + 409 * e + 128) >> 8)));
+                    rgb[i * 3 + 1] = static_cast<unsigned char>(std::min(255, std::max(0, (c - 100 * d - 208 * e + 128) >> 8)));
+                    rgb[i * 3 + 2] = static_cast<unsigned char>(std::min(255, std::max(0, (c + 516 * d + 128) >> 8)));
+                }
+
+                if (alpha != nullptr) {
+                    alpha[i] = 255;
+                }
+            }
+            break;
+        }
     }
-    else if (channels == 2) { // GrayAlpha
-        transparencyPresent = true;
-        totalImageSize = 2 * imageSize;
+    return true;
+}
+
+unsigned char * Image::ViewChannel(const int channel) {
+    auto values = new unsigned char[imageSize];
+    std::vector<unsigned char> rgb(static_cast<size_t>(imageWidth) * 3);
+    std::vector<unsigned char> alpha(static_cast<size_t>(imageWidth));
+
+    for (int y = 0; y < imageHeight; y++) {
+        getRow(y, 0, imageWidth, rgb.data(), alpha.data());
+
+        unsigned char * row = values + static_cast<size_t>(y) * imageWidth;
+
+        for (int x = 0; x < imageWidth; x++) {
+            row[x] = channel == 3 ? alpha[x] : rgb[x * 3 + channel];
+        }
     }
-    else if (channels == 1) { // Gray
-        transparencyPresent = false;
-        totalImageSize = imageSize;
+    return values;
+}
+
+unsigned char * Image::ViewGray(const GrayscaleMode mode) {
+    auto gray = new unsigned char[imageSize];
+
+    // Y plane of YUV formats, scaled from limited range like R, G and B
+    if (getLumaPresent()) {
+        for (int y = 0; y < imageHeight; y++) {
+            const unsigned char * row = planes[0] + static_cast<size_t>(y) * strides[0];
+
+            for (int x = 0; x < imageWidth; x++) {
+                gray[static_cast<size_t>(y) * imageWidth + x] = static_cast<unsigned char>(std::min(255, std::max(0, (298 * (row[x] - 16) + 128) >> 8)));
+            }
+        }
+        return gray;
     }
-    else {
-        stbi_image_free(imageData);
-        imageData = nullptr;
-        throw IMAGE_CHANNELS_NOT_SUPPORTED;
+
+    std::vector<unsigned char> rgb(static_cast<size_t>(imageWidth) * 3);
+
+    for (int y = 0; y < imageHeight; y++) {
+        getRow(y, 0, imageWidth, rgb.data(), nullptr);
+
+        for (int x = 0; x < imageWidth; x++) {
+            const unsigned char r = rgb[x * 3];
+            const unsigned char g = rgb[x * 3 + 1];
+            const unsigned char b = rgb[x * 3 + 2];
+
+            // Gray formats keep their gray values, colors are converted like in getGray of decoded image
+            if (channels <= 2) {
+                gray[static_cast<size_t>(y) * imageWidth + x] = r;
+            }
+            else if (mode == GRAYSCALE_LUMINOSITY) {
+                gray[static_cast<size_t>(y) * imageWidth + x] = static_cast<unsigned char>(0.299 * r + 0.587 * g + 0.114 * b);
+            }
+            else {
+                gray[static_cast<size_t>(y) * imageWidth + x] = static_cast<unsigned char>((r + g + b) / 3);
+            }
+        }
     }
+    return gray;
+}
 
-    depth = 8; // stb_image always returns 8-bit channels
+int Image::pixelSize(const PixelFormat format) {
+    switch (format) {
+        case PIXEL_GRAY:       return 1;
+        case PIXEL_GRAY_ALPHA: return 2;
+        case PIXEL_RGB:        return 3;
+        case PIXEL_RGBA:       return 4;
+        case PIXEL_BGR:        return 3;
+        case PIXEL_BGRA:       return 4;
+        case PIXEL_NV12:       return 1;
+        case PIXEL_NV21:       return 1;
+        case PIXEL_I420:       return 1;
+        default:
+            throw PIXEL_FORMAT_NOT_SUPPORTED;
+    }
 }
 
 unsigned char * Image::getChannel_R() {
+    if (isView) {
+        return ViewChannel(0);
+    }
+
     // Image size is pixel count in an image (width * height)
     const auto rChannel = new unsigned char[imageSize];
     
@@ -183,6 +457,11 @@ unsigned char * Image::getChannel_R() {
 }
 
 unsigned char * Image::getChannel_G() {
+    // Views of gray + alpha give alpha like decoded gray + alpha image
+    if (isView) {
+        return ViewChannel(layout == PIXEL_GRAY_ALPHA ? 3 : 1);
+    }
+
     const auto gChannel = new unsigned char[imageSize];
 
     if (!imageData) {
@@ -218,6 +497,10 @@ unsigned char * Image::getChannel_G() {
 }
 
 unsigned char * Image::getChannel_B() {
+    if (isView) {
+        return ViewChannel(2);
+    }
+
     const auto bChannel = new unsigned char[imageSize];
 
     if (!imageData) {
@@ -253,6 +536,10 @@ unsigned char * Image::getChannel_B() {
 }
 
 unsigned char * Image::getChannel_A() {
+    if (isView) {
+        return transparencyPresent ? ViewChannel(3) : nullptr;
+    }
+
     unsigned char * aChannel = nullptr;
 
     if (!imageData) {
@@ -313,6 +600,10 @@ unsigned char * Image::getGray() {
 }
 
 unsigned char * Image::getGray(const GrayscaleMode mode) {
+    if (isView) {
+        return ViewGray(mode == GRAYSCALE_LUMINOSITY ? GRAYSCALE_LUMINOSITY : GRAYSCALE_AVERAGE);
+    }
+
     auto grayChannel = new unsigned char[imageSize];
     
     if (!imageData) {
@@ -382,6 +673,15 @@ unsigned char * Image::getGray(const GrayscaleMode mode) {
 }
 
 unsigned char * Image::getRGB() {
+    if (isView) {
+        auto rgb = new unsigned char[imageSize * 3];
+
+        for (int y = 0; y < imageHeight; y++) {
+            getRow(y, 0, imageWidth, rgb + static_cast<size_t>(y) * imageWidth * 3, nullptr);
+        }
+        return rgb;
+    }
+
     unsigned char * RGB = nullptr;
 
     if (!imageData) {
@@ -426,6 +726,26 @@ unsigned char * Image::getRGB() {
 }
 
 unsigned char * Image::getRGBA() {
+    if (isView) {
+        auto rgba = new unsigned char[imageSize * 4];
+        std::vector<unsigned char> rgb(static_cast<size_t>(imageWidth) * 3);
+        std::vector<unsigned char> alpha(static_cast<size_t>(imageWidth));
+
+        for (int y = 0; y < imageHeight; y++) {
+            getRow(y, 0, imageWidth, rgb.data(), alpha.data());
+
+            unsigned char * row = rgba + static_cast<size_t>(y) * imageWidth * 4;
+
+            for (int x = 0; x < imageWidth; x++) {
+                row[x * 4]     = rgb[x * 3];
+                row[x * 4 + 1] = rgb[x * 3 + 1];
+                row[x * 4 + 2] = rgb[x * 3 + 2];
+                row[x * 4 + 3] = alpha[x];
+            }
+        }
+        return rgba;
+    }
+
     unsigned char * RGBA = nullptr;
 
     if (!imageData) {
@@ -505,8 +825,5 @@ int Image::getChannels() {
 }
 
 Image::~Image() {
-    if (imageData != nullptr) {
-        stbi_image_free(imageData);
-        imageData = nullptr;
-    }
+    ReleaseData();
 }
\ No newline at end of file
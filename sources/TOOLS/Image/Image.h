@@ -17,6 +17,22 @@ enum GrayscaleMode {
     GRAYSCALE_AVERAGE    = 2
 };
 
+/** Layout of raw pixels passed to Image::load and Image::view, interleaved 8-bit channels or YUV 4:2:0 planes
+ *  (BT.601 limited range, chroma of 2 x 2 pixels, Y plane followed by chroma planes in single buffer) */
+enum PixelFormat {
+    PIXEL_GRAY       = 1,
+    PIXEL_GRAY_ALPHA = 2,
+    PIXEL_RGB        = 3,
+    PIXEL_RGBA       = 4,
+    PIXEL_BGR        = 5, // capture devices, OpenCV
+    PIXEL_BGRA       = 6,
+    PIXEL_NV12       = 7, // Y plane, interleaved UV plane (hardware video decoders)
+    PIXEL_NV21       = 8, // Y plane, interleaved VU plane (Android camera)
+    PIXEL_I420       = 9  // Y, U and V planes (YUV420 of software decoders), chroma stride is half of stride
+};
+
+class ImageDecoder;
+
 class Image {
 	private:
 		unsigned char* imageData;
@@ -32,12 +48,71 @@ class Image {
 
 		int channels;
 		int depth;
+
+		/* Layout of pixels, read by getRow and by accessors of views. Decoded image is single plane
+		   of its own data, view has planes of external memory (YUV formats: Y, U or interleaved chroma, V) */
+		bool isView = false;
+		PixelFormat layout = PIXEL_RGB;
+		const unsigned char * planes[3] = {};
+		int strides[3] = {};
+
+		// Decoder of load (NULL selects it by format of data) and reduction of decoded size
+		ImageDecoder * decoder = nullptr;
+		int decodeScale = 1;
+
+		void SetLayout(PixelFormat format, const unsigned char * y, int yStride, const unsigned char * u, const unsigned char * v, int uvStride);
+		void ReleaseData();
+
+		// Accessors of views, the same values as accessors of image loaded from the same pixels
+		unsigned char * ViewChannel(int channel);
+		unsigned char * ViewGray(GrayscaleMode mode);
 	public:
 		Image();
 
         void load(unsigned char * data, int size, LoadMode decode_mode);
         void load(const char * filename, LoadMode load_mode);
 
+        /** @brief
+        * Decoder of following loads (ImageDecoders::find), NULL selects decoder by format of data (default) */
+        void setDecoder(ImageDecoder * imageDecoder);
+
+        /** @brief
+        * Following loads decode image reduced 'scale' times (1 - default, 2, 4 or 8), when decoder supports it
+        * (libjpeg-turbo in DCT domain), otherwise in full size, throws ErrorCode (DECODE_SCALE_NOT_SUPPORTED) */
+        void setDecodeScale(int scale);
+
+        /** @brief
+        * Copies already decoded pixels (e.g. video frame) without encoding and decoding them, BGR(A) is reordered to RGB(A).
+        * Buffer of previous image of the same size is reused. Throws ErrorCode (PIXELS_NOT_VALID, PIXEL_FORMAT_NOT_SUPPORTED)
+        * @param stride - bytes between starts of rows (at least width * bytes per pixel) */
+        void load(const unsigned char * pixels, int width, int height, int stride, PixelFormat format);
+
+        /** @brief
+        * View over external pixels in their native layout (stride, BGR order, YUV planes), nothing is copied or converted
+        * until accessors read it, pixels have to outlive view. Accessors give the same values as of image loaded
+        * from the same pixels, gray of YUV formats is their Y plane (scaled to full range, see getLumaPresent).
+        * Throws ErrorCode (PIXELS_NOT_VALID, PIXEL_FORMAT_NOT_SUPPORTED)
+        * @param stride - bytes between starts of rows (of Y plane for YUV formats) */
+        void view(const unsigned char * pixels, int width, int height, int stride, PixelFormat format);
+
+        /** @brief
+        * View over YUV format with planes in separate buffers (u is interleaved chroma plane of NV12 and NV21, v is not used) */
+        void view(int width, int height, PixelFormat format, const unsigned char * y, int yStride,
+                  const unsigned char * u, const unsigned char * v, int uvStride);
+
+        /** @brief
+        * Bytes of one pixel of format (of Y plane for YUV formats), throws ErrorCode (PIXEL_FORMAT_NOT_SUPPORTED) */
+        static int pixelSize(PixelFormat format);
+
+        /** @brief
+        * Gray image is native plane of pixels (Y of YUV views), gray-only descriptors read it without conversion to RGB */
+        bool getLumaPresent();
+
+        /** @brief
+        * Reads width pixels of row y from column x: RGB triplets (gray value to all of them, as in getRGB) into rgb,
+        * alpha values (255 without transparency) into alpha, either may be NULL. Returns false for image without pixels */
+        bool getRow(int y, int x, int width, unsigned char * rgb, unsigned char * alpha);
+
         int getChannels();
 		int getWidth();
 		int getHeight();
@@ -53,7 +128,7 @@ class Image {
 		unsigned char * getGray(GrayscaleMode mode);
 		unsigned char * getRGB();
 		unsigned char * getRGBA();
-		unsigned char * getData();
+		unsigned char * getData(); // decoded pixels (NULL for views)
 
 		~Image();
 };
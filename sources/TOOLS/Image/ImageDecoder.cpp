@@ -0,0 +1,179 @@
+#include "ImageDecoder.h"
+
+#include <climits>
+#include <cstdlib>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#ifdef MPEG7_JPEG_TURBO
+    #include <csetjmp>
+    #include <cstdio>
+    #include <cstring>
+    #include <jpeglib.h>
+#endif
+
+ImageDecoder::~ImageDecoder() = default;
+
+/** Every format of stb_image (JPEG, PNG, BMP, GIF, PSD, TGA, HDR, PIC, PNM), always in full size */
+class StbImageDecoder : public ImageDecoder {
+    public:
+        const char * getName() const override {
+            return "stb_image";
+        }
+
+        bool supports(const unsigned char *, int) const override {
+            return true;
+        }
+
+        unsigned char * decode(const unsigned char * data, const int size, const int desiredChannels, int,
+                               int * width, int * height, int * channels) const override {
+            int channelsInFile;
+            unsigned char * pixels = stbi_load_from_memory(data, size, width, height, &channelsInFile, desiredChannels);
+
+            *channels = desiredChannels != 0 ? desiredChannels : channelsInFile;
+            return pixels;
+        }
+
+        const char * getFailureReason() const override {
+            return stbi_failure_reason();
+        }
+};
+
+#ifdef MPEG7_JPEG_TURBO
+
+static thread_local char jpegFailure[JMSG_LENGTH_MAX];
+
+struct JpegError {
+    jpeg_error_mgr manager;
+    jmp_buf jump;
+};
+
+static void JpegErrorExit(j_common_ptr info) {
+    (*info->err->format_message)(info, jpegFailure);
+    longjmp(reinterpret_cast<JpegError *>(info->err)->jump, 1);
+}
+
+static void JpegOutputMessage(j_common_ptr) {
+    // Warnings of corrupt data are not printed (stb_image does not print them either)
+}
+
+/** JPEG with gray or YCbCr components (CMYK is left to stb_image) */
+class JpegTurboDecoder : public ImageDecoder {
+    public:
+        const char * getName() const override {
+            return "libjpeg-turbo";
+        }
+
+        bool supports(const unsigned char * data, const int size) const override {
+            return size >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF;
+        }
+
+        unsigned char * decode(const unsigned char * data, const int size, const int desiredChannels, const int scale,
+                               int * width, int * height, int * channels) const override {
+            if (desiredChannels != 0 && desiredChannels != 1 && desiredChannels != 3) {
+                strncpy(jpegFailure, "channels not supported", sizeof(jpegFailure));
+                return nullptr;
+            }
+
+            jpeg_decompress_struct info;
+            JpegError error;
+            unsigned char * volatile pixels = nullptr;
+
+            info.err = jpeg_std_error(&error.manager);
+            error.manager.error_exit     = JpegErrorExit;
+            error.manager.output_message = JpegOutputMessage;
+
+            if (setjmp(error.jump)) {
+                jpeg_destroy_decompress(&info);
+                free(pixels);
+                return nullptr;
+            }
+
+            jpeg_create_decompress(&info);
+            jpeg_mem_src(&info, const_cast<unsigned char *>(data), static_cast<unsigned long>(size));
+            jpeg_read_header(&info, TRUE);
+
+            if (info.num_components != 1 && info.num_components != 3) {
+                strncpy(jpegFailure, "components not supported", sizeof(jpegFailure));
+                jpeg_destroy_decompress(&info);
+                return nullptr;
+            }
+
+            // Gray output of YCbCr image is its Y component, chroma is not decoded at all
+            const int outputChannels = desiredChannels != 0 ? desiredChannels : info.num_components;
+
+            info.out_color_space = outputChannels == 1 ? JCS_GRAYSCALE : JCS_RGB;
+            info.scale_num       = 1;
+            info.scale_denom     = static_cast<unsigned int>(scale);
+
+            jpeg_start_decompress(&info);
+
+            if (static_cast<long long>(info.output_width) * info.output_height * outputChannels > INT_MAX) {
+                strncpy(jpegFailure, "too large", sizeof(jpegFailure));
+                jpeg_destroy_decompress(&info);
+                return nullptr;
+            }
+
+            const size_t rowSize = static_cast<size_t>(info.output_width) * outputChannels;
+            pixels = static_cast<unsigned char *>(malloc(rowSize * info.output_height));
+
+            if (pixels == nullptr) {
+                strncpy(jpegFailure, "outofmem", sizeof(jpegFailure));
+                jpeg_destroy_decompress(&info);
+                return nullptr;
+            }
+
+            while (info.output_scanline < info.output_height) {
+                JSAMPROW row = pixels + info.output_scanline * rowSize;
+                jpeg_read_scanlines(&info, &row, 1);
+            }
+
+            *width    = static_cast<int>(info.output_width);
+            *height   = static_cast<int>(info.output_height);
+            *channels = outputChannels;
+
+            jpeg_finish_decompress(&info);
+            jpeg_destroy_decompress(&info);
+            return pixels;
+        }
+
+        const char * getFailureReason() const override {
+            return jpegFailure;
+        }
+};
+
+#endif
+
+const std::vector<ImageDecoder *> & ImageDecoders::all() {
+#ifdef MPEG7_JPEG_TURBO
+    static JpegTurboDecoder jpegTurbo;
+    static const std::vector<ImageDecoder *> decoders = { &jpegTurbo, &fallback() };
+#else
+    static const std::vector<ImageDecoder *> decoders = { &fallback() };
+#endif
+    return decoders;
+}
+
+ImageDecoder & ImageDecoders::select(const unsigned char * data, const int size) {
+    for (ImageDecoder * decoder : all()) {
+        if (decoder->supports(data, size)) {
+            return *decoder;
+        }
+    }
+    return fallback();
+}
+
+ImageDecoder & ImageDecoders::fallback() {
+    static StbImageDecoder stb;
+    return stb;
+}
+
+ImageDecoder * ImageDecoders::find(const std::string & name) {
+    for (ImageDecoder * decoder : all()) {
+        if (name == decoder->getName()) {
+            return decoder;
+        }
+    }
+    return nullptr;
+}
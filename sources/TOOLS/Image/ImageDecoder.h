@@ -0,0 +1,59 @@
+/** @file   ImageDecoder.h
+ *  @brief  Decoders of encoded images behind Image::load.
+ *
+ *          stb_image decodes every supported format and is the default. When the library
+ *          is built with MPEG7_JPEG_TURBO (CMake option, libjpeg-turbo found), JPEG is
+ *          decoded by libjpeg-turbo instead: its SIMD IDCT is faster, it can downscale
+ *          in DCT domain (1/2, 1/4, 1/8 of size) and decodes gray image from Y component only.
+ *          Backends may differ by rounding of IDCT and color conversion (about 1 gray level).
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+class ImageDecoder {
+    public:
+        virtual const char * getName() const = 0;
+
+        /** @brief
+        * True, when decoder recognizes format of data */
+        virtual bool supports(const unsigned char * data, int size) const = 0;
+
+        /** @brief
+        * Decodes data into interleaved 8-bit channels, allocated with malloc (freed by Image)
+        * @param desiredChannels - 0 keeps channels of file, 1 gray, 3 RGB
+        * @param scale - image is decoded reduced 'scale' times (1, 2, 4 or 8), when decoder supports it,
+        *                otherwise in full size, width and height give size of decoded image
+        * @return unsigned char * - pixels or NULL on failure (see getFailureReason) */
+        virtual unsigned char * decode(const unsigned char * data, int size, int desiredChannels, int scale,
+                                       int * width, int * height, int * channels) const = 0;
+
+        /** @brief
+        * Reason of last failure of decode in calling thread */
+        virtual const char * getFailureReason() const = 0;
+
+        virtual ~ImageDecoder();
+};
+
+class ImageDecoders {
+    public:
+        /** @brief
+        * Decoders built into library, in order of preference (stb_image, decoding every format, is last) */
+        static const std::vector<ImageDecoder *> & all();
+
+        /** @brief
+        * First decoder supporting data */
+        static ImageDecoder & select(const unsigned char * data, int size);
+
+        /** @brief
+        * Default decoder (stb_image) */
+        static ImageDecoder & fallback();
+
+        /** @brief
+        * Decoder of given name ("stb_image", "libjpeg-turbo"), NULL when it is not built */
+        static ImageDecoder * find(const std::string & name);
+};
@@ -0,0 +1,232 @@
+#include "ShapeMask.h"
+#include "../ErrorCode.h"
+#include "../Trace/Trace.h"
+
+#include <algorithm>
+#include <cmath>
+
+void ShapeMask::reset(const int width, const int height, const MaskOrder maskOrder) {
+    if (width <= 0 || height <= 0) {
+        throw MASK_NOT_VALID;
+    }
+
+    maskWidth  = width;
+    maskHeight = height;
+    order      = maskOrder;
+
+    runs.clear();
+    polygon.clear();
+}
+
+void ShapeMask::loadRLE(const int width, const int height, const unsigned int * counts, const int countSize, const MaskOrder maskOrder) {
+    TRACE_SCOPE("ShapeMask::loadRLE");
+
+    if (counts == nullptr && countSize > 0) {
+        throw MASK_DATA_NULL;
+    }
+
+    if (countSize < 0 || (maskOrder != MASK_COLUMN_MAJOR && maskOrder != MASK_ROW_MAJOR)) {
+        throw MASK_NOT_VALID;
+    }
+
+    reset(width, height, maskOrder);
+
+    // Runs are split at ends of lines (columns for column-major order)
+    const unsigned long lineLength = maskOrder == MASK_COLUMN_MAJOR ? height : width;
+    const unsigned long total      = static_cast<unsigned long>(width) * height;
+
+    unsigned long position = 0;
+
+    for (int i = 0; i < countSize; i++) {
+        if (counts[i] > total - position) {
+            runs.clear();
+            throw MASK_NOT_VALID;
+        }
+
+        // Even counts are background
+        if (i % 2 == 1) {
+            unsigned long remaining = counts[i];
+            unsigned long start     = position;
+
+            while (remaining > 0) {
+                const unsigned long line   = start / lineLength;
+                const unsigned long offset = start % lineLength;
+                const unsigned long length = std::min(remaining, lineLength - offset);
+
+                MaskRun run;
+                run.x      = static_cast<int>(maskOrder == MASK_COLUMN_MAJOR ? line : offset);
+                run.y      = static_cast<int>(maskOrder == MASK_COLUMN_MAJOR ? offset : line);
+                run.length = static_cast<int>(length);
+                runs.push_back(run);
+
+                start     += length;
+                remaining -= length;
+            }
+        }
+        position += counts[i];
+    }
+}
+
+void ShapeMask::loadPolygon(const int width, const int height, const double * xy, const int vertexCount) {
+    TRACE_SCOPE("ShapeMask::loadPolygon");
+
+    if (xy == nullptr) {
+        throw MASK_DATA_NULL;
+    }
+
+    if (vertexCount < 3) {
+        throw MASK_NOT_VALID;
+    }
+
+    for (int i = 0; i < vertexCount * 2; i++) {
+        if (!std::isfinite(xy[i])) {
+            throw MASK_NOT_VALID;
+        }
+    }
+
+    reset(width, height, MASK_ROW_MAJOR);
+    polygon.assign(xy, xy + vertexCount * 2);
+
+    double minY = xy[1];
+    double maxY = xy[1];
+
+    for (int i = 1; i < vertexCount; i++) {
+        minY = std::min(minY, xy[i * 2 + 1]);
+        maxY = std::max(maxY, xy[i * 2 + 1]);
+    }
+
+    // Rows with pixel centers between lowest and highest vertex
+    const int firstRow = std::max(0, static_cast<int>(std::ceil(minY - 0.5)));
+    const int lastRow  = std::min(height - 1, static_cast<int>(std::floor(maxY - 0.5)));
+
+    std::vector<double> crossings;
+
+    for (int y = firstRow; y <= lastRow; y++) {
+        const double center = y + 0.5;
+        crossings.clear();
+
+        for (int i = 0; i < vertexCount; i++) {
+            const double * a = xy + i * 2;
+            const double * b = xy + ((i + 1) % vertexCount) * 2;
+
+            // Half-open edges, so vertex on scanline is counted once
+            if ((a[1] <= center && center < b[1]) || (b[1] <= center && center < a[1])) {
+                crossings.push_back(a[0] + (center - a[1]) * (b[0] - a[0]) / (b[1] - a[1]));
+            }
+        }
+
+        std::sort(crossings.begin(), crossings.end());
+
+        for (size_t i = 0; i + 1 < crossings.size(); i += 2) {
+            // Pixels with centers in [crossing, next crossing)
+            const int first = std::max(0, static_cast<int>(std::ceil(crossings[i] - 0.5)));
+            const int last  = std::min(width, static_cast<int>(std::ceil(crossings[i + 1] - 0.5)));
+
+            if (last > first) {
+                MaskRun run;
+                run.x      = first;
+                run.y      = y;
+                run.length = last - first;
+                runs.push_back(run);
+            }
+        }
+    }
+}
+
+void ShapeMask::loadLabels(const int width, const int height, const unsigned short * labels, const int labelCount, std::vector<ShapeMask> & masks) {
+    TRACE_SCOPE("ShapeMask::loadLabels");
+
+    if (labels == nullptr) {
+        throw MASK_DATA_NULL;
+    }
+
+    if (labelCount < 0) {
+        throw MASK_NOT_VALID;
+    }
+
+    masks.resize(static_cast<size_t>(labelCount) + 1);
+
+    for (ShapeMask & mask : masks) {
+        mask.reset(width, height, MASK_ROW_MAJOR);
+    }
+
+    // Every row is cut into runs of equal labels, each run goes to mask of its label
+    for (int y = 0; y < height; y++) {
+        const unsigned short * row = labels + static_cast<size_t>(y) * width;
+        int start = 0;
+
+        for (int x = 1; x <= width; x++) {
+            if (x < width && row[x] == row[start]) {
+                continue;
+            }
+
+            const int label = row[start];
+
+            if (label != 0 && label <= labelCount) {
+                MaskRun run;
+                run.x      = start;
+                run.y      = y;
+                run.length = x - start;
+                masks[label].runs.push_back(run);
+            }
+            start = x;
+        }
+    }
+}
+
+int ShapeMask::getWidth() const {
+    return maskWidth;
+}
+
+int ShapeMask::getHeight() const {
+    return maskHeight;
+}
+
+MaskOrder ShapeMask::getOrder() const {
+    return order;
+}
+
+const std::vector<MaskRun> & ShapeMask::getRuns() const {
+    return runs;
+}
+
+const std::vector<double> & ShapeMask::getPolygon() const {
+    return polygon;
+}
+
+std::vector<unsigned char> ShapeMask::rasterize(const int border, int & left, int & top, int & width, int & height) const {
+    left = top = width = height = 0;
+
+    if (runs.empty()) {
+        return std::vector<unsigned char>();
+    }
+
+    const int dx = order == MASK_ROW_MAJOR ? 1 : 0;
+    const int dy = order == MASK_ROW_MAJOR ? 0 : 1;
+
+    int minX = maskWidth, minY = maskHeight, maxX = 0, maxY = 0;
+
+    for (const MaskRun & run : runs) {
+        minX = std::min(minX, run.x);
+        minY = std::min(minY, run.y);
+        maxX = std::max(maxX, run.x + (run.length - 1) * dx);
+        maxY = std::max(maxY, run.y + (run.length - 1) * dy);
+    }
+
+    left   = minX - border;
+    top    = minY - border;
+    width  = maxX - minX + 1 + 2 * border;
+    height = maxY - minY + 1 + 2 * border;
+
+    std::vector<unsigned char> raster(static_cast<size_t>(width) * height, 0);
+
+    for (const MaskRun & run : runs) {
+        unsigned char * pixel = &raster[static_cast<size_t>(run.y - top) * width + (run.x - left)];
+        const size_t step = order == MASK_ROW_MAJOR ? 1 : width;
+
+        for (int i = 0; i < run.length; i++) {
+            pixel[i * step] = 255;
+        }
+    }
+    return raster;
+}
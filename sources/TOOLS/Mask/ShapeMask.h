@@ -0,0 +1,73 @@
+/** @file   ShapeMask.h
+ *  @brief  Binary segmentation mask kept as runs of foreground pixels,
+ *          input of shape extractors without encoding and decoding an image.
+ *
+ *          Masks are loaded from run-length encoding (COCO style: counts of
+ *          alternating background and foreground pixels, starting with background,
+ *          in column-major or row-major pixel order) or from polygon (pixel is
+ *          foreground, when its center lies inside, even-odd rule). Runs never
+ *          cross column (row) boundaries and are ordered as pixels of the mask.
+ *          Polygon masks keep their vertices, so contour does not have to be traced.
+ *          Label maps of instance segmentation are split into masks of all objects at once.
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include <vector>
+
+enum MaskOrder {
+    MASK_COLUMN_MAJOR = 1, // runs go down columns (COCO RLE)
+    MASK_ROW_MAJOR    = 2  // runs go along rows
+};
+
+/** Run of foreground pixels starting at (x, y) */
+struct MaskRun {
+    int x, y;
+    int length;
+};
+
+class ShapeMask {
+    private:
+        int maskWidth  = 0;
+        int maskHeight = 0;
+
+        MaskOrder order = MASK_ROW_MAJOR;
+        std::vector<MaskRun> runs;
+        std::vector<double> polygon; // x, y pairs, empty for RLE masks
+
+        void reset(int width, int height, MaskOrder order);
+    public:
+        /** @brief
+        * Loads mask from RLE counts, throws ErrorCode (MASK_DATA_NULL, MASK_NOT_VALID
+        * for counts covering more than width * height pixels) */
+        void loadRLE(int width, int height, const unsigned int * counts, int countSize, MaskOrder order);
+
+        /** @brief
+        * Loads mask from polygon of vertexCount (x, y) pairs in pixel coordinates (pixel (0, 0) covers [0, 1) x [0, 1)),
+        * parts outside of width x height are clipped, throws ErrorCode (MASK_DATA_NULL, MASK_NOT_VALID for less than 3 vertices) */
+        void loadPolygon(int width, int height, const double * xy, int vertexCount);
+
+        /** @brief
+        * Splits label map (width x height labels, row by row, 0 is background) into row-major masks
+        * of labels 1 to labelCount in single pass over the map, higher labels are ignored,
+        * throws ErrorCode (MASK_DATA_NULL, MASK_NOT_VALID)
+        * @param masks - output, masks[label] for label in [0, labelCount] (masks[0] and masks of missing labels have no runs) */
+        static void loadLabels(int width, int height, const unsigned short * labels, int labelCount, std::vector<ShapeMask> & masks);
+
+        int getWidth() const;
+        int getHeight() const;
+        MaskOrder getOrder() const;
+
+        const std::vector<MaskRun> & getRuns() const;
+        const std::vector<double> & getPolygon() const;
+
+        /** @brief
+        * Writes foreground pixels (255) of bounding box of runs extended by 'border' pixels on every side,
+        * background is 0
+        * @param left, top - output, mask coordinates of first pixel of raster
+        * @param width, height - output, size of raster (0 for empty mask)
+        * @return std::vector<unsigned char> - raster, row by row */
+        std::vector<unsigned char> rasterize(int border, int & left, int & top, int & width, int & height) const;
+};
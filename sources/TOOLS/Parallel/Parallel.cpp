@@ -0,0 +1,39 @@
+#include "Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+int Parallel::resolveThreads(const int threads) {
+    if (threads > 0) {
+        return threads;
+    }
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+void Parallel::forEach(const unsigned long count, const int threads, const std::function<void(unsigned long, int)> & task) {
+    const int workers = static_cast<int>(std::min<unsigned long>(resolveThreads(threads), std::max(count, 1UL)));
+
+    std::atomic<unsigned long> next(0);
+
+    const auto work = [&](const int worker) {
+        for (unsigned long index = next++; index < count; index = next++) {
+            task(index, worker);
+        }
+    };
+
+    // Calling thread is one of workers, so single threaded runs do not spawn anything
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+
+    for (int worker = 1; worker < workers; worker++) {
+        pool.emplace_back(work, worker);
+    }
+
+    work(0);
+
+    for (std::thread & thread : pool) {
+        thread.join();
+    }
+}
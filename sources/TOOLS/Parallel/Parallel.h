@@ -0,0 +1,31 @@
+/** @file   Parallel.h
+ *  @brief  Minimal worker pool for running independent extraction tasks.
+ *
+ *          Tasks are indices [0, count) handed out to worker threads
+ *          one by one, so long and short tasks balance themselves.
+ *          Tasks must not throw - errors are expected to be stored
+ *          by the task itself (as ErrorCode results).
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include <functional>
+
+class Parallel {
+    public:
+        /** @brief
+        * Number of worker threads to use
+        * @param threads - requested threads, 0 or less means all hardware threads
+        * @return int - at least 1 */
+        static int resolveThreads(int threads);
+
+        /** @brief
+        * Runs task for every index in [0, count) on worker threads,
+        * returns after all tasks are finished
+        * @param count - number of tasks
+        * @param threads - requested threads, 0 or less means all hardware threads
+        * @param task - task(index, worker), worker is in [0, resolveThreads(threads)) */
+        static void forEach(unsigned long count, int threads, const std::function<void(unsigned long, int)> & task);
+};
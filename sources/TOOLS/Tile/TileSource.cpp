@@ -0,0 +1,98 @@
+#include "TileSource.h"
+#include "../ErrorCode.h"
+
+int TileSource::getTileHeight() {
+    return TILE_DEFAULT_HEIGHT;
+}
+
+TileSource::~TileSource() = default;
+
+ImageTileSource::ImageTileSource(Image & image, const int tileHeight) : image(image), tileHeight(tileHeight) {
+}
+
+int ImageTileSource::getWidth() {
+    return image.getWidth();
+}
+
+int ImageTileSource::getHeight() {
+    return image.getHeight();
+}
+
+bool ImageTileSource::getTransparencyPresent() {
+    return image.getTransparencyPresent();
+}
+
+int ImageTileSource::getTileHeight() {
+    return tileHeight;
+}
+
+void ImageTileSource::read(const int x, const int y, const int width, const int height, unsigned char * rgb, unsigned char * alpha) {
+    // Rows are read in native layout of image (decoded pixels or view)
+    for (int j = 0; j < height; j++) {
+        const size_t offset = static_cast<size_t>(j) * width;
+
+        if (!image.getRow(y + j, x, width, rgb != nullptr ? rgb + offset * 3 : nullptr, alpha != nullptr ? alpha + offset : nullptr)) {
+            throw TILE_READ_FAILED;
+        }
+    }
+}
+
+RegionTileSource::RegionTileSource(TileSource & source, const int x, const int y, const int width, const int height)
+    : source(source), left(x), top(y), regionWidth(width), regionHeight(height) {
+
+    if (x < 0 || y < 0 || width <= 0 || height <= 0 || width > source.getWidth() - x || height > source.getHeight() - y) {
+        throw TILE_SOURCE_NOT_VALID;
+    }
+}
+
+int RegionTileSource::getWidth() {
+    return regionWidth;
+}
+
+int RegionTileSource::getHeight() {
+    return regionHeight;
+}
+
+bool RegionTileSource::getTransparencyPresent() {
+    return source.getTransparencyPresent();
+}
+
+int RegionTileSource::getTileHeight() {
+    return source.getTileHeight();
+}
+
+void RegionTileSource::read(const int x, const int y, const int width, const int height, unsigned char * rgb, unsigned char * alpha) {
+    source.read(left + x, top + y, width, height, rgb, alpha);
+}
+
+CallbackTileSource::CallbackTileSource(const TileReader reader, void * user, const int width, const int height,
+                                       const bool transparencyPresent, const int tileHeight)
+    : reader(reader), user(user), sourceWidth(width), sourceHeight(height),
+      transparencyPresent(transparencyPresent), tileHeight(tileHeight > 0 ? tileHeight : TILE_DEFAULT_HEIGHT) {
+
+    if (reader == nullptr || width <= 0 || height <= 0) {
+        throw TILE_SOURCE_NOT_VALID;
+    }
+}
+
+int CallbackTileSource::getWidth() {
+    return sourceWidth;
+}
+
+int CallbackTileSource::getHeight() {
+    return sourceHeight;
+}
+
+bool CallbackTileSource::getTransparencyPresent() {
+    return transparencyPresent;
+}
+
+int CallbackTileSource::getTileHeight() {
+    return tileHeight;
+}
+
+void CallbackTileSource::read(const int x, const int y, const int width, const int height, unsigned char * rgb, unsigned char * alpha) {
+    if (reader(user, x, y, width, height, rgb, alpha) != 0) {
+        throw TILE_READ_FAILED;
+    }
+}
@@ -0,0 +1,92 @@
+/** @file   TileSource.h
+ *  @brief  Source of pixels read region by region, input of extractors for images
+ *          too large to be decoded into single buffer (satellite, slide-scanner imagery).
+ *
+ *          Extractors of decomposable descriptors (Scalable Color, Color Structure,
+ *          Edge Histogram, CT Browsing) read bands of full rows from source, keep only
+ *          their partial accumulators and give the same descriptor as extraction from
+ *          whole image. Sources may be backed by decoded image, by region of other source
+ *          (region of interest) or by reader callback of C API.
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include "../Image/Image.h"
+
+#define TILE_DEFAULT_HEIGHT 256 // rows read at once, when source does not prefer other height
+
+/** Reader of C API, fills width x height region at (x, y) row by row: RGB triplets into rgb,
+ *  alpha values into alpha (either is NULL, when not requested), returns 0 or non-zero on failure */
+extern "C" typedef int (*TileReader)(void * user, int x, int y, int width, int height, unsigned char * rgb, unsigned char * alpha);
+
+class TileSource {
+    public:
+        virtual int getWidth() = 0;
+        virtual int getHeight() = 0;
+        virtual bool getTransparencyPresent() = 0;
+
+        /** @brief
+        * Preferred number of rows of single read (e.g. height of tiles of file) */
+        virtual int getTileHeight();
+
+        /** @brief
+        * Reads width x height region at (x, y), always inside of source, throws ErrorCode (TILE_READ_FAILED)
+        * @param rgb - output, width * height RGB triplets, row by row, NULL when not needed
+        * @param alpha - output, width * height alpha values (255 without transparency), NULL when not needed */
+        virtual void read(int x, int y, int width, int height, unsigned char * rgb, unsigned char * alpha) = 0;
+
+        virtual ~TileSource();
+};
+
+/** Source reading regions of already decoded image (gray, gray + alpha, RGB or RGBA) or of view of pixels */
+class ImageTileSource : public TileSource {
+    private:
+        Image & image;
+        int tileHeight;
+    public:
+        ImageTileSource(Image & image, int tileHeight = TILE_DEFAULT_HEIGHT);
+
+        int getWidth() override;
+        int getHeight() override;
+        bool getTransparencyPresent() override;
+        int getTileHeight() override;
+        void read(int x, int y, int width, int height, unsigned char * rgb, unsigned char * alpha) override;
+};
+
+/** Region of interest of other source, throws ErrorCode (TILE_SOURCE_NOT_VALID), when region is empty or exceeds source */
+class RegionTileSource : public TileSource {
+    private:
+        TileSource & source;
+        int left, top;
+        int regionWidth, regionHeight;
+    public:
+        RegionTileSource(TileSource & source, int x, int y, int width, int height);
+
+        int getWidth() override;
+        int getHeight() override;
+        bool getTransparencyPresent() override;
+        int getTileHeight() override;
+        void read(int x, int y, int width, int height, unsigned char * rgb, unsigned char * alpha) override;
+};
+
+/** Source calling reader of C API */
+class CallbackTileSource : public TileSource {
+    private:
+        TileReader reader;
+        void * user;
+        int sourceWidth, sourceHeight;
+        bool transparencyPresent;
+        int tileHeight;
+    public:
+        /** @brief
+        * Throws ErrorCode (TILE_SOURCE_NOT_VALID for NULL reader or not positive size) */
+        CallbackTileSource(TileReader reader, void * user, int width, int height, bool transparencyPresent, int tileHeight);
+
+        int getWidth() override;
+        int getHeight() override;
+        bool getTransparencyPresent() override;
+        int getTileHeight() override;
+        void read(int x, int y, int width, int height, unsigned char * rgb, unsigned char * alpha) override;
+};
@@ -0,0 +1,162 @@
+#include "Trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace {
+    struct TraceEvent {
+        const char * name;
+        long long start;
+        long long duration;
+        unsigned long long allocations;
+        unsigned long long bytes;
+        int thread;
+    };
+
+    std::atomic<bool> traceEnabled(false);
+    std::atomic<int> nextThread(0);
+    std::mutex eventsMutex;
+    std::vector<TraceEvent> events;
+    unsigned long long dropped = 0;
+
+    thread_local unsigned long long allocationCount = 0;
+    thread_local unsigned long long allocationBytes = 0;
+
+    int threadIndex() {
+        thread_local const int index = ++nextThread;
+        return index;
+    }
+
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+}
+
+#ifdef MPEG7_TRACE
+
+// Allocation counting - replaced global operators are compiled only into tracing builds
+void * operator new(const std::size_t size) {
+    allocationCount++;
+    allocationBytes += size;
+
+    void * pointer = std::malloc(size == 0 ? 1 : size);
+
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void operator delete(void * pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void * pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+TraceScope::TraceScope(const char * name) : name(name), active(traceEnabled), start(0), allocations(0), bytes(0) {
+    if (active) {
+        allocations = allocationCount;
+        bytes = allocationBytes;
+        start = Trace::now();
+    }
+}
+
+TraceScope::~TraceScope() {
+    if (active) {
+        const long long end = Trace::now();
+        Trace::record(name, start, end - start, allocationCount - allocations, allocationBytes - bytes);
+    }
+}
+
+#endif
+
+bool Trace::available() {
+#ifdef MPEG7_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Trace::enable(const bool enabled) {
+    traceEnabled = enabled && available();
+}
+
+bool Trace::enabled() {
+    return traceEnabled;
+}
+
+void Trace::clear() {
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    events.clear();
+    dropped = 0;
+}
+
+unsigned long long Trace::droppedEvents() {
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    return dropped;
+}
+
+long long Trace::now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+unsigned long long Trace::threadAllocations() {
+    return allocationCount;
+}
+
+unsigned long long Trace::threadAllocatedBytes() {
+    return allocationBytes;
+}
+
+void Trace::record(const char * name, const long long start, const long long duration,
+                   const unsigned long long allocations, const unsigned long long bytes) {
+    const int thread = threadIndex();
+
+    // Growth of events is not counted in allocations of enclosing scopes, which are still open
+    const unsigned long long count = allocationCount;
+    const unsigned long long total = allocationBytes;
+    {
+        std::lock_guard<std::mutex> lock(eventsMutex);
+
+        if (events.size() < TRACE_MAX_EVENTS) {
+            events.push_back({ name, start, duration, allocations, bytes, thread });
+        }
+        else {
+            dropped++;
+        }
+    }
+    allocationCount = count;
+    allocationBytes = total;
+}
+
+std::string Trace::exportChrome() {
+    std::vector<TraceEvent> recorded;
+    unsigned long long droppedCount;
+    {
+        std::lock_guard<std::mutex> lock(eventsMutex);
+        recorded = events;
+        droppedCount = dropped;
+    }
+
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    char event[512];
+
+    for (size_t i = 0; i < recorded.size(); i++) {
+        const TraceEvent & e = recorded[i];
+
+        // Names are string literals of TRACE_SCOPE, so they need no escaping
+        snprintf(event, sizeof(event),
+                 "%s\n{\"name\":\"%s\",\"cat\":\"mpeg7\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":%d,"
+                 "\"args\":{\"allocations\":%llu,\"bytes\":%llu}}",
+                 i > 0 ? "," : "", e.name, e.start, e.duration, e.thread, e.allocations, e.bytes);
+        json += event;
+    }
+    snprintf(event, sizeof(event), "\n],\"otherData\":{\"droppedEvents\":%llu}}\n", droppedCount);
+    return json + event;
+}
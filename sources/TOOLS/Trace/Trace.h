@@ -0,0 +1,89 @@
+/** @file   Trace.h
+ *  @brief  Per-stage tracing of extraction pipelines.
+ *
+ *          Stages are marked with TRACE_SCOPE("name") at the beginning of a block.
+ *          When the library is built with MPEG7_TRACE (CMake option MPEG7_TRACE=ON)
+ *          and tracing is enabled at runtime, every scope records its wall time
+ *          and number and size of heap allocations made inside it (nested scopes included,
+ *          allocations of trace itself are not counted).
+ *          Without MPEG7_TRACE the macro expands to nothing, so default builds pay nothing.
+ *
+ *          Recorded events are exported in Chrome trace format (chrome://tracing, Perfetto):
+ *          {"traceEvents": [{"name", "cat", "ph": "X", "ts", "dur", "pid", "tid", "args": {"allocations", "bytes"}}],
+ *           "otherData": {"droppedEvents"}}
+ *          At most TRACE_MAX_EVENTS events are kept (first ones), later events are only counted
+ *          as dropped until clear, so tracing left enabled in long-running process stays bounded.
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include <string>
+
+#define TRACE_MAX_EVENTS 1000000 // about 48 MB of events
+
+class Trace {
+    public:
+        /** @brief
+        * @return bool - true, when library was built with MPEG7_TRACE */
+        static bool available();
+
+        /** @brief
+        * Starts or stops recording (recorded events are kept) */
+        static void enable(bool enabled);
+        static bool enabled();
+
+        /** @brief
+        * Drops all recorded events (and count of dropped ones) */
+        static void clear();
+
+        /** @brief
+        * Events not recorded since last clear, because TRACE_MAX_EVENTS events were kept */
+        static unsigned long long droppedEvents();
+
+        /** @brief
+        * @return std::string - recorded events as Chrome trace JSON */
+        static std::string exportChrome();
+
+        /** @brief
+        * Time in microseconds from a fixed process epoch */
+        static long long now();
+
+        /** @brief
+        * Heap allocations (count, bytes) made so far by calling thread,
+        * counted only in MPEG7_TRACE builds */
+        static unsigned long long threadAllocations();
+        static unsigned long long threadAllocatedBytes();
+
+        static void record(const char * name, long long start, long long duration,
+                           unsigned long long allocations, unsigned long long bytes);
+};
+
+#ifdef MPEG7_TRACE
+
+class TraceScope {
+    private:
+        const char * name;
+        bool active;
+        long long start;
+        unsigned long long allocations;
+        unsigned long long bytes;
+
+    public:
+        explicit TraceScope(const char * name);
+        ~TraceScope();
+
+        TraceScope(const TraceScope &) = delete;
+        TraceScope & operator=(const TraceScope &) = delete;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+
+#else
+
+#define TRACE_SCOPE(name)
+
+#endif
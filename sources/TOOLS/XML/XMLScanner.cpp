@@ -0,0 +1,309 @@
+#include "XMLScanner.h"
+
+#include <cstring>
+
+static bool isSpace(const char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool isNameEnd(const char c) {
+    return isSpace(c) || c == '/' || c == '>' || c == '=';
+}
+
+bool XMLSpan::equals(const char * text) const {
+    const size_t textLength = strlen(text);
+    return textLength == length && memcmp(data, text, length) == 0;
+}
+
+XMLScanner::XMLScanner(const char * data, const size_t size) : begin(data), position(data), end(data + size), token(XML_END),
+                                                               tokenStart(data), pendingEnd(false), depth(0) {
+}
+
+const char * XMLScanner::find(const char * from, const char * pattern) const {
+    const size_t length = strlen(pattern);
+
+    for (const char * c = from; c + length <= end; c++) {
+        c = static_cast<const char *>(memchr(c, pattern[0], end - c));
+
+        if (c == nullptr || c + length > end) {
+            return nullptr;
+        }
+
+        if (memcmp(c, pattern, length) == 0) {
+            return c;
+        }
+    }
+    return nullptr;
+}
+
+void XMLScanner::readName(XMLSpan & name) {
+    const char * start = position;
+
+    while (position < end && !isNameEnd(*position)) {
+        position++;
+    }
+
+    if (position == start || position == end) {
+        throw PARSE_ERROR;
+    }
+
+    name.data   = start;
+    name.length = position - start;
+}
+
+XMLToken XMLScanner::next() {
+    if (pendingEnd) {
+        pendingEnd = false;
+        depth--;
+        token = XML_ELEMENT_END;
+        return token;
+    }
+
+    while (position < end) {
+        tokenStart = position;
+
+        if (*position != '<') {
+            const char * textEnd = static_cast<const char *>(memchr(position, '<', end - position));
+
+            if (textEnd == nullptr) {
+                textEnd = end;
+            }
+
+            const char * c = position;
+
+            while (c < textEnd && isSpace(*c)) {
+                c++;
+            }
+
+            const char * start = position;
+            position = textEnd;
+
+            if (c == textEnd) {
+                continue; // whitespace between elements
+            }
+
+            if (depth == 0) {
+                throw PARSE_ERROR; // text outside of root element
+            }
+
+            tokenText.data   = start;
+            tokenText.length = textEnd - start;
+            token = XML_TEXT;
+            return token;
+        }
+
+        if (end - position > 1 && position[1] == '?') {
+            const char * close = find(position + 2, "?>");
+
+            if (close == nullptr) {
+                throw PARSE_ERROR;
+            }
+            position = close + 2;
+            continue;
+        }
+
+        if (end - position > 3 && memcmp(position, "<!--", 4) == 0) {
+            const char * close = find(position + 4, "-->");
+
+            if (close == nullptr) {
+                throw PARSE_ERROR;
+            }
+            position = close + 3;
+            continue;
+        }
+
+        if (end - position > 8 && memcmp(position, "<![CDATA[", 9) == 0) {
+            const char * close = find(position + 9, "]]>");
+
+            if (close == nullptr || depth == 0) {
+                throw PARSE_ERROR;
+            }
+
+            tokenText.data   = position + 9;
+            tokenText.length = close - tokenText.data;
+            position = close + 3;
+            token = XML_TEXT;
+            return token;
+        }
+
+        if (end - position > 1 && position[1] == '!') {
+            const char * close = static_cast<const char *>(memchr(position, '>', end - position));
+
+            if (close == nullptr) {
+                throw PARSE_ERROR;
+            }
+            position = close + 1;
+            continue;
+        }
+
+        if (end - position > 1 && position[1] == '/') {
+            position += 2;
+            readName(tokenName);
+
+            while (position < end && isSpace(*position)) {
+                position++;
+            }
+
+            if (position == end || *position != '>' || depth == 0) {
+                throw PARSE_ERROR;
+            }
+
+            const XMLSpan & open = openElements[depth - 1];
+
+            if (open.length != tokenName.length || memcmp(open.data, tokenName.data, open.length) != 0) {
+                throw PARSE_ERROR;
+            }
+
+            position++;
+            depth--;
+            token = XML_ELEMENT_END;
+            return token;
+        }
+
+        // Element start, attributes end at first '>' outside of quotes
+        position++;
+        readName(tokenName);
+
+        const char * attributes = position;
+        char quote = 0;
+
+        while (position < end && (quote != 0 || *position != '>')) {
+            if (quote != 0) {
+                quote = *position == quote ? 0 : quote;
+            }
+            else if (*position == '"' || *position == '\'') {
+                quote = *position;
+            }
+            position++;
+        }
+
+        if (position == end || depth == XML_SCANNER_MAX_DEPTH) {
+            throw PARSE_ERROR;
+        }
+
+        const bool empty = position[-1] == '/';
+
+        tokenAttributes.data   = attributes;
+        tokenAttributes.length = position - attributes - (empty ? 1 : 0);
+        position++;
+
+        openElements[depth++] = tokenName;
+        pendingEnd = empty;
+        token = XML_ELEMENT_START;
+        return token;
+    }
+
+    if (depth != 0) {
+        throw PARSE_ERROR; // input ends inside of element
+    }
+
+    tokenStart = end;
+    token = XML_END;
+    return token;
+}
+
+const XMLSpan & XMLScanner::name() const {
+    return tokenName;
+}
+
+const XMLSpan & XMLScanner::text() const {
+    return tokenText;
+}
+
+bool XMLScanner::attribute(const char * attributeName, XMLSpan & value) const {
+    const size_t nameLength = strlen(attributeName);
+    const char * c = tokenAttributes.data;
+    const char * attributesEnd = tokenAttributes.data + tokenAttributes.length;
+
+    while (c < attributesEnd) {
+        while (c < attributesEnd && isSpace(*c)) {
+            c++;
+        }
+
+        const char * nameStart = c;
+
+        while (c < attributesEnd && !isNameEnd(*c)) {
+            c++;
+        }
+
+        const size_t length = c - nameStart;
+
+        while (c < attributesEnd && isSpace(*c)) {
+            c++;
+        }
+
+        if (c == attributesEnd || *c != '=') {
+            return false;
+        }
+        c++;
+
+        while (c < attributesEnd && isSpace(*c)) {
+            c++;
+        }
+
+        if (c == attributesEnd || (*c != '"' && *c != '\'')) {
+            return false;
+        }
+
+        const char quote = *c++;
+        const char * valueEnd = static_cast<const char *>(memchr(c, quote, attributesEnd - c));
+
+        if (valueEnd == nullptr) {
+            return false;
+        }
+
+        if (length == nameLength && memcmp(nameStart, attributeName, length) == 0) {
+            value.data   = c;
+            value.length = valueEnd - c;
+            return true;
+        }
+        c = valueEnd + 1;
+    }
+    return false;
+}
+
+int XMLScanner::getDepth() const {
+    return depth;
+}
+
+size_t XMLScanner::getOffset() const {
+    return tokenStart - begin;
+}
+
+void XMLScanner::skipElement() {
+    const int target = depth - 1;
+
+    while (depth > target) {
+        if (next() == XML_END) {
+            throw PARSE_ERROR;
+        }
+    }
+}
+
+XMLSpan XMLScanner::readText() {
+    const int elementDepth = depth;
+    XMLSpan result;
+    bool found = false;
+
+    while (depth >= elementDepth) {
+        const XMLToken current = next();
+
+        if (current == XML_END) {
+            throw PARSE_ERROR;
+        }
+
+        if (current == XML_TEXT && !found && depth == elementDepth) {
+            result = tokenText;
+            found = true;
+        }
+    }
+    return result;
+}
+
+void XMLScanner::reset(const size_t offset) {
+    position   = begin + (offset < static_cast<size_t>(end - begin) ? offset : end - begin);
+    tokenStart = position;
+    pendingEnd = false;
+    depth      = 0;
+    token      = XML_END;
+}
@@ -0,0 +1,95 @@
+/** @file   XMLScanner.h
+ *  @brief  Pull tokenizer of XML held in memory, reading it without building a DOM.
+ *
+ *          Scanner walks the input once and reports element starts, element ends and text.
+ *          Names, attributes and text are spans of the input (not copied and not null terminated),
+ *          so scanning does not allocate. Declarations, processing instructions, comments and
+ *          DOCTYPE are skipped, CDATA sections are reported as text. Entities are not expanded
+ *          (descriptor payloads are numbers and plain words), whitespace-only text is not reported.
+ *
+ *          Malformed input (unterminated markup, mismatched end tag, nesting deeper than
+ *          XML_SCANNER_MAX_DEPTH) throws PARSE_ERROR.
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include "../ErrorCode.h"
+
+#include <cstddef>
+
+#define XML_SCANNER_MAX_DEPTH 32
+
+/** Part of scanned input */
+struct XMLSpan {
+    const char * data = nullptr;
+    size_t length     = 0;
+
+    bool equals(const char * text) const;
+};
+
+enum XMLToken {
+    XML_END,            // end of input
+    XML_ELEMENT_START,  // name() and attribute() describe started element
+    XML_ELEMENT_END,    // name() is name of ended element (also reported for <empty/> elements)
+    XML_TEXT            // text() holds text or CDATA content
+};
+
+class XMLScanner {
+    private:
+        const char * begin;
+        const char * position;
+        const char * end;
+
+        XMLToken token;
+        XMLSpan tokenName;
+        XMLSpan tokenText;
+        XMLSpan tokenAttributes;
+        const char * tokenStart;
+        bool pendingEnd;
+
+        int depth;
+        XMLSpan openElements[XML_SCANNER_MAX_DEPTH];
+
+        const char * find(const char * from, const char * pattern) const;
+        void readName(XMLSpan & name);
+
+    public:
+        XMLScanner(const char * data, size_t size);
+
+        /** @brief
+        * Reads next token
+        * @return XMLToken - token type, XML_END at end of input */
+        XMLToken next();
+
+        const XMLSpan & name() const;
+        const XMLSpan & text() const;
+
+        /** @brief
+        * Finds attribute of last started element
+        * @param value - output, attribute value without quotes
+        * @return bool - false, when element has no such attribute */
+        bool attribute(const char * attributeName, XMLSpan & value) const;
+
+        /** @brief
+        * Number of open elements (1 right after start of root element) */
+        int getDepth() const;
+
+        /** @brief
+        * Offset of last token from beginning of input */
+        size_t getOffset() const;
+
+        /** @brief
+        * Skips rest of element started last (or open at current depth), ending after its end tag */
+        void skipElement();
+
+        /** @brief
+        * Reads first text of element started last and skips rest of element
+        * @return XMLSpan - text, empty for element without text */
+        XMLSpan readText();
+
+        /** @brief
+        * Continues scanning from offset (e.g. after malformed part), with no open elements */
+        void reset(size_t offset);
+};
@@ -0,0 +1,216 @@
+#include "XMLWriter.h"
+
+#include <cstdio>
+#include <cstring>
+
+XMLWriter::XMLWriter() : buffer(nullptr), capacity(0), length(0), growable(true), depth(0), overflow(0), textDepth(-1),
+                         elementJustOpened(false), firstElement(true) {
+}
+
+XMLWriter::XMLWriter(char * buffer, const size_t capacity) : buffer(buffer), capacity(capacity), length(0), growable(false), depth(0), overflow(0),
+                                                             textDepth(-1), elementJustOpened(false), firstElement(true) {
+    if (capacity > 0) {
+        buffer[0] = '\0';
+    }
+}
+
+void XMLWriter::clear() {
+    length            = 0;
+    depth             = 0;
+    overflow          = 0;
+    textDepth         = -1;
+    elementJustOpened = false;
+    firstElement      = true;
+
+    if (capacity > 0) {
+        buffer[0] = '\0';
+    }
+}
+
+void XMLWriter::grow(const size_t required) {
+    // Own storage always keeps one byte for terminating null
+    size_t newCapacity = capacity > 0 ? capacity * 2 : 4096;
+
+    while (newCapacity < required + 1) {
+        newCapacity *= 2;
+    }
+
+    storage.resize(newCapacity);
+    buffer   = storage.data();
+    capacity = newCapacity;
+}
+
+void XMLWriter::put(const char * text, const size_t textLength) {
+    if (growable && length + textLength >= capacity) {
+        grow(length + textLength);
+    }
+
+    if (length < capacity) {
+        const size_t available = capacity - length;
+        memcpy(buffer + length, text, textLength < available ? textLength : available);
+    }
+    length += textLength;
+}
+
+void XMLWriter::put(const char c) {
+    put(&c, 1);
+}
+
+void XMLWriter::putString(const char * text) {
+    put(text, strlen(text));
+}
+
+void XMLWriter::putEscaped(const char * text, const bool restricted) {
+    // Same entities as XMLPrinter::PrintString, text escapes only '&', '<' and '>'
+    const char * run = text;
+
+    for (const char * c = text; *c != '\0'; c++) {
+        const char * entity = *c == '&' ? "&amp;" :
+                              *c == '<' ? "&lt;"  :
+                              *c == '>' ? "&gt;"  :
+                              restricted ? nullptr :
+                              *c == '"' ? "&quot;" :
+                              *c == '\'' ? "&apos;" : nullptr;
+
+        if (entity != nullptr) {
+            put(run, c - run);
+            putString(entity);
+            run = c + 1;
+        }
+    }
+    putString(run);
+}
+
+void XMLWriter::putIndent() {
+    for (int i = 0; i < depth; i++) {
+        put("    ", XML_WRITER_INDENT);
+    }
+}
+
+void XMLWriter::sealElement() {
+    if (elementJustOpened) {
+        elementJustOpened = false;
+        put('>');
+    }
+}
+
+void XMLWriter::beginText() {
+    textDepth = depth - 1;
+    sealElement();
+}
+
+void XMLWriter::declaration(const char * value) {
+    sealElement();
+
+    if (textDepth < 0 && !firstElement) {
+        put('\n');
+        putIndent();
+    }
+    firstElement = false;
+
+    put("<?", 2);
+    putString(value);
+    put("?>", 2);
+}
+
+void XMLWriter::openElement(const char * name) {
+    sealElement();
+
+    if (depth == XML_WRITER_MAX_DEPTH) {
+        overflow++; // element (and its closing) is dropped, library documents are much shallower
+        return;
+    }
+    openElements[depth] = name;
+
+    if (textDepth < 0 && !firstElement) {
+        put('\n');
+    }
+    putIndent();
+
+    put('<');
+    putString(name);
+
+    elementJustOpened = true;
+    firstElement      = false;
+    depth++;
+}
+
+void XMLWriter::closeElement() {
+    if (overflow > 0) {
+        overflow--;
+        return;
+    }
+
+    if (depth == 0) {
+        return;
+    }
+    depth--;
+
+    if (elementJustOpened) {
+        put("/>", 2);
+    }
+    else {
+        if (textDepth < 0) {
+            put('\n');
+            putIndent();
+        }
+        put("</", 2);
+        putString(openElements[depth]);
+        put('>');
+    }
+
+    if (textDepth == depth) {
+        textDepth = -1;
+    }
+
+    if (depth == 0) {
+        put('\n');
+    }
+    elementJustOpened = false;
+}
+
+void XMLWriter::attribute(const char * name, const char * value) {
+    put(' ');
+    putString(name);
+    put("=\"", 2);
+    putEscaped(value, false);
+    put('"');
+}
+
+void XMLWriter::text(const char * value) {
+    beginText();
+    putEscaped(value, true);
+}
+
+void XMLWriter::text(const float value) {
+    // Format of XMLElement::SetText(float)
+    char formatted[32];
+    const int formattedLength = snprintf(formatted, sizeof(formatted), "%.8g", value);
+
+    beginText();
+    put(formatted, static_cast<size_t>(formattedLength));
+}
+
+void XMLWriter::write(const char * text, const size_t textLength) {
+    put(text, textLength);
+}
+
+const char * XMLWriter::c_str() const {
+    if (length < capacity) {
+        buffer[length] = '\0';
+        return buffer;
+    }
+    return capacity > 0 ? buffer : "";
+}
+
+size_t XMLWriter::size() const {
+    return length;
+}
+
+bool XMLWriter::fits() const {
+    return length < capacity;
+}
+
+std::string XMLWriter::str() const {
+    return std::string(buffer != nullptr ? buffer : "", length < capacity ? length : capacity);
+}
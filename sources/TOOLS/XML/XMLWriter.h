@@ -0,0 +1,165 @@
+/** @file   XMLWriter.h
+ *  @brief  Streaming XML writer appending markup straight into a character buffer.
+ *
+ *          Output is byte for byte the one of tinyxml2::XMLPrinter printing an equal document
+ *          (4 space indentation, text elements kept on one line, empty elements closed with "/>"),
+ *          but no DOM nodes and no intermediate strings are created. Integers are formatted
+ *          with a digit loop instead of std::to_string.
+ *
+ *          Writer appends into a buffer supplied by the caller or into its own storage, which
+ *          grows when needed and keeps its capacity after clear(), so writer reused for many
+ *          descriptors allocates only until the largest document fits. Output not fitting into
+ *          caller buffer is dropped, but still counted by size() (like snprintf), so caller can
+ *          retry with buffer of size() + 1 bytes.
+ *
+ *  @author Krzysztof Lech Kucharski
+ *  @bug    No bugs detected. */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#define XML_WRITER_MAX_DEPTH  32
+#define XML_WRITER_INDENT     4
+
+class XMLWriter {
+    private:
+        char * buffer;
+        size_t capacity;
+        size_t length;
+        bool growable;
+        std::vector<char> storage;
+
+        const char * openElements[XML_WRITER_MAX_DEPTH];
+        int depth;
+        int overflow;
+        int textDepth;
+        bool elementJustOpened;
+        bool firstElement;
+
+        void grow(size_t required);
+        void put(const char * text, size_t textLength);
+        void put(char c);
+        void putString(const char * text);
+        void putEscaped(const char * text, bool restricted);
+        void putIndent();
+        void sealElement();
+        void beginText();
+
+        template <typename T>
+        void putInteger(T value) {
+            // Digits are written backwards into local buffer, unsigned arithmetic handles minimum of signed types
+            typedef typename std::make_unsigned<T>::type Unsigned;
+
+            char digits[24];
+            char * end = digits + sizeof(digits);
+            char * c = end;
+
+            const bool negative = value < 0;
+            Unsigned magnitude = negative ? static_cast<Unsigned>(0) - static_cast<Unsigned>(value) : static_cast<Unsigned>(value);
+
+            do {
+                *--c = static_cast<char>('0' + magnitude % 10);
+                magnitude /= 10;
+            } while (magnitude != 0);
+
+            if (negative) {
+                *--c = '-';
+            }
+            put(c, end - c);
+        }
+
+    public:
+        /** @brief
+        * Writer with own storage */
+        XMLWriter();
+
+        /** @brief
+        * Writer appending into caller buffer of given capacity (null terminated, when output fits) */
+        XMLWriter(char * buffer, size_t capacity);
+
+        XMLWriter(const XMLWriter &) = delete;
+        XMLWriter & operator=(const XMLWriter &) = delete;
+
+        /** @brief
+        * Starts new document, own storage keeps its capacity */
+        void clear();
+
+        /** @brief
+        * Writes <?declaration?> */
+        void declaration(const char * value);
+
+        /** @brief
+        * Opens element, name must stay valid until element is closed */
+        void openElement(const char * name);
+
+        /** @brief
+        * Closes element opened last */
+        void closeElement();
+
+        /** @brief
+        * Adds attribute to element opened last (before its text or children) */
+        void attribute(const char * name, const char * value);
+
+        template <typename T>
+        typename std::enable_if<std::is_integral<T>::value>::type attribute(const char * name, T value) {
+            put(' ');
+            putString(name);
+            put("=\"", 2);
+            putInteger(value);
+            put('"');
+        }
+
+        /** @brief
+        * Writes text of element opened last */
+        void text(const char * value);
+        void text(float value);
+
+        template <typename T>
+        typename std::enable_if<std::is_integral<T>::value>::type text(T value) {
+            beginText();
+            putInteger(value);
+        }
+
+        /** @brief
+        * Writes text of values separated and followed by single spaces (e.g. "1 2 3 ") */
+        template <typename T>
+        void textValues(const T * values, const size_t count) {
+            beginText();
+
+            for (size_t i = 0; i < count; i++) {
+                putInteger(values[i]);
+                put(' ');
+            }
+        }
+
+        /** @brief
+        * Opens element, writes its text and closes it */
+        template <typename T>
+        void textElement(const char * name, T value) {
+            openElement(name);
+            text(value);
+            closeElement();
+        }
+
+        /** @brief
+        * Appends text as is (no markup, no escaping), e.g. for plain text results */
+        void write(const char * text, size_t textLength);
+
+        /** @brief
+        * Written document, null terminated for own storage and for caller buffer holding whole output */
+        const char * c_str() const;
+
+        /** @brief
+        * Length of whole output, may be greater than caller buffer capacity */
+        size_t size() const;
+
+        /** @brief
+        * Whether whole output (with terminating null) fits into buffer */
+        bool fits() const;
+
+        std::string str() const;
+};
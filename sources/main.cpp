@@ -1,4 +1,7 @@
 #include "Mpeg7.h"
+#include "APP/BatchCommand.h"
+#include "APP/ConformanceCommand.h"
+#include "APP/StoreCommand.h"
 #include <iostream>
 #include <string>
 #include <vector>
@@ -8,6 +11,11 @@ void printUsage(const char* programName) {
     std::cout << "Usage:" << std::endl;
     std::cout << "  Extract descriptor: " << programName << " extract <descriptor_type> <image_path> [param_name param_value ...]" << std::endl;
     std::cout << "  Calculate distance: " << programName << " distance <xml_file1> <xml_file2> [param_name param_value ...]" << std::endl;
+    BatchCommand::printUsage(programName);
+    ConformanceCommand::printUsage(programName);
+    StoreCommand::printUsage(programName);
+    std::cout << "Tracing (library built with MPEG7_TRACE):" << std::endl;
+    std::cout << "  --trace <trace.json> added to any command writes its per-stage timings as Chrome trace JSON" << std::endl;
     std::cout << "Descriptor types:" << std::endl;
     std::cout << "  1 - Dominant Color" << std::endl;
     std::cout << "  2 - Scalable Color" << std::endl;
@@ -22,10 +30,13 @@ void printUsage(const char* programName) {
     std::cout << "Examples:" << std::endl;
     std::cout << "  Extract: " << programName << " extract 3 image.jpg NumberOfYCoeff 64 NumberOfCCoeff 64" << std::endl;
     std::cout << "  Distance: " << programName << " distance descriptor1.xml descriptor2.xml" << std::endl;
+    std::cout << "  Batch: " << programName << " batch images/ out/ --threads 8 -d 3 NumberOfYCoeff 64 NumberOfCCoeff 64 -d 8" << std::endl;
+    std::cout << "  Conformance: " << programName << " conformance --golden resources/conformance.golden" << std::endl;
+    std::cout << "  Store: " << programName << " store convert out/EDGE_HISTOGRAM_default.jsonl edges.m7s" << std::endl;
 }
 
-int main(const int argc, char* argv[]) {
-    if (argc < 3) {
+static int runCommand(const int argc, char* argv[]) {
+    if (argc < 2) {
         printUsage(argv[0]);
         return 1;
     }
@@ -140,11 +151,73 @@ int main(const int argc, char* argv[]) {
             std::cerr << "Error: Failed to calculate distance." << std::endl;
         }
     }
+    else if (command == "batch") {
+        // Batch extraction mode
+        const int result = BatchCommand::run(argc, argv);
+
+        if (result != 0) {
+            printUsage(argv[0]);
+        }
+        return result;
+    }
+    else if (command == "conformance") {
+        // Golden output regression check
+        const int result = ConformanceCommand::run(argc, argv);
+
+        if (result == 1) {
+            printUsage(argv[0]);
+        }
+        return result;
+    }
+    else if (command == "store") {
+        // Descriptor store conversion and inspection
+        const int result = StoreCommand::run(argc, argv);
+
+        if (result != 0) {
+            printUsage(argv[0]);
+        }
+        return result;
+    }
     else {
-        std::cerr << "Error: Unknown command '" << command << "'. Use 'extract' or 'distance'." << std::endl;
+        std::cerr << "Error: Unknown command '" << command << "'. Use 'extract', 'distance', 'batch', 'conformance' or 'store'." << std::endl;
         printUsage(argv[0]);
         return 1;
     }
     
     return 0;
 }
+
+int main(const int argc, char* argv[]) {
+    // --trace <path> may be given with any command, it is removed before command arguments are parsed
+    std::vector<char*> args;
+    std::string tracePath;
+
+    for (int i = 0; i < argc; i++) {
+        if (std::string(argv[i]) == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        }
+        else {
+            args.push_back(argv[i]);
+        }
+    }
+
+    if (!tracePath.empty() && enableTracing(1) != 0) {
+        std::cerr << "Warning: Library was built without MPEG7_TRACE, trace will be empty." << std::endl;
+    }
+
+    const int result = runCommand(static_cast<int>(args.size()), args.data());
+
+    if (!tracePath.empty()) {
+        std::ofstream traceFile(tracePath);
+        const char* trace = exportTrace();
+
+        if (traceFile.is_open()) {
+            traceFile << trace;
+        }
+        else {
+            std::cerr << "Error: Could not write trace " << tracePath << std::endl;
+        }
+        freeResultPointer(const_cast<char*>(trace));
+    }
+    return result;
+}